@@ -4,6 +4,7 @@
 #include <math.h>
 #include "../../library/cppsock/cppsock.hpp"
 #include "../../visualization/external/SchwarmPacket/packet.h"
+#include "../../visualization/external/SchwarmPacket/linkstats.h"
 #include "SvVis_PC.hpp"
 
 class SwarmCommandHandler
@@ -13,12 +14,47 @@ private:
 	cppsock::tcp::socket visualisation;
 	cppsock::socketaddr conv_server;
 	std::vector<std::shared_ptr<SvVis::client> > vehicles;
+	Schwarm::LinkStats stats;	// delay and lost commands, if the visualisation sends the extended header
+
+	void execute(const Schwarm::VehicleCommandPacket& command, std::chrono::system_clock::time_point& last_packet, std::chrono::system_clock::duration& time_last_packet)
+	{
+		std::stringstream ss;
+
+		std::cout << "[SERVER]: Command recived: " << command.get_length() << "m , " << command.get_angle() << "rad" << std::endl;
+		// send angle
+		if (command.get_angle() < 0)
+			ss << "rr " << int(command.get_angle() * (-180 / M_PI));
+		else if (command.get_angle() > 0)
+			ss << "rl " << int(command.get_angle() * (+180 / M_PI));
+		else
+			ss << "stop";
+		std::cout << "[SERVER / SvVis]: Command to send: " << ss.str() << std::endl;
+		this->vehicles.at(command.get_vehicle_id())->send_str(ss.str());
+		// sleep for half the time between the last packets, 500ms maximum
+		std::this_thread::sleep_for(std::min<std::chrono::milliseconds>(std::chrono::duration_cast<std::chrono::milliseconds>(time_last_packet / 2), std::chrono::milliseconds(500)));
+		// send length
+		ss.str("");
+		ss.clear();
+		if (command.get_length() < 0)
+			ss << "bw " << int(command.get_length() * -100);
+		else if (command.get_length() > 0)
+			ss << "fw " << int(command.get_length() * 100);
+		else
+			ss << "stop";
+		std::cout << "[SERVER / SvVis]: Command to send: " << ss.str() << std::endl;
+		this->vehicles.at(command.get_vehicle_id())->send_str(ss.str());
+
+		time_last_packet = std::chrono::system_clock::now() - last_packet;
+		std::cout << "[SERVER]: time since last packet: " << std::chrono::duration_cast<std::chrono::milliseconds>(time_last_packet).count() << "ms" << std::endl;
+		last_packet = std::chrono::system_clock::now();
+	}
+
 public:
 	void run(const cppsock::socketaddr& addr, const cppsock::socketaddr& conv_server, size_t num_vehicles)
 	{
 		std::vector<uint8_t> recv_buf;
 		Schwarm::VehicleCommandPacket command;
-		std::stringstream ss;
+		Schwarm::BatchPacket batch;
 		std::streamsize len;
 		std::chrono::system_clock::time_point last_packet;
 		std::chrono::system_clock::duration time_last_packet;
@@ -26,7 +62,7 @@ public:
 		this->conv_server = conv_server;
 		std::cout << "[SERVER]: connecting to conversion server at " << conv_server << std::endl;
 		this->vehicles.resize(num_vehicles);
-		recv_buf.resize(command.min_size());
+		recv_buf.resize(Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH);
 		for (std::shared_ptr<SvVis::client> &vehicle : vehicles)
 		{
 			vehicle = std::make_shared<SvVis::client>();
@@ -45,42 +81,52 @@ public:
 		errno = 0;
 		last_packet = std::chrono::system_clock::now();
 		time_last_packet = std::chrono::milliseconds(10);
-		while ( (len=this->visualisation.recv(recv_buf.data(), command.min_size(), cppsock::waitall)) > 0)
+		while ( (len=this->visualisation.recv(recv_buf.data(), Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH, cppsock::waitall)) > 0)
 		{
-			std::cout << "data received (" << len << " bytes)" << std::endl;
-			command.allocate(command.min_size());
-			command.set(recv_buf.data());
-			command.decode();
+			// read the rest of the packet, the visualisation sends single commands or all commands of one tick as batch
+			const uint8_t id = Schwarm::Packet::get_id(recv_buf.data());
+			const uint32_t size = *Schwarm::Packet::size_ptr(recv_buf.data());
+			if (size < Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH || size > (1 << 20))
+				break;
+			recv_buf.resize(size);
+			if (size > len && (len = this->visualisation.recv(recv_buf.data() + len, size - len, cppsock::waitall)) <= 0)
+				break;
+			std::cout << "data received (" << size << " bytes)" << std::endl;
 
-			std::cout << "[SERVER]: Command recived: " << command.get_length() << "m , " << command.get_angle() << "rad" << std::endl;
-			// send angle
-			ss.str("");
-			ss.clear();
-			if (command.get_angle() < 0)
-				ss << "rr " << int(command.get_angle() * (-180 / M_PI));
-			else if (command.get_angle() > 0)
-				ss << "rl " << int(command.get_angle() * (+180 / M_PI));
-			else
-				ss << "stop";
-			std::cout << "[SERVER / SvVis]: Command to send: " << ss.str() << std::endl;
-			this->vehicles.at(command.get_vehicle_id())->send_str(ss.str());
-			// sleep for half the time between the last packets, 500ms maximum
-			std::this_thread::sleep_for(std::min<std::chrono::milliseconds>(std::chrono::duration_cast<std::chrono::milliseconds>(time_last_packet / 2), std::chrono::milliseconds(500)));
-			// send length
-			ss.str("");
-			ss.clear();
-			if (command.get_length() < 0)
-				ss << "bw " << int(command.get_length() * -100);
-			else if (command.get_length() > 0)
-				ss << "fw " << int(command.get_length() * 100);
-			else
-				ss << "stop";
-			std::cout << "[SERVER / SvVis]: Command to send: " << ss.str() << std::endl;
-			this->vehicles.at(command.get_vehicle_id())->send_str(ss.str());
-
-			time_last_packet = std::chrono::system_clock::now() - last_packet;
-			std::cout << "[SERVER]: time since last packet: " << std::chrono::duration_cast<std::chrono::milliseconds>(time_last_packet).count() << "ms" << std::endl;
-			last_packet = std::chrono::system_clock::now();
+			if (id == Schwarm::VehicleCommandPacket::PACKET_ID)
+			{
+				// allocate the received size, the packet may carry the extended header
+				command.allocate(size);
+				command.set(recv_buf.data());
+				if (command.decode() != Schwarm::packet_error::PACKET_NONE)
+					continue;
+				this->stats.record(command);
+				this->execute(command, last_packet, time_last_packet);
+			}
+			else if (id == Schwarm::BatchPacket::PACKET_ID)
+			{
+				batch.allocate(size);
+				batch.set(recv_buf.data());
+				if (batch.decode() != Schwarm::packet_error::PACKET_NONE)
+				{
+					std::cerr << "[SERVER]: received invalid batch" << std::endl;
+					continue;
+				}
+				// record the arrival of all commands first, executing a command sleeps
+				for (const uint8_t* sub = batch.first(); sub != nullptr; sub = batch.next(sub))
+					this->stats.record(sub, *Schwarm::Packet::size_ptr(sub));
+				// the sub-packets are decoded directly from the batch buffer
+				for (const uint8_t* sub = batch.first(); sub != nullptr; sub = batch.next(sub))
+				{
+					if (Schwarm::Packet::get_id(sub) != Schwarm::VehicleCommandPacket::PACKET_ID)
+						continue;
+					command.allocate(*Schwarm::Packet::size_ptr(sub));
+					command.set((uint8_t*)sub);
+					if (command.decode() != Schwarm::packet_error::PACKET_NONE)
+						continue;
+					this->execute(command, last_packet, time_last_packet);
+				}
+			}
 		}
 		visualisation.close();
 		for (std::shared_ptr<SvVis::client> &vehicle : vehicles)
@@ -88,5 +134,6 @@ public:
 			vehicle->close();
 		}
 		std::cout << "recv call indicated disconnect (return code " << len << ") (errno: " << errno << ") " << strerror(errno) << std::endl;
+		this->stats.print(stdout, "visualisation -> control server");
 	}
 };
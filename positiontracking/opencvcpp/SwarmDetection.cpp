@@ -117,6 +117,8 @@ void SwarmDetection::makePacket(float x, float y, int id)
     //Uses the SchwarmPacket to make a packet for easier encoding and decoding
     packet.set_goal(x, y);
     packet.set_vehicle_id(id);
+    //Sequence number and timestamp (extended header)
+    stats.stamp(packet);
     packet.allocate(packet.min_size());
     packet.encode();
 }
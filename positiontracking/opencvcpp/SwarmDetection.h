@@ -6,6 +6,7 @@
 #include <chrono>
 #include <atomic>
 #include "../../visualization/external/SchwarmPacket/packet.h"
+#include "../../visualization/external/SchwarmPacket/linkstats.h"
 #include <exception>
 #include "../../library/cppsock/cppsock.hpp"
 #include <fstream>
@@ -64,6 +65,7 @@ private:
     cv::VideoCapture cap;
     std::vector <Car> cars;
     Schwarm::GoalPacket packet;
+    Schwarm::LinkStats stats;       // Numbers the packets, the visualization can tell how old a position is
     cppsock::tcp::listener listener;
     cppsock::tcp::socket connection;
     std::atomic_bool pkgReady = false;
@@ -0,0 +1,150 @@
+/******************************************************************************************************************************************
+* Title:        Batch packet benchmark
+* Programtitle: batch_benchmark
+* Description:
+*   Compares the per-tick traffic of the visualization with and without the BatchPacket.
+*   Every tick each vehicle produces one VehicleCommandPacket and one GoalReqPacket.
+*   Without batching every packet is one write (one syscall), with batching
+*   all packets of a tick are sent with one single write.
+*   The packets are written into a local stream socket (socketpair) which is drained by a receiver thread.
+*
+*   Command syntax:
+*       batch_benchmark [<number of ticks>]
+*
+*   Note: POSIX only (socketpair).
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../external/SchwarmPacket/packet.h"
+
+/*
+*   Counts the writes and bytes that are sent during a run.
+*/
+struct SendStats
+{
+    uint64_t writes{0};
+    uint64_t bytes{0};
+};
+
+static void send_all(int fd, const uint8_t* data, uint32_t size, SendStats& stats)
+{
+    uint32_t sent = 0;
+    while(sent < size)
+    {
+        ssize_t ret = send(fd, data + sent, size - sent, 0);
+        if(ret <= 0)
+        {
+            perror("send");
+            exit(-1);
+        }
+        sent += ret;
+        stats.writes++;
+    }
+    stats.bytes += size;
+}
+
+static void receiver(int fd, std::atomic_bool* running)
+{
+    uint8_t buff[65536];
+    while(*running)
+    {
+        if(recv(fd, buff, sizeof(buff), 0) <= 0)
+            break;
+    }
+}
+
+static void tick_individual(int fd, uint32_t num_vehicles, Schwarm::VehicleCommandPacket& command, Schwarm::GoalReqPacket& request, SendStats& stats)
+{
+    uint32_t i;
+    for(i = 0; i < num_vehicles; i++)
+    {
+        command.set_vehicle_id(i);
+        command.set_angle(0.5f);
+        command.set_length(0.1f);
+        command.allocate(command.min_size());
+        command.encode();
+        send_all(fd, command.rawdata(), command.size(), stats);
+
+        request.set_vehicle_id(i);
+        request.set_goal_index(i);
+        request.allocate(request.min_size());
+        request.encode();
+        send_all(fd, request.rawdata(), request.size(), stats);
+    }
+}
+
+static void tick_batch(int fd, uint32_t num_vehicles, Schwarm::VehicleCommandPacket& command, Schwarm::GoalReqPacket& request, Schwarm::BatchPacket& batch, SendStats& stats)
+{
+    batch.clear();
+    uint32_t i;
+    for(i = 0; i < num_vehicles; i++)
+    {
+        command.set_vehicle_id(i);
+        command.set_angle(0.5f);
+        command.set_length(0.1f);
+        command.allocate(command.min_size());
+        command.encode();
+        batch.add(command);
+
+        request.set_vehicle_id(i);
+        request.set_goal_index(i);
+        request.allocate(request.min_size());
+        request.encode();
+        batch.add(request);
+    }
+    batch.allocate(batch.min_size() + batch.batch_size());
+    batch.encode();
+    send_all(fd, batch.rawdata(), batch.size(), stats);
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned int num_ticks = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1000;
+    const uint32_t vehicle_counts[] = {1, 10, 100, 1000};
+
+    int fds[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    {
+        perror("socketpair");
+        return -1;
+    }
+    std::atomic_bool running{true};
+    std::thread recv_thread(receiver, fds[1], &running);
+
+    Schwarm::VehicleCommandPacket command;
+    Schwarm::GoalReqPacket request;
+    Schwarm::BatchPacket batch;
+
+    printf("vehicles,mode,writes/tick,bytes/tick,us/tick\n");
+    for(uint32_t num_vehicles : vehicle_counts)
+    {
+        SendStats individual, batched;
+
+        std::chrono::time_point t0 = std::chrono::steady_clock::now();
+        for(unsigned int t = 0; t < num_ticks; t++)
+            tick_individual(fds[0], num_vehicles, command, request, individual);
+        const double t_individual = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+        t0 = std::chrono::steady_clock::now();
+        for(unsigned int t = 0; t < num_ticks; t++)
+            tick_batch(fds[0], num_vehicles, command, request, batch, batched);
+        const double t_batched = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+        printf("%u,individual,%.1f,%.1f,%.2f\n", num_vehicles, (double)individual.writes / num_ticks, (double)individual.bytes / num_ticks, t_individual / num_ticks);
+        printf("%u,batch,%.1f,%.1f,%.2f\n", num_vehicles, (double)batched.writes / num_ticks, (double)batched.bytes / num_ticks, t_batched / num_ticks);
+    }
+
+    running = false;
+    shutdown(fds[0], SHUT_RDWR);
+    recv_thread.join();
+    close(fds[0]);
+    close(fds[1]);
+    return 0;
+}
@@ -0,0 +1,183 @@
+/******************************************************************************************************************************************
+* Title:        Packet codec benchmark
+* Programtitle: codec_benchmark
+* Description:
+*   Measures the cost of the SchwarmPacket codec for every packet id:
+*       encode  -> allocate() + encode() of a packet that is reused (like the senders do every tick)
+*       decode  -> set() + decode() of a received buffer into a reused packet (like the receivers do)
+*       copy    -> copy constructor (like the packets that are stored in the shared variables)
+*   For every operation the time per operation (ns/op) and the number of heap allocations
+*   per operation are printed. The allocations are counted by replacing the global operator new.
+*
+*   Command syntax:
+*       codec_benchmark [<number of iterations>]
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include "../external/SchwarmPacket/packet.h"
+#include "../external/SchwarmPacket/linkstats.h"
+
+static std::atomic<uint64_t> num_allocations{0};
+
+void* operator new(size_t size)
+{
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if(p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept                  {free(p);}
+void operator delete[](void* p) noexcept                {free(p);}
+void operator delete(void* p, size_t) noexcept          {free(p);}
+void operator delete[](void* p, size_t) noexcept        {free(p);}
+
+/*
+*   Time and allocations of one measured operation.
+*/
+struct Result
+{
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+/*
+*   Runs 'op' 'iterations' times and returns the average time and number of allocations.
+*   The compiler can not remove the calls because the packets are virtual and live in another translation unit.
+*/
+template<typename Op>
+static Result measure(unsigned int iterations, Op op)
+{
+    op();   // warm up, the first call may allocate the reused buffers
+    const uint64_t allocs = num_allocations.load(std::memory_order_relaxed);
+    const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    for(unsigned int i = 0; i < iterations; i++)
+        op();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    return {ns / iterations, (double)(num_allocations.load(std::memory_order_relaxed) - allocs) / iterations};
+}
+
+/*
+*   Benchmarks encode, decode and copy of an already filled packet.
+*   Parameters:
+*       const char* name        -> Name that is printed.
+*       T& packet               -> Packet with all fields set.
+*       uint32_t size           -> Encoded size of the packet.
+*       unsigned int iterations -> Number of iterations per operation.
+*/
+template<typename T>
+static void bench(const char* name, T& packet, uint32_t size, unsigned int iterations)
+{
+    const Result enc = measure(iterations, [&](){
+        packet.allocate(size);
+        packet.encode();
+    });
+
+    T received;
+    received.allocate(size);
+    const Result dec = measure(iterations, [&](){
+        received.set((uint8_t*)packet.rawdata(), size);
+        received.decode();
+    });
+
+    const Result cpy = measure(iterations, [&](){
+        T copy(packet);
+        (void)copy;
+    });
+
+    printf("%u,%s,%u,%.1f,%.2f,%.1f,%.2f,%.1f,%.2f\n", (unsigned int)packet.id(), name, size,
+            enc.ns_per_op, enc.allocs_per_op, dec.ns_per_op, dec.allocs_per_op, cpy.ns_per_op, cpy.allocs_per_op);
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned int iterations = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1000000;
+
+    printf("id,packet,bytes,encode ns/op,encode allocs/op,decode ns/op,decode allocs/op,copy ns/op,copy allocs/op\n");
+
+    Schwarm::ExitPacket exit_packet;
+    bench("ExitPacket", exit_packet, exit_packet.min_size(), iterations);
+
+    Schwarm::AcnPacket acn;
+    bench("AcnPacket", acn, acn.min_size(), iterations);
+
+    Schwarm::ErrorPacket error;
+    error.set_code(Schwarm::PACKET_INVALID_GOAL);
+    bench("ErrorPacket", error, error.min_size(), iterations);
+
+    Schwarm::PathGeneratePacket generate;
+    generate.set_vehicle_id(1);
+    generate.set_num_goals(500);
+    generate.should_invert() = true;
+    generate.set_filepath("C:/Users/schwarm/Pictures/path_vehicle_1.png");
+    bench("PathGeneratePacket", generate, generate.min_size() + generate.filepath_size(), iterations);
+
+    Schwarm::GoalReqPacket request;
+    request.set_vehicle_id(1);
+    request.set_goal_index(42);
+    bench("GoalReqPacket", request, request.min_size(), iterations);
+
+    Schwarm::GoalPacket goal;
+    goal.set_vehicle_id(1);
+    goal.set_goal(0.25f, 0.75f);
+    bench("GoalPacket", goal, goal.min_size(), iterations);
+
+    Schwarm::VehicleCommandPacket command;
+    command.set_vehicle_id(1);
+    command.set_angle(0.5f);
+    command.set_length(0.1f);
+    bench("VehicleCommandPacket", command, command.min_size(), iterations);
+
+    // the same packets with sequence number and timestamp (extended header)
+    Schwarm::LinkStats stats;
+    Schwarm::GoalPacket goal_ext(goal);
+    stats.stamp(goal_ext);
+    bench("GoalPacket+ext", goal_ext, goal_ext.min_size(), iterations);
+
+    Schwarm::VehicleCommandPacket command_ext(command);
+    stats.stamp(command_ext);
+    bench("VehicleCommandPacket+ext", command_ext, command_ext.min_size(), iterations);
+
+    // one tick of 16 vehicles: one command and one goal request each
+    Schwarm::BatchPacket batch;
+    command.allocate(command.min_size());
+    command.encode();
+    request.allocate(request.min_size());
+    request.encode();
+    for(unsigned int i = 0; i < 16; i++)
+    {
+        batch.add(command);
+        batch.add(request);
+    }
+    bench("BatchPacket", batch, batch.min_size() + batch.batch_size(), iterations);
+
+    Schwarm::GoalRangeReqPacket range_request;
+    range_request.set_vehicle_id(1);
+    range_request.set_start_index(0);
+    range_request.set_count(64);
+    bench("GoalRangeReqPacket", range_request, range_request.min_size(), iterations);
+
+    // one window of the GUI (64 goals)
+    float goals[2 * 64];
+    for(unsigned int i = 0; i < 2 * 64; i++)
+        goals[i] = (float)i / (2 * 64);
+    Schwarm::GoalListPacket goal_list;
+    goal_list.set_vehicle_id(1);
+    goal_list.set_start_index(0);
+    goal_list.set_total_goals(500);
+    goal_list.is_end_of_path() = false;
+    goal_list.set_goals(goals, 64);
+    bench("GoalListPacket", goal_list, goal_list.min_size() + goal_list.goals_size(), iterations);
+
+    return 0;
+}
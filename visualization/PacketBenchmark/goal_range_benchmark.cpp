@@ -0,0 +1,218 @@
+/******************************************************************************************************************************************
+* Title:        Goal range benchmark
+* Programtitle: goal_range_benchmark
+* Description:
+*   Measures the round-trips and the time of a full path traversal with single goal requests (GoalReqPacket)
+*   compared to goal range requests (GoalRangeReqPacket / GoalListPacket).
+*   A server thread answers the requests over a local stream socket (socketpair) from a goal vector,
+*   the same way the path server serves them from its goal storage.
+*
+*   Command syntax:
+*       goal_range_benchmark [<number of goals>]
+*
+*   Note: POSIX only (socketpair).
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../external/SchwarmPacket/packet.h"
+
+struct Goal
+{
+    float x, y;
+};
+
+/*
+*   Receives one whole packet (header first, then the rest).
+*   Return:
+*       'false' if the socket has been closed.
+*/
+static bool recv_packet(int fd, std::vector<uint8_t>& buff)
+{
+    constexpr uint32_t HEADER_SIZE = Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH;
+    buff.resize(HEADER_SIZE);
+    if(recv(fd, buff.data(), HEADER_SIZE, MSG_WAITALL) != HEADER_SIZE)
+        return false;
+    const uint32_t size = *Schwarm::Packet::size_ptr(buff.data());
+    buff.resize(size);
+    if(size > HEADER_SIZE && recv(fd, buff.data() + HEADER_SIZE, size - HEADER_SIZE, MSG_WAITALL) != (ssize_t)(size - HEADER_SIZE))
+        return false;
+    return true;
+}
+
+static void send_packet(int fd, const Schwarm::Packet& packet)
+{
+    send(fd, packet.rawdata(), packet.size(), 0);
+}
+
+static void server(int fd, const std::vector<Goal>* goals)
+{
+    std::vector<uint8_t> buff;
+    Schwarm::GoalReqPacket goalreq;
+    Schwarm::GoalRangeReqPacket rangereq;
+    Schwarm::GoalPacket goal;
+    Schwarm::GoalListPacket list;
+    Schwarm::ErrorPacket error;
+
+    while(recv_packet(fd, buff))
+    {
+        const uint8_t id = *Schwarm::Packet::id_ptr(buff.data());
+        if(id == Schwarm::GoalReqPacket::PACKET_ID)
+        {
+            goalreq.allocate(buff.size());
+            goalreq.set(buff.data());
+            goalreq.decode();
+            if(goalreq.get_goal_index() >= goals->size())
+            {
+                error.set_code(Schwarm::packet_error::PACKET_INVALID_GOAL);
+                error.allocate(error.min_size());
+                error.encode();
+                send_packet(fd, error);
+                continue;
+            }
+            const Goal& g = goals->at(goalreq.get_goal_index());
+            goal.set_goal(g.x, g.y);
+            goal.set_vehicle_id(goalreq.get_vehicle_id());
+            goal.allocate(goal.min_size());
+            goal.encode();
+            send_packet(fd, goal);
+        }
+        else if(id == Schwarm::GoalRangeReqPacket::PACKET_ID)
+        {
+            rangereq.allocate(buff.size());
+            rangereq.set(buff.data());
+            rangereq.decode();
+            const uint32_t start = rangereq.get_start_index();
+            if(start >= goals->size())
+            {
+                error.set_code(Schwarm::packet_error::PACKET_INVALID_GOAL);
+                error.allocate(error.min_size());
+                error.encode();
+                send_packet(fd, error);
+                continue;
+            }
+            const uint32_t count = std::min<uint32_t>({rangereq.get_count(), Schwarm::GoalListPacket::MAX_GOALS, (uint32_t)goals->size() - start});
+            list.set_vehicle_id(rangereq.get_vehicle_id());
+            list.set_start_index(start);
+            list.set_total_goals(goals->size());
+            list.is_end_of_path() = (start + count == goals->size());
+            list.set_goals((const float*)(goals->data() + start), count);
+            list.allocate(list.min_size() + list.goals_size());
+            list.encode();
+            send_packet(fd, list);
+        }
+    }
+}
+
+/*
+*   Traverses the whole path with single goal requests until the server answers with an invalid goal.
+*/
+static unsigned int traverse_single(int fd, float& checksum)
+{
+    std::vector<uint8_t> buff;
+    Schwarm::GoalReqPacket request;
+    Schwarm::GoalPacket goal;
+    unsigned int round_trips = 0;
+    for(uint32_t idx = 0; ; idx++)
+    {
+        request.set_goal_index(idx);
+        request.set_vehicle_id(0);
+        request.allocate(request.min_size());
+        request.encode();
+        send_packet(fd, request);
+        recv_packet(fd, buff);
+        round_trips++;
+        if(*Schwarm::Packet::id_ptr(buff.data()) != Schwarm::GoalPacket::PACKET_ID)
+            break;
+        goal.allocate(buff.size());
+        goal.set(buff.data());
+        goal.decode();
+        checksum += goal.get_goal_x() + goal.get_goal_y();
+    }
+    return round_trips;
+}
+
+/*
+*   Traverses the whole path with goal range requests until the end of the path is reached.
+*/
+static unsigned int traverse_range(int fd, uint32_t window, float& checksum)
+{
+    std::vector<uint8_t> buff;
+    Schwarm::GoalRangeReqPacket request;
+    Schwarm::GoalListPacket list;
+    unsigned int round_trips = 0;
+    uint32_t idx = 0;
+    bool end_of_path = false;
+    while(!end_of_path)
+    {
+        request.set_vehicle_id(0);
+        request.set_start_index(idx);
+        request.set_count(window);
+        request.allocate(request.min_size());
+        request.encode();
+        send_packet(fd, request);
+        recv_packet(fd, buff);
+        round_trips++;
+        if(*Schwarm::Packet::id_ptr(buff.data()) != Schwarm::GoalListPacket::PACKET_ID)
+            break;
+        list.allocate(buff.size());
+        list.set(buff.data());
+        list.decode();
+        for(uint32_t i = 0; i < list.get_num_goals(); i++)
+            checksum += list.get_goal_x(i) + list.get_goal_y(i);
+        idx += list.get_num_goals();
+        end_of_path = list.is_end_of_path();
+    }
+    return round_trips;
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t num_goals = (argc > 1) ? (uint32_t)atoi(argv[1]) : 500;
+    std::vector<Goal> goals(num_goals);
+    for(uint32_t i = 0; i < num_goals; i++)
+        goals[i] = {(float)i / num_goals, 1.0f - (float)i / num_goals};
+
+    int fds[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    {
+        perror("socketpair");
+        return -1;
+    }
+    std::thread server_thread(server, fds[1], &goals);
+
+    printf("goals,mode,window,round-trips,ms\n");
+    float checksum_single = 0.0f;
+    std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    unsigned int rt = traverse_single(fds[0], checksum_single);
+    double t = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    printf("%u,single,1,%u,%.3f\n", num_goals, rt, t);
+
+    const uint32_t windows[] = {16, 64, 256, 1024};
+    for(uint32_t window : windows)
+    {
+        float checksum_range = 0.0f;
+        t0 = std::chrono::steady_clock::now();
+        rt = traverse_range(fds[0], window, checksum_range);
+        t = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        printf("%u,range,%u,%u,%.3f\n", num_goals, window, rt, t);
+        if(checksum_range != checksum_single)
+        {
+            printf("[ERROR] Goals of range requests differ from single requests.\n");
+            return -1;
+        }
+    }
+
+    shutdown(fds[0], SHUT_RDWR);
+    server_thread.join();
+    close(fds[0]);
+    close(fds[1]);
+    return 0;
+}
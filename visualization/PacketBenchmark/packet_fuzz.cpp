@@ -0,0 +1,254 @@
+/******************************************************************************************************************************************
+* Title:        Packet fuzzer
+* Programtitle: packet_fuzz
+* Description:
+*   Feeds random and truncated buffers into the decode() implementations of all packets.
+*   A buffer is handled the same way as the receivers do it: the first byte is the packet id (and header flags),
+*   the length field is the number of received bytes, the packet is allocated with that length,
+*   set() and decode() are called. Successfully decoded packets are read out and encoded again.
+*   Out-of-bounds reads and writes are reported by the address sanitizer (build with SCHWARM_ASAN=ON).
+*
+*   The file can be used as libFuzzer target (SCHWARM_LIBFUZZER=ON, clang only), in that case libFuzzer
+*   provides the main function. Otherwise a plain loop generates the inputs.
+*
+*   Command syntax (plain loop):
+*       packet_fuzz [<number of iterations>] [<seed>]
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <random>
+#include "../external/SchwarmPacket/packet.h"
+
+static constexpr uint32_t HEADER_SIZE = Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH;
+static constexpr uint8_t NUM_PACKET_IDS = 12;
+
+/*
+*   Reads every field of the decoded packets, the sanitizer reports if a getter reads outside of the packet.
+*/
+static volatile float sink;
+
+static void read_fields(Schwarm::PathGeneratePacket& p)
+{
+    const char* filepath = p.get_filepath();
+    sink = (filepath != nullptr) ? (float)strlen(filepath) : 0.0f;
+    sink = (float)p.filepath_size();
+}
+
+static void read_fields(Schwarm::BatchPacket& p)
+{
+    uint32_t n = 0;
+    for(const uint8_t* sub = p.first(); sub != nullptr; sub = p.next(sub))
+    {
+        sink = (float)*Schwarm::Packet::id_ptr(sub) + (float)*Schwarm::Packet::size_ptr(sub);
+        n++;
+    }
+    if(n != p.get_num_packets())
+    {
+        fprintf(stderr, "BatchPacket: decoded %u sub-packets, header says %u\n", n, p.get_num_packets());
+        abort();
+    }
+
+    // extending a decoded batch copies its sub-packets out of the received data, they have to be kept
+    Schwarm::BatchPacket extended(p);
+    Schwarm::ExitPacket exit;
+    exit.allocate(exit.min_size());
+    exit.encode();
+    extended.add(exit);
+    extended.allocate(extended.min_size() + extended.batch_size());
+    Schwarm::BatchPacket received;
+    received.allocate(extended.size());
+    if(extended.encode() != Schwarm::PACKET_NONE || received.set((uint8_t*)extended.rawdata(), extended.size()) != Schwarm::PACKET_NONE ||
+       received.decode() != Schwarm::PACKET_NONE || received.get_num_packets() != n + 1 ||
+       memcmp(received.rawdata() + received.min_size(), p.rawdata() + p.min_size(), p.batch_size()) != 0)
+    {
+        fprintf(stderr, "BatchPacket: extended batch does not contain the decoded sub-packets\n");
+        abort();
+    }
+}
+
+static void read_fields(Schwarm::GoalListPacket& p)
+{
+    for(uint32_t i = 0; i < p.get_num_goals(); i++)
+        sink = p.get_goal_x(i) + p.get_goal_y(i);
+}
+
+template<typename T>
+static void read_fields(T&) {}
+
+/*
+*   Decodes one buffer with the packet type T.
+*   Parameters:
+*       uint8_t* buff   -> Received data, id and length are already set.
+*       uint32_t size   -> Size of the received data.
+*/
+template<typename T>
+static void fuzz_packet(uint8_t* buff, uint32_t size)
+{
+    T packet;
+    packet.allocate(size);
+    if(packet.set(buff, size) != Schwarm::PACKET_NONE)
+        return;
+    if(packet.decode() != Schwarm::PACKET_NONE)
+        return;
+
+    read_fields(packet);
+
+    // a decoded packet has to survive a copy and an encode
+    T copy(packet);
+    copy.encode();
+}
+
+static void fuzz_one(const uint8_t* data, size_t size)
+{
+    // Packets that are shorter than the header are never decoded by the receivers.
+    if(size < HEADER_SIZE || size > Schwarm::GoalListPacket::MAX_SIZE)
+        return;
+
+    // Exact size heap copy, so the sanitizer can see reads behind the end of the received data.
+    uint8_t* buff = new uint8_t[size];
+    memcpy(buff, data, size);
+    buff[0] = (buff[0] & Schwarm::Packet::FLAG_EXT_HEADER) | ((buff[0] & ~Schwarm::Packet::FLAG_EXT_HEADER) % NUM_PACKET_IDS);
+    *((uint32_t*)(buff + Schwarm::Packet::SIZE_ID)) = (uint32_t)size;
+
+    switch(Schwarm::Packet::get_id(buff))
+    {
+        case Schwarm::ExitPacket::PACKET_ID:            fuzz_packet<Schwarm::ExitPacket>(buff, size); break;
+        case Schwarm::AcnPacket::PACKET_ID:             fuzz_packet<Schwarm::AcnPacket>(buff, size); break;
+        case Schwarm::ErrorPacket::PACKET_ID:           fuzz_packet<Schwarm::ErrorPacket>(buff, size); break;
+        case Schwarm::PathGeneratePacket::PACKET_ID:    fuzz_packet<Schwarm::PathGeneratePacket>(buff, size); break;
+        case Schwarm::GoalReqPacket::PACKET_ID:         fuzz_packet<Schwarm::GoalReqPacket>(buff, size); break;
+        case Schwarm::GoalPacket::PACKET_ID:            fuzz_packet<Schwarm::GoalPacket>(buff, size); break;
+        case Schwarm::VehicleCommandPacket::PACKET_ID:  fuzz_packet<Schwarm::VehicleCommandPacket>(buff, size); break;
+        case Schwarm::BatchPacket::PACKET_ID:           fuzz_packet<Schwarm::BatchPacket>(buff, size); break;
+        case Schwarm::GoalRangeReqPacket::PACKET_ID:    fuzz_packet<Schwarm::GoalRangeReqPacket>(buff, size); break;
+        case Schwarm::GoalListPacket::PACKET_ID:        fuzz_packet<Schwarm::GoalListPacket>(buff, size); break;
+        case Schwarm::GoalSubscribePacket::PACKET_ID:   fuzz_packet<Schwarm::GoalSubscribePacket>(buff, size); break;
+        case Schwarm::GoalAckPacket::PACKET_ID:         fuzz_packet<Schwarm::GoalAckPacket>(buff, size); break;
+    }
+    delete[](buff);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    fuzz_one(data, size);
+    return 0;
+}
+
+#ifndef SCHWARM_LIBFUZZER
+
+/*
+*   Encodes one valid packet of every id, these are the seeds for truncating and mutating.
+*/
+static std::vector<std::vector<uint8_t>> make_seeds(void)
+{
+    std::vector<std::vector<uint8_t>> seeds;
+    auto add = [&](Schwarm::Packet& p, uint32_t size){
+        p.allocate(size);
+        p.encode();
+        seeds.emplace_back(p.rawdata(), p.rawdata() + p.size());
+    };
+
+    Schwarm::ExitPacket exit_packet;
+    add(exit_packet, exit_packet.min_size());
+    Schwarm::AcnPacket acn;
+    add(acn, acn.min_size());
+    Schwarm::ErrorPacket error;
+    error.set_code(Schwarm::PACKET_SERVER_BUSY);
+    error.set_request_id(7);
+    add(error, error.min_size());
+    Schwarm::PathGeneratePacket generate;
+    generate.set_num_goals(100);
+    generate.set_filepath("path.png");
+    add(generate, generate.min_size() + generate.filepath_size());
+    Schwarm::GoalReqPacket request;
+    request.set_goal_index(3);
+    add(request, request.min_size());
+    Schwarm::GoalPacket goal;
+    goal.set_goal(1.0f, 2.0f);
+    add(goal, goal.min_size());
+    Schwarm::VehicleCommandPacket command;
+    command.set_angle(1.0f);
+    add(command, command.min_size());
+    Schwarm::BatchPacket batch;
+    batch.add(command);
+    batch.add(goal);
+    batch.add(generate);
+    add(batch, batch.min_size() + batch.batch_size());
+    Schwarm::GoalRangeReqPacket range_request;
+    range_request.set_count(8);
+    add(range_request, range_request.min_size());
+    const float goals[] = {0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f};
+    Schwarm::GoalListPacket goal_list;
+    goal_list.set_total_goals(3);
+    goal_list.set_goals(goals, 3);
+    add(goal_list, goal_list.min_size() + goal_list.goals_size());
+    Schwarm::GoalSubscribePacket subscribe;
+    subscribe.set_window(64);
+    add(subscribe, subscribe.min_size());
+    Schwarm::GoalAckPacket ack;
+    ack.set_next_index(32);
+    add(ack, ack.min_size());
+
+    // packets with extended header, also as sub-packets of a batch
+    goal.set_ext_header(true);
+    add(goal, goal.min_size());
+    goal_list.set_ext_header(true);
+    add(goal_list, goal_list.min_size() + goal_list.goals_size());
+    command.set_ext_header(true);
+    command.allocate(command.min_size());
+    command.encode();
+    Schwarm::BatchPacket batch_ext;
+    batch_ext.add(command);
+    batch_ext.add(command);
+    add(batch_ext, batch_ext.min_size() + batch_ext.batch_size());
+
+    return seeds;
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned long iterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    const unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], nullptr, 10) : std::random_device()();
+    std::mt19937 rng(seed);
+    printf("packet_fuzz: %lu iterations, seed %u\n", iterations, seed);
+
+    const std::vector<std::vector<uint8_t>> seeds = make_seeds();
+
+    // every prefix of every valid packet (truncated receive)
+    for(const std::vector<uint8_t>& s : seeds)
+    {
+        for(size_t len = 0; len <= s.size(); len++)
+            fuzz_one(s.data(), len);
+    }
+
+    std::vector<uint8_t> buff;
+    for(unsigned long i = 0; i < iterations; i++)
+    {
+        if(rng() % 2)
+        {
+            // completely random buffer
+            buff.resize(rng() % 512);
+            for(uint8_t& b : buff)
+                b = (uint8_t)rng();
+        }
+        else
+        {
+            // valid packet with some flipped bytes, truncated or extended
+            buff = seeds[rng() % seeds.size()];
+            const unsigned int num_flips = rng() % 4;
+            for(unsigned int f = 0; f < num_flips && !buff.empty(); f++)
+                buff[rng() % buff.size()] = (uint8_t)rng();
+            buff.resize(rng() % (buff.size() + 16));
+        }
+        fuzz_one(buff.data(), buff.size());
+    }
+
+    printf("packet_fuzz: no errors\n");
+    return 0;
+}
+
+#endif // SCHWARM_LIBFUZZER
@@ -0,0 +1,232 @@
+/******************************************************************************************************************************************
+* Title:        Pipeline benchmark
+* Programtitle: pipeline_benchmark
+* Description:
+*   Load test of pipelined goal requests on one connection over loopback (TCP, 127.0.0.1).
+*   The client keeps up to <depth> GoalReqPackets in flight and matches the replies by their request id.
+*   A server thread answers the requests strictly in order, the same way the path server does it.
+*   Every 16th request asks for an invalid goal, the ErrorPacket has to carry the request id as well.
+*   For every depth the throughput (requests per second) and the average time from request to reply are printed.
+*   Depth 1 is the old protocol: one request, wait for the reply, next request.
+*
+*   Command syntax:
+*       pipeline_benchmark [<number of requests per depth>]
+*
+*   Note: POSIX only.
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "../external/SchwarmPacket/packet.h"
+
+static constexpr uint32_t NUM_GOALS = 500;
+static constexpr uint32_t INVALID_EVERY = 16;   // every n-th request asks for an invalid goal index
+
+/*
+*   Receives one whole packet (header first, then the rest).
+*   Return:
+*       'false' if the socket has been closed.
+*/
+static bool recv_packet(int fd, std::vector<uint8_t>& buff)
+{
+    constexpr uint32_t HEADER_SIZE = Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH;
+    buff.resize(HEADER_SIZE);
+    if(recv(fd, buff.data(), HEADER_SIZE, MSG_WAITALL) != HEADER_SIZE)
+        return false;
+    const uint32_t size = *Schwarm::Packet::size_ptr(buff.data());
+    if(size < HEADER_SIZE)
+        return false;
+    buff.resize(size);
+    if(size > HEADER_SIZE && recv(fd, buff.data() + HEADER_SIZE, size - HEADER_SIZE, MSG_WAITALL) != (ssize_t)(size - HEADER_SIZE))
+        return false;
+    return true;
+}
+
+static void send_packet(int fd, const Schwarm::Packet& packet)
+{
+    send(fd, packet.rawdata(), packet.size(), MSG_NOSIGNAL);
+}
+
+static void set_nodelay(int fd)
+{
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+/*
+*   Answers the goal requests of one connection in the order they are received.
+*/
+static void server(int listen_fd)
+{
+    const int fd = accept(listen_fd, nullptr, nullptr);
+    if(fd < 0)
+        return;
+    set_nodelay(fd);
+
+    std::vector<uint8_t> buff;
+    Schwarm::GoalReqPacket request;
+    Schwarm::GoalPacket goal;
+    Schwarm::ErrorPacket error;
+    while(recv_packet(fd, buff))
+    {
+        if(Schwarm::Packet::get_id(buff.data()) != Schwarm::GoalReqPacket::PACKET_ID)
+            continue;
+        request.allocate(buff.size());
+        request.set(buff.data());
+        if(request.decode() != Schwarm::packet_error::PACKET_NONE)
+            continue;
+
+        if(request.get_goal_index() >= NUM_GOALS)
+        {
+            error.set_code(Schwarm::packet_error::PACKET_INVALID_GOAL);
+            error.set_request_id(request.get_request_id());
+            error.allocate(error.min_size());
+            error.encode();
+            send_packet(fd, error);
+            continue;
+        }
+        const float t = (float)request.get_goal_index() / NUM_GOALS;
+        goal.set_goal(t, 1.0f - t);
+        goal.set_vehicle_id(request.get_vehicle_id());
+        goal.set_request_id(request.get_request_id());
+        goal.allocate(goal.min_size());
+        goal.encode();
+        send_packet(fd, goal);
+    }
+    close(fd);
+}
+
+/*
+*   Sends 'num_requests' goal requests with at most 'depth' requests in flight.
+*   Parameters:
+*       int fd                  -> Connected socket.
+*       uint32_t depth          -> Maximum number of outstanding requests.
+*       uint32_t num_requests   -> Number of requests.
+*       uint32_t& next_id       -> Next request id, continues over all depths.
+*       double& latency_us      -> Average time from sending a request to receiving its reply.
+*   Return:
+*       'false' if a reply is missing, out of order or has the wrong content.
+*/
+static bool run(int fd, uint32_t depth, uint32_t num_requests, uint32_t& next_id, double& latency_us)
+{
+    std::vector<uint8_t> buff;
+    Schwarm::GoalReqPacket request;
+    Schwarm::GoalPacket goal;
+    Schwarm::ErrorPacket error;
+
+    // send time of the outstanding requests, indexed by request id modulo depth
+    std::vector<std::chrono::steady_clock::time_point> sent(depth);
+    const uint32_t first_id = next_id;
+    uint32_t num_sent = 0, num_received = 0;
+    double latency_sum = 0.0;
+
+    while(num_received < num_requests)
+    {
+        // fill the pipeline
+        while(num_sent < num_requests && num_sent - num_received < depth)
+        {
+            const uint32_t n = num_sent++;
+            request.set_vehicle_id(0);
+            request.set_goal_index((n % INVALID_EVERY == INVALID_EVERY - 1) ? NUM_GOALS : n % NUM_GOALS);
+            request.set_request_id(next_id++);
+            request.allocate(request.min_size());
+            request.encode();
+            sent[request.get_request_id() % depth] = std::chrono::steady_clock::now();
+            send_packet(fd, request);
+        }
+
+        if(!recv_packet(fd, buff))
+            return false;
+
+        // The server answers in order, so the reply has to belong to the oldest outstanding request.
+        const uint32_t n = num_received++;
+        const uint32_t expected_id = first_id + n;
+        const bool invalid = (n % INVALID_EVERY == INVALID_EVERY - 1);
+        uint32_t reply_id;
+        if(Schwarm::Packet::get_id(buff.data()) == Schwarm::GoalPacket::PACKET_ID && !invalid)
+        {
+            goal.allocate(buff.size());
+            goal.set(buff.data());
+            if(goal.decode() != Schwarm::packet_error::PACKET_NONE || goal.get_goal_x() != (float)(n % NUM_GOALS) / NUM_GOALS)
+                return false;
+            reply_id = goal.get_request_id();
+        }
+        else if(Schwarm::Packet::get_id(buff.data()) == Schwarm::ErrorPacket::PACKET_ID && invalid)
+        {
+            error.allocate(buff.size());
+            error.set(buff.data());
+            if(error.decode() != Schwarm::packet_error::PACKET_NONE || error.get_code() != Schwarm::packet_error::PACKET_INVALID_GOAL)
+                return false;
+            reply_id = error.get_request_id();
+        }
+        else
+            return false;
+
+        if(reply_id != expected_id)
+        {
+            fprintf(stderr, "[ERROR] Expected reply to request %u, received %u.\n", expected_id, reply_id);
+            return false;
+        }
+        latency_sum += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent[reply_id % depth]).count();
+    }
+    latency_us = latency_sum / num_requests;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t num_requests = (argc > 1) ? (uint32_t)atoi(argv[1]) : 100000;
+
+    const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;  // any free port
+    socklen_t addrlen = sizeof(addr);
+    if(listen_fd < 0 || bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 1) != 0 ||
+       getsockname(listen_fd, (sockaddr*)&addr, &addrlen) != 0)
+    {
+        perror("listen");
+        return -1;
+    }
+    std::thread server_thread(server, listen_fd);
+
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        perror("connect");
+        return -1;
+    }
+    set_nodelay(fd);
+
+    printf("depth,requests,ms,requests/s,avg latency us\n");
+    uint32_t next_id = 1;   // 0 is reserved for packets that are not an answer
+    const uint32_t depths[] = {1, 2, 4, 8, 16, 32, 64};
+    for(uint32_t depth : depths)
+    {
+        double latency_us = 0.0;
+        const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+        if(!run(fd, depth, num_requests, next_id, latency_us))
+        {
+            printf("[ERROR] Invalid reply at depth %u.\n", depth);
+            return -1;
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        printf("%u,%u,%.1f,%.0f,%.1f\n", depth, num_requests, ms, num_requests / (ms / 1000.0), latency_us);
+    }
+
+    shutdown(fd, SHUT_RDWR);
+    server_thread.join();
+    close(fd);
+    close(listen_fd);
+    return 0;
+}
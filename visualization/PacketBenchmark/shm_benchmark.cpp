@@ -0,0 +1,311 @@
+/******************************************************************************************************************************************
+* Title:        Shared-memory transport benchmark
+* Programtitle: shm_benchmark
+* Description:
+*   Compares the shared-memory transport (Schwarm::ShmEndpoint) with loopback TCP (127.0.0.1, TCP_NODELAY).
+*   The server is a separate process (fork), like the path server and the visualization.
+*   For every transport it prints:
+*       latency     -> Round-trips of one GoalReqPacket and its GoalPacket: average, median and 99th percentile.
+*       throughput  -> The server sends goal lists (GoalListPacket with 500 goals, about 4 kB) as fast as possible
+*                      after one request: packets per second and MB per second.
+*
+*   Command syntax:
+*       shm_benchmark [<number of round-trips> [<number of goal lists>]]
+*
+*   Note: POSIX only (fork).
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "../external/SchwarmPacket/packet.h"
+#include "../external/SchwarmPacket/shm_transport.h"
+
+static constexpr uint32_t GOALS_PER_LIST = 500;
+
+/*
+*   The same packet frames over both transports.
+*/
+class Transport
+{
+public:
+    virtual ~Transport(void) {}
+    virtual bool send(const uint8_t*, uint32_t) = 0;
+    virtual bool recv(std::vector<uint8_t>&) = 0;
+};
+
+class TcpTransport : public Transport
+{
+private:
+    int fd;
+
+public:
+    TcpTransport(int fd)
+    {
+        this->fd = fd;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    virtual ~TcpTransport(void) {close(this->fd);}
+
+    bool send(const uint8_t* data, uint32_t size) override
+    {
+        return ::send(this->fd, data, size, MSG_NOSIGNAL) == (ssize_t)size;
+    }
+
+    bool recv(std::vector<uint8_t>& buff) override
+    {
+        constexpr uint32_t HEADER_SIZE = Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH;
+        buff.resize(HEADER_SIZE);
+        if(::recv(this->fd, buff.data(), HEADER_SIZE, MSG_WAITALL) != HEADER_SIZE)
+            return false;
+        const uint32_t size = *Schwarm::Packet::size_ptr(buff.data());
+        if(size < HEADER_SIZE)
+            return false;
+        buff.resize(size);
+        return size == HEADER_SIZE || ::recv(this->fd, buff.data() + HEADER_SIZE, size - HEADER_SIZE, MSG_WAITALL) == (ssize_t)(size - HEADER_SIZE);
+    }
+};
+
+class ShmTransport : public Transport
+{
+private:
+    Schwarm::ShmEndpoint* endpoint;
+
+public:
+    ShmTransport(Schwarm::ShmEndpoint* endpoint) {this->endpoint = endpoint;}
+    virtual ~ShmTransport(void) {delete(this->endpoint);}
+
+    bool send(const uint8_t* data, uint32_t size) override
+    {
+        return this->endpoint->send(data, size);
+    }
+
+    bool recv(std::vector<uint8_t>& buff) override
+    {
+        int ret;
+        while((ret = this->endpoint->recv(buff, 1000)) == 0);
+        return ret > 0;
+    }
+};
+
+/*
+*   Answers goal requests with a goal, a goal range request with <count> goal lists.
+*/
+static void serve(Transport& transport)
+{
+    std::vector<uint8_t> buff;
+    Schwarm::GoalReqPacket request;
+    Schwarm::GoalRangeReqPacket rangereq;
+    Schwarm::GoalPacket goal;
+    Schwarm::GoalListPacket list;
+
+    std::vector<float> goals(GOALS_PER_LIST * 2);
+    for(uint32_t i = 0; i < goals.size(); i++)
+        goals[i] = (float)i / goals.size();
+
+    while(transport.recv(buff))
+    {
+        const uint8_t id = Schwarm::Packet::get_id(buff.data());
+        if(id == Schwarm::GoalReqPacket::PACKET_ID)
+        {
+            request.allocate(buff.size());
+            request.set(buff.data());
+            request.decode();
+            goal.set_goal(0.5f, 0.25f);
+            goal.set_vehicle_id(request.get_vehicle_id());
+            goal.set_request_id(request.get_request_id());
+            goal.allocate(goal.min_size());
+            goal.encode();
+            transport.send(goal.rawdata(), goal.size());
+        }
+        else if(id == Schwarm::GoalRangeReqPacket::PACKET_ID)
+        {
+            rangereq.allocate(buff.size());
+            rangereq.set(buff.data());
+            rangereq.decode();
+            for(uint32_t i = 0; i < rangereq.get_count(); i++)
+            {
+                list.set_vehicle_id(rangereq.get_vehicle_id());
+                list.set_start_index(i * GOALS_PER_LIST);
+                list.set_total_goals(rangereq.get_count() * GOALS_PER_LIST);
+                list.is_end_of_path() = (i + 1 == rangereq.get_count());
+                list.set_request_id(rangereq.get_request_id());
+                list.set_goals(goals.data(), GOALS_PER_LIST);
+                list.allocate(list.min_size() + list.goals_size());
+                list.encode();
+                transport.send(list.rawdata(), list.size());
+            }
+        }
+        else if(id == Schwarm::ExitPacket::PACKET_ID)
+            break;
+    }
+}
+
+static bool run_client(const char* name, Transport& transport, uint32_t num_round_trips, uint32_t num_lists)
+{
+    std::vector<uint8_t> buff;
+    Schwarm::GoalReqPacket request;
+    std::vector<double> rtt_us(num_round_trips);
+
+    for(uint32_t i = 0; i < num_round_trips; i++)
+    {
+        request.set_vehicle_id(1);
+        request.set_goal_index(i);
+        request.set_request_id(i + 1);
+        request.allocate(request.min_size());
+        request.encode();
+        const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        if(!transport.send(request.rawdata(), request.size()) || !transport.recv(buff) || Schwarm::Packet::get_id(buff.data()) != Schwarm::GoalPacket::PACKET_ID)
+        {
+            printf("[ERROR] %s: round-trip %u failed.\n", name, i);
+            return false;
+        }
+        rtt_us[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    }
+    double sum = 0.0;
+    for(double us : rtt_us)
+        sum += us;
+    std::sort(rtt_us.begin(), rtt_us.end());
+    printf("%s,latency,%u round-trips,avg %.2f us,median %.2f us,p99 %.2f us\n", name, num_round_trips, sum / num_round_trips,
+           rtt_us[num_round_trips / 2], rtt_us[(size_t)(num_round_trips * 0.99)]);
+
+    Schwarm::GoalRangeReqPacket rangereq;
+    rangereq.set_vehicle_id(1);
+    rangereq.set_start_index(0);
+    rangereq.set_count(num_lists);
+    rangereq.set_request_id(1);
+    rangereq.allocate(rangereq.min_size());
+    rangereq.encode();
+    uint64_t bytes = 0;
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    transport.send(rangereq.rawdata(), rangereq.size());
+    for(uint32_t i = 0; i < num_lists; i++)
+    {
+        if(!transport.recv(buff) || Schwarm::Packet::get_id(buff.data()) != Schwarm::GoalListPacket::PACKET_ID)
+        {
+            printf("[ERROR] %s: goal list %u is missing.\n", name, i);
+            return false;
+        }
+        bytes += buff.size();
+    }
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%s,throughput,%u goal lists,%.0f packets/s,%.1f MB/s\n", name, num_lists, num_lists / s, bytes / s / 1e6);
+
+    Schwarm::ExitPacket exit;
+    exit.allocate(exit.min_size());
+    exit.encode();
+    transport.send(exit.rawdata(), exit.size());
+    return true;
+}
+
+static bool bench_tcp(uint32_t num_round_trips, uint32_t num_lists)
+{
+    const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;  // any free port
+    socklen_t addrlen = sizeof(addr);
+    if(listen_fd < 0 || bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 1) != 0 ||
+       getsockname(listen_fd, (sockaddr*)&addr, &addrlen) != 0)
+    {
+        perror("listen");
+        return false;
+    }
+
+    const pid_t pid = fork();
+    if(pid == 0)
+    {
+        TcpTransport transport(accept(listen_fd, nullptr, nullptr));
+        serve(transport);
+        _exit(0);
+    }
+    close(listen_fd);
+
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        perror("connect");
+        return false;
+    }
+    bool ok;
+    {
+        TcpTransport transport(fd);
+        ok = run_client("tcp", transport, num_round_trips, num_lists);
+    }
+    waitpid(pid, nullptr, 0);
+    return ok;
+}
+
+static bool bench_shm(uint32_t num_round_trips, uint32_t num_lists)
+{
+    // The name of the shared memory is the port, the process id makes it unique.
+    const uint16_t port = 20000 + getpid() % 20000;
+    int ready[2];
+    if(pipe(ready) != 0)
+        return false;
+
+    const pid_t pid = fork();
+    if(pid == 0)
+    {
+        Schwarm::ShmServer* server = Schwarm::ShmServer::create(port, 1);
+        const char ok = (server != nullptr);
+        write(ready[1], &ok, 1);
+        if(server != nullptr)
+        {
+            Schwarm::ShmEndpoint* endpoint = server->accept(0, 5000);
+            if(endpoint != nullptr)
+            {
+                ShmTransport transport(endpoint);
+                serve(transport);
+            }
+            delete(server);
+        }
+        _exit(0);
+    }
+
+    char ok = 0;
+    if(read(ready[0], &ok, 1) != 1 || !ok)
+    {
+        printf("[ERROR] The server could not create the shared memory.\n");
+        waitpid(pid, nullptr, 0);
+        return false;
+    }
+    close(ready[0]);
+    close(ready[1]);
+
+    Schwarm::ShmEndpoint* endpoint = Schwarm::shm_connect(port);
+    if(endpoint == nullptr)
+    {
+        printf("[ERROR] Could not connect to the shared memory.\n");
+        kill(pid, SIGTERM);
+        waitpid(pid, nullptr, 0);
+        return false;
+    }
+    {
+        ShmTransport transport(endpoint);
+        ok = run_client("shm", transport, num_round_trips, num_lists);
+    }
+    waitpid(pid, nullptr, 0);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t num_round_trips = (argc > 1) ? (uint32_t)atoi(argv[1]) : 20000;
+    const uint32_t num_lists = (argc > 2) ? (uint32_t)atoi(argv[2]) : 20000;
+
+    printf("transport,test,count,result,,\n");
+    const bool ok = bench_tcp(num_round_trips, num_lists) && bench_shm(num_round_trips, num_lists);
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,189 @@
+#include "linkstats.h"
+#include <cstring>
+
+using namespace Schwarm;
+
+LinkStats::LinkStats(void)
+{
+    this->next_seq = 0;
+    this->reset();
+}
+
+void LinkStats::stamp(Packet& packet) noexcept
+{
+    packet.set_ext_header(true);
+    packet.set_sequence(this->next_seq++);
+}
+
+void LinkStats::record(const Packet& packet) noexcept
+{
+    if(packet.has_ext_header())
+        this->add(packet.get_sequence(), packet.get_timestamp());
+}
+
+void LinkStats::record(const uint8_t* data, uint32_t size) noexcept
+{
+    if(data == nullptr || size < Packet::SIZE_ID + Packet::SIZE_PACKET_LENGTH + Packet::SIZE_EXT_HEADER)
+        return;
+    if((*Packet::id_ptr(data) & Packet::FLAG_EXT_HEADER) == 0)
+        return;
+
+    const uint32_t seq = *((uint32_t*)(data + Packet::SIZE_ID + Packet::SIZE_PACKET_LENGTH));
+    const uint64_t timestamp = *((uint64_t*)(data + Packet::SIZE_ID + Packet::SIZE_PACKET_LENGTH + Packet::SIZE_SEQUENCE));
+    this->add(seq, timestamp);
+}
+
+void LinkStats::add(uint32_t seq, uint64_t timestamp) noexcept
+{
+    // The difference is signed, so a wrap around of the sequence number is not a gap.
+    const int32_t diff = (int32_t)(seq - this->expected_seq);
+    if(this->first)
+    {
+        this->missing = 0;
+        this->expected_seq = seq + 1;
+    }
+    else if(diff >= 0)
+    {
+        // Moves the window behind 'seq', the skipped sequence numbers are marked as missing.
+        const uint64_t shift = (uint64_t)diff + 1;
+        const uint64_t skipped = (diff >= (int32_t)SEQ_WINDOW - 1) ? ~1ULL : (((1ULL << diff) - 1) << 1);
+        this->missing = ((shift >= SEQ_WINDOW) ? 0 : (this->missing << shift)) | skipped;
+        this->num_lost += diff;
+        this->expected_seq = seq + 1;
+    }
+    else
+    {
+        const uint32_t age = (uint32_t)(-(diff + 1));
+        if(age >= SEQ_WINDOW)
+        {
+            this->num_late++;
+        }
+        else if(this->missing & (1ULL << age))
+        {
+            this->missing &= ~(1ULL << age);
+            this->num_late++;
+            this->num_lost--;
+        }
+        else
+        {
+            this->num_duplicate++;
+        }
+    }
+
+    const int64_t delay = (int64_t)(Packet::monotonic_time() - timestamp);
+    if(this->first || delay < this->min_delay)
+        this->min_delay = delay;
+    this->first = false;
+
+    const uint64_t rel_delay = (uint64_t)(delay - this->min_delay);
+    this->delay_sum += rel_delay;
+    if(rel_delay > this->delay_max)
+        this->delay_max = rel_delay;
+
+    uint32_t b = 0;
+    for(uint64_t us = rel_delay / 1000; us > 0 && b < NUM_BUCKETS - 1; us >>= 1)
+        b++;
+    this->hist[b]++;
+    this->num_received++;
+}
+
+void LinkStats::reset(void) noexcept
+{
+    this->first = true;
+    this->expected_seq = 0;
+    this->num_received = 0;
+    this->num_lost = 0;
+    this->num_late = 0;
+    this->num_duplicate = 0;
+    this->missing = 0;
+    this->min_delay = 0;
+    this->delay_sum = 0;
+    this->delay_max = 0;
+    memset(this->hist, 0, sizeof(this->hist));
+}
+
+uint64_t LinkStats::received(void) const noexcept
+{
+    return this->num_received;
+}
+
+uint64_t LinkStats::lost(void) const noexcept
+{
+    return this->num_lost;
+}
+
+uint64_t LinkStats::late(void) const noexcept
+{
+    return this->num_late;
+}
+
+uint64_t LinkStats::duplicate(void) const noexcept
+{
+    return this->num_duplicate;
+}
+
+int64_t LinkStats::min_delay_ns(void) const noexcept
+{
+    return this->min_delay;
+}
+
+uint64_t LinkStats::max_delay_ns(void) const noexcept
+{
+    return this->delay_max;
+}
+
+double LinkStats::avg_delay_ns(void) const noexcept
+{
+    if(this->num_received == 0)
+        return 0.0;
+    return (double)this->delay_sum / this->num_received;
+}
+
+uint64_t LinkStats::bucket(uint32_t b) const noexcept
+{
+    if(b >= NUM_BUCKETS)
+        return 0;
+    return this->hist[b];
+}
+
+void LinkStats::format(const char* name, std::vector<std::string>& lines) const
+{
+    char line[128];
+    lines.clear();
+    snprintf(line, sizeof(line), "link %s: received %llu, lost %llu, late %llu, duplicate %llu", name,
+             (unsigned long long)this->num_received, (unsigned long long)this->num_lost, (unsigned long long)this->num_late,
+             (unsigned long long)this->num_duplicate);
+    lines.push_back(line);
+    if(this->num_received == 0)
+        return;
+
+    snprintf(line, sizeof(line), "    min delay %.1f us, delay above min: avg %.1f us, max %.1f us",
+             this->min_delay / 1000.0, this->avg_delay_ns() / 1000.0, this->delay_max / 1000.0);
+    lines.push_back(line);
+
+    // Only the range of buckets that contains packets.
+    uint32_t lo = 0, hi = NUM_BUCKETS - 1;
+    while(lo < hi && this->hist[lo] == 0)
+        lo++;
+    while(hi > lo && this->hist[hi] == 0)
+        hi--;
+
+    for(uint32_t b = lo; b <= hi; b++)
+    {
+        if(b == 0)
+            snprintf(line, sizeof(line), "    < %8u us: %llu", 1U, (unsigned long long)this->hist[b]);
+        else if(b == NUM_BUCKETS - 1)
+            snprintf(line, sizeof(line), "    >= %7llu us: %llu", 1ULL << (b - 1), (unsigned long long)this->hist[b]);
+        else
+            snprintf(line, sizeof(line), "    < %8llu us: %llu", 1ULL << b, (unsigned long long)this->hist[b]);
+        lines.push_back(line);
+    }
+}
+
+void LinkStats::print(FILE* f, const char* name) const
+{
+    std::vector<std::string> lines;
+    this->format(name, lines);
+    for(const std::string& line : lines)
+        fprintf(f, "%s\n", line.c_str());
+}
@@ -0,0 +1,107 @@
+#ifndef __schwarm_linkstats_h__
+#define __schwarm_linkstats_h__
+
+#include "packet.h"
+#include <cstdio>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace Schwarm
+{
+    /*
+    *   Class: LinkStats
+    *   Statistics of one direction of a connection (link), based on the extended packet header.
+    *   The sender uses stamp() to number its packets, the receiver calls record() for every decoded packet.
+    *
+    *   Delay:
+    *       The timestamps are monotonic clocks of the sender, on another machine the clock has an unknown offset.
+    *       Therefore the histogram contains the delay relative to the smallest delay seen so far (queueing and jitter).
+    *       If both ends run on the same machine, the smallest delay is the real one-way delay.
+    *   Sequence:
+    *       A sequence number that is bigger than expected counts the skipped packets as lost.
+    *       The last SEQ_WINDOW sequence numbers are kept in a bitmap, so a smaller one can be told apart:
+    *       if it was counted as lost it is late (reordered) and takes back the lost packet, otherwise it is a duplicate.
+    *       A sequence number that is older than the window counts as late, but stays lost.
+    *
+    *   stamp() can be called by several sending threads, record() must only be called by the receiving thread.
+    */
+    class LinkStats
+    {
+    public:
+        static constexpr uint32_t NUM_BUCKETS = 24;     // bucket i: relative delay < 2^i us, the last bucket takes the rest
+        static constexpr uint32_t SEQ_WINDOW = 64;      // number of sequence numbers in the bitmap of missing packets
+
+    private:
+        std::atomic<uint32_t> next_seq;
+
+        bool     first;
+        uint32_t expected_seq;
+        uint64_t num_received;
+        uint64_t num_lost;
+        uint64_t num_late;
+        uint64_t num_duplicate;
+        uint64_t missing;           // bit i: sequence number expected_seq - 1 - i has not been received (yet)
+
+        int64_t  min_delay;         // ns, may be negative if the clocks differ
+        uint64_t delay_sum;         // ns, relative to min_delay
+        uint64_t delay_max;         // ns, relative to min_delay
+        uint64_t hist[NUM_BUCKETS];
+
+        void add(uint32_t, uint64_t) noexcept;
+
+    public:
+        LinkStats(void);
+        virtual ~LinkStats(void) {/*dtor*/}
+
+        /*
+        *   Sender side: enables the extended header of the packet and sets the next sequence number.
+        *   Has to be called before allocate() of the packet.
+        */
+        void stamp(Packet&) noexcept;
+
+        /*
+        *   Receiver side: adds a decoded packet to the statistics.
+        *   Packets without extended header are ignored.
+        */
+        void record(const Packet&) noexcept;
+
+        /*
+        *   Same as above, but reads the extended header of raw packet data.
+        *   Can be called before the packet is dispatched, so also packets that are dropped are counted.
+        *   Parameters:
+        *       const uint8_t* data -> Raw data of the packet (id | length | ...).
+        *       uint32_t size       -> Number of valid bytes.
+        */
+        void record(const uint8_t*, uint32_t) noexcept;
+        void reset(void) noexcept;
+
+        uint64_t received(void)     const noexcept;
+        uint64_t lost(void)         const noexcept;
+        uint64_t late(void)         const noexcept;
+        uint64_t duplicate(void)    const noexcept;
+        int64_t  min_delay_ns(void) const noexcept;
+        uint64_t max_delay_ns(void) const noexcept;     // relative to min_delay_ns()
+        double   avg_delay_ns(void) const noexcept;     // relative to min_delay_ns()
+        uint64_t bucket(uint32_t)   const noexcept;
+
+        /*
+        *   Formats the statistics and the delay histogram, one line per string (without the newline).
+        *   E.g. to hand them over to a logger line by line instead of writing into its file.
+        *   Parameters:
+        *       const char* name                -> Name of the link.
+        *       std::vector<std::string>& lines -> Gets the lines (the content gets replaced).
+        */
+        void format(const char*, std::vector<std::string>&) const;
+
+        /*
+        *   Prints the statistics and the delay histogram (see format(...)).
+        *   Parameters:
+        *       FILE* f             -> Output stream.
+        *       const char* name    -> Name of the link.
+        */
+        void print(FILE*, const char*) const;
+    };
+};
+
+#endif // __schwarm_linkstats_h__
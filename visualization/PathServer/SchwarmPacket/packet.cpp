@@ -1,6 +1,7 @@
 #include "packet.h"
 #include <cstring>
 #include <new>
+#include <chrono>
 
 using namespace Schwarm;
 
@@ -8,14 +9,18 @@ Packet::Packet(void)
 {
     this->__data = nullptr;
     this->data_size = 0;
+    this->alloc_size = 0;
+    this->ext_header = false;
+    this->sequence = 0;
+    this->timestamp = 0;
 }
 
-Packet::Packet(const Packet& other)
+Packet::Packet(const Packet& other) : Packet()
 {
     *this = other;
 }
 
-Packet::Packet(Packet&& other)
+Packet::Packet(Packet&& other) : Packet()
 {
     *this = other;
 }
@@ -25,10 +30,17 @@ Packet::~Packet(void)
     this->free();
 }
 
-void Packet::allocate(size_t s)
+void Packet::allocate(uint32_t s)
 {
     if(s >= Packet::min_size())
     {
+        // Reuse the old buffer if it is big enough, packets that are sent every tick do not have to reallocate.
+        if(this->__data != nullptr && this->alloc_size >= s)
+        {
+            this->data_size = s;
+            return;
+        }
+
         if(this->__data != nullptr)
             this->free();
     
@@ -36,6 +48,7 @@ void Packet::allocate(size_t s)
         if(this->__data == nullptr)
             throw std::bad_alloc();
         this->data_size = s;
+        this->alloc_size = s;
     }
 }
 
@@ -43,18 +56,19 @@ void Packet::free(void)
 {
     if(this->__data != nullptr)
     {
-        delete(this->__data);
+        delete[](this->__data);
         this->__data = nullptr;
         this->data_size = 0;
+        this->alloc_size = 0;
     }
 }
 
-packet_error Packet::set(uint8_t* __data, size_t custom_size)
+packet_error Packet::set(uint8_t* __data, uint32_t custom_size)
 {
     if(this->__data == nullptr || __data == nullptr)
         return packet_error::PACKET_NULL;
 
-    if(*Packet::id_ptr(__data) != this->id())
+    if(Packet::get_id(__data) != this->id())
         return packet_error::PACKET_INVALID_ID;
     
     memcpy(this->__data, __data, (custom_size >= Packet::min_size()) ? custom_size : this->data_size);
@@ -66,7 +80,7 @@ uint8_t* Packet::internal_data_ptr(void)
     if(this->__data == nullptr)
         return nullptr;
 
-    return this->__data + SIZE_ID + SIZE_PACKET_LENGTH;
+    return this->__data + this->header_size();
 }
 
 packet_error Packet::internal_encode(void)
@@ -74,17 +88,43 @@ packet_error Packet::internal_encode(void)
     if(this->__data == nullptr)
         return packet_error::PACKET_NULL;
 
-    *(this->__data + 0) = this->id();
-    *((size_t*)(this->__data + SIZE_ID)) = this->data_size;
+    // The fields of the derived packet would not fit into the buffer.
+    if(this->data_size < this->min_size())
+        return packet_error::PACKET_INVALID_SIZE;
+
+    *(this->__data + 0) = this->id() | (this->ext_header ? FLAG_EXT_HEADER : 0);
+    *((uint32_t*)(this->__data + SIZE_ID)) = this->data_size;
+    if(this->ext_header)
+    {
+        // The packet is sent right after encoding, this is the closest point to the send time.
+        this->timestamp = Packet::monotonic_time();
+        *((uint32_t*)(this->__data + SIZE_ID + SIZE_PACKET_LENGTH)) = this->sequence;
+        *((uint64_t*)(this->__data + SIZE_ID + SIZE_PACKET_LENGTH + SIZE_SEQUENCE)) = this->timestamp;
+    }
     return packet_error::PACKET_NONE;
 }
 
 packet_error Packet::internal_decode(void)
 {
-    return (this->__data == nullptr) ? packet_error::PACKET_NULL : packet_error::PACKET_NONE;
+    if(this->__data == nullptr)
+        return packet_error::PACKET_NULL;
+
+    // The flag decides where the data begins, so it has to be known before the size is checked.
+    this->ext_header = (*(this->__data + 0) & FLAG_EXT_HEADER) != 0;
+
+    // A truncated packet must not be decoded, the fields would be read outside of the buffer.
+    if(this->data_size < this->min_size())
+        return packet_error::PACKET_INVALID_SIZE;
+
+    if(this->ext_header)
+    {
+        this->sequence = *((uint32_t*)(this->__data + SIZE_ID + SIZE_PACKET_LENGTH));
+        this->timestamp = *((uint64_t*)(this->__data + SIZE_ID + SIZE_PACKET_LENGTH + SIZE_SEQUENCE));
+    }
+    return packet_error::PACKET_NONE;
 }
 
-size_t Packet::size(void) const noexcept
+uint32_t Packet::size(void) const noexcept
 {
     return this->data_size;
 }
@@ -94,7 +134,7 @@ const uint8_t* Packet::data(void) const
     if(this->__data == nullptr)
         return nullptr;
 
-    return this->__data + SIZE_ID + SIZE_PACKET_LENGTH;
+    return this->__data + this->header_size();
 }
 
 const uint8_t* Packet::rawdata(void) const
@@ -110,12 +150,12 @@ const uint8_t* Packet::id_ptr(const uint8_t* data)
     return data;
 }
 
-const size_t* Packet::size_ptr(const uint8_t* data)
+const uint32_t* Packet::size_ptr(const uint8_t* data)
 {  
     if(data == nullptr)
         return nullptr;
 
-    return (size_t*)(data + SIZE_ID);
+    return (uint32_t*)(data + SIZE_ID);
 }
 
 const uint8_t* Packet::data_ptr(const uint8_t* data)
@@ -123,9 +163,46 @@ const uint8_t* Packet::data_ptr(const uint8_t* data)
     if(data == nullptr)
         return nullptr;
 
+    if(*data & FLAG_EXT_HEADER)
+        return data + SIZE_ID + SIZE_PACKET_LENGTH + SIZE_EXT_HEADER;
     return data + SIZE_ID + SIZE_PACKET_LENGTH;
 }
 
+uint8_t Packet::get_id(const uint8_t* data)
+{
+    return (uint8_t)(*data & ~FLAG_EXT_HEADER);
+}
+
+void Packet::set_ext_header(bool ext) noexcept
+{
+    this->ext_header = ext;
+}
+
+bool Packet::has_ext_header(void) const noexcept
+{
+    return this->ext_header;
+}
+
+void Packet::set_sequence(uint32_t seq) noexcept
+{
+    this->sequence = seq;
+}
+
+uint32_t Packet::get_sequence(void) const noexcept
+{
+    return this->sequence;
+}
+
+uint64_t Packet::get_timestamp(void) const noexcept
+{
+    return this->timestamp;
+}
+
+uint64_t Packet::monotonic_time(void) noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 const char* Packet::strerror(packet_error error) noexcept
 {
     switch(error)
@@ -142,6 +219,8 @@ const char* Packet::strerror(packet_error error) noexcept
         return "Failed to generate path.\n";
     case packet_error::PACKET_SERVER_BUSY:
         return "Server is busy.\n";
+    case packet_error::PACKET_INVALID_SIZE:
+        return "Packet has an invalid size.\n";
     };
     return "Unknown error.";
 }
@@ -149,6 +228,9 @@ const char* Packet::strerror(packet_error error) noexcept
 
 Packet& Packet::operator=(const Packet& other)
 {
+    this->ext_header = other.ext_header;
+    this->sequence = other.sequence;
+    this->timestamp = other.timestamp;
     this->data_size = other.data_size;
     this->allocate(other.data_size);
     memcpy(this->__data, other.__data, other.data_size);
@@ -157,6 +239,9 @@ Packet& Packet::operator=(const Packet& other)
 
 Packet& Packet::operator=(Packet&& other)
 {
+    this->ext_header = other.ext_header;
+    this->sequence = other.sequence;
+    this->timestamp = other.timestamp;
     this->data_size = other.data_size;
     this->allocate(other.data_size);
     memcpy(this->__data, other.__data, other.data_size);
@@ -0,0 +1,592 @@
+#include "shm_transport.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <csignal>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+#endif
+
+using namespace Schwarm;
+
+static constexpr uint32_t SHM_MAGIC = 0x53484d31;   // "SHM1"
+static constexpr uint32_t SHM_VERSION = 1;
+static constexpr int POLL_MS = 100;                 // A waiting side checks this often if the other process is still running.
+static constexpr int ATTACH_TIMEOUT_MS = 1000;      // A client waits this long for the server to take its slot.
+
+namespace Schwarm
+{
+    /*
+    *   One direction of a connection, lives in the shared memory.
+    *   head and tail count the bytes that have been written / read (they wrap around at 2^32, the size of the ring is a power of 2).
+    *   The values that the sender writes and the ones that the receiver writes are in different cache lines.
+    */
+    struct ShmRing
+    {
+        static constexpr uint32_t SIZE = 1 << 18;
+
+        alignas(64) std::atomic_uint32_t head;          // Only written by the sender.
+        std::atomic_uint32_t writer_waiting;            // The sender sleeps until there is space.
+        alignas(64) std::atomic_uint32_t tail;          // Only written by the receiver.
+        std::atomic_uint32_t reader_waiting;            // The receiver sleeps until there is a packet.
+        alignas(64) uint8_t data[SIZE];
+    };
+
+    enum shm_slot_state : uint32_t
+    {
+        SLOT_FREE,          // No client.
+        SLOT_CLAIMED,       // A client initializes the slot.
+        SLOT_OPEN,          // The client waits for the server.
+        SLOT_ATTACHED,      // Connected.
+        SLOT_CLOSED         // One side has closed the connection, the server frees the slot.
+    };
+
+    struct alignas(64) ShmSlot
+    {
+        std::atomic_uint32_t state;
+        std::atomic_uint32_t client_pid;
+        ShmRing to_server;
+        ShmRing to_client;
+    };
+
+    struct alignas(64) ShmHeader
+    {
+        std::atomic_uint32_t magic;     // Is set last, the segment is ready then.
+        uint32_t version;
+        uint32_t num_slots;
+        uint32_t server_pid;
+    };
+
+    /*
+    *   A mapped shared memory segment.
+    */
+    struct ShmSegment
+    {
+        std::string name;
+        void* ptr{nullptr};
+        size_t size{0};
+#ifdef _WIN32
+        HANDLE mapping{nullptr};
+#else
+        bool owner{false};      // The server removes the name when it closes the segment.
+#endif
+
+        ShmHeader* header(void) const noexcept {return (ShmHeader*)this->ptr;}
+        ShmSlot* slot(uint32_t i) const noexcept {return (ShmSlot*)((uint8_t*)this->ptr + sizeof(ShmHeader)) + i;}
+    };
+};
+
+// Events of a slot (Windows): the state and the data / space events of both rings.
+enum
+{
+    EVENT_STATE,
+    EVENT_TO_SERVER_DATA,
+    EVENT_TO_SERVER_SPACE,
+    EVENT_TO_CLIENT_DATA,
+    EVENT_TO_CLIENT_SPACE,
+    EVENTS_PER_SLOT
+};
+
+static std::string segment_name(uint16_t port)
+{
+#ifdef _WIN32
+    return "Local\\schwarm_shm_" + std::to_string(port);
+#else
+    return "/schwarm_shm_" + std::to_string(port);
+#endif
+}
+
+static size_t segment_size(uint32_t num_slots)
+{
+    return sizeof(ShmHeader) + num_slots * sizeof(ShmSlot);
+}
+
+static uint32_t current_pid(void)
+{
+#ifdef _WIN32
+    return (uint32_t)GetCurrentProcessId();
+#else
+    return (uint32_t)getpid();
+#endif
+}
+
+static bool process_alive(uint32_t pid)
+{
+#ifdef _WIN32
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+    if(process == nullptr)
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    const bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+#else
+    return kill((pid_t)pid, 0) == 0 || errno != ESRCH;
+#endif
+}
+
+/*
+*   Sleeps until the word has another value than expected, it has been woken up or the timeout has expired.
+*   Linux: futex on the word in the shared memory. Windows: the event, the word is only checked by the caller.
+*/
+static void wait_word(std::atomic_uint32_t* word, uint32_t expected, void* event, int timeout_ms)
+{
+#ifdef _WIN32
+    (void)word;
+    (void)expected;
+    WaitForSingleObject((HANDLE)event, timeout_ms);
+#else
+    (void)event;
+    timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    // Not FUTEX_PRIVATE_FLAG, the word is shared between processes.
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#endif
+}
+
+static void wake_word(std::atomic_uint32_t* word, void* event)
+{
+#ifdef _WIN32
+    (void)word;
+    SetEvent((HANDLE)event);
+#else
+    (void)event;
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+/*
+*   Opens (or creates) the events of a slot.
+*   Return:
+*       False if an event could not be opened, the opened ones are closed then.
+*/
+static bool open_events(const std::string& name, uint32_t slot, void** events)
+{
+#ifdef _WIN32
+    int i;
+    for(i = 0; i < EVENTS_PER_SLOT; i++)
+    {
+        const std::string event_name = name + "_" + std::to_string(slot) + "_" + std::to_string(i);
+        events[i] = CreateEventA(nullptr, FALSE, FALSE, event_name.c_str());    // Opens the event if it exists.
+        if(events[i] == nullptr)
+        {
+            while(--i >= 0)
+                CloseHandle((HANDLE)events[i]);
+            return false;
+        }
+    }
+#else
+    (void)name;
+    (void)slot;
+    memset(events, 0, EVENTS_PER_SLOT * sizeof(void*));
+#endif
+    return true;
+}
+
+static void close_events(void** events)
+{
+#ifdef _WIN32
+    int i;
+    for(i = 0; i < EVENTS_PER_SLOT; i++)
+        CloseHandle((HANDLE)events[i]);
+#else
+    (void)events;
+#endif
+}
+
+/*
+*   Maps the segment of a server.
+*   Parameters:
+*       size_t size -> Size of a new segment, 0 to open an existing one.
+*/
+static ShmSegment* open_segment(const std::string& name, size_t size)
+{
+    ShmSegment* segment = new ShmSegment;
+    segment->name = name;
+#ifdef _WIN32
+    if(size > 0)
+    {
+        segment->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, name.c_str());
+        if(segment->mapping != nullptr && GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            // Another server uses the port.
+            CloseHandle(segment->mapping);
+            segment->mapping = nullptr;
+        }
+    }
+    else
+        segment->mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if(segment->mapping == nullptr)
+    {
+        delete(segment);
+        return nullptr;
+    }
+    segment->ptr = MapViewOfFile(segment->mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    MEMORY_BASIC_INFORMATION info;
+    if(segment->ptr == nullptr || VirtualQuery(segment->ptr, &info, sizeof(info)) == 0)
+    {
+        if(segment->ptr != nullptr)
+            UnmapViewOfFile(segment->ptr);
+        CloseHandle(segment->mapping);
+        delete(segment);
+        return nullptr;
+    }
+    segment->size = info.RegionSize;
+#else
+    int fd;
+    if(size > 0)
+    {
+        // A segment of a server that has crashed is replaced, the port of the server is not used by another one.
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if(fd >= 0 && ftruncate(fd, size) != 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            fd = -1;
+        }
+        segment->owner = true;
+    }
+    else
+    {
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+        struct stat info;
+        if(fd >= 0 && fstat(fd, &info) == 0)
+            size = info.st_size;
+    }
+    if(fd < 0 || size < sizeof(ShmHeader))
+    {
+        if(fd >= 0)
+            close(fd);
+        delete(segment);
+        return nullptr;
+    }
+    segment->ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // The mapping stays valid.
+    if(segment->ptr == MAP_FAILED)
+    {
+        if(segment->owner)
+            shm_unlink(name.c_str());
+        delete(segment);
+        return nullptr;
+    }
+    segment->size = size;
+#endif
+    return segment;
+}
+
+static void close_segment(ShmSegment* segment)
+{
+#ifdef _WIN32
+    UnmapViewOfFile(segment->ptr);
+    CloseHandle(segment->mapping);
+#else
+    munmap(segment->ptr, segment->size);
+    if(segment->owner)
+        shm_unlink(segment->name.c_str());
+#endif
+    delete(segment);
+}
+
+// Copies into the ring at a position, the data may wrap around the end of the ring.
+static void ring_write(ShmRing* ring, uint32_t pos, const uint8_t* data, uint32_t size)
+{
+    const uint32_t offset = pos & (ShmRing::SIZE - 1);
+    const uint32_t first = std::min(size, ShmRing::SIZE - offset);
+    memcpy(ring->data + offset, data, first);
+    memcpy(ring->data, data + first, size - first);
+}
+
+static void ring_read(const ShmRing* ring, uint32_t pos, uint8_t* data, uint32_t size)
+{
+    const uint32_t offset = pos & (ShmRing::SIZE - 1);
+    const uint32_t first = std::min(size, ShmRing::SIZE - offset);
+    memcpy(data, ring->data + offset, first);
+    memcpy(data + first, ring->data, size - first);
+}
+
+static void reset_ring(ShmRing* ring)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->writer_waiting = 0;
+    ring->reader_waiting = 0;
+}
+
+ShmEndpoint::ShmEndpoint(ShmSegment* segment, ShmSlot* slot, bool server, void* const* slot_events)
+{
+    this->segment = segment;
+    this->slot = slot;
+    this->server = server;
+    this->in = server ? &slot->to_server : &slot->to_client;
+    this->out = server ? &slot->to_client : &slot->to_server;
+    memcpy(this->events, slot_events, sizeof(this->events));
+}
+
+ShmEndpoint::~ShmEndpoint(void)
+{
+    this->close();
+    if(!this->server)
+    {
+        // The client owns its events and its mapping.
+        close_events(this->events);
+        close_segment(this->segment);
+    }
+}
+
+int ShmEndpoint::event(bool incoming, bool data) const noexcept
+{
+    const bool to_server = (incoming == this->server);
+    if(to_server)
+        return data ? EVENT_TO_SERVER_DATA : EVENT_TO_SERVER_SPACE;
+    return data ? EVENT_TO_CLIENT_DATA : EVENT_TO_CLIENT_SPACE;
+}
+
+bool ShmEndpoint::peer_alive(void) const noexcept
+{
+    if(this->slot->state.load() != SLOT_ATTACHED)
+        return false;
+    return process_alive(this->server ? this->slot->client_pid.load() : this->segment->header()->server_pid);
+}
+
+bool ShmEndpoint::send(const uint8_t* data, uint32_t size) noexcept
+{
+    if(size > ShmRing::SIZE || this->slot->state.load() != SLOT_ATTACHED)
+        return false;
+
+    ShmRing* ring = this->out;
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+    while(ShmRing::SIZE - (head - ring->tail.load(std::memory_order_acquire)) < size)
+    {
+        // The receiver wakes the sender up only if the sender says that it sleeps, the tail is checked again after that.
+        ring->writer_waiting.store(1);
+        const uint32_t tail = ring->tail.load();
+        if(ShmRing::SIZE - (head - tail) < size)
+        {
+            if(!this->peer_alive())
+            {
+                ring->writer_waiting.store(0);
+                return false;
+            }
+            wait_word(&ring->tail, tail, this->events[this->event(false, false)], POLL_MS);
+        }
+        ring->writer_waiting.store(0, std::memory_order_relaxed);
+    }
+
+    ring_write(ring, head, data, size);
+    ring->head.store(head + size);
+    if(ring->reader_waiting.load())
+        wake_word(&ring->head, this->events[this->event(false, true)]);
+    return true;
+}
+
+int ShmEndpoint::recv(std::vector<uint8_t>& packet, int timeout_ms) noexcept
+{
+    ShmRing* ring = this->in;
+    const uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+    if(head == tail)
+    {
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while(head == tail)
+        {
+            if(this->slot->state.load() != SLOT_ATTACHED)
+                return -1;
+            const int remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if(remaining <= 0)
+                return this->peer_alive() ? 0 : -1;
+
+            // Like the sender: say that the receiver sleeps, then check the head again.
+            ring->reader_waiting.store(1);
+            head = ring->head.load();
+            if(head == tail)
+                wait_word(&ring->head, head, this->events[this->event(true, true)], std::min(remaining, POLL_MS));
+            ring->reader_waiting.store(0, std::memory_order_relaxed);
+            head = ring->head.load(std::memory_order_acquire);
+            if(head == tail && !this->peer_alive())
+                return -1;
+        }
+    }
+
+    // The sender publishes only whole packets.
+    constexpr uint32_t HEADER_SIZE = Packet::SIZE_ID + Packet::SIZE_PACKET_LENGTH;
+    uint8_t header[HEADER_SIZE];
+    ring_read(ring, tail, header, HEADER_SIZE);
+    const uint32_t size = *Packet::size_ptr(header);
+    if(size < HEADER_SIZE || size > head - tail)
+    {
+        this->close();  // Broken stream, like a socket with garbage.
+        return -1;
+    }
+    packet.resize(size);
+    ring_read(ring, tail, packet.data(), size);
+    ring->tail.store(tail + size);
+    if(ring->writer_waiting.load())
+        wake_word(&ring->tail, this->events[this->event(true, false)]);
+    return 1;
+}
+
+void ShmEndpoint::close(void) noexcept
+{
+    if(this->server)
+    {
+        // The client does not use the slot anymore if it has closed it or if it has crashed.
+        uint32_t state = this->slot->state.load();
+        if(state == SLOT_CLOSED || (state == SLOT_ATTACHED && !process_alive(this->slot->client_pid)))
+            this->slot->state.compare_exchange_strong(state, SLOT_FREE);
+        else if(state == SLOT_ATTACHED)
+            this->slot->state.compare_exchange_strong(state, SLOT_CLOSED);
+    }
+    else
+    {
+        uint32_t state = SLOT_ATTACHED;
+        this->slot->state.compare_exchange_strong(state, SLOT_CLOSED);
+    }
+
+    // Wake up the other side and the own threads if they wait.
+    wake_word(&this->out->head, this->events[this->event(false, true)]);
+    wake_word(&this->out->tail, this->events[this->event(false, false)]);
+    wake_word(&this->in->head, this->events[this->event(true, true)]);
+    wake_word(&this->in->tail, this->events[this->event(true, false)]);
+}
+
+ShmServer::ShmServer(ShmSegment* segment, uint32_t num_slots)
+{
+    this->segment = segment;
+    this->slots = num_slots;
+}
+
+ShmServer::~ShmServer(void)
+{
+    uint32_t i;
+    for(i = 0; i < this->slots; i++)
+    {
+        // Clients that are still connected see the closed state.
+        this->segment->slot(i)->state = SLOT_CLOSED;
+        if(!this->events.empty())
+            close_events(&this->events[i * EVENTS_PER_SLOT]);
+    }
+    this->segment->header()->magic = 0;
+    close_segment(this->segment);
+}
+
+ShmServer* ShmServer::create(uint16_t port, uint32_t num_slots)
+{
+    const std::string name = segment_name(port);
+    ShmSegment* segment = open_segment(name, segment_size(num_slots));
+    if(segment == nullptr)
+        return nullptr;
+
+    ShmServer* server = new ShmServer(segment, num_slots);
+    server->events.resize(num_slots * EVENTS_PER_SLOT);
+    uint32_t i;
+    for(i = 0; i < num_slots; i++)
+    {
+        if(!open_events(name, i, &server->events[i * EVENTS_PER_SLOT]))
+        {
+            // The events of the previous slots are closed by the destructor.
+            server->slots = i;
+            delete(server);
+            return nullptr;
+        }
+    }
+
+    // The new memory is zeroed, all slots are free.
+    ShmHeader* header = segment->header();
+    header->version = SHM_VERSION;
+    header->num_slots = num_slots;
+    header->server_pid = current_pid();
+    header->magic.store(SHM_MAGIC);
+    return server;
+}
+
+ShmEndpoint* ShmServer::accept(uint32_t index, int timeout_ms)
+{
+    ShmSlot* slot = this->segment->slot(index);
+    void** slot_events = &this->events[index * EVENTS_PER_SLOT];
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while(true)
+    {
+        uint32_t state = slot->state.load();
+        if(state == SLOT_OPEN && slot->state.compare_exchange_strong(state, SLOT_ATTACHED))
+        {
+            wake_word(&slot->state, slot_events[EVENT_STATE]);
+            return new ShmEndpoint(this->segment, slot, true, slot_events);
+        }
+        // A slot of a client that has crashed (or of a closed connection) is freed.
+        if((state == SLOT_CLAIMED && !process_alive(slot->client_pid)) || state == SLOT_CLOSED)
+            slot->state.compare_exchange_strong(state, SLOT_FREE);
+
+        const int remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if(remaining <= 0)
+            return nullptr;
+        wait_word(&slot->state, state, slot_events[EVENT_STATE], std::min(remaining, POLL_MS));
+    }
+}
+
+ShmEndpoint* Schwarm::shm_connect(uint16_t port)
+{
+    const std::string name = segment_name(port);
+    ShmSegment* segment = open_segment(name, 0);
+    if(segment == nullptr)
+        return nullptr;
+
+    const ShmHeader* header = segment->header();
+    if(header->magic.load() != SHM_MAGIC || header->version != SHM_VERSION || segment->size < segment_size(header->num_slots) ||
+       !process_alive(header->server_pid))
+    {
+        close_segment(segment);
+        return nullptr;
+    }
+
+    uint32_t i;
+    for(i = 0; i < header->num_slots; i++)
+    {
+        ShmSlot* slot = segment->slot(i);
+        uint32_t state = SLOT_FREE;
+        if(!slot->state.compare_exchange_strong(state, SLOT_CLAIMED))
+            continue;
+
+        void* slot_events[EVENTS_PER_SLOT];
+        if(!open_events(name, i, slot_events))
+        {
+            slot->state = SLOT_FREE;
+            break;
+        }
+        slot->client_pid = current_pid();
+        reset_ring(&slot->to_server);
+        reset_ring(&slot->to_client);
+        slot->state.store(SLOT_OPEN);
+        wake_word(&slot->state, slot_events[EVENT_STATE]);
+
+        // The server takes the slot if it has a thread for it.
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ATTACH_TIMEOUT_MS);
+        while((state = slot->state.load()) == SLOT_OPEN && std::chrono::steady_clock::now() < deadline)
+            wait_word(&slot->state, state, slot_events[EVENT_STATE], 10);
+        // The slot is given back if the server has not taken it (the server may take it just now).
+        if(state == SLOT_OPEN)
+            slot->state.compare_exchange_strong(state, SLOT_FREE);
+        if(state == SLOT_ATTACHED)
+            return new ShmEndpoint(segment, slot, false, slot_events);
+        close_events(slot_events);
+        break;
+    }
+    close_segment(segment);
+    return nullptr;
+}
+
+bool Schwarm::is_local_address(const char* addr) noexcept
+{
+    return strcmp(addr, "localhost") == 0 || strncmp(addr, "127.", 4) == 0 || strcmp(addr, "::1") == 0;
+}
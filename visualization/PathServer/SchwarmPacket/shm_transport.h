@@ -0,0 +1,135 @@
+#ifndef __schwarm_shm_transport_h__
+#define __schwarm_shm_transport_h__
+
+#include "packet.h"
+#include <vector>
+#include <atomic>
+
+namespace Schwarm
+{
+    struct ShmSegment;
+    struct ShmRing;
+    struct ShmSlot;
+
+    /*
+    *   Class: ShmEndpoint
+    *   One end of a shared-memory connection between two processes on the same machine.
+    *   It carries the same packet frames as a socket (id|length|...|data), every direction is a single-producer
+    *   single-consumer ring in the shared memory. A waiting receiver (or a sender that waits for space) sleeps
+    *   on a futex (Linux) or a named event (Windows), the other side only wakes it up if it sleeps.
+    *
+    *   send() may be called by one thread at a time (e.g. under the send mutex of a connection),
+    *   recv() only by one receiving thread.
+    */
+    class ShmEndpoint
+    {
+    private:
+        ShmSegment* segment;    // Is owned by the endpoint of the client, the server owns the segment of all slots.
+        ShmSlot* slot;
+        ShmRing* in;
+        ShmRing* out;
+        void* events[5];        // Windows: the state event and the data / space events of both rings, the client owns its events.
+        bool server;
+
+        // Return: index of an event of the incoming or outgoing ring.
+        int event(bool, bool) const noexcept;
+
+        // Return: true if the process on the other side is still running and has not closed the connection.
+        bool peer_alive(void) const noexcept;
+
+    public:
+        ShmEndpoint(ShmSegment*, ShmSlot*, bool, void* const*);
+
+        ShmEndpoint(const ShmEndpoint&) = delete;
+        ShmEndpoint& operator=(const ShmEndpoint&) = delete;
+
+        // Closes the connection.
+        virtual ~ShmEndpoint(void);
+
+        /*
+        *   Sends one packet, waits while the ring of the other side is full.
+        *   Parameters:
+        *       const uint8_t* data -> The encoded packet.
+        *       uint32_t size -> Size of the packet in bytes.
+        *   Return:
+        *       False if the connection has been closed or the packet is too big for the ring.
+        */
+        bool send(const uint8_t*, uint32_t) noexcept;
+
+        /*
+        *   Receives one packet.
+        *   Parameters:
+        *       std::vector<uint8_t>& packet -> Gets the whole packet.
+        *       int timeout_ms -> Maximum time to wait for a packet.
+        *   Return:
+        *       1 if a packet has been received, 0 on a timeout, -1 if the connection has been closed.
+        */
+        int recv(std::vector<uint8_t>&, int) noexcept;
+
+        /*
+        *   Closes the connection, the other side receives -1.
+        *   The server frees the slot, the client only marks it as closed.
+        */
+        void close(void) noexcept;
+    };
+
+    /*
+    *   Class: ShmServer
+    *   The shared memory of a server: a fixed number of slots, every slot is one connection of a local client.
+    *   The segment is named by the port of the server, so a client that connects to a local address finds it.
+    *   Every slot is served by its own thread that waits with accept() for a client.
+    */
+    class ShmServer
+    {
+    private:
+        ShmSegment* segment;
+        uint32_t slots;
+        std::vector<void*> events;      // Windows: the events of all slots, 5 per slot.
+
+        ShmServer(ShmSegment*, uint32_t);
+
+    public:
+        ShmServer(const ShmServer&) = delete;
+        ShmServer& operator=(const ShmServer&) = delete;
+
+        // Removes the shared memory, the endpoints of the slots have to be deleted before.
+        virtual ~ShmServer(void);
+
+        /*
+        *   Creates the shared memory of a server.
+        *   Parameters:
+        *       uint16_t port -> Port of the server (TCP), names the shared memory.
+        *       uint32_t num_slots -> Maximum number of local clients.
+        *   Return:
+        *       The server, 'nullptr' if the shared memory could not be created.
+        */
+        static ShmServer* create(uint16_t, uint32_t);
+
+        /*
+        *   Waits for a client in a slot.
+        *   Parameters:
+        *       uint32_t slot -> Index of the slot.
+        *       int timeout_ms -> Maximum time to wait.
+        *   Return:
+        *       The connection (has to be deleted), 'nullptr' if no client has connected.
+        */
+        ShmEndpoint* accept(uint32_t, int);
+
+        uint32_t num_slots(void) const noexcept {return this->slots;}
+    };
+
+    /*
+    *   Connects to the shared memory of a server on the same machine.
+    *   Parameters:
+    *       uint16_t port -> Port of the server.
+    *   Return:
+    *       The connection (has to be deleted), 'nullptr' if there is no such server or all slots are in use.
+    *       The client uses the socket then.
+    */
+    ShmEndpoint* shm_connect(uint16_t);
+
+    // Return: true if the address is the own machine (localhost, 127.x.x.x, ::1), only then shm_connect() makes sense.
+    bool is_local_address(const char*) noexcept;
+};
+
+#endif // __schwarm_shm_transport_h__
@@ -0,0 +1,128 @@
+#include <ctime>
+#include <algorithm>
+#include "async_logger.h"
+
+static const char* const LEVEL_NAMES[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+
+AsyncLogger::AsyncLogger(FILE* file, size_t capacity, unsigned int flush_interval_ms)
+{
+    // The capacity has to be a power of 2, so the position in the ring buffer is (pos & mask).
+    size_t size = 2;
+    while(size < capacity)
+        size *= 2;
+
+    this->records = new Record[size];
+    this->mask = size - 1;
+    uint64_t i;
+    for(i = 0; i < size; i++)
+        this->records[i].sequence.store(i, std::memory_order_relaxed);
+
+    this->file = file;
+    this->flush_interval_ms = flush_interval_ms;
+    this->write_pos = 0;
+    this->read_pos = 0;
+    this->min_level = LOG_DEBUG;
+    this->dropped = 0;
+    this->reported_dropped = 0;
+    this->running = true;
+    this->writer = std::thread(&AsyncLogger::write_loop, this);
+}
+
+AsyncLogger::~AsyncLogger(void)
+{
+    this->running = false;
+    this->writer.join();    // The background thread writes the remaining records before it returns.
+    delete[](this->records);
+}
+
+AsyncLogger::Record* AsyncLogger::acquire(uint64_t& pos) noexcept
+{
+    /*  Bounded MPMC queue by Dmitry Vyukov (only one consumer here).
+    *   Every record has a sequence number: it is equal to the position if the record is free,
+    *   position + 1 if it has been written and is waiting for the background thread.
+    */
+    pos = this->write_pos.load(std::memory_order_relaxed);
+    while(true)
+    {
+        Record* r = &this->records[pos & this->mask];
+        const int64_t diff = (int64_t)r->sequence.load(std::memory_order_acquire) - (int64_t)pos;
+        if(diff == 0)
+        {
+            // The record is free, try to reserve it (another thread may be faster).
+            if(this->write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                return r;
+        }
+        else if(diff < 0)
+            return nullptr;     // The record has not been written by the background thread yet, the ring buffer is full.
+        else
+            pos = this->write_pos.load(std::memory_order_relaxed);
+    }
+}
+
+size_t AsyncLogger::write_records(void)
+{
+    char line[512];
+    char time_str[16] = "--:--:--";
+    int64_t time_sec = -1;
+    size_t count = 0;
+    uint64_t pos = this->read_pos.load(std::memory_order_relaxed);
+
+    while(count <= this->mask)     // At most one round, then the batch is flushed.
+    {
+        Record& r = this->records[pos & this->mask];
+        if(r.sequence.load(std::memory_order_acquire) != pos + 1)
+            break;  // Not written yet.
+
+        // The local time is only converted once per second.
+        const int64_t sec = r.time / 1000000000;
+        if(sec != time_sec)
+        {
+            const time_t t = (time_t)sec;
+            const tm* local_time = localtime(&t);
+            strftime(time_str, sizeof(time_str), "%H:%M:%S", local_time);
+            time_sec = sec;
+        }
+
+        int len = snprintf(line, sizeof(line), "[%s] [%s] ", time_str, LEVEL_NAMES[r.level]);
+        const int msg_len = r.formatter(line + len, sizeof(line) - len - 1, r);
+        len = (msg_len < 0) ? len : std::min<int>(len + msg_len, sizeof(line) - 2);
+        line[len++] = '\n';
+        fwrite(line, 1, len, this->file);   // Buffered by the FILE, it is flushed once per batch.
+
+        r.sequence.store(pos + this->mask + 1, std::memory_order_release);  // The record is free for the next round.
+        pos++;
+        count++;
+    }
+
+    // Report the dropped messages (since the last report).
+    const uint64_t dropped = this->dropped.load(std::memory_order_relaxed);
+    bool report = dropped != this->reported_dropped;
+    if(report)
+    {
+        fprintf(this->file, "[%s] [WARNING] %llu log messages have been dropped (log buffer full).\n", time_str, (unsigned long long)(dropped - this->reported_dropped));
+        this->reported_dropped = dropped;
+    }
+
+    if(count > 0 || report)
+        fflush(this->file);
+    this->read_pos.store(pos, std::memory_order_release);
+    return count;
+}
+
+void AsyncLogger::write_loop(void)
+{
+    while(this->running)
+    {
+        // If there were many records, there are probably more, so don't sleep.
+        if(this->write_records() <= this->mask / 2)
+            std::this_thread::sleep_for(std::chrono::milliseconds(this->flush_interval_ms));
+    }
+    this->write_records();
+}
+
+void AsyncLogger::flush(void)
+{
+    const uint64_t target = this->write_pos.load(std::memory_order_acquire);
+    while(this->running && this->read_pos.load(std::memory_order_acquire) < target)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
@@ -0,0 +1,240 @@
+#ifndef __async_logger_h__
+#define __async_logger_h__
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <type_traits>
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <thread>
+#else
+    #include <mingw.thread.h>
+#endif
+
+/*
+*   Class: AsyncLogger
+*   Log file writer that keeps the formatting and the disk I/O away from the threads that log.
+*
+*   A call to log() only copies the format string pointer, the arguments and a timestamp into a fixed-size record
+*   of a lock-free ring buffer (several threads can log at the same time).
+*   A background thread formats the records ("[hh:mm:ss] [LEVEL] message") and writes them in batches.
+*   If the ring buffer is full, the message is dropped and counted, log() never waits.
+*
+*   Rules for the messages:
+*       - The format string has to be a string literal (only the pointer is stored).
+*       - Up to MAX_ARGS arguments: numbers, enums, pointers and strings (char*).
+*         Strings are copied into the record, together they can have up to STRING_SIZE - 1 characters (the rest is cut off).
+*       - The message gets a newline at the end.
+*       - A message without arguments is written as it is (no format specifiers).
+*/
+class AsyncLogger
+{
+public:
+    enum log_level : uint8_t
+    {
+        LOG_DEBUG,
+        LOG_INFO,
+        LOG_WARNING,
+        LOG_ERROR
+    };
+
+    static constexpr size_t MAX_ARGS = 8;
+    static constexpr size_t RECORD_SIZE = 256;
+    /*  The strings get the space of the record that is left by the other members, so the record has RECORD_SIZE bytes
+    *   with 32 and 64 bit pointers (sequence, time, format, formatter, args and level, see Record).
+    */
+    static constexpr size_t STRING_SIZE = RECORD_SIZE - 2 * sizeof(uint64_t) - 2 * sizeof(void*) - MAX_ARGS * sizeof(uint64_t) - sizeof(uint8_t);
+
+private:
+    struct Record;
+    using format_func_t = int(*)(char*, size_t, const Record&);
+
+    // One message, RECORD_SIZE bytes.
+    struct Record
+    {
+        std::atomic_uint64_t sequence;  // Position in the ring buffer, tells if the record is free or written.
+        int64_t time;                   // Nanoseconds since 1970 (system clock).
+        const char* format;
+        format_func_t formatter;        // Formats the arguments with the types they have been logged with.
+        uint64_t args[MAX_ARGS];        // One slot per argument.
+        char strings[STRING_SIZE];      // The copied strings.
+        log_level level;
+    };
+    static_assert(sizeof(Record) == RECORD_SIZE, "a record should have RECORD_SIZE bytes");
+
+    // A string argument: the position of the copy in the record.
+    struct string_ref_t
+    {
+        uint16_t offset;
+    };
+
+    template<typename T>
+    using stored_t = std::conditional_t<std::is_same<std::decay_t<T>, char*>::value || std::is_same<std::decay_t<T>, const char*>::value,
+                                        string_ref_t,
+                                        std::conditional_t<std::is_same<std::decay_t<T>, float>::value, double, std::decay_t<T>>>;
+
+    Record* records;
+    uint64_t mask;                          // Capacity - 1, the capacity is a power of 2.
+    alignas(64) std::atomic_uint64_t write_pos;
+    alignas(64) std::atomic_uint64_t read_pos;  // Only the background thread moves it, after the records have been written.
+    std::atomic_uint8_t min_level;
+    std::atomic_uint64_t dropped;
+    uint64_t reported_dropped;              // Dropped messages that have already been reported in the log file (background thread).
+    std::atomic_bool running;
+    std::thread writer;
+    FILE* file;
+    unsigned int flush_interval_ms;
+
+    // Stores one argument in a slot of the record.
+    template<typename T>
+    static void store(Record& r, size_t slot, size_t& str_pos, const T& value)
+    {
+        if constexpr(std::is_same<stored_t<T>, string_ref_t>::value)
+        {
+            // Copy the string, it does not have to exist anymore when the record is written.
+            const char* str = (value == nullptr) ? "(null)" : value;
+            string_ref_t ref{(uint16_t)str_pos};
+            if(str_pos < STRING_SIZE)
+            {
+                // Copy and measure in one pass, the string is cut off at the end of the record.
+                char* dst = r.strings + str_pos;
+                const size_t max_len = STRING_SIZE - 1 - str_pos;
+                size_t len = 0;
+                while(len < max_len && str[len] != '\0')
+                {
+                    dst[len] = str[len];
+                    len++;
+                }
+                dst[len] = '\0';
+                str_pos += len + 1;
+            }
+            else
+                ref.offset = STRING_SIZE - 1;   // Points to the terminating zero of the last string (empty string).
+            memcpy(&r.args[slot], &ref, sizeof(ref));
+        }
+        else
+        {
+            const stored_t<T> v = value;
+            memcpy(&r.args[slot], &v, sizeof(v));
+        }
+    }
+
+    // Reads one argument out of a slot of the record.
+    template<typename T>
+    static auto load(const Record& r, size_t slot)
+    {
+        stored_t<T> v;
+        memcpy(&v, &r.args[slot], sizeof(v));
+        if constexpr(std::is_same<stored_t<T>, string_ref_t>::value)
+            return (const char*)(r.strings + v.offset);
+        else
+            return v;
+    }
+
+    template<typename... Args, size_t... I>
+    static int format_args(char* out, size_t size, const Record& r, std::index_sequence<I...>)
+    {
+        if constexpr(sizeof...(Args) == 0)
+            return snprintf(out, size, "%s", r.format);
+        else
+            return snprintf(out, size, r.format, load<Args>(r, I)...);
+    }
+
+    template<typename... Args>
+    static int format_record(char* out, size_t size, const Record& r)
+    {
+        return format_args<Args...>(out, size, r, std::index_sequence_for<Args...>{});
+    }
+
+    /*
+    *   Reserves a record in the ring buffer.
+    *   Return:
+    *       The record, 'nullptr' if the ring buffer is full. The position is written to 'pos'.
+    */
+    Record* acquire(uint64_t&) noexcept;
+
+    // Loop of the background thread.
+    void write_loop(void);
+
+    /*
+    *   Formats and writes all records that have been logged.
+    *   Return:
+    *       Number of written records.
+    */
+    size_t write_records(void);
+
+public:
+    /*
+    *   Starts the background thread.
+    *   Parameters:
+    *       FILE* file -> The log file, it is not closed by the logger.
+    *       size_t capacity -> Number of records in the ring buffer, is rounded up to a power of 2.
+    *       unsigned int flush_interval_ms -> The background thread writes the records at least this often.
+    */
+    AsyncLogger(FILE*, size_t = 4096, unsigned int = 10);
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // Writes the remaining records and stops the background thread.
+    virtual ~AsyncLogger(void);
+
+    /*
+    *   Logs a message (see the rules in the class description).
+    *   Parameters:
+    *       log_level level -> Level of the message, nothing is done if it is below the minimum level.
+    *       const char* format -> printf-format string (string literal).
+    *       args... -> The arguments of the format string.
+    */
+    template<typename... Args>
+    void log(log_level level, const char* format, const Args&... args) noexcept
+    {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "too many arguments for a log message");
+        static_assert((... && (sizeof(stored_t<Args>) <= sizeof(uint64_t) && std::is_trivially_copyable<stored_t<Args>>::value)),
+                      "only numbers, enums, pointers and strings can be logged");
+
+        if(level < this->min_level.load(std::memory_order_relaxed))
+            return;
+
+        uint64_t pos;
+        Record* r = this->acquire(pos);
+        if(r == nullptr)
+        {
+            this->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        r->time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        r->level = level;
+        r->format = format;
+        r->formatter = &format_record<Args...>;
+        size_t slot = 0, str_pos = 0;
+        (store(*r, slot++, str_pos, args), ...);
+        (void)slot;
+        (void)str_pos;
+        r->sequence.store(pos + 1, std::memory_order_release);   // The record can be written now.
+    }
+
+    template<typename... Args>
+    void debug(const char* format, const Args&... args) noexcept {this->log(LOG_DEBUG, format, args...);}
+    template<typename... Args>
+    void info(const char* format, const Args&... args) noexcept {this->log(LOG_INFO, format, args...);}
+    template<typename... Args>
+    void warning(const char* format, const Args&... args) noexcept {this->log(LOG_WARNING, format, args...);}
+    template<typename... Args>
+    void error(const char* format, const Args&... args) noexcept {this->log(LOG_ERROR, format, args...);}
+
+    // Messages below this level are not logged (default: LOG_DEBUG, everything is logged).
+    void set_level(log_level level) noexcept {this->min_level.store(level, std::memory_order_relaxed);}
+
+    // Return: number of messages that have been dropped because the ring buffer was full.
+    uint64_t num_dropped(void) const noexcept {return this->dropped.load(std::memory_order_relaxed);}
+
+    // Writes all messages that have been logged until now (waits for the background thread).
+    void flush(void);
+};
+
+#endif // __async_logger_h__
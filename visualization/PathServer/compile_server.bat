@@ -2,4 +2,16 @@ mkdir obj
 g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c main.cpp -o obj/main.o
 g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c SchwarmPacket/packet.cpp -o obj/packet.o
 g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c SchwarmPacket/otherpacket.cpp -o obj/otherpacket.o
-g++ -LC:/CodeBlocks/gcc-8.2-32/i686-pc-mingw32/lib -LD:/Michi/Programmieren/Libraries/sockethandler-1.0.0/lib -LD:/Michi/Programmieren/Libraries/cppsock -o path_server.exe D:/Michi/Programmieren/Libraries/cppsock/cppsock_winonly.cpp obj/main.o obj/packet.o obj/otherpacket.o -lsockethandler -lcppsock -lws2_32 -s
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c SchwarmPacket/linkstats.cpp -o obj/linkstats.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c SchwarmPacket/shm_transport.cpp -o obj/shm_transport.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c generator_pool.cpp -o obj/generator_pool.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c request_queue.cpp -o obj/request_queue.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c goal_cache.cpp -o obj/goal_cache.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c async_logger.cpp -o obj/async_logger.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c goal_stream.cpp -o obj/goal_stream.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/cppsock -ID:/Michi/Programmieren/Libraries/sockethandler-1.0.0/include -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c pregenerator.cpp -o obj/pregenerator.o
+g++ -Wall -O3 -msse2 -std=c++17 -c ../VehiclePath/pathgen.cpp -o obj/pathgen.o
+g++ -Wall -O3 -std=c++17 -c ../VehiclePath/goalfile.cpp -o obj/goalfile.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/stb_master -c ../VehiclePath/pathgen_image.cpp -o obj/pathgen_image.o
+g++ -Wall -O3 -std=c++17 -c ../VehiclePath/polyline.cpp -o obj/polyline.o
+g++ -LC:/CodeBlocks/gcc-8.2-32/i686-pc-mingw32/lib -LD:/Michi/Programmieren/Libraries/sockethandler-1.0.0/lib -LD:/Michi/Programmieren/Libraries/cppsock -o path_server.exe D:/Michi/Programmieren/Libraries/cppsock/cppsock_winonly.cpp obj/main.o obj/packet.o obj/otherpacket.o obj/linkstats.o obj/shm_transport.o obj/generator_pool.o obj/request_queue.o obj/goal_cache.o obj/async_logger.o obj/goal_stream.o obj/pregenerator.o obj/pathgen.o obj/goalfile.o obj/pathgen_image.o obj/polyline.o -lsockethandler -lcppsock -lws2_32 -s
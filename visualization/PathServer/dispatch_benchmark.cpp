@@ -0,0 +1,345 @@
+/******************************************************************************************************************************************
+* Title:        Dispatch benchmark
+* Programtitle: dispatch_benchmark
+* Description:
+*   Load test of the request dispatching of the path server with several clients over loopback (TCP, 127.0.0.1).
+*   The path server needs the socket-handler library, so the benchmark contains a model of its dispatching.
+*   Every client has its own receiver thread (like the socket-handler) and the main thread answers the request on the
+*   connection of the client that sent it. There are two ways to hand the requests over to the main thread:
+*       poll  -> The previous path server: one request at a time (handover mutex, shared packet, packet id),
+*                the main loop checks for a new request every 5 ms.
+*       queue -> The path server now: the receiver threads push the requests into the request queue (request_queue.h),
+*                the main thread sleeps until a request arrives.
+*   Every client requests goals of its own vehicle, one request at a time. The replies are checked:
+*   a reply with the request id or the vehicle id of another client is an error.
+*   For every number of clients the throughput (requests per second) and the distribution
+*   of the time from request to reply (percentiles) are printed.
+*
+*   Command syntax:
+*       dispatch_benchmark [<number of requests per client> [poll | queue]]
+*   Both ways are measured if none is given.
+*
+*   Note: POSIX only.
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "SchwarmPacket/packet.h"
+#include "request_queue.h"
+
+static constexpr uint32_t NUM_GOALS = 500;
+static constexpr int MAIN_LOOP_SLEEP_MS = 5;    // the same as in the main loop of the path server
+
+/*
+*   Receives one whole packet (header first, then the rest).
+*   Return:
+*       'false' if the socket has been closed.
+*/
+static bool recv_packet(int fd, std::vector<uint8_t>& buff)
+{
+    constexpr uint32_t HEADER_SIZE = Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH;
+    buff.resize(HEADER_SIZE);
+    if(recv(fd, buff.data(), HEADER_SIZE, MSG_WAITALL) != HEADER_SIZE)
+        return false;
+    const uint32_t size = *Schwarm::Packet::size_ptr(buff.data());
+    if(size < HEADER_SIZE)
+        return false;
+    buff.resize(size);
+    if(size > HEADER_SIZE && recv(fd, buff.data() + HEADER_SIZE, size - HEADER_SIZE, MSG_WAITALL) != (ssize_t)(size - HEADER_SIZE))
+        return false;
+    return true;
+}
+
+static void set_nodelay(int fd)
+{
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+/*
+*   Model of the path server, the names are the same as in main.cpp.
+*/
+struct Connection
+{
+    int fd{-1};
+    std::mutex send_mutex;
+};
+
+struct SharedVariables
+{
+    std::atomic_bool running{false};
+    std::vector<std::vector<float>> goals;  // x, y of every goal of every vehicle
+
+    // poll
+    std::atomic_int8_t packet_id{-1};
+    Schwarm::GoalReqPacket goalreqpacket;
+    Connection* requester{nullptr};
+    std::mutex handover_mutex;
+
+    // queue
+    RequestQueue requests{1024};
+};
+
+static void send_reply(Connection* connection, Schwarm::Packet& packet)
+{
+    std::lock_guard<std::mutex> lock(connection->send_mutex);
+    packet.allocate(packet.min_size());
+    packet.encode();
+    send(connection->fd, packet.rawdata(), packet.size(), MSG_NOSIGNAL);
+}
+
+// Answers a goal request.
+static void answer(SharedVariables* shared_variables, Connection* requester, const Schwarm::GoalReqPacket& request)
+{
+    const int vehicle_id = request.get_vehicle_id();
+    const uint32_t index = request.get_goal_index();
+    if(vehicle_id < 0 || vehicle_id >= (int)shared_variables->goals.size() || index >= NUM_GOALS)
+    {
+        Schwarm::ErrorPacket packet;
+        packet.set_code(Schwarm::packet_error::PACKET_INVALID_GOAL);
+        packet.set_request_id(request.get_request_id());
+        send_reply(requester, packet);
+    }
+    else
+    {
+        const std::vector<float>& vehicle_goals = shared_variables->goals[vehicle_id];
+        Schwarm::GoalPacket packet;
+        packet.set_goal(vehicle_goals[2 * index], vehicle_goals[2 * index + 1]);
+        packet.set_vehicle_id(vehicle_id);
+        packet.set_request_id(request.get_request_id());
+        send_reply(requester, packet);
+    }
+}
+
+static void wait_for_main_thread(SharedVariables* shared_variables)
+{
+    while(shared_variables->running && shared_variables->packet_id != -1)
+        std::this_thread::yield();
+}
+
+// poll: receiver thread of one connection (on_receive + process_packet).
+static void receiver_poll(SharedVariables* shared_variables, Connection* connection)
+{
+    std::vector<uint8_t> buff;
+    while(recv_packet(connection->fd, buff))
+    {
+        if(Schwarm::Packet::get_id(buff.data()) != Schwarm::GoalReqPacket::PACKET_ID)
+            continue;
+        std::lock_guard<std::mutex> lock(shared_variables->handover_mutex);
+        wait_for_main_thread(shared_variables);
+        if(!shared_variables->running)
+            return;
+        shared_variables->goalreqpacket.allocate(buff.size());
+        shared_variables->goalreqpacket.set(buff.data());
+        if(shared_variables->goalreqpacket.decode() != Schwarm::packet_error::PACKET_NONE)
+            continue;
+        shared_variables->requester = connection;
+        shared_variables->packet_id = shared_variables->goalreqpacket.id();
+    }
+}
+
+// poll: the main loop of the path server (only goal requests).
+static void main_loop_poll(SharedVariables* shared_variables)
+{
+    while(shared_variables->running)
+    {
+        if(shared_variables->packet_id == Schwarm::GoalReqPacket::PACKET_ID)
+        {
+            answer(shared_variables, shared_variables->requester, shared_variables->goalreqpacket);
+            shared_variables->packet_id = -1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(MAIN_LOOP_SLEEP_MS));
+    }
+}
+
+// queue: receiver thread of one connection, only copies the request into the queue.
+static void receiver_queue(SharedVariables* shared_variables, Connection* connection)
+{
+    Request request;
+    while(recv_packet(connection->fd, request.data))
+    {
+        if(Schwarm::Packet::get_id(request.data.data()) != Schwarm::GoalReqPacket::PACKET_ID)
+            continue;
+        request.context = connection;
+        if(!shared_variables->requests.push(request))
+            return;
+    }
+}
+
+// queue: the main loop of the path server, sleeps until a request arrives.
+static void main_loop_queue(SharedVariables* shared_variables)
+{
+    Schwarm::GoalReqPacket goalreqpacket;
+    Request request;
+    while(shared_variables->running && shared_variables->requests.pop(request))
+    {
+        goalreqpacket.allocate(request.data.size());
+        goalreqpacket.set(request.data.data());
+        if(goalreqpacket.decode() == Schwarm::packet_error::PACKET_NONE)
+            answer(shared_variables, (Connection*)request.context, goalreqpacket);
+    }
+}
+
+/*
+*   One client: requests the goals of its vehicle one after another.
+*   The request ids of a client start at (vehicle id << 20), so a reply for another client can be detected.
+*/
+static void client(sockaddr_in addr, int vehicle_id, uint32_t num_requests, std::vector<double>* latencies, std::atomic_uint32_t* errors)
+{
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        (*errors)++;
+        return;
+    }
+    set_nodelay(fd);
+
+    std::vector<uint8_t> buff;
+    Schwarm::GoalReqPacket request;
+    Schwarm::GoalPacket goal;
+    for(uint32_t i = 0; i < num_requests; i++)
+    {
+        const uint32_t request_id = ((uint32_t)vehicle_id << 20) | (i + 1);
+        request.set_vehicle_id(vehicle_id);
+        request.set_goal_index(i % NUM_GOALS);
+        request.set_request_id(request_id);
+        request.allocate(request.min_size());
+        request.encode();
+
+        const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+        send(fd, request.rawdata(), request.size(), MSG_NOSIGNAL);
+        if(!recv_packet(fd, buff))
+        {
+            (*errors)++;
+            break;
+        }
+        latencies->push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+
+        goal.allocate(buff.size());
+        goal.set(buff.data());
+        if(Schwarm::Packet::get_id(buff.data()) != Schwarm::GoalPacket::PACKET_ID || goal.decode() != Schwarm::packet_error::PACKET_NONE ||
+           goal.get_request_id() != request_id || goal.get_vehicle_id() != vehicle_id)
+            (*errors)++;
+    }
+    close(fd);
+}
+
+/*
+*   Runs the server model (poll or queue) and 'num_clients' clients.
+*   Return:
+*       'false' if a reply was missing or went to the wrong client.
+*/
+static bool run(bool queue, int num_clients, uint32_t num_requests)
+{
+    SharedVariables shared_variables;
+    shared_variables.running = true;
+    shared_variables.goals.resize(num_clients);
+    for(int v = 0; v < num_clients; v++)
+    {
+        for(uint32_t i = 0; i < NUM_GOALS; i++)
+        {
+            shared_variables.goals[v].push_back((float)i / NUM_GOALS);
+            shared_variables.goals[v].push_back((float)v / num_clients);
+        }
+    }
+
+    const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;  // any free port
+    socklen_t addrlen = sizeof(addr);
+    if(listen_fd < 0 || bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, num_clients) != 0 ||
+       getsockname(listen_fd, (sockaddr*)&addr, &addrlen) != 0)
+    {
+        perror("listen");
+        return false;
+    }
+
+    std::thread main_thread(queue ? main_loop_queue : main_loop_poll, &shared_variables);
+    std::vector<std::vector<double>> latencies(num_clients);
+    std::atomic_uint32_t errors{0};
+    std::vector<std::thread> clients;
+    const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    for(int c = 0; c < num_clients; c++)
+        clients.emplace_back(client, addr, c, num_requests, &latencies[c], &errors);
+
+    // Accept the clients, every connection gets its own receiver thread.
+    std::vector<Connection*> connections;
+    std::vector<std::thread> receivers;
+    for(int c = 0; c < num_clients; c++)
+    {
+        Connection* connection = new Connection;
+        connection->fd = accept(listen_fd, nullptr, nullptr);
+        set_nodelay(connection->fd);
+        connections.push_back(connection);
+        receivers.emplace_back(queue ? receiver_queue : receiver_poll, &shared_variables, connection);
+    }
+
+    for(std::thread& t : clients)
+        t.join();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    shared_variables.running = false;
+    shared_variables.requests.close();
+    for(Connection* connection : connections)
+        shutdown(connection->fd, SHUT_RDWR);
+    for(std::thread& t : receivers)
+        t.join();
+    main_thread.join();
+    for(Connection* connection : connections)
+    {
+        close(connection->fd);
+        delete(connection);
+    }
+    close(listen_fd);
+
+    std::vector<double> all;
+    for(const std::vector<double>& l : latencies)
+        all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    const uint32_t total = num_clients * num_requests;
+    if(errors > 0 || all.size() != total)
+    {
+        printf("[ERROR] %u wrong or missing replies with %d clients.\n", errors.load(), num_clients);
+        return false;
+    }
+    printf("%s,%d,%u,%.1f,%.0f,%.0f,%.0f,%.0f,%.0f\n", queue ? "queue" : "poll", num_clients, total, ms, total / (ms / 1000.0),
+           all[all.size() / 2], all[(all.size() * 90) / 100], all[(all.size() * 99) / 100], all.back());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t num_requests = (argc > 1) ? (uint32_t)atoi(argv[1]) : 20;
+    const bool run_poll = (argc <= 2 || strcmp(argv[2], "poll") == 0);
+    const bool run_queue = (argc <= 2 || strcmp(argv[2], "queue") == 0);
+
+    printf("dispatch,clients,requests,ms,requests/s,p50 us,p90 us,p99 us,max us\n");
+    const int client_counts[] = {1, 2, 4, 8, 16, 32, 64};
+    for(int mode = 0; mode < 2; mode++)
+    {
+        const bool queue = (mode == 1);
+        if((queue && !run_queue) || (!queue && !run_poll))
+            continue;
+        for(int num_clients : client_counts)
+        {
+            if(!run(queue, num_clients, num_requests))
+                return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+/******************************************************************************************************************************************
+* Title:        Generator load test
+* Programtitle: generator_load_test
+* Description:
+*   Load test of the generator threads of the path server.
+*   Many vehicles request a new path at the same time (several rounds, so some of the waiting jobs are superseded)
+*   while the main thread keeps answering goal requests for random vehicles, like the path server does.
+*   The paths are generated from an image in memory (a thick ring), so no image files are needed.
+*
+*   For every number of generator threads it prints:
+*       ms              -> Time until all paths have been generated.
+*       paths/s         -> Generated paths per second.
+*       answered        -> Goal requests that have been answered with a goal (the others are SERVER_BUSY).
+*       answered (old)  -> Goal requests that would have been answered with a single "generating_path" flag for all vehicles.
+*       p99 us          -> 99th percentile of the time to answer a goal request.
+*
+*   Command syntax:
+*       generator_load_test [<number of vehicles> [<number of rounds> [<maximum number of threads>]]]
+*   The number of threads is doubled from 1 up to the maximum (default: number of cores).
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include "generator_pool.h"
+
+using Goal = Path::ntc_coord_t;
+
+static constexpr uint32_t NUM_GOALS = 500;
+
+/*
+*   Shared between the generator threads and the main thread.
+*/
+struct LoadTest
+{
+    std::vector<uint8_t> image;
+    Path::image_info_t image_info;
+
+    std::mutex goals_mutex;
+    std::map<int, std::vector<Goal>> goals;
+
+    std::atomic_uint32_t outstanding{0};    // Submitted jobs that are not finished and not superseded.
+    std::atomic_uint32_t generated{0};
+    std::atomic_uint32_t failed{0};
+};
+
+static LoadTest* load_test = nullptr;
+
+static std::vector<uint8_t> gen_ring(const Path::image_info_t& ii)
+{
+    std::vector<uint8_t> data(ii.width * ii.height * ii.channels, 0);
+    const float cx = ii.width / 2.0f, cy = ii.height / 2.0f;
+    const float r_out = ((ii.width < ii.height) ? ii.width : ii.height) * 0.4f;
+    const float r_in = r_out * 0.8f;
+    for(int y = 0; y < ii.height; y++)
+    {
+        for(int x = 0; x < ii.width; x++)
+        {
+            const float d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+            if(d2 <= r_out * r_out && d2 >= r_in * r_in)
+                memset(&data[Path::img_at(x, y, ii)], 255, ii.channels);
+        }
+    }
+    return data;
+}
+
+static Path::pathgen_error generate(const GenerateJob& job, std::vector<Goal>& goals, void* user)
+{
+    LoadTest* test = (LoadTest*)user;
+    return Path::generate_goals(test->image.data(), test->image_info, job.num_goals, job.invert, goals);
+}
+
+static void finished(const GenerateJob& job, Path::pathgen_error error, std::vector<Goal>& goals, void* user)
+{
+    LoadTest* test = (LoadTest*)user;
+    if(error == Path::PATHGEN_NONE)
+    {
+        test->goals_mutex.lock();
+        test->goals[job.vehicle_id].swap(goals);
+        test->goals_mutex.unlock();
+        test->generated++;
+    }
+    else
+        test->failed++;
+    test->outstanding--;
+}
+
+/*
+*   Runs the test with a certain number of generator threads.
+*   Return:
+*       'false' if a path could not be generated.
+*/
+static bool run(unsigned int num_workers, int num_vehicles, int num_rounds)
+{
+    LoadTest& test = *load_test;
+    test.goals.clear();
+    test.generated = 0;
+    test.failed = 0;
+    test.outstanding = 0;
+
+    GeneratorPool pool(num_workers, generate, finished, &test);
+    std::vector<double> latencies;
+    uint32_t requests = 0, answered = 0, answered_old = 0, superseded = 0;
+    uint32_t rnd = 12345;
+
+    const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    for(int round = 0; round < num_rounds; round++)
+    {
+        // Every vehicle requests a new path at the same time.
+        for(int v = 0; v < num_vehicles; v++)
+        {
+            GenerateJob job, old_job;
+            job.vehicle_id = v;
+            job.num_goals = NUM_GOALS;
+            job.request_id = round * num_vehicles + v + 1;
+            test.outstanding++;
+            if(pool.submit(job, old_job))
+            {
+                test.outstanding--;
+                superseded++;
+            }
+        }
+
+        // Meanwhile the main thread answers goal requests, the next round starts after a few of them.
+        const uint32_t requests_per_round = (round == num_rounds - 1) ? UINT32_MAX : 200;
+        for(uint32_t i = 0; i < requests_per_round && test.outstanding > 0; i++)
+        {
+            rnd = rnd * 1103515245 + 12345;
+            const int vehicle_id = (rnd >> 8) % num_vehicles;
+            const bool any_busy = test.outstanding > 0;
+
+            const std::chrono::time_point t_req = std::chrono::steady_clock::now();
+            if(!pool.busy(vehicle_id))
+            {
+                test.goals_mutex.lock();
+                const std::vector<Goal>& vehicle_goals = test.goals[vehicle_id];
+                volatile float x = vehicle_goals.empty() ? 0.0f : vehicle_goals[(rnd >> 4) % vehicle_goals.size()].x;
+                (void)x;
+                test.goals_mutex.unlock();
+                answered++;
+                if(!any_busy)
+                    answered_old++;
+            }
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t_req).count());
+            requests++;
+
+            // The path server waits 5 ms between two packets (main loop), here it is 50 us to get more samples.
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    while(test.outstanding > 0)
+        std::this_thread::yield();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    if(test.failed > 0)
+        return false;
+
+    std::sort(latencies.begin(), latencies.end());
+    const double p99 = latencies.empty() ? 0.0 : latencies[(latencies.size() * 99) / 100];
+    printf("%u,%d,%u,%u,%.1f,%.1f,%u,%.1f%%,%.1f%%,%.2f\n", num_workers, num_vehicles, test.generated.load(), superseded, ms,
+           test.generated / (ms / 1000.0), requests, 100.0 * answered / requests, 100.0 * answered_old / requests, p99);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const int num_vehicles = (argc > 1) ? atoi(argv[1]) : 64;
+    const int num_rounds = (argc > 2) ? atoi(argv[2]) : 3;
+
+    load_test = new LoadTest;
+    load_test->image_info = {1280, 720, 3};
+    load_test->image = gen_ring(load_test->image_info);
+
+    printf("threads,vehicles,paths,superseded,ms,paths/s,goal requests,answered,answered (old),p99 us\n");
+    const unsigned int max_workers = (argc > 3) ? (unsigned int)atoi(argv[3]) : std::max(1U, std::thread::hardware_concurrency());
+    for(unsigned int num_workers = 1; num_workers <= max_workers; num_workers *= 2)
+    {
+        if(!run(num_workers, num_vehicles, num_rounds))
+        {
+            printf("[ERROR] Failed to generate a path.\n");
+            delete(load_test);
+            return -1;
+        }
+    }
+    delete(load_test);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "generator_pool.h"
+
+GeneratorPool::GeneratorPool(unsigned int num_workers, generate_func_t generate, finished_func_t finished, void* user)
+{
+    this->stopping = false;
+    this->generate = generate;
+    this->finished = finished;
+    this->user = user;
+
+    if(num_workers == 0)
+        num_workers = 1;
+    for(unsigned int i = 0; i < num_workers; i++)
+        this->workers.emplace_back(&GeneratorPool::work, this);
+}
+
+GeneratorPool::~GeneratorPool(void)
+{
+    this->mtx.lock();
+    this->stopping = true;
+    this->mtx.unlock();
+    this->cv.notify_all();
+
+    for(std::thread& worker : this->workers)
+        worker.join();
+}
+
+bool GeneratorPool::submit(const GenerateJob& job, GenerateJob& superseded)
+{
+    std::unique_lock<std::mutex> lock(this->mtx);
+
+    auto iter = this->waiting.find(job.vehicle_id);
+    if(iter != this->waiting.end())
+    {
+        // The vehicle is already in the ready-queue (or gets in there after its running job), only replace the job.
+        superseded = std::move(iter->second);
+        iter->second = job;
+        return true;
+    }
+
+    this->waiting[job.vehicle_id] = job;
+    // If a job of this vehicle is running, the worker puts the vehicle into the ready-queue after it has finished.
+    if(this->running.count(job.vehicle_id) == 0)
+    {
+        this->ready.push_back(job.vehicle_id);
+        lock.unlock();
+        this->cv.notify_one();
+    }
+    return false;
+}
+
+bool GeneratorPool::busy(int vehicle_id)
+{
+    std::lock_guard<std::mutex> lock(this->mtx);
+    return this->waiting.count(vehicle_id) > 0 || this->running.count(vehicle_id) > 0;
+}
+
+void GeneratorPool::work(void)
+{
+    std::vector<Path::ntc_coord_t> goals;
+    std::unique_lock<std::mutex> lock(this->mtx);
+    while(true)
+    {
+        this->cv.wait(lock, [this](){return this->stopping || !this->ready.empty();});
+        if(this->stopping)
+            return;
+
+        // Take the oldest job that can start.
+        const int vehicle_id = this->ready.front();
+        this->ready.pop_front();
+        auto iter = this->waiting.find(vehicle_id);
+        GenerateJob job = std::move(iter->second);
+        this->waiting.erase(iter);
+        this->running.insert(vehicle_id);
+        lock.unlock();
+
+        // Generate without holding the lock, the other workers can generate the paths of other vehicles.
+        goals.clear();
+        const Path::pathgen_error err = this->generate(job, goals, this->user);
+        this->finished(job, err, goals, this->user);
+
+        lock.lock();
+        this->running.erase(vehicle_id);
+        // A job that has been submitted in the meantime can start now.
+        if(this->waiting.count(vehicle_id) > 0)
+        {
+            this->ready.push_back(vehicle_id);
+            this->cv.notify_one();
+        }
+    }
+}
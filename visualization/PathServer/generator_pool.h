@@ -0,0 +1,133 @@
+#ifndef __generator_pool_h__
+#define __generator_pool_h__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <chrono>
+#include "../VehiclePath/pathgen.h"
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+#else
+    #include <mingw.thread.h>
+    #include <mingw.mutex.h>
+    #include <mingw.condition_variable.h>
+#endif
+
+/*
+*   One path generation for one vehicle.
+*   Members:
+*       vehicle_id -> Vehicle that gets the goals.
+*       filepath -> Image (or command, e.g. "%delete") of the PathGeneratePacket.
+*       num_goals -> Number of goals that should be generated.
+*       invert -> Invert the image to be able to use a white background.
+*       request_id -> Request id of the PathGeneratePacket, is needed for the reply.
+*       context -> Where the reply goes to (e.g. the connection), the pool does not use it.
+*       session -> Session of the context when the job was submitted, e.g. to detect a reconnect of the client.
+*       received -> When the request has been received, to measure the latency of the generation.
+*/
+struct GenerateJob
+{
+    int vehicle_id{0};
+    std::string filepath;
+    uint32_t num_goals{0};
+    bool invert{false};
+    uint32_t request_id{0};
+    void* context{nullptr};
+    uint32_t session{0};
+    std::chrono::steady_clock::time_point received;
+};
+
+/*
+*   Class: GeneratorPool
+*   Worker threads that generate the paths of different vehicles at the same time.
+*   There is at most one job per vehicle in progress, so the goals of a vehicle are always replaced in the order of the requests.
+*   If another job for a vehicle is submitted while its previous job is still waiting, the waiting job is superseded
+*   (only the newest path of a vehicle is of interest). If the previous job is already running, the new one waits for it.
+*/
+class GeneratorPool
+{
+public:
+    /*
+    *   Generates the goals of a job, is called by the worker threads.
+    *   Parameters:
+    *       const GenerateJob& job -> The job.
+    *       std::vector<Path::ntc_coord_t>& goals -> Vector where the goals are written to.
+    *       void* user -> User pointer of the constructor.
+    *   Return:
+    *       PATHGEN_NONE if the goals have been generated.
+    */
+    using generate_func_t = Path::pathgen_error(*)(const GenerateJob&, std::vector<Path::ntc_coord_t>&, void*);
+
+    /*
+    *   Is called by the worker thread after a job has been generated, before the vehicle is not busy anymore.
+    *   The goals can be moved out of the vector.
+    *   Parameters:
+    *       const GenerateJob& job -> The job.
+    *       Path::pathgen_error error -> Return value of the generate function.
+    *       std::vector<Path::ntc_coord_t>& goals -> The generated goals.
+    *       void* user -> User pointer of the constructor.
+    */
+    using finished_func_t = void(*)(const GenerateJob&, Path::pathgen_error, std::vector<Path::ntc_coord_t>&, void*);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<int> ready;                  // Vehicles with a waiting job that can start now, in the order of submission.
+    std::map<int, GenerateJob> waiting;     // At most one waiting job per vehicle.
+    std::set<int> running;                  // Vehicles whose job is generated at the moment.
+    bool stopping;
+
+    generate_func_t generate;
+    finished_func_t finished;
+    void* user;
+
+    // Loop of one worker thread.
+    void work(void);
+
+public:
+    /*
+    *   Starts the worker threads.
+    *   Parameters:
+    *       unsigned int num_workers -> Number of worker threads (at least 1).
+    *       generate_func_t generate -> Generates the goals of a job.
+    *       finished_func_t finished -> Is called after a job has been generated.
+    *       void* user -> Is passed to the generate and the finished function.
+    */
+    GeneratorPool(unsigned int, generate_func_t, finished_func_t, void*);
+
+    GeneratorPool(const GeneratorPool&) = delete;
+    GeneratorPool& operator=(const GeneratorPool&) = delete;
+
+    // Stops the pool, waiting jobs are dropped, running jobs are finished.
+    virtual ~GeneratorPool(void);
+
+    /*
+    *   Adds a job.
+    *   Parameters:
+    *       const GenerateJob& job -> The job.
+    *       GenerateJob& superseded -> Gets the job that has been replaced by the new job.
+    *   Return:
+    *       True if a waiting job of the same vehicle has been superseded, it will never be generated.
+    *       False otherwise.
+    */
+    bool submit(const GenerateJob&, GenerateJob&);
+
+    /*
+    *   Return:
+    *       True if there is a waiting or running job for the vehicle.
+    */
+    bool busy(int);
+
+    // Return: number of worker threads.
+    size_t num_workers(void) const noexcept {return this->workers.size();}
+};
+
+#endif // __generator_pool_h__
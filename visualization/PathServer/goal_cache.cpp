@@ -0,0 +1,169 @@
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include "goal_cache.h"
+#include "../VehiclePath/goalfile.h"
+
+using Goal = Path::ntc_coord_t;
+
+bool GoalCacheKey::operator<(const GoalCacheKey& other) const noexcept
+{
+    if(this->hash != other.hash)
+        return this->hash < other.hash;
+    if(this->size != other.size)
+        return this->size < other.size;
+    if(this->num_goals != other.num_goals)
+        return this->num_goals < other.num_goals;
+    return this->invert < other.invert;
+}
+
+GoalCache::GoalCache(size_t budget, const char* directory)
+{
+    this->budget = budget;
+    if(directory != nullptr)
+        this->directory = directory;
+}
+
+GoalCacheKey GoalCache::make_key(const uint8_t* file, size_t size, uint32_t num_goals, bool invert) noexcept
+{
+    /*  64 bit FNV-1a, but with 8 bytes per step instead of 1 byte.
+    *   Every request is hashed (also the hits), images of several MB are hashed 8 times faster this way.
+    */
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i;
+    for(i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, file + i, sizeof(word));
+        hash ^= word;
+        hash *= FNV_PRIME;
+        hash ^= hash >> 32;     // Mixes the upper bytes of the word into the lower ones, the multiplication only moves bits up.
+    }
+    for(; i < size; i++)
+    {
+        hash ^= file[i];
+        hash *= FNV_PRIME;
+    }
+
+    GoalCacheKey key;
+    key.hash = hash;
+    key.size = size;
+    key.num_goals = num_goals;
+    key.invert = invert;
+    return key;
+}
+
+size_t GoalCache::entry_size(const std::vector<Goal>& goals) noexcept
+{
+    // The goals and about the size of the list and map nodes.
+    return goals.size() * sizeof(Goal) + sizeof(Entry) + 64;
+}
+
+std::string GoalCache::filepath(const GoalCacheKey& key) const
+{
+    char name[96];
+    sprintf(name, "/%016llx_%llu_%u_%d.sgol", (unsigned long long)key.hash, (unsigned long long)key.size, key.num_goals, key.invert ? 1 : 0);
+    return this->directory + name;
+}
+
+void GoalCache::insert(const GoalCacheKey& key, const std::vector<Goal>& goals)
+{
+    const size_t size = entry_size(goals);
+    if(size > this->budget || this->entries.count(key) > 0)
+        return;
+
+    this->lru.emplace_front(key, goals);
+    this->entries[key] = this->lru.begin();
+    this->counters.bytes += size;
+
+    // Remove the least recently used entries until the budget is kept.
+    while(this->counters.bytes > this->budget)
+    {
+        const Entry& oldest = this->lru.back();
+        this->counters.bytes -= entry_size(oldest.second);
+        this->entries.erase(oldest.first);
+        this->lru.pop_back();
+        this->counters.evictions++;
+    }
+}
+
+bool GoalCache::read_file(const GoalCacheKey& key, std::vector<Goal>& goals) const
+{
+    // An entry is a binary goal file with the goals as vehicle 0, it is mapped and copied without parsing.
+    Path::GoalFile file;
+    if(!file.open(this->filepath(key).c_str()))
+        return false;
+
+    uint32_t num_goals;
+    const Goal* file_goals = file.goals(0, num_goals);
+    if(file_goals == nullptr)
+        return false;
+    goals.assign(file_goals, file_goals + num_goals);
+    return true;
+}
+
+bool GoalCache::write_file(const GoalCacheKey& key, const std::vector<Goal>& goals) const
+{
+    /*  Write a temporary file first and rename it after it is complete,
+    *   so an interrupted write (or another thread) never leaves an incomplete entry.
+    */
+    static std::atomic_uint32_t tmp_counter{0};     // Two threads may write the same entry.
+    const std::string path = this->filepath(key);
+    const std::string tmp_path = path + ".tmp" + std::to_string(tmp_counter++);
+
+    const bool ok = Path::write_goalfile(tmp_path.c_str(), 0, goals);
+    remove(path.c_str());   // rename() does not replace an existing file on Windows.
+    if(!ok || rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+        remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool GoalCache::get(const GoalCacheKey& key, std::vector<Goal>& goals)
+{
+    std::unique_lock<std::mutex> lock(this->mtx);
+    auto iter = this->entries.find(key);
+    if(iter != this->entries.end())
+    {
+        // Move the entry to the front, it is the most recently used one now.
+        this->lru.splice(this->lru.begin(), this->lru, iter->second);
+        goals = iter->second->second;
+        this->counters.hits++;
+        return true;
+    }
+    lock.unlock();
+
+    // The file is read without the lock, the other threads can use the entries in memory meanwhile.
+    if(!this->directory.empty() && this->read_file(key, goals))
+    {
+        lock.lock();
+        this->insert(key, goals);
+        this->counters.disk_hits++;
+        return true;
+    }
+
+    lock.lock();
+    this->counters.misses++;
+    return false;
+}
+
+void GoalCache::put(const GoalCacheKey& key, const std::vector<Goal>& goals)
+{
+    this->mtx.lock();
+    this->insert(key, goals);
+    this->mtx.unlock();
+
+    if(!this->directory.empty())
+        this->write_file(key, goals);
+}
+
+GoalCacheStats GoalCache::stats(void)
+{
+    std::lock_guard<std::mutex> lock(this->mtx);
+    GoalCacheStats stats = this->counters;
+    stats.entries = this->entries.size();
+    return stats;
+}
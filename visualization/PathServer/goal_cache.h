@@ -0,0 +1,136 @@
+#ifndef __goal_cache_h__
+#define __goal_cache_h__
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include "../VehiclePath/pathgen.h"
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <mutex>
+#else
+    #include <mingw.mutex.h>
+#endif
+
+/*
+*   Identifies the goals of one path generation.
+*   The image is identified by its content, not by its name, so a changed image file is generated again.
+*   Members:
+*       hash -> FNV-1a hash of the image file.
+*       size -> Size of the image file in bytes.
+*       num_goals -> Number of goals that have been requested.
+*       invert -> The image has been inverted.
+*/
+struct GoalCacheKey
+{
+    uint64_t hash{0};
+    uint64_t size{0};
+    uint32_t num_goals{0};
+    bool invert{false};
+
+    bool operator<(const GoalCacheKey&) const noexcept;
+};
+
+/*
+*   Counters of the cache.
+*   Members:
+*       hits -> Requests that have been answered from memory.
+*       disk_hits -> Requests that have been answered from the cache directory.
+*       misses -> Requests whose goals had to be generated.
+*       evictions -> Entries that have been removed from memory because of the memory budget.
+*       entries -> Number of entries in memory.
+*       bytes -> Memory that is used by the entries.
+*/
+struct GoalCacheStats
+{
+    uint64_t hits{0};
+    uint64_t disk_hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t entries{0};
+    size_t bytes{0};
+};
+
+/*
+*   Class: GoalCache
+*   Stores generated goals, so the same image with the same settings does not have to be processed again.
+*   The entries are kept in memory up to a memory budget, the least recently used ones are removed first.
+*   Optionally every entry is also written to a directory (as binary goal file, see goalfile.h), so the cache survives a restart of the server.
+*   All functions can be called by several threads at the same time.
+*/
+class GoalCache
+{
+private:
+    using Entry = std::pair<GoalCacheKey, std::vector<Path::ntc_coord_t>>;
+
+    std::mutex mtx;
+    std::list<Entry> lru;                                           // The most recently used entry is at the front.
+    std::map<GoalCacheKey, std::list<Entry>::iterator> entries;
+    size_t budget;
+    std::string directory;                                          // Empty if the cache is not persistent.
+    GoalCacheStats counters;
+
+    // Return: memory that is used by an entry.
+    static size_t entry_size(const std::vector<Path::ntc_coord_t>&) noexcept;
+
+    // Return: path of the file of an entry in the cache directory.
+    std::string filepath(const GoalCacheKey&) const;
+
+    // Inserts an entry into memory and removes old entries if the budget is exceeded, the mutex has to be locked.
+    void insert(const GoalCacheKey&, const std::vector<Path::ntc_coord_t>&);
+
+    bool read_file(const GoalCacheKey&, std::vector<Path::ntc_coord_t>&) const;
+    bool write_file(const GoalCacheKey&, const std::vector<Path::ntc_coord_t>&) const;
+
+public:
+    /*
+    *   Parameters:
+    *       size_t budget -> Maximum memory of the entries in bytes.
+    *       const char* directory -> Directory where the entries are stored, 'nullptr' if the cache should only be in memory.
+    *                                The directory has to exist.
+    */
+    GoalCache(size_t, const char*);
+
+    GoalCache(const GoalCache&) = delete;
+    GoalCache& operator=(const GoalCache&) = delete;
+
+    virtual ~GoalCache(void) = default;
+
+    /*
+    *   Creates the key of a path generation.
+    *   Parameters:
+    *       const uint8_t* file -> Content of the image file.
+    *       size_t size -> Size of the image file in bytes.
+    *       uint32_t num_goals -> Number of goals.
+    *       bool invert -> Invert the image.
+    *   Return:
+    *       The key.
+    */
+    static GoalCacheKey make_key(const uint8_t*, size_t, uint32_t, bool) noexcept;
+
+    /*
+    *   Looks for the goals of a key, first in memory and then in the cache directory.
+    *   Parameters:
+    *       const GoalCacheKey& key -> The key.
+    *       std::vector<Path::ntc_coord_t>& goals -> Gets the goals.
+    *   Return:
+    *       True if the goals have been found.
+    */
+    bool get(const GoalCacheKey&, std::vector<Path::ntc_coord_t>&);
+
+    /*
+    *   Stores the goals of a key (in memory and in the cache directory).
+    *   Parameters:
+    *       const GoalCacheKey& key -> The key.
+    *       const std::vector<Path::ntc_coord_t>& goals -> The generated goals.
+    */
+    void put(const GoalCacheKey&, const std::vector<Path::ntc_coord_t>&);
+
+    // Return: the counters of the cache.
+    GoalCacheStats stats(void);
+};
+
+#endif // __goal_cache_h__
@@ -0,0 +1,196 @@
+/******************************************************************************************************************************************
+* Title:        Goal cache benchmark
+* Programtitle: goal_cache_benchmark
+* Description:
+*   Test of the goal cache of the path server with a corpus of images.
+*   The images are generated in memory (ellipses and rectangles of different sizes), the raw pixels are the
+*   "file content" that is hashed, so no image files and no image library are needed.
+*   Operators generate the same images again and again, the requests are therefore drawn with a skewed distribution
+*   (a few images are requested very often) and with a few different numbers of goals.
+*
+*   For every run it prints:
+*       requests        -> Number of path generations.
+*       hits            -> Answered from memory.
+*       disk hits       -> Answered from the cache directory.
+*       misses          -> Generated.
+*       evictions       -> Entries removed because of the memory budget.
+*       ms              -> Time for all requests.
+*       hit us          -> Average time of a request that has been answered by the cache (including the hash).
+*       miss us         -> Average time of a request that has been generated.
+*   The runs are: without cache, with a budget for all images, with a small budget, with a cache directory and
+*   after a "restart" with the same cache directory (new cache, empty memory).
+*   Every goal that comes from the cache is compared with the generated one.
+*
+*   Command syntax:
+*       goal_cache_benchmark [<number of requests> [<cache directory>]]
+*   The cache directory has to exist (default: the current directory).
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include "goal_cache.h"
+
+using Goal = Path::ntc_coord_t;
+
+struct Image
+{
+    Path::image_info_t info;
+    std::vector<uint8_t> data;
+};
+
+struct Request
+{
+    int image;
+    uint32_t num_goals;
+};
+
+// Draws a thick closed line: every pixel whose "distance" d(x, y) is between 0.9 and 1.0.
+template<typename dist_func>
+static Image gen_image(int width, int height, dist_func d)
+{
+    Image image;
+    image.info = {width, height, 3};
+    image.data.assign(width * height * 3, 0);
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            const float v = d((x - width / 2.0f) / (width * 0.4f), (y - height / 2.0f) / (height * 0.4f));
+            if(v >= 0.9f && v <= 1.0f)
+                memset(&image.data[Path::img_at(x, y, image.info)], 255, 3);
+        }
+    }
+    return image;
+}
+
+static std::vector<Image> gen_corpus(void)
+{
+    std::vector<Image> corpus;
+    const int sizes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}};
+    for(const auto& size : sizes)
+    {
+        corpus.push_back(gen_image(size[0], size[1], [](float x, float y){return std::sqrt(x * x + y * y);}));                     // ellipse
+        corpus.push_back(gen_image(size[0], size[1], [](float x, float y){return std::fmax(std::fabs(x), std::fabs(y));}));       // rectangle
+        corpus.push_back(gen_image(size[0], size[1], [](float x, float y){return std::sqrt(x * x * 1.5f + y * y * 0.7f);}));       // other ellipse
+        corpus.push_back(gen_image(size[0], size[1], [](float x, float y){return std::pow(x * x * x * x + y * y * y * y, 0.25f);})); // rounded rectangle
+    }
+    return corpus;
+}
+
+/*
+*   Runs the requests.
+*   Parameters:
+*       cache -> The cache, 'nullptr' to generate every request.
+*       reference -> The goals of every request without cache, is filled if cache is 'nullptr'.
+*   Return:
+*       'false' if goals from the cache are not the generated ones.
+*/
+static bool run(const char* name, GoalCache* cache, const std::vector<Image>& corpus, const std::vector<Request>& requests, std::vector<std::vector<Goal>>& reference)
+{
+    double hit_us = 0.0, miss_us = 0.0;
+    uint32_t hits = 0, misses = 0;
+    std::vector<Goal> goals;
+
+    if(cache == nullptr)
+        reference.resize(requests.size());
+    const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < requests.size(); i++)
+    {
+        const Image& image = corpus[requests[i].image];
+        const std::chrono::time_point t_req = std::chrono::steady_clock::now();
+        bool hit = false;
+        GoalCacheKey key;
+        if(cache != nullptr)
+        {
+            key = GoalCache::make_key(image.data.data(), image.data.size(), requests[i].num_goals, false);
+            hit = cache->get(key, goals);
+        }
+        if(!hit)
+        {
+            if(Path::generate_goals(image.data.data(), image.info, requests[i].num_goals, false, goals) != Path::PATHGEN_NONE)
+            {
+                printf("[ERROR] Failed to generate image %d.\n", requests[i].image);
+                return false;
+            }
+            if(cache != nullptr)
+                cache->put(key, goals);
+        }
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t_req).count();
+        if(hit)
+        {
+            hit_us += us;
+            hits++;
+        }
+        else
+        {
+            miss_us += us;
+            misses++;
+        }
+
+        if(cache == nullptr)
+            reference[i] = goals;
+        else if(goals.size() != reference[i].size() || memcmp(goals.data(), reference[i].data(), goals.size() * sizeof(Goal)) != 0)
+        {
+            printf("[ERROR] %s: goals of request %u are wrong.\n", name, (uint32_t)i);
+            return false;
+        }
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    GoalCacheStats stats;
+    if(cache != nullptr)
+        stats = cache->stats();
+    else
+        stats.misses = misses;
+    printf("%s,%u,%llu,%llu,%llu,%llu,%.1f,%.1f,%.1f\n", name, (uint32_t)requests.size(), (unsigned long long)stats.hits, (unsigned long long)stats.disk_hits,
+           (unsigned long long)stats.misses, (unsigned long long)stats.evictions, ms, hits ? hit_us / hits : 0.0, misses ? miss_us / misses : 0.0);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t num_requests = (argc > 1) ? (uint32_t)atoi(argv[1]) : 300;
+    const char* directory = (argc > 2) ? argv[2] : ".";
+
+    const std::vector<Image> corpus = gen_corpus();
+    const uint32_t goal_counts[] = {100, 250, 500};
+
+    // Skewed distribution: image i is requested about twice as often as image i + 1.
+    std::vector<Request> requests;
+    uint32_t rnd = 12345;
+    for(uint32_t i = 0; i < num_requests; i++)
+    {
+        rnd = rnd * 1103515245 + 12345;
+        int image = 0;
+        while(image < (int)corpus.size() - 1 && ((rnd >> (8 + image)) & 1))
+            image++;
+        requests.push_back({image, goal_counts[(rnd >> 4) % 3]});
+    }
+
+    printf("run,requests,hits,disk hits,misses,evictions,ms,hit us,miss us\n");
+    std::vector<std::vector<Goal>> reference;
+    if(!run("no cache", nullptr, corpus, requests, reference))
+        return -1;
+
+    GoalCache* cache = new GoalCache(64 * 1024 * 1024, nullptr);
+    bool ok = run("memory 64 MB", cache, corpus, requests, reference);
+    delete(cache);
+
+    // About the goals of 8 requests.
+    cache = new GoalCache(8 * (250 * sizeof(Goal) + 128), nullptr);
+    ok = ok && run("memory 16 kB", cache, corpus, requests, reference);
+    delete(cache);
+
+    cache = new GoalCache(64 * 1024 * 1024, directory);
+    ok = ok && run("directory", cache, corpus, requests, reference);
+    delete(cache);
+
+    cache = new GoalCache(64 * 1024 * 1024, directory);
+    ok = ok && run("directory (restart)", cache, corpus, requests, reference);
+    delete(cache);
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,49 @@
+#include <algorithm>
+#include "goal_stream.h"
+
+GoalStream::GoalStream(void) : GoalStream(0, 0, 0, 0)
+{
+}
+
+GoalStream::GoalStream(uint32_t start, uint32_t window, uint32_t request_id, uint32_t version)
+{
+    this->window = std::min(window, MAX_WINDOW);
+    this->request_id = request_id;
+    this->version = version;
+    this->sent = start;
+    this->acked = start;
+}
+
+void GoalStream::acknowledge(uint32_t next_index) noexcept
+{
+    // The acknowledgements are sent without waiting, an old one can arrive after a restart.
+    if(next_index > this->acked)
+        this->acked = std::min(next_index, this->sent);
+}
+
+void GoalStream::restart(uint32_t version) noexcept
+{
+    this->version = version;
+    this->sent = 0;
+    this->acked = 0;
+}
+
+uint32_t GoalStream::next_list(int vehicle_id, const Path::ntc_coord_t* goals, uint32_t num_goals, Schwarm::GoalListPacket& packet) noexcept
+{
+    if(this->sent >= num_goals)
+        return 0;   // The whole path has been pushed.
+
+    const uint32_t credit = this->acked + this->window - this->sent;
+    const uint32_t count = std::min(credit, num_goals - this->sent);
+    if(count == 0 || (count < this->window / 2 && this->sent + count < num_goals))
+        return 0;   // Wait for more acknowledgements.
+
+    packet.set_vehicle_id(vehicle_id);
+    packet.set_start_index(this->sent);
+    packet.set_total_goals(num_goals);
+    packet.is_end_of_path() = (this->sent + count == num_goals);
+    packet.set_request_id(this->request_id);
+    packet.set_goals((const float*)(goals + this->sent), count);    // Goal is a packed pair of floats.
+    this->sent += count;
+    return count;
+}
@@ -0,0 +1,70 @@
+#ifndef __goal_stream_h__
+#define __goal_stream_h__
+
+#include <cstdint>
+#include "SchwarmPacket/packet.h"
+#include "../VehiclePath/pathgen.h"
+
+/*
+*   Class: GoalStream
+*   State of one goal subscription (GoalSubscribePacket): which goals have been pushed to the client
+*   and which ones the client has used (GoalAckPacket).
+*
+*   Flow control: at most 'window' goals are pushed ahead of the acknowledged goals, so one subscription never
+*   has more than one window in the send buffer of the server or in the memory of the client.
+*   A goal list is only pushed if at least half a window (or the rest of the path) can be sent, so the client
+*   gets a few big lists instead of one small list per acknowledgement.
+*/
+class GoalStream
+{
+private:
+    uint32_t window;
+    uint32_t request_id;
+    uint32_t version;   // Version of the goals that are streamed, the stream restarts if the vehicle gets a new path.
+    uint32_t sent;      // Index of the next goal that is pushed.
+    uint32_t acked;     // The client has used the goals before this index.
+
+public:
+    static constexpr uint32_t MAX_WINDOW = Schwarm::GoalListPacket::MAX_GOALS;
+
+    GoalStream(void);
+
+    /*
+    *   Parameters:
+    *       uint32_t start -> Index of the first goal that is pushed.
+    *       uint32_t window -> Maximum number of goals that are pushed ahead, is limited to MAX_WINDOW.
+    *       uint32_t request_id -> Request id of the subscription, the pushed lists carry it.
+    *       uint32_t version -> Version of the goals of the vehicle.
+    */
+    GoalStream(uint32_t, uint32_t, uint32_t, uint32_t);
+
+    /*
+    *   The client has used the goals before an index.
+    *   Old acknowledgements and indices of goals that have not been pushed yet are ignored.
+    */
+    void acknowledge(uint32_t) noexcept;
+
+    // The vehicle has a new path (version), it is streamed from the beginning.
+    void restart(uint32_t) noexcept;
+
+    /*
+    *   Fills the next goal list of the subscription.
+    *   Parameters:
+    *       int vehicle_id -> The vehicle of the subscription.
+    *       const Path::ntc_coord_t* goals -> All goals of the vehicle.
+    *       uint32_t num_goals -> Number of goals of the vehicle.
+    *       Schwarm::GoalListPacket& packet -> Gets the goals, the values of the list and the request id (not allocated and encoded).
+    *   Return:
+    *       Number of goals in the list, 0 if nothing has to be pushed now.
+    */
+    uint32_t next_list(int, const Path::ntc_coord_t*, uint32_t, Schwarm::GoalListPacket&) noexcept;
+
+    uint32_t get_request_id(void)   const noexcept {return this->request_id;}
+    uint32_t get_version(void)      const noexcept {return this->version;}
+    uint32_t get_window(void)       const noexcept {return this->window;}
+
+    // Return: number of goals that have been pushed but not acknowledged yet.
+    uint32_t in_flight(void)        const noexcept {return this->sent - this->acked;}
+};
+
+#endif // __goal_stream_h__
@@ -0,0 +1,303 @@
+/******************************************************************************************************************************************
+* Title:        Goal stream benchmark
+* Programtitle: goal_stream_benchmark
+* Description:
+*   Loopback test of the goal subscriptions (GoalSubscribePacket / GoalAckPacket) compared to goal range requests.
+*   A server thread answers over a local stream socket (socketpair) from the goals of several vehicles, the subscriptions
+*   use the GoalStream of the path server. The client drives all vehicles like the GUI: every tick every vehicle takes
+*   its next goal, then the client sleeps for the rest of the tick.
+*       range       -> If a vehicle has used all goals of its window, the client requests the next window and waits.
+*       stream      -> The client subscribes every vehicle once and acknowledges the goals after half a window.
+*                      It only waits if the pushed goals of a vehicle have not arrived yet.
+*   For every mode it prints the round-trips (the client waits for the server), the packets of the client, the largest
+*   number of goals that the server had in flight for one subscription and the time of the whole traversal.
+*
+*   Command syntax:
+*       goal_stream_benchmark [<number of vehicles> [<number of goals> [<tick in us>]]]
+*
+*   Note: POSIX only (socketpair).
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "goal_stream.h"
+
+using Goal = Path::ntc_coord_t;
+
+/*
+*   Receives one whole packet (header first, then the rest).
+*   Parameters:
+*       bool wait -> If false, only a packet that has (at least partly) arrived is received.
+*   Return:
+*       'false' if there is no packet or the socket has been closed.
+*/
+static bool recv_packet(int fd, std::vector<uint8_t>& buff, bool wait = true)
+{
+    constexpr uint32_t HEADER_SIZE = Schwarm::Packet::SIZE_ID + Schwarm::Packet::SIZE_PACKET_LENGTH;
+    buff.resize(HEADER_SIZE);
+    if(!wait && recv(fd, buff.data(), HEADER_SIZE, MSG_PEEK | MSG_DONTWAIT) <= 0)
+        return false;
+    if(recv(fd, buff.data(), HEADER_SIZE, MSG_WAITALL) != HEADER_SIZE)
+        return false;
+    const uint32_t size = *Schwarm::Packet::size_ptr(buff.data());
+    buff.resize(size);
+    if(size > HEADER_SIZE && recv(fd, buff.data() + HEADER_SIZE, size - HEADER_SIZE, MSG_WAITALL) != (ssize_t)(size - HEADER_SIZE))
+        return false;
+    return true;
+}
+
+static void send_packet(int fd, Schwarm::Packet& packet, uint32_t data_size = 0)
+{
+    packet.allocate(packet.min_size() + data_size);
+    packet.encode();
+    send(fd, packet.rawdata(), packet.size(), 0);
+}
+
+struct ServerStats
+{
+    uint32_t max_in_flight{0};
+};
+
+static void server(int fd, const std::vector<std::vector<Goal>>* goals, ServerStats* stats)
+{
+    std::vector<uint8_t> buff;
+    Schwarm::GoalRangeReqPacket rangereq;
+    Schwarm::GoalSubscribePacket subscribe;
+    Schwarm::GoalAckPacket ack;
+    Schwarm::GoalListPacket list;
+    std::map<int, GoalStream> streams;
+
+    while(recv_packet(fd, buff))
+    {
+        const uint8_t id = Schwarm::Packet::get_id(buff.data());
+        int vehicle_id = -1;
+        if(id == Schwarm::GoalRangeReqPacket::PACKET_ID)
+        {
+            // The same as the path server (without the errors, the client only requests valid goals).
+            rangereq.allocate(buff.size());
+            rangereq.set(buff.data());
+            rangereq.decode();
+            const std::vector<Goal>& vehicle_goals = goals->at(rangereq.get_vehicle_id());
+            const uint32_t start = rangereq.get_start_index();
+            const uint32_t count = std::min<uint32_t>({rangereq.get_count(), Schwarm::GoalListPacket::MAX_GOALS, (uint32_t)vehicle_goals.size() - start});
+            list.set_vehicle_id(rangereq.get_vehicle_id());
+            list.set_start_index(start);
+            list.set_total_goals(vehicle_goals.size());
+            list.is_end_of_path() = (start + count == vehicle_goals.size());
+            list.set_request_id(rangereq.get_request_id());
+            list.set_goals((const float*)(vehicle_goals.data() + start), count);
+            send_packet(fd, list, list.goals_size());
+            continue;
+        }
+        else if(id == Schwarm::GoalSubscribePacket::PACKET_ID)
+        {
+            subscribe.allocate(buff.size());
+            subscribe.set(buff.data());
+            subscribe.decode();
+            vehicle_id = subscribe.get_vehicle_id();
+            streams[vehicle_id] = GoalStream(subscribe.get_start_index(), subscribe.get_window(), subscribe.get_request_id(), 0);
+        }
+        else if(id == Schwarm::GoalAckPacket::PACKET_ID)
+        {
+            ack.allocate(buff.size());
+            ack.set(buff.data());
+            ack.decode();
+            vehicle_id = ack.get_vehicle_id();
+            streams[vehicle_id].acknowledge(ack.get_next_index());
+        }
+        else
+            continue;
+
+        // Push the next goals of the subscription (push_goals() of the path server).
+        GoalStream& stream = streams[vehicle_id];
+        const std::vector<Goal>& vehicle_goals = goals->at(vehicle_id);
+        if(stream.next_list(vehicle_id, vehicle_goals.data(), vehicle_goals.size(), list) > 0)
+            send_packet(fd, list, list.goals_size());
+        stats->max_in_flight = std::max(stats->max_in_flight, stream.in_flight());
+    }
+}
+
+/*
+*   The goals of one vehicle that the client has received.
+*/
+struct VehicleGoals
+{
+    std::deque<Goal> goals;
+    uint32_t received{0};   // Index of the next goal that is received.
+    uint32_t used{0};       // Index of the next goal that is driven.
+    uint32_t acked{0};      // The server knows that the goals before this index have been used.
+    bool end_of_path{false};
+};
+
+struct ClientStats
+{
+    unsigned int round_trips{0};
+    unsigned int packets{0};
+    double checksum{0.0};
+    bool ok{true};
+};
+
+// Adds a received goal list to the goals of its vehicle.
+static void receive_list(const std::vector<uint8_t>& buff, std::vector<VehicleGoals>& vehicles, ClientStats& stats)
+{
+    Schwarm::GoalListPacket list;
+    list.allocate(buff.size());
+    list.set((uint8_t*)buff.data());
+    if(Schwarm::Packet::get_id(buff.data()) != Schwarm::GoalListPacket::PACKET_ID || list.decode() != Schwarm::PACKET_NONE)
+    {
+        stats.ok = false;
+        return;
+    }
+    VehicleGoals& vehicle = vehicles.at(list.get_vehicle_id());
+    if(list.get_start_index() != vehicle.received)
+        stats.ok = false;   // A goal is missing or has been sent twice.
+    for(uint32_t i = 0; i < list.get_num_goals(); i++)
+        vehicle.goals.push_back({list.get_goal_x(i), list.get_goal_y(i)});
+    vehicle.received += list.get_num_goals();
+    vehicle.end_of_path = list.is_end_of_path();
+}
+
+static void wait_tick(int tick_us)
+{
+    // The rest of the tick (the time after the vehicles have been moved), a wait for the server makes the tick longer.
+    std::this_thread::sleep_for(std::chrono::microseconds(tick_us));
+}
+
+static ClientStats traverse(int fd, bool stream, uint32_t window, size_t num_vehicles, int tick_us)
+{
+    std::vector<VehicleGoals> vehicles(num_vehicles);
+    std::vector<uint8_t> buff;
+    ClientStats stats;
+    uint32_t request_id = 1;
+
+    if(stream)
+    {
+        for(size_t v = 0; v < num_vehicles; v++)
+        {
+            Schwarm::GoalSubscribePacket subscribe;
+            subscribe.set_vehicle_id(v);
+            subscribe.set_start_index(0);
+            subscribe.set_window(window);
+            subscribe.set_request_id(request_id++);
+            send_packet(fd, subscribe);
+            stats.packets++;
+        }
+    }
+
+    size_t finished = 0;
+    while(finished < num_vehicles && stats.ok)
+    {
+        // Take the goals that have been pushed meanwhile.
+        while(stream && recv_packet(fd, buff, false))
+            receive_list(buff, vehicles, stats);
+
+        for(size_t v = 0; v < num_vehicles; v++)
+        {
+            VehicleGoals& vehicle = vehicles[v];
+            if(vehicle.goals.empty())
+            {
+                if(vehicle.end_of_path)
+                    continue;   // Already finished.
+                if(!stream)
+                {
+                    Schwarm::GoalRangeReqPacket request;
+                    request.set_vehicle_id(v);
+                    request.set_start_index(vehicle.received);
+                    request.set_count(window);
+                    request.set_request_id(request_id++);
+                    send_packet(fd, request);
+                    stats.packets++;
+                }
+                // Wait for the goals of this vehicle.
+                stats.round_trips++;
+                while(vehicle.goals.empty() && stats.ok && recv_packet(fd, buff))
+                    receive_list(buff, vehicles, stats);
+                if(!stats.ok)
+                    break;
+            }
+
+            // Drive to the next goal.
+            const Goal goal = vehicle.goals.front();
+            vehicle.goals.pop_front();
+            vehicle.used++;
+            stats.checksum += goal.x + goal.y;
+            if(vehicle.goals.empty() && vehicle.end_of_path)
+                finished++;
+
+            if(stream && vehicle.used - vehicle.acked >= window / 2 && !(vehicle.goals.empty() && vehicle.end_of_path))
+            {
+                Schwarm::GoalAckPacket ack;
+                ack.set_vehicle_id(v);
+                ack.set_next_index(vehicle.used);
+                send_packet(fd, ack);
+                stats.packets++;
+                vehicle.acked = vehicle.used;
+            }
+        }
+        wait_tick(tick_us);
+    }
+    return stats;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t num_vehicles = (argc > 1) ? (size_t)atoi(argv[1]) : 8;
+    const uint32_t num_goals = (argc > 2) ? (uint32_t)atoi(argv[2]) : 5000;
+    const int tick_us = (argc > 3) ? atoi(argv[3]) : 100;
+
+    // Paths of different lengths.
+    std::vector<std::vector<Goal>> goals(num_vehicles);
+    for(size_t v = 0; v < num_vehicles; v++)
+    {
+        const uint32_t n = num_goals + (uint32_t)v * 37;
+        for(uint32_t i = 0; i < n; i++)
+            goals[v].push_back({(float)i / n, (float)v / num_vehicles});
+    }
+
+    printf("vehicles,goals,mode,window,round-trips,client packets,max in flight,ms\n");
+    double reference = -1.0;
+    const uint32_t windows[] = {16, 64, 256};
+    for(uint32_t window : windows)
+    {
+        for(int mode = 0; mode < 2; mode++)
+        {
+            int fds[2];
+            if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            {
+                perror("socketpair");
+                return -1;
+            }
+            ServerStats server_stats;
+            std::thread server_thread(server, fds[1], &goals, &server_stats);
+
+            const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+            const ClientStats stats = traverse(fds[0], mode == 1, window, num_vehicles, tick_us);
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+            shutdown(fds[0], SHUT_RDWR);
+            server_thread.join();
+            close(fds[0]);
+            close(fds[1]);
+
+            if(reference < 0.0)
+                reference = stats.checksum;
+            if(!stats.ok || stats.checksum != reference)
+            {
+                printf("[ERROR] The goals of the %s mode differ.\n", (mode == 1) ? "stream" : "range");
+                return -1;
+            }
+            printf("%u,%u,%s,%u,%u,%u,%u,%.1f\n", (uint32_t)num_vehicles, num_goals, (mode == 1) ? "stream" : "range", window,
+                   stats.round_trips, stats.packets, (mode == 1) ? server_stats.max_in_flight : window, ms);
+        }
+    }
+    return 0;
+}
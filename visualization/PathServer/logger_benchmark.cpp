@@ -0,0 +1,130 @@
+/******************************************************************************************************************************************
+* Title:        Logger benchmark
+* Programtitle: logger_benchmark
+* Description:
+*   Measures the time that a thread spends for one log message (ns per call):
+*       fprintf     -> The previous logging of the path server: local time to "hh:mm:ss" and fprintf into the log file.
+*       async       -> AsyncLogger::log(), the message is written by the background thread.
+*       filtered    -> AsyncLogger::log() with a level below the minimum level.
+*   Every message is the same as a "Sent goal" message of the path server (3 numbers) and a "path generation" message
+*   (a string and 2 numbers). It is measured with 1 to the given number of threads that log at the same time.
+*   The logger has as many records as the one of the path server (LOG_BUFFER_SIZE), the messages are sent in bursts of 1000 with a pause in between
+*   (like the requests of the clients), the dropped messages are counted.
+*
+*   Command syntax:
+*       logger_benchmark [<number of bursts> [<maximum number of threads>]]
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <algorithm>
+#include "async_logger.h"
+
+static constexpr char LOG_PATH[] = "logger_benchmark.txt";
+static constexpr int BURST = 1000;
+static constexpr size_t LOG_BUFFER_SIZE = 16384;     // The same as in main.cpp.
+
+// The previous gettime() of the path server (portable version).
+static void gettime(char* timestr)
+{
+    const time_t timenow = time(nullptr);
+    const tm* local_time = localtime(&timenow);
+    char hour_str[8], min_str[8], sec_str[8];
+    sprintf(hour_str,   ((local_time->tm_hour < 10) ? "0%hd": "%hd"), (int16_t)local_time->tm_hour);
+    sprintf(min_str,    ((local_time->tm_min < 10)  ? "0%hd": "%hd"), (int16_t)local_time->tm_min);
+    sprintf(sec_str,    ((local_time->tm_sec < 10)  ? "0%hd": "%hd"), (int16_t)local_time->tm_sec);
+    sprintf(timestr,    "%s:%s:%s", hour_str, min_str, sec_str);
+}
+
+enum benchmark_mode {MODE_FPRINTF, MODE_ASYNC, MODE_FILTERED};
+
+static void log_burst(int mode, FILE* file, AsyncLogger* logger, int thread_id, int i0)
+{
+    char time[48];
+    int i;
+    for(i = i0; i < i0 + BURST; i++)
+    {
+        const char* filepath = (i & 1) ? "images/ring.png" : "images/rectangle.png";
+        if(mode == MODE_FPRINTF)
+        {
+            gettime(time);
+            if(i % 8 == 0)
+                fprintf(file, "[%s] [INFO] Received path generation for file %s with %u goals for vehicle %d.\n", time, filepath, (uint32_t)i, thread_id);
+            else
+                fprintf(file, "[%s] [INFO] Sent goal with index %u for vehicle %d.\n", time, (uint32_t)i, thread_id);
+        }
+        else
+        {
+            const AsyncLogger::log_level level = (mode == MODE_FILTERED) ? AsyncLogger::LOG_DEBUG : AsyncLogger::LOG_INFO;
+            if(i % 8 == 0)
+                logger->log(level, "Received path generation for file %s with %u goals for vehicle %d.", filepath, (uint32_t)i, thread_id);
+            else
+                logger->log(level, "Sent goal with index %u for vehicle %d.", (uint32_t)i, thread_id);
+        }
+    }
+}
+
+/*
+*   Return:
+*       Average time per call in ns.
+*/
+static double run(int mode, int num_threads, int num_bursts, uint64_t& dropped)
+{
+    FILE* file = fopen(LOG_PATH, "w");
+    AsyncLogger* logger = (mode == MODE_FPRINTF) ? nullptr : new AsyncLogger(file, LOG_BUFFER_SIZE);
+    if(logger != nullptr && mode == MODE_FILTERED)
+        logger->set_level(AsyncLogger::LOG_INFO);
+
+    std::vector<double> ns(num_threads, 0.0);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < num_threads; t++)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for(int b = 0; b < num_bursts; b++)
+            {
+                const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+                log_burst(mode, file, logger, t, b * BURST);
+                ns[t] += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));  // Pause between the bursts.
+            }
+        });
+    }
+    for(std::thread& thread : threads)
+        thread.join();
+
+    dropped = 0;
+    if(logger != nullptr)
+    {
+        dropped = logger->num_dropped();
+        delete(logger);
+    }
+    fclose(file);
+
+    double sum = 0.0;
+    for(double v : ns)
+        sum += v;
+    return sum / ((double)num_threads * num_bursts * BURST);
+}
+
+int main(int argc, char** argv)
+{
+    const int num_bursts = (argc > 1) ? atoi(argv[1]) : 50;
+    const int max_threads = (argc > 2) ? atoi(argv[2]) : 4;
+    const char* const names[] = {"fprintf", "async", "filtered"};
+
+    printf("logging,threads,messages,ns per call,dropped\n");
+    for(int mode = MODE_FPRINTF; mode <= MODE_FILTERED; mode++)
+    {
+        for(int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+        {
+            uint64_t dropped;
+            const double ns = run(mode, num_threads, num_bursts, dropped);
+            printf("%s,%d,%d,%.1f,%llu\n", names[mode], num_threads, num_threads * num_bursts * BURST, ns, (unsigned long long)dropped);
+        }
+    }
+    remove(LOG_PATH);
+    return 0;
+}
@@ -6,11 +6,31 @@
 * Description:
 *   The program sends goal information via sockets after a request from a client.
 *   The generation of the goals is also a server-side operarion.
+*   The goals are generated in the server process with the path generator library (VehiclePath/pathgen.h).
+*   The paths of different vehicles are generated at the same time by a pool of worker threads, meanwhile
+*   the goals of the other vehicles can still be requested.
+*   Several clients can be connected at the same time, every reply is sent to the client that sent the request.
+*   Generated goals are cached (by the content of the image, the number of goals and invert), so generating
+*   the same image again is answered without processing the image.
+*   The log file is written by a background thread, logging only costs the threads a copy of the message arguments.
+*   Instead of requesting every goal list, a client can subscribe the goals of a vehicle (GoalSubscribePacket),
+*   they are pushed in windows as the client acknowledges the goals it has used (GoalAckPacket).
+*   The goals of all images of the image folder can be generated in advance (at the start and whenever an image is
+*   added or changed), so even the first request of an image is answered from the cache.
+*   The file of a generate request can also be a vector drawing (polyline text file or SVG, see VehiclePath/polyline.h),
+*   its goals are sampled from the polylines directly without rasterizing and tracing it.
+*   Clients on the same machine can connect through shared memory instead of the socket (Schwarm::shm_connect),
+*   the packets are the same, every shared-memory connection is served by its own thread.
 *
 *   Command syntax:
-*       path_server.exe <path to image folder> [<flags>]
+*       path_server.exe <path to image folder> [<maximum number of clients> [<cache size in MB> [<cache directory>]]] [-pregen <numbers of goals>]
 *   Command flags:
-*       command has no flags
+*       -pregen -> Generate the goals of every image of the image folder for the given numbers of goals
+*                  (comma-separated, e.g. 100,250,500) into the cache. Needs the cache.
+*                  The goals of the inverted images are generated too after the first request of an inverted image.
+*   The maximum number of clients is 64 by default.
+*   The cache size is 64 MB by default, 0 disables the cache. If a cache directory is given, the cached goals
+*   are also stored there and can be used after a restart of the server. The directory is created if it does not exist.
 *
 *   Return values:
 *       0 -> Success!
@@ -44,39 +64,104 @@
 #include <atomic>   // for atomic variables
 #include <vector>   // for the vector container
 #include <map>      // for the map container
+#include <algorithm> // for std::min
 #include <dirent.h> // for directory operations
 #include <direct.h> // for directory operations
+#include <chrono>   // for time measurement
 #include "SchwarmPacket/packet.h"
+#include "SchwarmPacket/linkstats.h"
+#include "SchwarmPacket/shm_transport.h"
+#include "../VehiclePath/pathgen_image.h"   // for the generation of the goals
+#include "../VehiclePath/polyline.h"        // for the goals of vector drawings
+#include "generator_pool.h"                 // worker threads for the generation of the goals
+#include "request_queue.h"                  // hands the requests over to the main thread
+#include "goal_cache.h"                     // cache of the generated goals
+#include "async_logger.h"                   // writes the log file in the background
+#include "goal_stream.h"                    // goal subscriptions
+#include "pregenerator.h"                   // generates the goals of the image folder in advance
 
+#define SERVER_PORT 10000
+#define SHM_SLOTS 8             // maximum number of local clients that use the shared memory
 #define MIN_ARGLENGTH 2 // minimum argument length of the command
+#define MAX_ARGLENGTH 5 // maximum argument length of the command (without the flags)
+#define DEFAULT_MAX_CLIENTS 64
+#define DEFAULT_CACHE_SIZE_MB 64
+#define REQUEST_QUEUE_SIZE 1024 // maximum number of requests that wait for the main thread
+#define LOG_BUFFER_SIZE 16384   // maximum number of log messages that wait for the background thread
+#define MAX_SUBSCRIPTIONS 256   // maximum number of goal subscriptions of one client
 
 /*
-*   This struct's purpose is to share data between multiple threads.
-*   More precisely the main and the socket threads.
+*   Struct to store and have an easier access to X and Y values.
+*       float x -> X value of the coordinate.
+*       float y -> Y value of the coordinate.
+*   The goals are stored in the same format as the path generator library returns them.
 */
 
-struct SharedVariables
+using Goal = Path::ntc_coord_t;
+
+/*
+*   The state of one client connection.
+*   The socket-handler has a fixed number of sockets, the connection of a socket is reused when the next
+*   client connects to it. Replies of requests from the previous client are not sent to the new one (session).
+*/
+
+struct Connection
 {
-    std::atomic_bool running{false};            // Is used to set the running sate of the main thread.
-    std::atomic_bool generating_path{false};    // Is used to determine if the server is currently generating a path from an image file.
-    std::atomic_int8_t packet_id{-1};           // Is used to be able to process the packet in the main thread.
+    cppsock::socket* socket{nullptr};
+    Schwarm::ShmEndpoint* shm{nullptr};         // Shared memory of a local client instead of the socket, is guarded by the send mutex.
+    std::atomic_uint32_t session{0};            // Is incremented for every client that connects to the socket.
+    std::atomic_bool connected{false};
 
-    // Raw data that gets shared between threads.
-    Schwarm::PathGeneratePacket pathgenpacket;
-    Schwarm::GoalReqPacket goalreqpacket;
+    /*  Sequence numbers and timestamps (extended header).
+    *   The replies only carry the extended header if the client sends it, old clients keep working.
+    */
+    std::atomic_bool ext_header{false};
+    Schwarm::LinkStats recv_stats;              // Packets from the client, only used by the receiver thread of the socket.
+    Schwarm::LinkStats send_stats;              // Numbers the replies.
+    std::mutex send_mutex;                      // The replies are sent by the main and the generator threads.
 
-    FILE* logfile;
+    /*  Goal subscriptions of the client by vehicle id, only used by the main thread.
+    *   They belong to one session, when another client connects to the socket they are dropped.
+    */
+    std::map<int, GoalStream> streams;
+    uint32_t streams_session{0};
 };
 
 /*
-*   Struct to store and have an easier access to X and Y values.
-*       float x -> X value of the coordinate.
-*       float y -> Y value of the coordinate.
+*   This struct's purpose is to share data between multiple threads.
+*   More precisely the main, the socket and the generator threads.
 */
 
-struct Goal
+struct SharedVariables
 {
-    float x, y;
+    std::atomic_bool running{false};            // Is used to set the running sate of the main thread.
+
+    /*  The requests of all clients, every client has its own receiver thread.
+    *   The main thread sleeps until a request arrives, the requests of a client are processed in order (pipelining).
+    */
+    RequestQueue requests{REQUEST_QUEUE_SIZE};
+
+    // The connections of all sockets, they are created when a client connects the first time to a socket.
+    std::map<cppsock::socket*, Connection*> connections;
+    std::mutex connections_mutex;
+
+    /*  The shared memory for local clients, 'nullptr' if it could not be created. Every slot has a connection,
+    *   they are created before the threads of the slots start and are not changed until the server stops.
+    */
+    Schwarm::ShmServer* shm_server{nullptr};
+    std::vector<Connection*> shm_connections;
+
+    // The goals of every vehicle, they are written by the generator threads.
+    std::map<int, std::vector<Goal>> goals;
+    std::map<int, uint32_t> versions;           // Is incremented for every new path of a vehicle, the subscriptions restart then.
+    std::mutex goals_mutex;
+    GoalCache* cache{nullptr};                  // 'nullptr' if the cache is disabled.
+
+    FILE* logfile;
+    /*  All threads log through the logger, the messages are written to the log file by a background thread,
+    *   so a request is not delayed by the disk.
+    */
+    AsyncLogger* logger{nullptr};
 };
 
 /*
@@ -102,6 +187,16 @@ void on_connect(cppsock::socket*, void**, error_t);
 
 void on_disconnect(cppsock::socket*, void**);
 
+/*
+*   Writes the statistics of a link (see Schwarm::LinkStats) into the log file through the logger, one message per line.
+*   Parameters:
+*       const Schwarm::LinkStats& stats -> The statistics.
+*       const char* name -> Name of the link.
+*       SharedVariables* shared_variables -> Pointer to the shared memory.
+*/
+
+void log_link_stats(const Schwarm::LinkStats&, const char*, SharedVariables*);
+
 /*
 *   "on_reveive" is a function that is called by the socker-handler.
 *   This function will be called if the socket receives a packet.
@@ -114,23 +209,160 @@ void on_receive(cppsock::socket*, void**, SH::data_channel);
 
 /*
 *   This function decodes the received packets and 
-*   forwards certain packets to the main thread.
+*   forwards the requests to the main thread.
 *   Parameters:
-*       cppsock::socket* socket -> A pointer to the socket.
+*       Connection* connection -> The client that sent the packet.
 *       uint8_t* data -> Received data from the packet.
 *       void** persistant -> A pointer to a pointer to any data (-struct).
 */
 
-void process_packet(cppsock::socket*, uint8_t*, void**);
+void process_packet(Connection*, uint8_t*, void**);
+
+/*
+*   Serves the shared-memory connections of one slot, is the thread of the slot.
+*   The received packets are processed like the packets of a socket.
+*   Parameters:
+*       uint32_t slot -> Index of the slot.
+*       SharedVariables* shared_variables -> Pointer to the shared memory.
+*/
+
+void run_shm_slot(uint32_t, SharedVariables*);
 
 /*
 *   Sends via a socket an error packet to the client.
 *   Parameters:
-*       cppsock::socket* socket -> A pointer to the socket.
+*       Connection* connection -> The client.
 *       Schwarm::packet_error error -> Error code (enum).
+*       uint32_t request_id -> Request id of the request that failed, 0 if it is unknown.
+*/
+
+void send_error(Connection*, Schwarm::packet_error, uint32_t);
+
+/*
+*   Enables the extended header with the next sequence number for a reply,
+*   if the client sends the extended header. Has to be called before the packet is allocated.
+*   Parameters:
+*       Connection* connection -> The client that gets the reply.
+*       Schwarm::Packet& packet -> The reply.
+*/
+
+void prepare_reply(Connection*, Schwarm::Packet&);
+
+/*
+*   Allocates, encodes and sends a reply.
+*   Several threads send replies, the sending is locked so the packets and the sequence numbers are not mixed up.
+*   Parameters:
+*       Connection* connection -> The client that gets the reply.
+*       Schwarm::Packet& packet -> The reply, all values have to be set.
+*       uint32_t data_size -> Size of the variable data of the packet (e.g. goals_size() of a GoalListPacket).
+*/
+
+void send_reply(Connection*, Schwarm::Packet&, uint32_t);
+
+/*
+*   Returns the connection of a socket.
+*   Parameters:
+*       cppsock::socket* socket -> A pointer to the socket.
+*       SharedVariables* shared_variables -> Pointer to the shared memory.
+*   Return:
+*       The connection, it is created if the socket has none yet.
+*/
+
+Connection* get_connection(cppsock::socket*, SharedVariables*);
+
+/*
+*   Generates the goals of a job, is called by the generator threads.
+*   The command "%delete" generates no goals, this deletes the goals of the vehicle.
+*   The goals are taken from the cache if the same image has been generated with the same settings before.
+*   Parameters:
+*       const GenerateJob& job -> The job, the filepath contains the image folder.
+*       std::vector<Goal>& goals -> Vector where the goals are written to.
+*       void* shared_variables -> Pointer to the shared memory.
+*/
+
+Path::pathgen_error generate_job(const GenerateJob&, std::vector<Goal>&, void*);
+
+/*
+*   Generates the goals of a file that is in memory, the file can be an image or a vector drawing (found by its content).
+*   Has the same parameters as Path::generate_goals_from_memory(...), it is also used by the pre-generator.
+*   Parameters:
+*       const uint8_t* file -> Content of the file.
+*       size_t size -> Size of the file in bytes.
+*       unsigned int num_goals -> Number of goals.
+*       bool invert -> Invert the image, has no effect on a drawing.
+*       std::vector<Goal>& goals -> Vector where the goals are written to.
+*   Return:
+*       PATHGEN_NONE if the goals have been generated, otherwise the reason why it failed.
+*/
+
+Path::pathgen_error generate_goals_from_content(const uint8_t*, size_t, unsigned int, bool, std::vector<Goal>&);
+
+/*
+*   Reads a whole file.
+*   Parameters:
+*       const char* path -> Path to the file.
+*       std::vector<uint8_t>& content -> Gets the content of the file.
+*   Return:
+*       'false' if the file could not be read.
+*/
+
+bool read_file(const char*, std::vector<uint8_t>&);
+
+/*
+*   Stores the generated goals and replies to the client, is called by the generator threads.
+*   Parameters:
+*       const GenerateJob& job -> The job, the context is the connection of the client.
+*       Path::pathgen_error error -> Result of the generation.
+*       std::vector<Goal>& goals -> The generated goals.
+*       void* shared_variables -> Pointer to the shared memory.
+*/
+
+void on_generated(const GenerateJob&, Path::pathgen_error, std::vector<Goal>&, void*);
+
+/*
+*   Logs the result of a scan of the image folder, is called by the pre-generator.
+*   Parameters:
+*       const PregenStats& stats -> Result of the scan.
+*       void* shared_variables -> Pointer to the shared memory.
+*/
+
+void on_pregenerated(const PregenStats&, void*);
+
+/*
+*   Checks if the client that sent the request of a job is still connected.
+*   The reply of a job is not sent if the client has disconnected, another client may use the socket now.
+*   Parameters:
+*       const GenerateJob& job -> The job, the context is the connection of the client.
+*   Return:
+*       True if the reply can be sent.
+*/
+
+bool can_reply(const GenerateJob&);
+
+/*
+*   Returns the goal subscriptions of a client for a request.
+*   Parameters:
+*       Connection* connection -> The client.
+*       uint32_t session -> Session of the request.
+*   Return:
+*       The subscriptions, they are dropped first if they belong to the previous client of the socket.
 */
 
-void send_error(cppsock::socket*, Schwarm::packet_error);
+std::map<int, GoalStream>& get_streams(Connection*, uint32_t);
+
+/*
+*   Pushes the next goals of a subscription to the client, as far as the flow control allows it.
+*   If the vehicle has got a new path, the subscription restarts at the first goal.
+*   Parameters:
+*       Connection* connection -> The client.
+*       int vehicle_id -> The vehicle of the subscription.
+*       GoalStream& stream -> The subscription.
+*       SharedVariables* shared_variables -> Pointer to the shared memory.
+*   Return:
+*       False if the vehicle has no goals, the subscription should be ended.
+*/
+
+bool push_goals(Connection*, int, GoalStream&, SharedVariables*);
 
 /*
 *   Returns the local time in hh:mm:ss.
@@ -152,37 +384,52 @@ void on_connect(cppsock::socket* socket, void** persistant, error_t error)
 {
     // Check for 'nullptr' is not needed because there are not 2 different servers / clients used.
     SharedVariables* shared_variables = (SharedVariables*)*persistant;
-    char time[48];
 
     /* Handler the errors that may occur when a connection gets accepted. */
-    gettime(time);
     if(error & SH::error_code_t::HANDLER_NOT_RUNNING)       // This error occures if the socket-handler is not running.
     {
-        fprintf(shared_variables->logfile, "[%s] [ERROR] Connection refused because socket-handler is not running.", time);
-        fprintf(shared_variables->logfile, "[%s] [INFO] IP-Address / Hostname: %s:%hu\n", time, socket->getpeername().get_addr().c_str(), socket->getpeername().get_port());
+        shared_variables->logger->error("Connection refused because socket-handler is not running.");
+        shared_variables->logger->info("IP-Address / Hostname: %s:%hu", socket->getpeername().get_addr().c_str(), socket->getpeername().get_port());
     }
     else if(error & SH::error_code_t::SERVER_LIMIT)         // This error occures if the server has reached its limit of connections.
     {
-        fprintf(shared_variables->logfile, "[%s] [ERROR] Connection refused because server has reached maximum of connections.", time);
-        fprintf(shared_variables->logfile, "[%s] [INFO] IP-Address / Hostname: %s:%hu\n", time, socket->getpeername().get_addr().c_str(), socket->getpeername().get_port());
+        shared_variables->logger->error("Connection refused because server has reached maximum of connections.");
+        shared_variables->logger->info("IP-Address / Hostname: %s:%hu", socket->getpeername().get_addr().c_str(), socket->getpeername().get_port());
     }
     else if(error & SH::error_code_t::SERVER_ACCEPT_ERROR)  // This error occures if the server was not able to accept the socket / connection.
     {
-        fprintf(shared_variables->logfile, "[%s] [ERROR] Could not accept connection.", time);
+        shared_variables->logger->error("Could not accept connection.");
     }
     else    // If everything worked well.
     {
-        fprintf(shared_variables->logfile, "[%s] [INFO] Client connected.\n", time);
-        fprintf(shared_variables->logfile, "[%s] [INFO] IP-Address / Hostname: %s:%hu\n", time, socket->getpeername().get_addr().c_str(), socket->getpeername().get_port());
+        // A new session begins, the state of the previous client of this socket is reset.
+        Connection* connection = get_connection(socket, shared_variables);
+        connection->session++;
+        connection->ext_header = false;
+        connection->recv_stats.reset();
+        connection->connected = true;
+        shared_variables->logger->info("Client connected.");
+        shared_variables->logger->info("IP-Address / Hostname: %s:%hu", socket->getpeername().get_addr().c_str(), socket->getpeername().get_port());
     }
 }
 
 void on_disconnect(cppsock::socket* socket, void** persistant)
 {
     SharedVariables* shared_variables = (SharedVariables*)*persistant;
-    char time[48];
-    gettime(time);
-    fprintf(shared_variables->logfile, "[%s] [INFO] Client disconnected.\n", time);
+    Connection* connection = get_connection(socket, shared_variables);
+    connection->connected = false;
+    shared_variables->logger->info("Client disconnected.");
+    // Delay and lost packets of the requests (only if the client sends the extended header).
+    log_link_stats(connection->recv_stats, "client -> path server", shared_variables);
+}
+
+void log_link_stats(const Schwarm::LinkStats& stats, const char* name, SharedVariables* shared_variables)
+{
+    // The lines are copied into the records of the logger, the thread does not wait for the log file.
+    std::vector<std::string> lines;
+    stats.format(name, lines);
+    for(const std::string& line : lines)
+        shared_variables->logger->info("%s", line.c_str());
 }
 
 void on_receive(cppsock::socket* socket, void** persistant, SH::data_channel channel)
@@ -194,7 +441,7 @@ void on_receive(cppsock::socket* socket, void** persistant, SH::data_channel cha
     *   This is done to get the size of the whole packet without modifying the receive buffer.
     */
     socket->recv(buff1, sizeof(buff1), channel | MSG_PEEK);
-    const size_t* packet_size = Schwarm::Packet::size_ptr(buff1);   // Get the size of the packet.
+    const uint32_t* packet_size = Schwarm::Packet::size_ptr(buff1); // Get the size of the packet.
     uint8_t buff2[*packet_size];                    // Create a second buffer with the size of the packet.
     /*
     *   Receive the second time now with the full size of the packet and without peeking so that the
@@ -202,89 +449,301 @@ void on_receive(cppsock::socket* socket, void** persistant, SH::data_channel cha
     */
     socket->recv(buff2, sizeof(buff2), channel);    
 
+    // Only the packets as they are received are counted, not the sub-packets of a batch.
+    SharedVariables* shared_variables = (SharedVariables*)*persistant;
+    Connection* connection = get_connection(socket, shared_variables);
+    if(*Schwarm::Packet::id_ptr(buff2) & Schwarm::Packet::FLAG_EXT_HEADER)
+        connection->ext_header = true;
+    connection->recv_stats.record(buff2, sizeof(buff2));
+
     // Process the packet...
-    process_packet(socket, buff2, persistant);
+    process_packet(connection, buff2, persistant);
 }
 
-void process_packet(cppsock::socket* socket, uint8_t* data, void** persistant)
+void run_shm_slot(uint32_t slot, SharedVariables* shared_variables)
 {
-    const uint8_t* id = Schwarm::Packet::id_ptr(data);              // Get pointer to packet id.
-    const size_t* size = Schwarm::Packet::size_ptr(data);           // Get pointer to size of packet.
+    Connection* connection = shared_variables->shm_connections[slot];
+    void* persistant = shared_variables;
+    std::vector<uint8_t> buff;
+    while(shared_variables->running)
+    {
+        Schwarm::ShmEndpoint* endpoint = shared_variables->shm_server->accept(slot, 100);
+        if(endpoint == nullptr)
+            continue;
+
+        // The same as on_connect(), a new session begins.
+        connection->session++;
+        connection->ext_header = false;
+        connection->recv_stats.reset();
+        connection->send_mutex.lock();
+        connection->shm = endpoint;
+        connection->send_mutex.unlock();
+        connection->connected = true;
+        shared_variables->logger->info("Local client connected through shared memory (slot %u).", slot);
+
+        int ret;
+        while(shared_variables->running && (ret = endpoint->recv(buff, 100)) >= 0)
+        {
+            if(ret == 0)
+                continue;
+            if(*Schwarm::Packet::id_ptr(buff.data()) & Schwarm::Packet::FLAG_EXT_HEADER)
+                connection->ext_header = true;
+            connection->recv_stats.record(buff.data(), buff.size());
+            process_packet(connection, buff.data(), &persistant);
+        }
+
+        // The generator threads may still send a reply, the endpoint is removed under the send mutex.
+        connection->connected = false;
+        connection->send_mutex.lock();
+        connection->shm = nullptr;
+        connection->send_mutex.unlock();
+        delete(endpoint);
+        shared_variables->logger->info("Local client disconnected (slot %u).", slot);
+        log_link_stats(connection->recv_stats, "local client -> path server", shared_variables);
+    }
+}
+
+void process_packet(Connection* connection, uint8_t* data, void** persistant)
+{
+    const uint8_t id = Schwarm::Packet::get_id(data);               // Get packet id (without the header flags).
+    const uint32_t* size = Schwarm::Packet::size_ptr(data);         // Get pointer to size of packet.
     SharedVariables* shared_variables = (SharedVariables*)*persistant;    // Get pointer to shared memory.
-    char time[48];
 
-    gettime(time);
-    if(*id == Schwarm::ExitPacket::PACKET_ID)
+    if(id == Schwarm::ExitPacket::PACKET_ID)
     {
         /*  If exit command was received set running value to 'false'.
         The server will shut down. */
-        fprintf(shared_variables->logfile, "[%s] [INFO] Received stop command.\n", time);
+        shared_variables->logger->info("Received stop command.");
         shared_variables->running = false;
+        shared_variables->requests.close();     // Wake up the main thread.
     }
-    else if(*id == Schwarm::PathGeneratePacket::PACKET_ID)
+    else if(id == Schwarm::PathGeneratePacket::PACKET_ID || id == Schwarm::GoalReqPacket::PACKET_ID || id == Schwarm::GoalRangeReqPacket::PACKET_ID ||
+            id == Schwarm::GoalSubscribePacket::PACKET_ID || id == Schwarm::GoalAckPacket::PACKET_ID)
     {
-        /*  Only process the packet if the main thread is still running (highest priority)
-            and only if the server is not already generating a path. */
-        if(shared_variables->running && !shared_variables->generating_path)
-        {
-            shared_variables->pathgenpacket.allocate(*size); // Allocate memory for the packet.
-            shared_variables->pathgenpacket.set(data);       // Set the data string.
-            shared_variables->pathgenpacket.decode();        // Decode the packet.
-
-            fprintf(shared_variables->logfile, 
-                    "[%s] [INFO] Generating goals for file %s with %u goals for vehicle %d...\n", 
-                    time, 
-                    shared_variables->pathgenpacket.get_filepath(), 
-                    shared_variables->pathgenpacket.get_num_goals(), 
-                    shared_variables->pathgenpacket.get_vehicle_id());
-            // Set values for shared memory.
-            shared_variables->generating_path = true;     // Set "generating_path" to 'true' to let the rest of the server know that a path is being generated.
-            shared_variables->packet_id = shared_variables->pathgenpacket.id();
-            /*  NOTE: It is important that setting the packed id is the last operation to ensure a synchronization
-            *   betwenn this and the main thread. The main thread will only start to process the packet if the
-            *   id has been set.
-            */
-        }
-        else if(shared_variables->running && shared_variables->generating_path)
-        {
-            // If the server is busy generating goals, send an error to the client.
-            fprintf(shared_variables->logfile, "[%s] [INFO] Server is already generating goals.\n", time);
-            send_error(socket, Schwarm::packet_error::PACKET_SERVER_BUSY);
-        }
+        /*  The requests are processed by the main thread because the main thread knows which vehicles are being generated.
+        *   The packet is only copied into the queue, so the receiver thread can receive the next packet immediately.
+        */
+        Request request;
+        request.context = connection;                       // The reply goes to the client that sent the request.
+        request.session = connection->session;
+        request.data.assign(data, data + *size);
+        shared_variables->requests.push(request);
     }
-    else if(*id == Schwarm::GoalReqPacket::PACKET_ID)
+    else if(id == Schwarm::BatchPacket::PACKET_ID)
     {
-        fprintf(shared_variables->logfile, "[%s] [INFO] Received goal request.\n", time);
-        if(shared_variables->running && !shared_variables->generating_path)
+        // A batch contains several complete packets, e.g. the requests of one tick of the visualization.
+        Schwarm::BatchPacket batch;
+        batch.allocate(*size);
+        batch.set(data);
+        if(batch.decode() != Schwarm::packet_error::PACKET_NONE)
         {
-            shared_variables->goalreqpacket.allocate(*size); // Allocate memory for the packet.
-            shared_variables->goalreqpacket.set(data);       // Set the packet data.
-            shared_variables->goalreqpacket.decode();        // Decode the packet.
-
-            /*  The sending mechanic takes place in the main thread because 
-            *   the vector for the goals is located threre.
-            */
-
-            // Set values for shared memory.
-            shared_variables->packet_id = shared_variables->goalreqpacket.id();    // The same thing with the id like before...
+            shared_variables->logger->error("Received invalid batch.");
+            send_error(connection, Schwarm::packet_error::PACKET_INVALID_SIZE, 0);
+            return;
         }
-        else if(shared_variables->running && shared_variables->generating_path)
+
+        /*  Process the sub-packets in place without copying them out of the batch.
+        *   The requests are queued in order, so they are answered in order.
+        */
+        for(const uint8_t* sub = batch.first(); sub != nullptr; sub = batch.next(sub))
         {
-            // If the server is busy generating goals, send an error to the client.
-            fprintf(shared_variables->logfile, "[%s] [INFO] Can't send goal because server has not finished generating goals\n", time);
-            send_error(socket, Schwarm::packet_error::PACKET_SERVER_BUSY);
-        } 
+            // Nested batches are not allowed.
+            if(Schwarm::Packet::get_id(sub) != Schwarm::BatchPacket::PACKET_ID)
+                process_packet(connection, (uint8_t*)sub, persistant);
+        }
     }
 }
 
-void send_error(cppsock::socket* socket, Schwarm::packet_error error)
+void send_error(Connection* connection, Schwarm::packet_error error, uint32_t request_id)
 {
     // For information that this function does see the prototype.
     Schwarm::ErrorPacket packet;
     packet.set_code(error);                             // Set the error code.
-    packet.allocate(packet.min_size());                 // Allocate memory for the packet.
+    packet.set_request_id(request_id);                  // Let the client know which request failed.
+    send_reply(connection, packet, 0);                  // Send it to the client.
+}
+
+void prepare_reply(Connection* connection, Schwarm::Packet& packet)
+{
+    if(connection->ext_header)
+        connection->send_stats.stamp(packet);
+}
+
+void send_reply(Connection* connection, Schwarm::Packet& packet, uint32_t data_size)
+{
+    // The sequence numbers have to be in the same order as the packets are sent.
+    std::lock_guard<std::mutex> lock(connection->send_mutex);
+    prepare_reply(connection, packet);                  // Sequence number and timestamp.
+    packet.allocate(packet.min_size() + data_size);     // Allocate memory for the packet.
     packet.encode();                                    // Encode the packet.
-    socket->send(packet.rawdata(), packet.size(), 0);   // Send it to the client.
+    if(connection->shm != nullptr)
+        connection->shm->send(packet.rawdata(), packet.size());
+    else if(connection->socket != nullptr)
+        connection->socket->send(packet.rawdata(), packet.size(), 0);
+}
+
+Connection* get_connection(cppsock::socket* socket, SharedVariables* shared_variables)
+{
+    std::lock_guard<std::mutex> lock(shared_variables->connections_mutex);
+    Connection*& connection = shared_variables->connections[socket];
+    if(connection == nullptr)
+    {
+        // The connections are deleted when the server stops, the sockets of the socket-handler are never reallocated.
+        connection = new Connection;
+        connection->socket = socket;
+    }
+    return connection;
+}
+
+Path::pathgen_error generate_job(const GenerateJob& job, std::vector<Goal>& goals, void* persistant)
+{
+    SharedVariables* shared_variables = (SharedVariables*)persistant;
+
+    // Deleting the goals is a job too, so it can not be overwritten by a generation that was requested before.
+    if(job.filepath == "%delete")
+        return Path::PATHGEN_NONE;
+
+    // The file is read only once, it is hashed for the cache and decoded from memory.
+    std::vector<uint8_t> file;
+    if(!read_file(job.filepath.c_str(), file))
+        return Path::PATHGEN_INVALID_IMAGE;
+    if(shared_variables->cache == nullptr)
+        return generate_goals_from_content(file.data(), file.size(), job.num_goals, job.invert, goals);
+
+    const GoalCacheKey key = GoalCache::make_key(file.data(), file.size(), job.num_goals, job.invert);
+    if(shared_variables->cache->get(key, goals))
+    {
+        shared_variables->logger->info("Took goals for vehicle %d from the cache.", job.vehicle_id);
+        return Path::PATHGEN_NONE;
+    }
+
+    const Path::pathgen_error err = generate_goals_from_content(file.data(), file.size(), job.num_goals, job.invert, goals);
+    if(err == Path::PATHGEN_NONE)
+        shared_variables->cache->put(key, goals);
+    return err;
+}
+
+Path::pathgen_error generate_goals_from_content(const uint8_t* file, size_t size, unsigned int num_goals, bool invert, std::vector<Goal>& goals)
+{
+    // A drawing is never rasterized, its goals are sampled from the polylines.
+    if(Path::is_drawing(file, size))
+        return Path::generate_drawing_goals(file, size, num_goals, invert, goals);
+    return Path::generate_goals_from_memory(file, size, num_goals, invert, goals);
+}
+
+bool read_file(const char* path, std::vector<uint8_t>& content)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr)
+        return false;
+
+    // Read in blocks, the size of the file is not needed.
+    uint8_t buff[65536];
+    size_t n;
+    content.clear();
+    while((n = fread(buff, 1, sizeof(buff), file)) > 0)
+        content.insert(content.end(), buff, buff + n);
+    const bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+void on_generated(const GenerateJob& job, Path::pathgen_error error, std::vector<Goal>& goals, void* persistant)
+{
+    SharedVariables* shared_variables = (SharedVariables*)persistant;
+    Connection* connection = (Connection*)job.context;
+
+    if(job.filepath == "%delete")
+    {
+        // Is usefull for a dynamic number of vehicles to delete unused memory.
+        shared_variables->goals_mutex.lock();
+        // Only a vehicle that has goals gets a new version, an unknown vehicle id does not add an entry.
+        if(shared_variables->goals.erase(job.vehicle_id) > 0)
+            shared_variables->versions[job.vehicle_id]++;
+        shared_variables->goals_mutex.unlock();
+        shared_variables->logger->info("Deleted goals for vehicle id %d.", job.vehicle_id);
+    }
+    else if(error != Path::PATHGEN_NONE)
+    {
+        // The old goals of the vehicle are kept.
+        shared_variables->logger->error("Failed to generate goals for vehicle %d: %s.", job.vehicle_id, Path::error_string(error));
+        // Send an error back to the cient to let it know that the generation has been failed.
+        if(can_reply(job))
+            send_error(connection, Schwarm::packet_error::PACKET_FAILED_GENERATING_PATH, job.request_id);
+    }
+    else
+    {
+        const uint32_t num_goals = goals.size();
+        shared_variables->goals_mutex.lock();
+        shared_variables->goals[job.vehicle_id].swap(goals);
+        shared_variables->versions[job.vehicle_id]++;
+        shared_variables->goals_mutex.unlock();
+        shared_variables->logger->info("Successfully generated %u goals for vehicle %d in %.1f ms after the request.", num_goals, job.vehicle_id,
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - job.received).count());
+
+        // Send acnoledge.
+        if(can_reply(job))
+        {
+            Schwarm::AcnPacket packet;
+            packet.set_request_id(job.request_id);
+            send_reply(connection, packet, 0);
+        }
+    }
+
+    /*  Let the main thread push the goals to the subscribers of the vehicle.
+    *   Subscriptions that wait for the first path get an error if the generation has failed.
+    */
+    Request notification;
+    notification.data.resize(sizeof(int));
+    memcpy(notification.data.data(), &job.vehicle_id, sizeof(int));
+    shared_variables->requests.push(notification);
+}
+
+void on_pregenerated(const PregenStats& stats, void* persistant)
+{
+    SharedVariables* shared_variables = (SharedVariables*)persistant;
+    shared_variables->logger->info("%s: %u images%s, %u goal sets generated, %u already cached, %u failed in %.1f ms.",
+            stats.startup ? "Pre-generated the image folder" : "Pre-generated the changed image folder",
+            stats.images, stats.inverted ? " (also inverted)" : "", stats.generated, stats.cached, stats.failed, stats.ms);
+}
+
+bool can_reply(const GenerateJob& job)
+{
+    const Connection* connection = (const Connection*)job.context;
+    return connection->connected && connection->session == job.session;
+}
+
+std::map<int, GoalStream>& get_streams(Connection* connection, uint32_t session)
+{
+    if(connection->streams_session != session)
+    {
+        connection->streams.clear();
+        connection->streams_session = session;
+    }
+    return connection->streams;
+}
+
+bool push_goals(Connection* connection, int vehicle_id, GoalStream& stream, SharedVariables* shared_variables)
+{
+    // The goals are copied into the packet, so the lock is only needed until then.
+    Schwarm::GoalListPacket packet;
+    uint32_t count = 0;
+    shared_variables->goals_mutex.lock();
+    auto iter = shared_variables->goals.find(vehicle_id);
+    const bool has_goals = iter != shared_variables->goals.end() && !iter->second.empty();
+    if(has_goals)
+    {
+        // Every vehicle with goals has a version.
+        const uint32_t version = shared_variables->versions.find(vehicle_id)->second;
+        if(stream.get_version() != version)
+            stream.restart(version);
+        count = stream.next_list(vehicle_id, iter->second.data(), iter->second.size(), packet);
+    }
+    shared_variables->goals_mutex.unlock();
+
+    if(count > 0)
+        send_reply(connection, packet, packet.goals_size());
+    return has_goals;
 }
 
 void gettime(char* timestr)
@@ -317,8 +776,7 @@ void getdate(char* datestr)
 // its showtime
 int main(int argc, const char* const * const argv)
 {
-    std::map<int, std::vector<Goal>> goals;    // The vector where the goals from the file are saved.
-
+    const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
     SharedVariables shared_variables;   // The shared-data struct.
     shared_variables.running = true;  // Set running to true because the main thrad should be in the running state.
   
@@ -352,164 +810,488 @@ int main(int argc, const char* const * const argv)
     }
 
     /* DECODE COMMAND */
-    if(argc < MIN_ARGLENGTH)
+    // The flags can be anywhere, the other arguments are positional.
+    std::vector<const char*> args;
+    const char* pregen_list = nullptr;
+    int i;
+    for(i = 0; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-pregen") == 0 && i + 1 < argc)
+            pregen_list = argv[++i];
+        else if(argv[i][0] == '-' && i > 0)
+        {
+            printf("[ERROR] Invalid flag: \"%s\"\n", argv[i]);
+            printf("Exit code -2\n");
+            return -2;
+        }
+        else
+            args.push_back(argv[i]);
+    }
+    const int num_args = args.size();
+
+    if(num_args < MIN_ARGLENGTH)
     {
         // Number of arguments equals argc - 1 because the first element is the command (name of the executable) itself.
-        printf("[ERROR] At least 1 argument requiered, given: %d\n", argc - 1);
+        printf("[ERROR] At least 1 argument requiered, given: %d\n", num_args - 1);
         printf("Exit code -2\n");
         return -2;
     }
-    else if(argc > MIN_ARGLENGTH)
+    else if(num_args > MAX_ARGLENGTH)
     {
         // Number of arguments equals argc - 1 because the first element is the command (name of the executable) itself.
-        printf("[ERROR] Too many arguments given: %d, requiered: 1\n", argc - 1);
+        printf("[ERROR] Too many arguments given: %d, requiered: 1 to 4\n", num_args - 1);
         printf("Exit code -2\n");
         return -2;
     }
+
+    // The optional 2nd argument is the maximum number of clients.
+    int max_clients = DEFAULT_MAX_CLIENTS;
+    if(num_args > 2 && (sscanf(args[2], "%d", &max_clients) != 1 || max_clients < 1))
+    {
+        printf("[ERROR] Invalid maximum number of clients: \"%s\"\n", args[2]);
+        printf("Exit code -2\n");
+        return -2;
+    }
+
+    // The optional 3rd argument is the size of the cache, the 4th one the cache directory.
+    int cache_size_mb = DEFAULT_CACHE_SIZE_MB;
+    if(num_args > 3 && (sscanf(args[3], "%d", &cache_size_mb) != 1 || cache_size_mb < 0))
+    {
+        printf("[ERROR] Invalid cache size: \"%s\"\n", args[3]);
+        printf("Exit code -2\n");
+        return -2;
+    }
+    const char* cache_directory = (num_args > 4) ? args[4] : nullptr;
+
+    // The pre-generated goals are only kept in the cache.
+    std::vector<uint32_t> pregen_counts;
+    if(pregen_list != nullptr && !Pregenerator::parse_goal_counts(pregen_list, pregen_counts))
+    {
+        printf("[ERROR] Invalid numbers of goals for the pre-generation: \"%s\"\n", pregen_list);
+        printf("Exit code -2\n");
+        return -2;
+    }
+    if(pregen_list != nullptr && cache_size_mb == 0)
+    {
+        printf("[ERROR] The pre-generation needs the cache, the cache size must not be 0.\n");
+        printf("Exit code -2\n");
+        return -2;
+    }
+    const char* image_folder = args[1];
+    if(cache_directory != nullptr)
+    {
+        DIR* cache_dir = opendir(cache_directory);
+        if(cache_dir == nullptr)
+            mkdir(cache_directory);
+        else
+            closedir(cache_dir);
+    }
+    if(cache_size_mb > 0)
+        shared_variables.cache = new GoalCache((size_t)cache_size_mb * 1024 * 1024, cache_directory);
     fprintf(shared_variables.logfile, "\n--------------------------------------------------\n");
+    shared_variables.logger = new AsyncLogger(shared_variables.logfile, LOG_BUFFER_SIZE);
 
     /* START SOCKET HANDLER */
     SH::SocketHandler handler;
     handler.start();  
-    gettime(time);              
-    fprintf(shared_variables.logfile, "[%s] [INFO] Started socket-handler.\n", time);
+    shared_variables.logger->info("Started socket-handler.");
     
     /* START SERVER */
-    SH::Server server(handler, 1);              // The server class that accepts connections.
+    SH::Server server(handler, max_clients);    // The server class that accepts connections, one socket per client.
     *server.persist_ptr() = &shared_variables;    // Let the persistant pointer point to the shared-memory struct.
     server.set_callbacks(on_connect, on_disconnect, on_receive);    // Set the callbacks for this server.
-    if(server.start("0.0.0.0", 10000, 1) != 0)                      // Start the server and interrogare for occured errors.
+    if(server.start("0.0.0.0", SERVER_PORT, max_clients) != 0)            // Start the server and interrogare for occured errors.
     {
+        delete(shared_variables.logger);
         printf("[ERROR] Error occured while starting server.\n");
         printf("Exit code -3\n");
         return -3;
     }
-    gettime(time);
-    fprintf(shared_variables.logfile, "[%s] [INFO] Started server.\n", time);
+    shared_variables.logger->info("Started server for up to %d clients.", max_clients);
+
+    /* START GENERATOR THREADS */
+    // One thread per core, the paths of that many vehicles can be generated at the same time.
+    GeneratorPool* generator = new GeneratorPool(std::thread::hardware_concurrency(), generate_job, on_generated, &shared_variables);
+    shared_variables.logger->info("Started %u generator threads.", (uint32_t)generator->num_workers());
+
+    /* START PRE-GENERATION */
+    // The image folder is scanned in the background, requests are already answered meanwhile.
+    Pregenerator* pregenerator = nullptr;
+    if(!pregen_counts.empty())
+    {
+        pregenerator = new Pregenerator(image_folder, pregen_counts, shared_variables.cache, std::thread::hardware_concurrency(),
+                                        generate_goals_from_content, on_pregenerated, &shared_variables, true);
+        shared_variables.logger->info("Started pre-generation of the image folder for %u numbers of goals.", (uint32_t)pregen_counts.size());
+    }
+    /* START SHARED MEMORY */
+    // Local clients find the shared memory by the port, without it they use the socket.
+    std::vector<std::thread> shm_threads;
+    shared_variables.shm_server = Schwarm::ShmServer::create(SERVER_PORT, SHM_SLOTS);
+    if(shared_variables.shm_server != nullptr)
+    {
+        // Every connection exists before the first thread starts, the vector is never changed while the threads run.
+        for(i = 0; i < SHM_SLOTS; i++)
+            shared_variables.shm_connections.push_back(new Connection);
+        for(i = 0; i < SHM_SLOTS; i++)
+            shm_threads.emplace_back(run_shm_slot, (uint32_t)i, &shared_variables);
+        shared_variables.logger->info("Started shared memory for up to %d local clients.", SHM_SLOTS);
+    }
+    else
+        shared_variables.logger->error("Could not create the shared memory, local clients use the socket.");
+
+    shared_variables.logger->info("Server is ready after %.1f ms.", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count());
 
     /* THE MAIN LOOP */
-    while(shared_variables.running)
-    {   
+    // The packets are decoded here, the shared memory only contains the raw requests.
+    Schwarm::PathGeneratePacket pathgenpacket;
+    Schwarm::GoalReqPacket goalreqpacket;
+    Schwarm::GoalRangeReqPacket goalrangereqpacket;
+    Schwarm::GoalSubscribePacket subscribepacket;
+    Schwarm::GoalAckPacket ackpacket;
+    Request request;
+    /*  Number of submitted jobs of a vehicle whose notification has not been handled yet, only used by the main thread.
+    *   Unlike GeneratorPool::busy it is in the order of the requests: a worker is still busy while its notification may have been handled already.
+    */
+    std::map<int, uint32_t> generating;
+    while(shared_variables.running && shared_variables.requests.pop(request))  // Sleeps until a request is received.
+    {
+        // A request without a client is sent by the generator threads: a job of a vehicle (data) has been finished.
+        if(request.context == nullptr)
+        {
+            int vehicle_id;
+            memcpy(&vehicle_id, request.data.data(), sizeof(int));
+            auto pending = generating.find(vehicle_id);
+            if(pending != generating.end() && --pending->second == 0)
+                generating.erase(pending);
+
+            std::vector<Connection*> connections;
+            shared_variables.connections_mutex.lock();
+            for(auto iter = shared_variables.connections.begin(); iter != shared_variables.connections.end(); iter++)
+                connections.push_back(iter->second);
+            shared_variables.connections_mutex.unlock();
+            // The local clients subscribe the same way, their connections are fixed since the start.
+            connections.insert(connections.end(), shared_variables.shm_connections.begin(), shared_variables.shm_connections.end());
+
+            for(Connection* connection : connections)
+            {
+                if(!connection->connected || connection->streams_session != connection->session)
+                    continue;
+                auto stream = connection->streams.find(vehicle_id);
+                if(stream != connection->streams.end() && !push_goals(connection, vehicle_id, stream->second, &shared_variables))
+                {
+                    // The goals have been deleted or the first path of the vehicle could not be generated.
+                    send_error(connection, Schwarm::packet_error::PACKET_INVALID_GOAL, stream->second.get_request_id());
+                    connection->streams.erase(stream);
+                }
+            }
+            continue;
+        }
+
+        Connection* requester = (Connection*)request.context;   // The client that sent the request, gets the reply.
+        if(!requester->connected || requester->session != request.session)
+            continue;   // The client has disconnected while the request was waiting, another client may use the socket now.
+        const uint8_t id = Schwarm::Packet::get_id(request.data.data());
+        const uint32_t size = request.data.size();
+
         // If a PathGeneratePacket gehts transmitted to the main thread.
-        if(shared_variables.packet_id == Schwarm::PathGeneratePacket::PACKET_ID)
+        if(id == Schwarm::PathGeneratePacket::PACKET_ID)
         {
-            if(strcmp(shared_variables.pathgenpacket.get_filepath(), "%delete") == 0)
+            pathgenpacket.allocate(size);               // Allocate memory for the packet.
+            pathgenpacket.set(request.data.data());     // Set the data string.
+            if(pathgenpacket.decode() != Schwarm::packet_error::PACKET_NONE)
+            {
+                shared_variables.logger->error("Received invalid path generate packet.");
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_SIZE, 0);
+                continue;
+            }
+            shared_variables.logger->info("Received path generation for file %s with %u goals for vehicle %d.",
+                    pathgenpacket.get_filepath(), 
+                    pathgenpacket.get_num_goals(), 
+                    pathgenpacket.get_vehicle_id());
+
+            GenerateJob job;
+            job.vehicle_id = pathgenpacket.get_vehicle_id();
+            job.num_goals = pathgenpacket.get_num_goals();
+            job.invert = pathgenpacket.should_invert();
+            if(pregenerator != nullptr)
+                pregenerator->request_seen(job.invert);     // The first inverted request starts the pre-generation of the inverted goals.
+            job.request_id = pathgenpacket.get_request_id();
+            job.context = requester;                    // The reply goes to the client that sent the request.
+            job.session = request.session;
+            job.received = std::chrono::steady_clock::now();
+            if(strcmp(pathgenpacket.get_filepath(), "%delete") == 0)
             {
                 // If this command gets received delete the goals for this vehicle id.
-                // Is usefull for a dynamic number of vehicles to delete unused memory.
-                goals[shared_variables.pathgenpacket.get_vehicle_id()].clear();
-                gettime(time);
-                fprintf(shared_variables.logfile, "[%s] [INFO] Deleting goals for vehicle id %d.\n", time, shared_variables.pathgenpacket.get_vehicle_id());
+                job.filepath = "%delete";
+            }
+            else
+            {
+                // Path to the image, the filepath of the packet is relative to the image folder.
+                job.filepath = std::string(image_folder) + "/" + pathgenpacket.get_filepath();
+            }
+
+            /*  Hand the job over to the generator threads, the reply is sent when the goals have been generated.
+            *   If the previous job of the vehicle has not been started yet, only the newest one is generated.
+            */
+            GenerateJob superseded;
+            if(generator->submit(job, superseded))
+            {
+                // The superseded job is never finished, so there is still one notification for the vehicle.
+                shared_variables.logger->info("Path generation for vehicle %d has been superseded by a newer one.", superseded.vehicle_id);
+                if(superseded.filepath != "%delete" && can_reply(superseded))
+                    send_error((Connection*)superseded.context, Schwarm::packet_error::PACKET_FAILED_GENERATING_PATH, superseded.request_id);
+            }
+            else
+                generating[job.vehicle_id]++;
+        }
+        // If a GoalReqPacket gets transmitted to the main thread.
+        else if(id == Schwarm::GoalReqPacket::PACKET_ID)
+        {
+            goalreqpacket.allocate(size);               // Allocate memory for the packet.
+            goalreqpacket.set(request.data.data());     // Set the packet data.
+            if(goalreqpacket.decode() != Schwarm::packet_error::PACKET_NONE)
+            {
+                shared_variables.logger->error("Received invalid goal request.");
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_SIZE, 0);
+                continue;
+            }
+            shared_variables.logger->info("Received goal request.");
+
+            const int vehicle_id = goalreqpacket.get_vehicle_id();
+            const uint32_t index = goalreqpacket.get_goal_index();
+
+            // The goals of the other vehicles can be sent while the path of this vehicle is being generated.
+            if(generator->busy(vehicle_id))
+            {
+                shared_variables.logger->info("Can't send goal because server has not finished generating goals for vehicle %d.", vehicle_id);
+                send_error(requester, Schwarm::packet_error::PACKET_SERVER_BUSY, goalreqpacket.get_request_id());
             }
             else
             {
-                // Build the command to call the "pathgenerator.exe" program.
-                char cmd[256];
-                sprintf(cmd, "pathgenerator.exe.lnk %s/%s goals.gol %u -nodebug -log %s", argv[1], shared_variables.pathgenpacket.get_filepath(), shared_variables.pathgenpacket.get_num_goals(), (shared_variables.pathgenpacket.should_invert()) ? "-invert" : "");
-                //printf("%s\n", cmd);
+                /*  If the request for the goal contains a too big number for the index (bigger than the size of the vector)
+                *   an error will be sent to the client to let it know that the index was invalid.
+                */
+                Schwarm::GoalPacket packet;
+                shared_variables.goals_mutex.lock();
+                // An unknown vehicle has no goals, the vehicle id comes from the client and must not add an entry.
+                auto vehicle_goals = shared_variables.goals.find(vehicle_id);
+                const uint32_t num_goals = (vehicle_goals != shared_variables.goals.end()) ? vehicle_goals->second.size() : 0;
+                if(index < num_goals)
+                    packet.set_goal(vehicle_goals->second[index].x, vehicle_goals->second[index].y);    // Set the goal values.
+                shared_variables.goals_mutex.unlock();
 
-                // Call the program "pathgenerator.exe".
-                if(std::system(cmd) != 0)
+                if(index >= num_goals)
                 {
-                    /*  If the std::system returns something unequal 0 (the return code of the program will be returned),
-                    *   the generation of the goals has been failed.
-                    *   For more information see the logfile of the "pathgenerator.exe" progarm.
-                    */
-                    gettime(time);
-                    fprintf(shared_variables.logfile, "[%s] [ERROR] Failed to generate goals.\n", time);
-                    // Send an error back to the cient to let it know that the generation has been failed.
-                    send_error(&server.get_socket(0), Schwarm::packet_error::PACKET_FAILED_GENERATING_PATH);
+                    shared_variables.logger->error("Received invalid goal index %u for vehicle %d (Number of goals: %u).", index, vehicle_id, num_goals);
+                    // Send the actual packet.
+                    send_error(requester, Schwarm::packet_error::PACKET_INVALID_GOAL, goalreqpacket.get_request_id());
                 }
                 else
                 {
-                    /*  If the path has successfully been generated, the goals can be
-                    *   read from the file.
-                    */
-                    FILE* file = fopen("pathgenerator/goals.gol", "r");   // Open the file, the filename is defined.
-                    if(file == NULL)
-                    {
-                        /*  If the file could not be opened the output file could not be opened
-                        *   or the file has been deleted.
-                        */
-                        gettime(time);
-                        fprintf(shared_variables.logfile, "[%s] [ERROR] Could not find path to goal-output file.\n", time);
-                        send_error(&server.get_socket(0), Schwarm::packet_error::PACKET_FAILED_GENERATING_PATH);
-                    }
-                    else
-                    {
-                        /* If the file can be open, the reading process can begin. */
-                        // Clear the goal vector to write new goals into it.
-                        goals[shared_variables.pathgenpacket.get_vehicle_id()].clear();
-                        Goal goal;
-                        gettime(time);
-                        fprintf(shared_variables.logfile, "[%s] [INFO] Reading goals...\n", time);
-                        while(!feof(file))  // Read the whole file...
-                        {
-                            fscanf(file, "%f %f\n", &goal.x, &goal.y);          // Read one line and put the values into the "Goal" struct.
-                            goals[shared_variables.pathgenpacket.get_vehicle_id()].push_back(goal); // Push the goal to the goal vector.
-                        }
-                        gettime(time);
-                        fprintf(shared_variables.logfile, "[%s] [INFO] Successfully generated goals for vehicle %d.\n", time, shared_variables.pathgenpacket.get_vehicle_id());
-                        fclose(file);   // Close the previously opened file.
-
-                        // Send acnoledge.
-                        Schwarm::AcnPacket packet;
-                        packet.allocate(packet.min_size());
-                        packet.encode();
-                        server.get_socket(0).send(packet.rawdata(), packet.size(), 0);
-                    }
+                    // Otherwise, instead of an error, send the goal to the client if the index is valid.
+                    packet.set_vehicle_id(vehicle_id);
+                    packet.set_request_id(goalreqpacket.get_request_id());    // Echo the request id.
+                    send_reply(requester, packet, 0);                          // Sent the packet to the client.
+                    shared_variables.logger->info("Sent goal with index %u for vehicle %d.", index, vehicle_id);
                 }
             }
+        }
+        // If a GoalRangeReqPacket gets transmitted to the main thread.
+        else if(id == Schwarm::GoalRangeReqPacket::PACKET_ID)
+        {
+            goalrangereqpacket.allocate(size);              // Allocate memory for the packet.
+            goalrangereqpacket.set(request.data.data());    // Set the packet data.
+            if(goalrangereqpacket.decode() != Schwarm::packet_error::PACKET_NONE)
+            {
+                shared_variables.logger->error("Received invalid goal range request.");
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_SIZE, 0);
+                continue;
+            }
+            shared_variables.logger->info("Received goal range request.");
 
-            // After processing the packet, reset the shared memory.
-            shared_variables.packet_id = -1;          // Set packet id to -1 because -1 indicates that no packet was received.
-            shared_variables.generating_path = false; // Last but nor least, let the rest of the server know that the generation of the goals has been finished.
+            const int vehicle_id = goalrangereqpacket.get_vehicle_id();
+            const uint32_t start = goalrangereqpacket.get_start_index();
 
-            /*
-            *   NOTE: it is important that the "generating_path" set to 'false' is the last operation that should be done when processing
-            *   this packet to enshure the syncronization between the receiver and the main thread.
-            *   The receiver thread will only be accepting new packets if the value of "generating_path" is 'false', therefore
-            *   this should be the last operation.
-            */
+            if(generator->busy(vehicle_id))
+            {
+                shared_variables.logger->info("Can't send goals because server has not finished generating goals for vehicle %d.", vehicle_id);
+                send_error(requester, Schwarm::packet_error::PACKET_SERVER_BUSY, goalrangereqpacket.get_request_id());
+            }
+            else
+            {
+                // The goals are copied into the packet, so the lock is only needed until then.
+                Schwarm::GoalListPacket packet;
+                uint32_t count = 0;
+                shared_variables.goals_mutex.lock();
+                auto vehicle_goals = shared_variables.goals.find(vehicle_id);    // like a single goal, no entry for an unknown vehicle
+                const uint32_t num_goals = (vehicle_goals != shared_variables.goals.end()) ? vehicle_goals->second.size() : 0;
+                if(start < num_goals)
+                {
+                    // Send as many goals as requested but not more than one list can hold and not more than the path has.
+                    count = std::min<uint32_t>({goalrangereqpacket.get_count(), Schwarm::GoalListPacket::MAX_GOALS, num_goals - start});
+                    packet.set_goals((const float*)(vehicle_goals->second.data() + start), count);  // Goal is a packed pair of floats.
+                }
+                shared_variables.goals_mutex.unlock();
+
+                // The same as for a single goal, the first index has to be valid.
+                if(start >= num_goals)
+                {
+                    shared_variables.logger->error("Received invalid goal index %u for vehicle %d (Number of goals: %u).", start, vehicle_id, num_goals);
+                    send_error(requester, Schwarm::packet_error::PACKET_INVALID_GOAL, goalrangereqpacket.get_request_id());
+                }
+                else
+                {
+                    packet.set_vehicle_id(vehicle_id);
+                    packet.set_start_index(start);
+                    packet.set_total_goals(num_goals);
+                    packet.is_end_of_path() = (start + count == num_goals);
+                    packet.set_request_id(goalrangereqpacket.get_request_id());
+                    send_reply(requester, packet, packet.goals_size());
+                    shared_variables.logger->info("Sent %u goals beginning with index %u for vehicle %d.", count, start, vehicle_id);
+                }
+            }
         }
-        // If a GoalReqPacket gets transmitted to the main thread.
-        else if(shared_variables.packet_id == Schwarm::GoalReqPacket::PACKET_ID)
+        // If a GoalSubscribePacket gets transmitted to the main thread.
+        else if(id == Schwarm::GoalSubscribePacket::PACKET_ID)
         {
-            /*  If the request for the goal contains a too big number for the index (bigger than the size of the vector)
-            *   an error will be sent to the client to let it know that the index was invalid.
+            subscribepacket.allocate(size);                 // Allocate memory for the packet.
+            subscribepacket.set(request.data.data());       // Set the packet data.
+            if(subscribepacket.decode() != Schwarm::packet_error::PACKET_NONE)
+            {
+                shared_variables.logger->error("Received invalid goal subscription.");
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_SIZE, 0);
+                continue;
+            }
+
+            const int vehicle_id = subscribepacket.get_vehicle_id();
+            const uint32_t request_id = subscribepacket.get_request_id();
+            std::map<int, GoalStream>& streams = get_streams(requester, request.session);
+            if(subscribepacket.get_window() == 0)
+            {
+                // A window of 0 ends the subscription.
+                streams.erase(vehicle_id);
+                shared_variables.logger->info("Ended goal subscription for vehicle %d.", vehicle_id);
+                Schwarm::AcnPacket packet;
+                packet.set_request_id(request_id);
+                send_reply(requester, packet, 0);
+                continue;
+            }
+            if(streams.size() >= MAX_SUBSCRIPTIONS && streams.count(vehicle_id) == 0)
+            {
+                shared_variables.logger->error("Refused goal subscription for vehicle %d, the client has too many subscriptions.", vehicle_id);
+                send_error(requester, Schwarm::packet_error::PACKET_SERVER_BUSY, request_id);
+                continue;
+            }
+
+            /*  A new subscription of the same vehicle replaces the old one.
+            *   A vehicle that has never had goals has no version, unless its first path is being generated it can't be streamed.
             */
-            if(shared_variables.goalreqpacket.get_goal_index() >= goals[shared_variables.goalreqpacket.get_vehicle_id()].size())
+            const uint32_t start = subscribepacket.get_start_index();
+            shared_variables.goals_mutex.lock();
+            auto version_iter = shared_variables.versions.find(vehicle_id);
+            const bool known = version_iter != shared_variables.versions.end();
+            const uint32_t version = known ? version_iter->second : 0;
+            auto vehicle_goals = shared_variables.goals.find(vehicle_id);
+            const uint32_t num_goals = (vehicle_goals != shared_variables.goals.end()) ? vehicle_goals->second.size() : 0;
+            shared_variables.goals_mutex.unlock();
+            const bool pending = generating.count(vehicle_id) != 0;
+            if(!known && !pending)
             {
-                gettime(time);
-                fprintf(shared_variables.logfile, "[%s] [ERROR] Received invalid goal index %u for vehicle %d (Maximum index: %u).\n", time, shared_variables.goalreqpacket.get_goal_index(), shared_variables.goalreqpacket.get_vehicle_id(), goals[shared_variables.goalreqpacket.get_vehicle_id()].size() - 1);
-                // Send the actual packet.
-                send_error(&server.get_socket(0), Schwarm::packet_error::PACKET_INVALID_GOAL);
+                shared_variables.logger->error("Can't stream goals of vehicle %d, the vehicle has no goals.", vehicle_id);
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_GOAL, request_id);
+                streams.erase(vehicle_id);
+                continue;
             }
-            else
+            // Like a goal range request, the first index has to be a goal of the path (otherwise nothing would ever be pushed).
+            if(num_goals > 0 && start >= num_goals)
             {
-                // Otherwise, instead of an error, send the goal to the client if the index is valid.
-                Schwarm::GoalPacket packet;
-                packet.set_goal(goals[shared_variables.goalreqpacket.get_vehicle_id()].at(shared_variables.goalreqpacket.get_goal_index()).x, goals[shared_variables.goalreqpacket.get_vehicle_id()].at(shared_variables.goalreqpacket.get_goal_index()).y);  // Set the goal values.
-                packet.set_vehicle_id(shared_variables.goalreqpacket.get_vehicle_id());
-                packet.allocate(packet.min_size()); // Allocate memory for the packet.
-                packet.encode();                    // Encode the packet to the byte string.
-                server.get_socket(0).send(packet.rawdata(), packet.size(), 0);  // Sent the packet to the client.
-                gettime(time);
-                fprintf(shared_variables.logfile, "[%s] [INFO] Sent goal with index %u for vehicle %d.\n", time, shared_variables.goalreqpacket.get_goal_index(), shared_variables.goalreqpacket.get_goal_index());
+                shared_variables.logger->error("Received invalid goal index %u for vehicle %d (Number of goals: %u).", start, vehicle_id, num_goals);
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_GOAL, request_id);
+                streams.erase(vehicle_id);
+                continue;
+            }
+            GoalStream& stream = streams[vehicle_id];
+            stream = GoalStream(start, subscribepacket.get_window(), request_id, version);
+            shared_variables.logger->info("Received goal subscription for vehicle %d beginning with index %u (window: %u goals).",
+                    vehicle_id, start, stream.get_window());
+
+            // If the path is being generated, the goals are pushed when its notification is handled (after this subscription).
+            if(!pending && !push_goals(requester, vehicle_id, stream, &shared_variables))
+            {
+                shared_variables.logger->error("Can't stream goals of vehicle %d, the vehicle has no goals.", vehicle_id);
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_GOAL, request_id);
+                streams.erase(vehicle_id);
+            }
+        }
+        // If a GoalAckPacket gets transmitted to the main thread.
+        else if(id == Schwarm::GoalAckPacket::PACKET_ID)
+        {
+            ackpacket.allocate(size);                       // Allocate memory for the packet.
+            ackpacket.set(request.data.data());             // Set the packet data.
+            if(ackpacket.decode() != Schwarm::packet_error::PACKET_NONE)
+            {
+                shared_variables.logger->error("Received invalid goal acknowledgement.");
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_SIZE, 0);
+                continue;
+            }
+
+            // Acknowledgements of an ended subscription are ignored, they are sent without waiting for an answer.
+            const int vehicle_id = ackpacket.get_vehicle_id();
+            std::map<int, GoalStream>& streams = get_streams(requester, request.session);
+            auto stream = streams.find(vehicle_id);
+            if(stream == streams.end())
+                continue;
+            stream->second.acknowledge(ackpacket.get_next_index());
+            if(!push_goals(requester, vehicle_id, stream->second, &shared_variables))
+            {
+                send_error(requester, Schwarm::packet_error::PACKET_INVALID_GOAL, stream->second.get_request_id());
+                streams.erase(stream);
             }
-            // After processing the packet, reset the shared memory.
-            shared_variables.packet_id = -1;  // Set packet id to -1 because -1 indicates that no packet was received.
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));  // for low CPU usage
     }
+    // The threads of the slots stop after their timeout, the local clients see the closed connection.
+    for(std::thread& thread : shm_threads)
+        thread.join();
+    if(shared_variables.shm_server != nullptr)
+    {
+        delete(shared_variables.shm_server);
+        shared_variables.logger->info("Stopped shared memory.");
+    }
+
+    if(pregenerator != nullptr)
+    {
+        delete(pregenerator);   // Stops a running scan, it uses the cache.
+        shared_variables.logger->info("Stopped pre-generation.");
+    }
+    delete(generator);  // Finish the running generations before the server stops, they still send replies.
+    shared_variables.logger->info("Stopped generator threads.");
+
+    if(shared_variables.cache != nullptr)
+    {
+        const GoalCacheStats stats = shared_variables.cache->stats();
+        shared_variables.logger->info("Goal cache: %llu hits, %llu hits from the cache directory, %llu misses, %llu evictions, %u entries (%u kB).",
+                (unsigned long long)stats.hits, (unsigned long long)stats.disk_hits, (unsigned long long)stats.misses,
+                (unsigned long long)stats.evictions, (uint32_t)stats.entries, (uint32_t)(stats.bytes / 1024));
+        delete(shared_variables.cache);
+    }
+
     server.stop();  // Stop the server.
-    gettime(time);
-    fprintf(shared_variables.logfile, "[%s] [INFO] Stopped server.\n", time);
+    shared_variables.logger->info("Stopped server.");
 
     handler.stop(); // Stop the socket handler.
-    gettime(time);
-    fprintf(shared_variables.logfile, "[%s] [INFO] Stoppend socket-handler.\n", time);
+    shared_variables.logger->info("Stoppend socket-handler.");
 
+    // The statistics of the connections have been printed when they have been disconnected.
+    for(auto iter = shared_variables.connections.begin(); iter != shared_variables.connections.end(); iter++)
+        delete(iter->second);
+    shared_variables.connections.clear();
+    for(Connection* connection : shared_variables.shm_connections)
+        delete(connection);
+    shared_variables.shm_connections.clear();
+
+    // The logger writes the remaining messages, the exit code is the last line.
+    delete(shared_variables.logger);
+    gettime(time);
     fprintf(shared_variables.logfile, "[%s] Exit code 0\n", time);
     return 0; // You have been terminated.
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+/******************************************************************************************************************************************
+* Title:        Pre-generation benchmark
+* Programtitle: pregen_benchmark
+* Description:
+*   Test of the pre-generation of the path server (Pregenerator) with a directory of images.
+*   The images are generated like in the goal cache benchmark (ellipses and rectangles of different sizes) and written
+*   as PPM files, the goals are generated from the decoded PPM files, so no image library is needed.
+*
+*   It prints:
+*       cold request    -> Time of the first request of every image and number of goals without pre-generation
+*                          (read the file, hash it, generate the goals), average and maximum.
+*       startup scan    -> Time of the scan at the start with one thread and with one thread per core.
+*       warm request    -> Time of the first request after the scan (read the file, hash it, goals from the cache).
+*       watch           -> An image is added to the directory while the server is running: time until its goals
+*                          are in the cache.
+*       inverted scan   -> The first request of an inverted image: scan that generates the inverted goals of every image.
+*   Every goal from the cache is compared with the generated one.
+*
+*   Command syntax:
+*       pregen_benchmark [<image directory>]
+*   The directory has to exist and should be empty (default: a new directory in /tmp that is removed at the end).
+*
+*   Note: POSIX only (mkdtemp).
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <unistd.h>
+#include "pregenerator.h"
+
+using Goal = Path::ntc_coord_t;
+
+struct Image
+{
+    Path::image_info_t info;
+    std::vector<uint8_t> data;
+};
+
+// Draws a thick closed line: every pixel whose "distance" d(x, y) is between 0.9 and 1.0.
+template<typename dist_func>
+static Image gen_image(int width, int height, dist_func d)
+{
+    Image image;
+    image.info = {width, height, 3};
+    image.data.assign(width * height * 3, 0);
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            const float v = d((x - width / 2.0f) / (width * 0.4f), (y - height / 2.0f) / (height * 0.4f));
+            if(v >= 0.9f && v <= 1.0f)
+                memset(&image.data[Path::img_at(x, y, image.info)], 255, 3);
+        }
+    }
+    return image;
+}
+
+static std::vector<Image> gen_corpus(void)
+{
+    std::vector<Image> corpus;
+    const int sizes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}};
+    for(const auto& size : sizes)
+    {
+        corpus.push_back(gen_image(size[0], size[1], [](float x, float y){return std::sqrt(x * x + y * y);}));                     // ellipse
+        corpus.push_back(gen_image(size[0], size[1], [](float x, float y){return std::fmax(std::fabs(x), std::fabs(y));}));       // rectangle
+        corpus.push_back(gen_image(size[0], size[1], [](float x, float y){return std::sqrt(x * x * 1.5f + y * y * 0.7f);}));       // other ellipse
+        corpus.push_back(gen_image(size[0], size[1], [](float x, float y){return std::pow(x * x * x * x + y * y * y * y, 0.25f);})); // rounded rectangle
+    }
+    return corpus;
+}
+
+static bool write_ppm(const std::string& path, const Image& image)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if(file == nullptr)
+        return false;
+    fprintf(file, "P6\n%d %d\n255\n", image.info.width, image.info.height);
+    const bool ok = fwrite(image.data.data(), 1, image.data.size(), file) == image.data.size();
+    return fclose(file) == 0 && ok;
+}
+
+static bool read_file(const std::string& path, std::vector<uint8_t>& content)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == nullptr)
+        return false;
+    fseek(file, 0, SEEK_END);
+    content.resize(ftell(file));
+    fseek(file, 0, SEEK_SET);
+    const bool ok = fread(content.data(), 1, content.size(), file) == content.size();
+    fclose(file);
+    return ok;
+}
+
+// Generates the goals of a PPM file (only the files of write_ppm), replaces Path::generate_goals_from_memory.
+static Path::pathgen_error generate_ppm(const uint8_t* file, size_t size, unsigned int num_goals, bool invert, std::vector<Goal>& goals)
+{
+    const std::string text((const char*)file, std::min<size_t>(size, 32));
+    int width, height, maxval, header;
+    if(sscanf(text.c_str(), "P6 %d %d %d%n", &width, &height, &maxval, &header) != 3 || maxval != 255)
+        return Path::PATHGEN_INVALID_IMAGE;
+    header++;   // the single whitespace after the maximum value
+    const Path::image_info_t info = {width, height, 3};
+    if(width <= 0 || height <= 0 || size - header < (size_t)width * height * 3)
+        return Path::PATHGEN_INVALID_IMAGE;
+    return Path::generate_goals(file + header, info, num_goals, invert, goals);
+}
+
+static bool same_goals(const std::vector<Goal>& a, const std::vector<Goal>& b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(Goal)) == 0;
+}
+
+/*
+*   Waits for the scans of a pre-generator (finished function).
+*/
+struct ScanWaiter
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<PregenStats> scans;
+
+    static void finished(const PregenStats& stats, void* user)
+    {
+        ScanWaiter* waiter = (ScanWaiter*)user;
+        std::lock_guard<std::mutex> lock(waiter->mutex);
+        waiter->scans.push_back(stats);
+        waiter->cv.notify_all();
+    }
+
+    PregenStats wait(size_t num_scans)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->cv.wait(lock, [&](){return this->scans.size() >= num_scans;});
+        return this->scans[num_scans - 1];
+    }
+};
+
+/*
+*   First request of every image and number of goals, like generate_job() of the path server.
+*   Parameters:
+*       cache -> 'nullptr' to generate every request.
+*       reference -> The goals of every request, is filled if cache is 'nullptr'.
+*/
+static bool requests(const char* name, GoalCache* cache, const std::vector<std::string>& files, const std::vector<uint32_t>& goal_counts,
+                     std::vector<std::vector<Goal>>& reference)
+{
+    std::vector<uint8_t> file;
+    std::vector<Goal> goals;
+    double sum_ms = 0.0, max_ms = 0.0;
+    uint32_t hits = 0;
+    size_t i = 0;
+
+    if(cache == nullptr)
+        reference.resize(files.size() * goal_counts.size());
+    for(const std::string& path : files)
+    {
+        for(uint32_t num_goals : goal_counts)
+        {
+            const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+            if(!read_file(path, file))
+            {
+                printf("[ERROR] Failed to read %s.\n", path.c_str());
+                return false;
+            }
+            const GoalCacheKey key = GoalCache::make_key(file.data(), file.size(), num_goals, false);
+            if(cache != nullptr && cache->get(key, goals))
+                hits++;
+            else if(generate_ppm(file.data(), file.size(), num_goals, false, goals) != Path::PATHGEN_NONE)
+            {
+                printf("[ERROR] Failed to generate %s.\n", path.c_str());
+                return false;
+            }
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            sum_ms += ms;
+            max_ms = std::max(max_ms, ms);
+
+            if(cache == nullptr)
+                reference[i] = goals;
+            else if(!same_goals(goals, reference[i]))
+            {
+                printf("[ERROR] %s: goals of %s (%u goals) are wrong.\n", name, path.c_str(), num_goals);
+                return false;
+            }
+            i++;
+        }
+    }
+    printf("%s,%u requests,%u hits,avg %.3f ms,max %.3f ms\n", name, (uint32_t)i, hits, sum_ms / i, max_ms);
+    return true;
+}
+
+static void print_scan(const char* name, unsigned int threads, const PregenStats& stats)
+{
+    printf("%s,%u threads,%u images,%u generated,%u cached,%u failed,%.1f ms\n", name, threads,
+           stats.images, stats.generated, stats.cached, stats.failed, stats.ms);
+}
+
+int main(int argc, char** argv)
+{
+    char temp_dir[] = "/tmp/pregen_benchmark_XXXXXX";
+    const bool own_dir = argc < 2;
+    if(own_dir && mkdtemp(temp_dir) == nullptr)
+    {
+        perror("mkdtemp");
+        return -1;
+    }
+    const std::string directory = own_dir ? temp_dir : argv[1];
+    const std::vector<uint32_t> goal_counts = {100, 250, 500};
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+
+    const std::vector<Image> corpus = gen_corpus();
+    std::vector<std::string> files;
+    for(size_t i = 0; i < corpus.size(); i++)
+    {
+        files.push_back(directory + "/image" + std::to_string(i) + ".ppm");
+        if(!write_ppm(files.back(), corpus[i]))
+        {
+            printf("[ERROR] Failed to write %s.\n", files.back().c_str());
+            return -1;
+        }
+    }
+
+    std::vector<std::vector<Goal>> reference;
+    bool ok = requests("cold request", nullptr, files, goal_counts, reference);
+
+    // Startup scans without watching.
+    const unsigned int thread_counts[] = {1, cores};
+    GoalCache* cache = nullptr;
+    for(unsigned int threads : thread_counts)
+    {
+        delete(cache);
+        cache = new GoalCache(64 * 1024 * 1024, nullptr);
+        ScanWaiter waiter;
+        Pregenerator* pregen = new Pregenerator(directory, goal_counts, cache, threads, generate_ppm, ScanWaiter::finished, &waiter, false);
+        print_scan("startup scan", threads, waiter.wait(1));
+        delete(pregen);
+    }
+    ok = ok && requests("warm request", cache, files, goal_counts, reference);
+
+    // Add an image while the directory is watched.
+    if(ok)
+    {
+        ScanWaiter waiter;
+        Pregenerator* pregen = new Pregenerator(directory, goal_counts, cache, cores, generate_ppm, ScanWaiter::finished, &waiter, true);
+        print_scan("restart scan", cores, waiter.wait(1));
+
+        const Image image = gen_image(1280, 720, [](float x, float y){return std::sqrt(x * x * 0.6f + y * y * 1.4f);});
+        files.push_back(directory + "/added.ppm");
+        const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+        ok = write_ppm(files.back(), image);
+        const PregenStats stats = waiter.wait(2);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        print_scan("watch scan", cores, stats);
+        printf("watch,added image in the cache after %.1f ms (scan %.1f ms)\n", ms, stats.ms);
+        delete(pregen);
+
+        std::vector<uint8_t> file;
+        std::vector<Goal> goals, generated;
+        for(uint32_t num_goals : goal_counts)
+        {
+            ok = ok && read_file(files.back(), file) && cache->get(GoalCache::make_key(file.data(), file.size(), num_goals, false), goals) &&
+                 generate_ppm(file.data(), file.size(), num_goals, false, generated) == Path::PATHGEN_NONE && same_goals(goals, generated);
+        }
+        if(!ok)
+            printf("[ERROR] The goals of the added image are not in the cache.\n");
+    }
+
+    // The first request of an inverted image, the not inverted goals are already in the cache.
+    if(ok)
+    {
+        ScanWaiter waiter;
+        Pregenerator* pregen = new Pregenerator(directory, goal_counts, cache, cores, generate_ppm, ScanWaiter::finished, &waiter, false);
+        waiter.wait(1);
+        pregen->request_seen(true);
+        const PregenStats stats = waiter.wait(2);
+        print_scan("inverted scan", cores, stats);
+        delete(pregen);
+
+        // An inverted image that has no path is not in the cache either.
+        std::vector<uint8_t> file;
+        std::vector<Goal> goals, generated;
+        ok = stats.inverted && stats.generated + stats.failed == files.size() * goal_counts.size();
+        for(const std::string& path : files)
+        {
+            for(uint32_t num_goals : goal_counts)
+            {
+                ok = ok && read_file(path, file);
+                const bool cached = ok && cache->get(GoalCache::make_key(file.data(), file.size(), num_goals, true), goals);
+                const bool valid = ok && generate_ppm(file.data(), file.size(), num_goals, true, generated) == Path::PATHGEN_NONE;
+                ok = ok && cached == valid && (!valid || same_goals(goals, generated));
+            }
+        }
+        if(!ok)
+            printf("[ERROR] The inverted goals are not in the cache.\n");
+    }
+    delete(cache);
+
+    if(own_dir)
+    {
+        for(const std::string& path : files)
+            remove(path.c_str());
+        rmdir(temp_dir);
+    }
+    return ok ? 0 : -1;
+}
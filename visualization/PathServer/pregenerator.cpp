@@ -0,0 +1,280 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <chrono>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "pregenerator.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/inotify.h>
+#endif
+
+#define WATCH_POLL_MS 100       // The background thread checks this often if it has been stopped.
+#define WATCH_QUIET_MS 200      // A scan starts when the directory has not changed for this time.
+
+// The formats that can be decoded (stb_image).
+// The vector drawings (svg, poly) are images of the folder too, the generate function decides how they are read.
+static const char* const IMAGE_EXTENSIONS[] = {"png", "jpg", "jpeg", "bmp", "tga", "gif", "psd", "hdr", "pic", "pnm", "ppm", "pgm", "svg", "poly"};
+
+static bool read_file(const std::string& path, std::vector<uint8_t>& content)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == nullptr)
+        return false;
+
+    uint8_t buff[65536];
+    size_t n;
+    content.clear();
+    while((n = fread(buff, 1, sizeof(buff), file)) > 0)
+        content.insert(content.end(), buff, buff + n);
+    const bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+Pregenerator::Pregenerator(const std::string& directory, const std::vector<uint32_t>& goal_counts, GoalCache* cache, unsigned int num_threads,
+                           generate_func_t generate, finished_func_t finished, void* user, bool watch)
+{
+    this->directory = directory;
+    this->goal_counts = goal_counts;
+    this->cache = cache;
+    this->num_threads = (num_threads < 1) ? 1 : num_threads;
+    this->generate = generate;
+    this->finished = finished;
+    this->user = user;
+    this->watch = watch;
+#ifdef _WIN32
+    this->watch_handle = INVALID_HANDLE_VALUE;
+#else
+    this->watch_fd = -1;
+#endif
+    this->invert = false;
+    this->rescan = false;
+    this->running = true;
+    this->control = std::thread(&Pregenerator::control_loop, this);
+}
+
+Pregenerator::~Pregenerator(void)
+{
+    this->running = false;
+    this->control.join();
+}
+
+void Pregenerator::control_loop(void)
+{
+    // The watch is opened before the first scan, so the changes during the scan are not missed.
+    const bool watching = this->watch && this->open_watch();
+
+    PregenStats stats = this->scan();
+    if(this->finished != nullptr && this->running)
+        this->finished(stats, this->user);
+
+    while(this->wait_for_change(watching))
+    {
+        stats = this->scan();
+        stats.startup = false;
+        if(this->finished != nullptr && this->running)
+            this->finished(stats, this->user);
+    }
+    if(watching)
+        this->close_watch();
+}
+
+PregenStats Pregenerator::scan(void)
+{
+    const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    PregenStats stats;
+    std::vector<std::string> files;
+    list_images(this->directory, files);
+    stats.images = files.size();
+    // A request that changes the settings after this point starts the next scan.
+    this->rescan = false;
+    stats.inverted = this->invert;
+
+    // One task per image, number of goals and variant (not inverted, inverted), every thread takes the next task until all are done.
+    const size_t num_counts = this->goal_counts.size();
+    const size_t num_variants = stats.inverted ? 2 : 1;
+    const size_t num_tasks = files.size() * num_counts * num_variants;
+    std::atomic_size_t next_task{0};
+    std::atomic_uint32_t generated{0}, cached{0}, failed{0};
+    auto work = [&](void)
+    {
+        std::vector<uint8_t> file;
+        std::vector<Path::ntc_coord_t> goals;
+        size_t task;
+        while(this->running && (task = next_task++) < num_tasks)
+        {
+            const uint32_t num_goals = this->goal_counts[(task / num_variants) % num_counts];
+            const bool invert = (task % num_variants) == 1;
+            if(!read_file(files[task / (num_counts * num_variants)], file))
+            {
+                failed++;
+                continue;
+            }
+            // The same key as a request for the image, the request is then answered from the cache.
+            const GoalCacheKey key = GoalCache::make_key(file.data(), file.size(), num_goals, invert);
+            if(this->cache->get(key, goals))
+                cached++;
+            else if(this->generate(file.data(), file.size(), num_goals, invert, goals) == Path::PATHGEN_NONE)
+            {
+                this->cache->put(key, goals);
+                generated++;
+            }
+            else
+                failed++;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    unsigned int i;
+    for(i = 0; i < this->num_threads; i++)
+        threads.emplace_back(work);
+    for(std::thread& thread : threads)
+        thread.join();
+
+    stats.generated = generated;
+    stats.cached = cached;
+    stats.failed = failed;
+    stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return stats;
+}
+
+void Pregenerator::request_seen(bool invert)
+{
+    // Only the first inverted request changes the settings.
+    if(invert && !this->invert.exchange(true))
+        this->rescan = true;
+}
+
+bool Pregenerator::wait_for_change(bool watching)
+{
+    int event = 0;
+    while(this->running && event == 0 && !this->rescan)
+    {
+        if(watching)
+            event = this->wait_for_event(WATCH_POLL_MS);
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(WATCH_POLL_MS));
+    }
+    if(event < 0)
+        return false;
+
+    // Wait until the files have been written completely.
+    if(event == 1)
+    {
+        while(this->running && (event = this->wait_for_event(WATCH_QUIET_MS)) == 1);
+    }
+    return this->running && event >= 0;
+}
+
+#ifdef _WIN32
+bool Pregenerator::open_watch(void)
+{
+    this->watch_handle = FindFirstChangeNotificationA(this->directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    return this->watch_handle != INVALID_HANDLE_VALUE;
+}
+
+void Pregenerator::close_watch(void)
+{
+    FindCloseChangeNotification(this->watch_handle);
+    this->watch_handle = INVALID_HANDLE_VALUE;
+}
+
+int Pregenerator::wait_for_event(int timeout_ms)
+{
+    const DWORD result = WaitForSingleObject(this->watch_handle, timeout_ms);
+    if(result == WAIT_TIMEOUT)
+        return 0;
+    if(result != WAIT_OBJECT_0 || !FindNextChangeNotification(this->watch_handle))
+        return -1;
+    return 1;
+}
+#else
+bool Pregenerator::open_watch(void)
+{
+    this->watch_fd = inotify_init1(IN_NONBLOCK);
+    if(this->watch_fd < 0)
+        return false;
+    // A written file is closed, a copied file is often moved into the directory.
+    if(inotify_add_watch(this->watch_fd, this->directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        this->close_watch();
+        return false;
+    }
+    return true;
+}
+
+void Pregenerator::close_watch(void)
+{
+    close(this->watch_fd);
+    this->watch_fd = -1;
+}
+
+int Pregenerator::wait_for_event(int timeout_ms)
+{
+    pollfd pfd{this->watch_fd, POLLIN, 0};
+    const int result = poll(&pfd, 1, timeout_ms);
+    if(result <= 0)
+        return result;
+
+    // Only the fact that something has changed is needed, the events are discarded.
+    alignas(inotify_event) char buff[4096];
+    while(read(this->watch_fd, buff, sizeof(buff)) > 0);
+    return 1;
+}
+#endif
+
+bool Pregenerator::list_images(const std::string& directory, std::vector<std::string>& files)
+{
+    DIR* dir = opendir(directory.c_str());
+    if(dir == nullptr)
+        return false;
+
+    files.clear();
+    dirent* entry;
+    while((entry = readdir(dir)) != nullptr)
+    {
+        const char* dot = strrchr(entry->d_name, '.');
+        if(dot == nullptr)
+            continue;
+        char extension[8] = {0};
+        size_t i;
+        for(i = 0; i < sizeof(extension) - 1 && dot[i + 1] != '\0'; i++)
+            extension[i] = (char)tolower((unsigned char)dot[i + 1]);
+        if(dot[i + 1] != '\0')
+            continue;   // Too long for an image extension.
+
+        bool is_image = false;
+        for(const char* image_extension : IMAGE_EXTENSIONS)
+            is_image = is_image || strcmp(extension, image_extension) == 0;
+
+        const std::string path = directory + "/" + entry->d_name;
+        struct stat info;
+        if(is_image && stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+            files.push_back(path);
+    }
+    closedir(dir);
+    return true;
+}
+
+bool Pregenerator::parse_goal_counts(const char* list, std::vector<uint32_t>& goal_counts)
+{
+    goal_counts.clear();
+    const char* ptr = list;
+    while(*ptr != '\0')
+    {
+        char* end;
+        const unsigned long n = strtoul(ptr, &end, 10);
+        if(end == ptr || n == 0 || n > UINT32_MAX || (*end != ',' && *end != '\0'))
+            return false;
+        goal_counts.push_back((uint32_t)n);
+        ptr = (*end == ',') ? end + 1 : end;
+    }
+    return !goal_counts.empty();
+}
@@ -0,0 +1,171 @@
+#ifndef __pregenerator_h__
+#define __pregenerator_h__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include "goal_cache.h"
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <thread>
+#else
+    #include <mingw.thread.h>
+#endif
+
+/*
+*   Result of one scan of the image directory.
+*   Members:
+*       images -> Number of image files.
+*       generated -> Goal sets that have been generated.
+*       cached -> Goal sets that have already been in the cache (memory or cache directory).
+*       failed -> Goal sets that could not be generated (e.g. no path in the image).
+*       ms -> Time of the scan.
+*       startup -> True for the scan at the start, false for a scan after the directory or the settings have changed.
+*       inverted -> True if the goals of the inverted images have been generated too.
+*/
+struct PregenStats
+{
+    uint32_t images{0};
+    uint32_t generated{0};
+    uint32_t cached{0};
+    uint32_t failed{0};
+    double ms{0.0};
+    bool startup{true};
+    bool inverted{false};
+};
+
+/*
+*   Class: Pregenerator
+*   Generates the goals of every image of a directory for some numbers of goals in advance and puts them into the goal cache,
+*   so the first request of an image is answered from memory.
+*   The directory is scanned at the start (in the background, the server can already answer requests) and again whenever
+*   an image has been added or changed (inotify on Linux, change notifications on Windows).
+*   Images that are already in the cache are not generated again, so a scan after a change only generates the new images.
+*   The images are generated by several threads at the same time. They are generated not inverted until the first request
+*   of an inverted image (see request_seen(...)), then the directory is scanned again and from then on both variants are
+*   generated. Like this the inverted goals are only generated if a client uses them.
+*/
+class Pregenerator
+{
+public:
+    /*
+    *   Generates the goals of an image file that is in memory (e.g. Path::generate_goals_from_memory).
+    *   Parameters:
+    *       const uint8_t* file -> Content of the image file.
+    *       size_t size -> Size of the file in bytes.
+    *       unsigned int num_goals -> Number of goals.
+    *       bool invert -> Invert the image.
+    *       std::vector<Path::ntc_coord_t>& goals -> Gets the goals.
+    */
+    using generate_func_t = Path::pathgen_error(*)(const uint8_t*, size_t, unsigned int, bool, std::vector<Path::ntc_coord_t>&);
+
+    /*
+    *   Is called by the background thread after every scan.
+    *   Parameters:
+    *       const PregenStats& stats -> Result of the scan.
+    *       void* user -> User pointer of the constructor.
+    */
+    using finished_func_t = void(*)(const PregenStats&, void*);
+
+private:
+    std::string directory;
+    std::vector<uint32_t> goal_counts;
+    GoalCache* cache;
+    unsigned int num_threads;
+    generate_func_t generate;
+    finished_func_t finished;
+    void* user;
+    bool watch;
+    std::atomic_bool running;
+    std::atomic_bool invert;    // Also generate the goals of the inverted images.
+    std::atomic_bool rescan;    // A request has changed the settings, the directory has to be scanned again.
+    std::thread control;
+#ifdef _WIN32
+    void* watch_handle;     // Change notification handle of the directory.
+#else
+    int watch_fd;           // inotify instance that watches the directory.
+#endif
+
+    // Loop of the background thread: the scan at the start, then a scan after every change of the directory.
+    void control_loop(void);
+
+    // Return: false if the directory can't be watched.
+    bool open_watch(void);
+    void close_watch(void);
+
+    /*
+    *   Waits for a change of the directory.
+    *   Parameters:
+    *       int timeout_ms -> Maximum time to wait.
+    *   Return:
+    *       1 if a file has been added or changed, 0 if nothing has changed, -1 on an error.
+    */
+    int wait_for_event(int);
+
+    /*
+    *   Waits until files of the directory have been added or changed and no further change follows for a moment
+    *   (a file that is being copied causes several events), or until a request has changed the settings.
+    *   Parameters:
+    *       bool watching -> False if the directory is not watched, then only the settings are waited for.
+    *   Return:
+    *       False if the pre-generator has been stopped.
+    */
+    bool wait_for_change(bool);
+
+public:
+    /*
+    *   Starts the scan of the directory in the background.
+    *   Parameters:
+    *       const std::string& directory -> The image directory (the files directly in it, not the subdirectories).
+    *       const std::vector<uint32_t>& goal_counts -> Numbers of goals that are generated for every image.
+    *       GoalCache* cache -> The cache that gets the goals.
+    *       unsigned int num_threads -> Number of threads that generate the goals (at least 1).
+    *       generate_func_t generate -> Generates the goals of an image.
+    *       finished_func_t finished -> Is called after every scan, can be 'nullptr'.
+    *       void* user -> User pointer for the finished function.
+    *       bool watch -> Scan the directory again when it changes.
+    */
+    Pregenerator(const std::string&, const std::vector<uint32_t>&, GoalCache*, unsigned int, generate_func_t, finished_func_t, void*, bool);
+
+    Pregenerator(const Pregenerator&) = delete;
+    Pregenerator& operator=(const Pregenerator&) = delete;
+
+    // Stops the background thread, a running scan is cancelled after the images that are being generated.
+    virtual ~Pregenerator(void);
+
+    /*
+    *   Scans the directory once and generates the goals of the images that are not in the cache.
+    *   Is called by the background thread, can also be called directly (e.g. with watch disabled).
+    *   Return:
+    *       Result of the scan.
+    */
+    PregenStats scan(void);
+
+    /*
+    *   Tells the pre-generator the settings of a generate request, is called for every request (cheap, thread safe).
+    *   The first request of an inverted image starts a scan that generates the inverted goals of every image.
+    *   Parameters:
+    *       bool invert -> The request inverts the image.
+    */
+    void request_seen(bool);
+
+    /*
+    *   Lists the image files of a directory (by the file extension).
+    *   Parameters:
+    *       const std::string& directory -> The directory.
+    *       std::vector<std::string>& files -> Gets the paths of the image files.
+    *   Return:
+    *       False if the directory can't be opened.
+    */
+    static bool list_images(const std::string&, std::vector<std::string>&);
+
+    /*
+    *   Parses a list of numbers of goals, e.g. "100,250,500".
+    *   Return:
+    *       False if the list contains something else than positive numbers.
+    */
+    static bool parse_goal_counts(const char*, std::vector<uint32_t>&);
+};
+
+#endif // __pregenerator_h__
@@ -0,0 +1,55 @@
+#include "request_queue.h"
+
+RequestQueue::RequestQueue(size_t capacity)
+{
+    this->capacity = (capacity == 0) ? 1 : capacity;
+    this->closed = false;
+}
+
+bool RequestQueue::push(Request& request)
+{
+    std::unique_lock<std::mutex> lock(this->mtx);
+    this->not_full.wait(lock, [this](){return this->closed || this->requests.size() < this->capacity;});
+    if(this->closed)
+        return false;
+
+    this->requests.emplace_back();
+    this->requests.back().context = request.context;
+    this->requests.back().session = request.session;
+    this->requests.back().data.swap(request.data);
+    lock.unlock();
+    this->not_empty.notify_one();   // There is only one consumer.
+    return true;
+}
+
+bool RequestQueue::pop(Request& request)
+{
+    std::unique_lock<std::mutex> lock(this->mtx);
+    this->not_empty.wait(lock, [this](){return this->closed || !this->requests.empty();});
+    if(this->closed)
+        return false;
+
+    request.context = this->requests.front().context;
+    request.session = this->requests.front().session;
+    request.data = std::move(this->requests.front().data);
+    this->requests.pop_front();
+    lock.unlock();
+    this->not_full.notify_one();
+    return true;
+}
+
+void RequestQueue::close(void)
+{
+    this->mtx.lock();
+    this->closed = true;
+    this->requests.clear();
+    this->mtx.unlock();
+    this->not_empty.notify_all();
+    this->not_full.notify_all();
+}
+
+size_t RequestQueue::size(void)
+{
+    std::lock_guard<std::mutex> lock(this->mtx);
+    return this->requests.size();
+}
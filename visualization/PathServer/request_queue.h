@@ -0,0 +1,84 @@
+#ifndef __request_queue_h__
+#define __request_queue_h__
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <mutex>
+    #include <condition_variable>
+#else
+    #include <mingw.mutex.h>
+    #include <mingw.condition_variable.h>
+#endif
+
+/*
+*   One received request.
+*   Members:
+*       context -> Who sent the request and gets the reply (e.g. the connection), the queue does not use it.
+*       session -> Session of the context when the request was received, e.g. to detect a reconnect of the client.
+*       data -> The whole packet as it has been received (header and data).
+*/
+struct Request
+{
+    void* context{nullptr};
+    uint32_t session{0};
+    std::vector<uint8_t> data;
+};
+
+/*
+*   Class: RequestQueue
+*   Hands the received requests of several receiver threads over to one thread that processes them (multiple producer, single consumer).
+*   The consumer sleeps until a request arrives, so a request is processed as soon as it has been received.
+*   The requests are processed in the order they have been pushed, the requests of one receiver thread stay in order.
+*   If the queue is full, the receiver threads wait (the clients can not flood the memory of the server).
+*/
+class RequestQueue
+{
+private:
+    std::mutex mtx;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<Request> requests;
+    size_t capacity;
+    bool closed;
+
+public:
+    /*
+    *   Parameters:
+    *       size_t capacity -> Maximum number of waiting requests (at least 1).
+    */
+    RequestQueue(size_t);
+
+    RequestQueue(const RequestQueue&) = delete;
+    RequestQueue& operator=(const RequestQueue&) = delete;
+
+    virtual ~RequestQueue(void) = default;
+
+    /*
+    *   Adds a request, waits while the queue is full.
+    *   Parameters:
+    *       Request& request -> The request, the data is moved into the queue.
+    *   Return:
+    *       False if the queue has been closed, the request is dropped.
+    */
+    bool push(Request&);
+
+    /*
+    *   Takes the oldest request, waits until there is one.
+    *   Parameters:
+    *       Request& request -> Gets the request.
+    *   Return:
+    *       False if the queue has been closed.
+    */
+    bool pop(Request&);
+
+    // Wakes up all waiting threads, the waiting requests are dropped.
+    void close(void);
+
+    // Return: number of waiting requests.
+    size_t size(void);
+};
+
+#endif // __request_queue_h__
@@ -15,6 +15,8 @@ int decode_command(char* buff, char(*ret_args)[128]);
 void on_command(int len, char(*args)[128], SH::Client& client);
 void process_packet(uint8_t* buff);
 
+static uint32_t next_request_id = 1;    // echoed by the server, 0 is reserved for packets that are not an answer
+
 void on_connect(cppsock::socket* socket, void** persistant, error_t error)
 {
     if(error != SH::error_code_t::HANDLER_NO_ERROR)
@@ -34,7 +36,7 @@ void on_receive(cppsock::socket* socket, void** persistant, SH::data_channel cha
 {
     uint8_t buff1[5];
     socket->recv(buff1, sizeof(buff1), channel | MSG_PEEK);
-    const size_t* packet_size = Schwarm::Packet::size_ptr(buff1);
+    const uint32_t* packet_size = Schwarm::Packet::size_ptr(buff1);
     uint8_t buff2[*packet_size];
     socket->recv(buff2, sizeof(buff2), channel); 
 
@@ -70,10 +72,11 @@ void on_command(int len, char(*args)[128], SH::Client& client)
         packet.set_num_goals(num_goals);
         packet.set_vehicle_id(vehicle_id);
         packet.should_invert() = false;
+        packet.set_request_id(next_request_id++);
         packet.allocate(packet.min_size() + packet.filepath_size());
         packet.encode();
         client.get_socket().send(packet.rawdata(), packet.size(), 0);
-        printf("Sent generate packet\n");
+        printf("Sent generate packet (request %u)\n", packet.get_request_id());
     }
     else if(strcmp(args[0], "goal") == 0)
     {
@@ -88,10 +91,71 @@ void on_command(int len, char(*args)[128], SH::Client& client)
         Schwarm::GoalReqPacket packet;
         packet.set_goal_index(idx);
         packet.set_vehicle_id(vehicle_id);
+        packet.set_request_id(next_request_id++);
+        packet.allocate(packet.min_size());
+        packet.encode();
+        client.get_socket().send(packet.rawdata(), packet.size(), 0);
+        printf("Sent goal request packet (request %u)\n", packet.get_request_id());
+    }
+    else if(strcmp(args[0], "goals") == 0)
+    {
+        // goals <start index> <count> <vehicle id>
+        if(len != 4)
+            return;
+        uint32_t start, count;
+        int vehicle_id;
+        sscanf(args[1], "%u", &start);
+        sscanf(args[2], "%u", &count);
+        sscanf(args[3], "%d", &vehicle_id);
+
+        Schwarm::GoalRangeReqPacket packet;
+        packet.set_start_index(start);
+        packet.set_count(count);
+        packet.set_vehicle_id(vehicle_id);
+        packet.set_request_id(next_request_id++);
+        packet.allocate(packet.min_size());
+        packet.encode();
+        client.get_socket().send(packet.rawdata(), packet.size(), 0);
+        printf("Sent goal range request packet (request %u)\n", packet.get_request_id());
+    }
+    else if(strcmp(args[0], "subscribe") == 0)
+    {
+        // subscribe <start index> <window> <vehicle id>, a window of 0 ends the subscription
+        if(len != 4)
+            return;
+        uint32_t start, window;
+        int vehicle_id;
+        sscanf(args[1], "%u", &start);
+        sscanf(args[2], "%u", &window);
+        sscanf(args[3], "%d", &vehicle_id);
+
+        Schwarm::GoalSubscribePacket packet;
+        packet.set_start_index(start);
+        packet.set_window(window);
+        packet.set_vehicle_id(vehicle_id);
+        packet.set_request_id(next_request_id++);
+        packet.allocate(packet.min_size());
+        packet.encode();
+        client.get_socket().send(packet.rawdata(), packet.size(), 0);
+        printf("Sent goal subscription packet (request %u)\n", packet.get_request_id());
+    }
+    else if(strcmp(args[0], "ack") == 0)
+    {
+        // ack <next index> <vehicle id>
+        if(len != 3)
+            return;
+        uint32_t next;
+        int vehicle_id;
+        sscanf(args[1], "%u", &next);
+        sscanf(args[2], "%d", &vehicle_id);
+
+        Schwarm::GoalAckPacket packet;
+        packet.set_next_index(next);
+        packet.set_vehicle_id(vehicle_id);
         packet.allocate(packet.min_size());
         packet.encode();
         client.get_socket().send(packet.rawdata(), packet.size(), 0);
-        printf("Sent goal request packet\n");
+        printf("Sent goal acknowledgement packet\n");
     }
     else if(strcmp(args[0], "exit") == 0)
     {
@@ -109,30 +173,46 @@ void on_command(int len, char(*args)[128], SH::Client& client)
 
 void process_packet(uint8_t* buff)
 {
-    const uint8_t* id = Schwarm::Packet::id_ptr(buff);
-    const size_t* size = Schwarm::Packet::size_ptr(buff);
+    const uint8_t id = Schwarm::Packet::get_id(buff);
+    const uint32_t* size = Schwarm::Packet::size_ptr(buff);
 
-    if(*id == Schwarm::AcnPacket::PACKET_ID)
+    if(id == Schwarm::AcnPacket::PACKET_ID)
     {
-        printf("Successfully generated path.");
+        Schwarm::AcnPacket packet;
+        packet.allocate(*size);
+        packet.set(buff);
+        packet.decode();
+
+        printf("[request %u] Successfully generated path.\n", packet.get_request_id());
     }
-    else if(*id == Schwarm::GoalPacket::PACKET_ID)
+    else if(id == Schwarm::GoalPacket::PACKET_ID)
     {
         Schwarm::GoalPacket packet;
         packet.allocate(*size);
         packet.set(buff);
         packet.decode();
 
-        printf("GOAL -> X: %f Y: %f Vehicle: %d\n", packet.get_goal_x(), packet.get_goal_y(), packet.get_vehicle_id());
+        printf("[request %u] GOAL -> X: %f Y: %f Vehicle: %d\n", packet.get_request_id(), packet.get_goal_x(), packet.get_goal_y(), packet.get_vehicle_id());
+    }
+    else if(id == Schwarm::GoalListPacket::PACKET_ID)
+    {
+        Schwarm::GoalListPacket packet;
+        packet.allocate(*size);
+        packet.set(buff);
+        packet.decode();
+
+        printf("[request %u] GOALS %u - %u of %u (end of path: %d) Vehicle: %d\n", packet.get_request_id(), packet.get_start_index(), packet.get_start_index() + packet.get_num_goals(), packet.get_total_goals(), packet.is_end_of_path(), packet.get_vehicle_id());
+        for(uint32_t i = 0; i < packet.get_num_goals(); i++)
+            printf("    X: %f Y: %f\n", packet.get_goal_x(i), packet.get_goal_y(i));
     }
-    else if(*id == Schwarm::ErrorPacket::PACKET_ID)
+    else if(id == Schwarm::ErrorPacket::PACKET_ID)
     {
         Schwarm::ErrorPacket packet;
         packet.allocate(*size);
         packet.set(buff);
         packet.decode();
 
-        printf("%s", Schwarm::Packet::strerror(packet.get_code()));
+        printf("[request %u] %s\n", packet.get_request_id(), Schwarm::Packet::strerror(packet.get_code()));
     }
 }
 
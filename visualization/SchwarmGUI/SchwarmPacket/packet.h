@@ -1,6 +1,6 @@
 #ifndef __schwarm_packet_h__
 #define __schwarm_packet_h__
-
+#define _CRT_SECURE_NO_WARNINGS
 #include <cstdint>
 
 namespace Schwarm
@@ -13,14 +13,29 @@ namespace Schwarm
 
         PACKET_FAILED_GENERATING_PATH,
         PACKET_INVALID_GOAL,
-        PACKET_SERVER_BUSY
+        PACKET_SERVER_BUSY,
+        PACKET_INVALID_SIZE
     };
 
+    /*  HEADER:
+    *       id | length | (data)
+    *       1B | 4B     |
+    *   If FLAG_EXT_HEADER is set in the id byte, the extended header follows the length:
+    *       id | length | sequence number | timestamp | (data)
+    *       1B | 4B     | 4B              | 8B        |
+    *   The timestamp is the monotonic time (ns) of encode(), the sequence number is set by the sender.
+    *   Receivers that do not know the flag reject the packet with PACKET_INVALID_ID instead of
+    *   misinterpreting the data, so the extended header is only sent if the sender enables it.
+    */
     class Packet
     {
     private:
         uint8_t* __data;
         uint32_t data_size;
+        uint32_t alloc_size;    // capacity of __data, the buffer is reused as long as it is big enough
+        bool ext_header;
+        uint32_t sequence;
+        uint64_t timestamp;
 
         void free(void);
 
@@ -32,6 +47,10 @@ namespace Schwarm
     public:
         static constexpr uint32_t SIZE_ID            = sizeof(uint8_t);
         static constexpr uint32_t SIZE_PACKET_LENGTH = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_SEQUENCE      = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_TIMESTAMP     = sizeof(uint64_t);
+        static constexpr uint32_t SIZE_EXT_HEADER    = SIZE_SEQUENCE + SIZE_TIMESTAMP;
+        static constexpr uint8_t  FLAG_EXT_HEADER    = 0x80;    // set in the id byte
 
         Packet(void);
         Packet(const Packet&);
@@ -48,12 +67,37 @@ namespace Schwarm
         uint32_t        size(void)      const noexcept;
         const uint8_t*  data(void)      const;
         const uint8_t*  rawdata(void)   const;
-        virtual inline uint32_t min_size(void) const noexcept {return SIZE_ID + SIZE_PACKET_LENGTH;}
+        virtual inline uint32_t min_size(void) const noexcept {return this->header_size();}
+        inline uint32_t header_size(void) const noexcept {return SIZE_ID + SIZE_PACKET_LENGTH + (this->ext_header ? SIZE_EXT_HEADER : 0);}
+
+        /*
+        *   Enables or disables the extended header for the next encode().
+        *   Has to be called before allocate(), because it changes the size of the packet.
+        *   decode() sets it according to the flag of the received packet.
+        */
+        void set_ext_header(bool)       noexcept;
+        bool has_ext_header(void)       const noexcept;
+
+        void     set_sequence(uint32_t) noexcept;
+        uint32_t get_sequence(void)     const noexcept;
+        uint64_t get_timestamp(void)    const noexcept;     // send time (ns), only valid with the extended header
 
         static const uint8_t*   id_ptr(const uint8_t*);
         static const uint32_t*  size_ptr(const uint8_t*);
         static const uint8_t*   data_ptr(const uint8_t*);
 
+        /*
+        *   Returns the packet id of raw packet data without the header flags.
+        *   Has to be used instead of *id_ptr() to dispatch received packets.
+        */
+        static uint8_t get_id(const uint8_t*);
+
+        /*
+        *   Monotonic time in nanoseconds that is used for the timestamps.
+        *   Only comparable between processes on the same machine.
+        */
+        static uint64_t monotonic_time(void) noexcept;
+
         static const char* strerror(packet_error) noexcept;
 
         Packet& operator=(const Packet&);
@@ -85,16 +129,20 @@ namespace Schwarm
     };
 
     /*  DATA STRUCTURE:
-    *       id | length | (no extra data)
-    *       1B | 4B     | 0B  
+    *       id | length | request id
+    *       1B | 4B     | 4B
     */
 
     class AcnPacket : public Packet
     {
+    private:
+        uint32_t request_id;
+
     public:
         static constexpr uint8_t PACKET_ID = 1;
+        static constexpr uint32_t SIZE_REQUEST_ID = sizeof(uint32_t);
 
-        AcnPacket(void) = default;
+        AcnPacket(void);
         AcnPacket(const AcnPacket&);
         AcnPacket(AcnPacket&&);
         virtual ~AcnPacket(void) {/*dtor*/}
@@ -103,14 +151,18 @@ namespace Schwarm
         virtual packet_error decode(void);
 
         virtual inline uint8_t id(void) const noexcept  {return PACKET_ID;}
+        virtual inline uint32_t min_size(void) const noexcept {return this->header_size() + SIZE_REQUEST_ID;}
+
+        void     set_request_id(uint32_t)   noexcept;
+        uint32_t get_request_id(void)       const noexcept;
 
         AcnPacket& operator=(const AcnPacket&);
         AcnPacket& operator=(AcnPacket&&);
     };
 
     /*  DATA STRUCTURE:
-    *       id | length | error code
-    *       1B | 4B     | 4B  
+    *       id | length | error code | request id
+    *       1B | 4B     | 4B         | 4B
     */
 
     class ErrorPacket : public Packet
@@ -123,10 +175,12 @@ namespace Schwarm
         *       PACKET_SERVER_BUSY:             SERVER IS BUSY GENERATING PATH
         */
         packet_error error_code;
+        uint32_t request_id;
 
     public:
         static constexpr uint8_t PACKET_ID = 2;
         static constexpr uint32_t ERROR_CODE_SIZE = sizeof(packet_error);
+        static constexpr uint32_t SIZE_REQUEST_ID = sizeof(uint32_t);
 
         ErrorPacket(void);
         ErrorPacket(const ErrorPacket&);
@@ -137,18 +191,21 @@ namespace Schwarm
         virtual packet_error decode(void);
 
         virtual inline uint8_t id(void) const noexcept      {return PACKET_ID;}
-        virtual inline uint32_t min_size(void) const noexcept {return SIZE_ID + SIZE_PACKET_LENGTH + ERROR_CODE_SIZE;}
+        virtual inline uint32_t min_size(void) const noexcept {return this->header_size() + ERROR_CODE_SIZE + SIZE_REQUEST_ID;}
 
         void            set_code(packet_error)  noexcept;
         packet_error    get_code(void)          const noexcept;
 
+        void     set_request_id(uint32_t)   noexcept;
+        uint32_t get_request_id(void)       const noexcept;
+
         ErrorPacket& operator=(const ErrorPacket&);
         ErrorPacket& operator=(ErrorPacket&&);
     };
 
     /*  DATA STRUCTURE:
-    *       id | length | num goals | vehicle id | invert |filename / path
-    *       1B | 4B     | 4B        | 4B         | 1B     | x bytes
+    *       id | length | num goals | vehicle id | invert | request id | filename / path
+    *       1B | 4B     | 4B        | 4B         | 1B     | 4B         | x bytes
     */
 
     class PathGeneratePacket : public Packet
@@ -157,6 +214,7 @@ namespace Schwarm
         unsigned int num_goals;
         int vehicle_id;
         bool invert;
+        uint32_t request_id;
         char* filepath;
         uint32_t fp_allocsize;
 
@@ -168,6 +226,7 @@ namespace Schwarm
         static constexpr uint32_t SIZE_NUM_GOALS = sizeof(unsigned int);
         static constexpr uint32_t SIZE_INVERT = sizeof(bool);
         static constexpr uint32_t SIZE_VEHICLE_ID = sizeof(int);
+        static constexpr uint32_t SIZE_REQUEST_ID = sizeof(uint32_t);
 
         PathGeneratePacket(void);
         PathGeneratePacket(const PathGeneratePacket&);
@@ -178,7 +237,7 @@ namespace Schwarm
         virtual packet_error decode(void);
 
         virtual inline uint8_t id(void) const noexcept      {return PACKET_ID;}
-        virtual inline uint32_t min_size(void) const noexcept {return SIZE_ID + SIZE_PACKET_LENGTH + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT;}
+        virtual inline uint32_t min_size(void) const noexcept {return this->header_size() + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT + SIZE_REQUEST_ID;}
 
         void            set_num_goals(unsigned int) noexcept;
         unsigned int    get_num_goals(void)         const noexcept;
@@ -189,6 +248,9 @@ namespace Schwarm
         bool& should_invert(void)   noexcept;
         bool  should_invert(void)   const noexcept;
 
+        void     set_request_id(uint32_t)   noexcept;
+        uint32_t get_request_id(void)       const noexcept;
+
         void        set_filepath(const char*)   noexcept;
         const char* get_filepath(void)          const noexcept;
         uint32_t      filepath_size(void)         const noexcept;
@@ -198,8 +260,11 @@ namespace Schwarm
     };
 
     /*  DATA STRUCTURE:
-    *       id | length | goal index | vehicle id 
-    *       1B | 4B     | 4B         | 4B
+    *       id | length | goal index | vehicle id | request id
+    *       1B | 4B     | 4B         | 4B         | 4B
+    *   The request id is chosen by the client and echoed in the answer (GoalPacket, AcnPacket or ErrorPacket),
+    *   so several requests can be outstanding on one connection. The server answers them in order.
+    *   Request id 0 is reserved for packets that are not an answer.
     */
 
     class GoalReqPacket : public Packet
@@ -207,11 +272,13 @@ namespace Schwarm
     private:
         unsigned int goal_idx;
         int vehicle_id;
+        uint32_t request_id;
 
     public:
         static constexpr uint8_t PACKET_ID = 4;
         static constexpr uint32_t SIZE_GOAL_IDX = sizeof(uint32_t);
         static constexpr uint32_t SIZE_VEHICLE_ID = sizeof(int);
+        static constexpr uint32_t SIZE_REQUEST_ID = sizeof(uint32_t);
 
         GoalReqPacket(void);
         GoalReqPacket(const GoalReqPacket&);
@@ -222,7 +289,7 @@ namespace Schwarm
         virtual packet_error decode(void);
 
         virtual inline uint8_t id(void) const noexcept      {return PACKET_ID;}
-        virtual inline uint32_t min_size(void) const noexcept {return SIZE_ID + SIZE_PACKET_LENGTH + SIZE_GOAL_IDX + SIZE_VEHICLE_ID;}
+        virtual inline uint32_t min_size(void) const noexcept {return this->header_size() + SIZE_GOAL_IDX + SIZE_VEHICLE_ID + SIZE_REQUEST_ID;}
 
         void    set_goal_index(uint32_t)  noexcept;
         uint32_t  get_goal_index(void)    const noexcept;
@@ -230,13 +297,17 @@ namespace Schwarm
         void set_vehicle_id(int)    noexcept;
         int  get_vehicle_id(void)   const noexcept;
 
+        void     set_request_id(uint32_t)   noexcept;
+        uint32_t get_request_id(void)       const noexcept;
+
         GoalReqPacket& operator=(const GoalReqPacket&);
         GoalReqPacket& operator=(GoalReqPacket&&);
     };
 
     /*  DATA STRUCTURE:
-    *       id | length | goal | vehicle id
-    *       1B | 4B     | 8B   | 4B
+    *       id | length | goal | vehicle id | request id
+    *       1B | 4B     | 8B   | 4B         | 4B
+    *   The request id is the one of the answered request, 0 if the goal is not an answer.
     */
 
     class GoalPacket : public Packet
@@ -244,11 +315,13 @@ namespace Schwarm
     private:
         float goal_x, goal_y;
         int vehicle_id;
+        uint32_t request_id;
 
     public:
         static constexpr uint8_t PACKET_ID = 5;
         static constexpr uint32_t SIZE_GOAL = 2 * sizeof(float);
         static constexpr uint32_t SIZE_VEHICLE_ID = sizeof(int);
+        static constexpr uint32_t SIZE_REQUEST_ID = sizeof(uint32_t);
 
         GoalPacket(void);
         GoalPacket(const GoalPacket&);
@@ -259,7 +332,7 @@ namespace Schwarm
         virtual packet_error decode(void);
 
         virtual inline uint8_t id(void) const noexcept          {return PACKET_ID;}
-        virtual inline uint32_t min_size(void) const noexcept   {return SIZE_ID + SIZE_PACKET_LENGTH + SIZE_GOAL + SIZE_VEHICLE_ID;}
+        virtual inline uint32_t min_size(void) const noexcept   {return this->header_size() + SIZE_GOAL + SIZE_VEHICLE_ID + SIZE_REQUEST_ID;}
 
         void    set_goal(float, float)  noexcept;
         float   get_goal_x(void)        const noexcept;
@@ -268,6 +341,9 @@ namespace Schwarm
         void set_vehicle_id(int)    noexcept;
         int  get_vehicle_id(void)   const noexcept;
 
+        void     set_request_id(uint32_t)   noexcept;
+        uint32_t get_request_id(void)       const noexcept;
+
         GoalPacket& operator=(const GoalPacket&);
         GoalPacket& operator=(GoalPacket&&);
     };
@@ -290,15 +366,15 @@ namespace Schwarm
         static constexpr uint32_t SIZE_LENGTH       = sizeof(float);
 
         VehicleCommandPacket(void);
-        VehicleCommandPacket(const GoalPacket&);
-        VehicleCommandPacket(GoalPacket&&);
+        VehicleCommandPacket(const VehicleCommandPacket&);
+        VehicleCommandPacket(VehicleCommandPacket&&);
         virtual ~VehicleCommandPacket(void) {/*dtor*/ }
 
         virtual packet_error encode(void);
         virtual packet_error decode(void);
 
         virtual inline uint8_t id(void) const noexcept { return PACKET_ID; }
-        virtual inline uint32_t min_size(void) const noexcept { return SIZE_ID + SIZE_PACKET_LENGTH + SIZE_VEHICLE_ID + SIZE_ANGLE + SIZE_LENGTH; }
+        virtual inline uint32_t min_size(void) const noexcept { return this->header_size() + SIZE_VEHICLE_ID + SIZE_ANGLE + SIZE_LENGTH; }
 
         void     set_vehicle_id(uint32_t)   noexcept;
         uint32_t get_vehicle_id(void)       const noexcept;
@@ -312,6 +388,281 @@ namespace Schwarm
         VehicleCommandPacket& operator=(const VehicleCommandPacket&);
         VehicleCommandPacket& operator=(VehicleCommandPacket&&);
     };
+
+    /*  DATA STRUCTURE:
+    *       id | length | number of packets | packet 1 | packet 2 | ... | packet n
+    *       1B | 4B     | 4B                | x bytes  | x bytes  | ... | x bytes
+    *   Every sub-packet is a complete encoded packet (with its own id and length),
+    *   this allows to send the packets of a whole tick with one single write.
+    */
+    class BatchPacket : public Packet
+    {
+    private:
+        uint32_t num_packets;
+        uint8_t* payload;           // encoded sub-packets, reused between ticks
+        uint32_t payload_size;
+        uint32_t payload_allocsize;
+        uint32_t payload_offset;    // != 0 if the sub-packets are still in the received data (at this offset)
+
+        void alloc_payload(uint32_t);
+        void free_payload(void);
+        void own_payload(void);
+
+    public:
+        static constexpr uint8_t PACKET_ID = 7;
+        static constexpr uint32_t SIZE_NUM_PACKETS = sizeof(uint32_t);
+
+        BatchPacket(void);
+        BatchPacket(const BatchPacket&);
+        BatchPacket(BatchPacket&&);
+        virtual ~BatchPacket(void);
+
+        virtual packet_error encode(void);
+        virtual packet_error decode(void);
+
+        virtual inline uint8_t id(void) const noexcept { return PACKET_ID; }
+        virtual inline uint32_t min_size(void) const noexcept { return this->header_size() + SIZE_NUM_PACKETS; }
+
+        /*
+        *   Appends an already encoded packet to the batch.
+        *   The memory of the batch is kept, clear() only resets the content.
+        *   decode() does not copy the sub-packets, they are copied out of the received data by the first add().
+        *   Because of this a decoded batch that is encoded again without add() must keep its header (allocate() reuses
+        *   the buffer with the sub-packets), otherwise encode() returns PACKET_INVALID_SIZE.
+        */
+        packet_error add(const Packet&);
+        void clear(void) noexcept;
+
+        uint32_t get_num_packets(void)  const noexcept;
+        uint32_t batch_size(void)       const noexcept;     // size of all sub-packets in bytes
+
+        /*
+        *   Iterates the sub-packets of an encoded or decoded batch without copying them.
+        *   The returned pointer points to the raw data of the sub-packet (id | length | data)
+        *   and can be used with Packet::id_ptr(), Packet::size_ptr() and Packet::set().
+        *   Return:
+        *       Pointer to the sub-packet or 'nullptr' if there is no (further) sub-packet.
+        */
+        const uint8_t* first(void)              const noexcept;
+        const uint8_t* next(const uint8_t*)     const noexcept;
+
+        BatchPacket& operator=(const BatchPacket&);
+        BatchPacket& operator=(BatchPacket&&);
+    };
+
+    /*  DATA STRUCTURE:
+    *       id | length | vehicle id | start index | count | request id
+    *       1B | 4B     | 4B         | 4B          | 4B    | 4B
+    *   Requests up to 'count' goals of a vehicle beginning at 'start index'.
+    */
+
+    class GoalRangeReqPacket : public Packet
+    {
+    private:
+        int vehicle_id;
+        uint32_t start_idx;
+        uint32_t count;
+        uint32_t request_id;
+
+    public:
+        static constexpr uint8_t PACKET_ID = 8;
+        static constexpr uint32_t SIZE_VEHICLE_ID = sizeof(int);
+        static constexpr uint32_t SIZE_START_IDX = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_COUNT = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_REQUEST_ID = sizeof(uint32_t);
+
+        GoalRangeReqPacket(void);
+        GoalRangeReqPacket(const GoalRangeReqPacket&);
+        GoalRangeReqPacket(GoalRangeReqPacket&&);
+        virtual ~GoalRangeReqPacket(void) {/*dtor*/}
+
+        virtual packet_error encode(void);
+        virtual packet_error decode(void);
+
+        virtual inline uint8_t id(void) const noexcept          {return PACKET_ID;}
+        virtual inline uint32_t min_size(void) const noexcept   {return this->header_size() + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_COUNT + SIZE_REQUEST_ID;}
+
+        void set_vehicle_id(int)    noexcept;
+        int  get_vehicle_id(void)   const noexcept;
+
+        void     set_start_index(uint32_t)  noexcept;
+        uint32_t get_start_index(void)      const noexcept;
+
+        void     set_count(uint32_t)    noexcept;
+        uint32_t get_count(void)        const noexcept;
+
+        void     set_request_id(uint32_t)   noexcept;
+        uint32_t get_request_id(void)       const noexcept;
+
+        GoalRangeReqPacket& operator=(const GoalRangeReqPacket&);
+        GoalRangeReqPacket& operator=(GoalRangeReqPacket&&);
+    };
+
+    /*  DATA STRUCTURE:
+    *       id | length | vehicle id | start index | total goals | end of path | number of goals | request id | goals (x, y)
+    *       1B | 4B     | 4B         | 4B          | 4B          | 1B          | 4B              | 4B         | n * 8B
+    *   Answer to a GoalRangeReqPacket (with its request id), the goals are packed float pairs.
+    *   'end of path' is set if the list contains the last goal of the path.
+    */
+
+    class GoalListPacket : public Packet
+    {
+    private:
+        int vehicle_id;
+        uint32_t start_idx;
+        uint32_t total_goals;
+        bool end_of_path;
+        uint32_t num_goals;
+        uint32_t request_id;
+        float* goals;
+        uint32_t goals_allocsize;   // number of goals that fit into 'goals'
+
+        void alloc_goals(uint32_t);
+        void free_goals(void);
+
+    public:
+        static constexpr uint8_t PACKET_ID = 9;
+        static constexpr uint32_t SIZE_VEHICLE_ID = sizeof(int);
+        static constexpr uint32_t SIZE_START_IDX = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_TOTAL_GOALS = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_END_OF_PATH = sizeof(bool);
+        static constexpr uint32_t SIZE_NUM_GOALS = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_REQUEST_ID = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_GOAL = 2 * sizeof(float);
+        static constexpr uint32_t MAX_GOALS = 1024;     // maximum number of goals in one list
+        static constexpr uint32_t MAX_SIZE  = SIZE_ID + SIZE_PACKET_LENGTH + SIZE_EXT_HEADER + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS + SIZE_END_OF_PATH + SIZE_NUM_GOALS + SIZE_REQUEST_ID + MAX_GOALS * SIZE_GOAL;
+
+        GoalListPacket(void);
+        GoalListPacket(const GoalListPacket&);
+        GoalListPacket(GoalListPacket&&);
+        virtual ~GoalListPacket(void);
+
+        virtual packet_error encode(void);
+        virtual packet_error decode(void);
+
+        virtual inline uint8_t id(void) const noexcept          {return PACKET_ID;}
+        virtual inline uint32_t min_size(void) const noexcept   {return this->header_size() + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS + SIZE_END_OF_PATH + SIZE_NUM_GOALS + SIZE_REQUEST_ID;}
+
+        void set_vehicle_id(int)    noexcept;
+        int  get_vehicle_id(void)   const noexcept;
+
+        void     set_start_index(uint32_t)  noexcept;
+        uint32_t get_start_index(void)      const noexcept;
+
+        void     set_total_goals(uint32_t)  noexcept;
+        uint32_t get_total_goals(void)      const noexcept;
+
+        bool& is_end_of_path(void)  noexcept;
+        bool  is_end_of_path(void)  const noexcept;
+
+        void     set_request_id(uint32_t)   noexcept;
+        uint32_t get_request_id(void)       const noexcept;
+
+        /*
+        *   Sets the goals of the list.
+        *   Parameters:
+        *       const float* goals -> Packed goals (x0, y0, x1, y1, ...).
+        *       uint32_t n -> Number of goals (not floats), is limited to MAX_GOALS.
+        */
+        void     set_goals(const float*, uint32_t);
+        uint32_t get_num_goals(void)        const noexcept;
+        float    get_goal_x(uint32_t)       const noexcept;
+        float    get_goal_y(uint32_t)       const noexcept;
+        uint32_t goals_size(void)           const noexcept;     // size of the goals in bytes
+
+        GoalListPacket& operator=(const GoalListPacket&);
+        GoalListPacket& operator=(GoalListPacket&&);
+    };
+    /*  DATA STRUCTURE:
+    *       id | length | vehicle id | start index | window | request id
+    *       1B | 4B     | 4B         | 4B          | 4B     | 4B
+    *   Subscribes the goals of a vehicle. The server pushes the goals beginning at 'start index' as GoalListPackets
+    *   (with the request id of the subscription), the client does not have to request them.
+    *   At most 'window' goals are sent ahead of the goals that the client has acknowledged (GoalAckPacket).
+    *   If the vehicle gets a new path, it is pushed from the beginning (start index 0).
+    *   A window of 0 ends the subscription, this is answered with an AcnPacket.
+    */
+
+    class GoalSubscribePacket : public Packet
+    {
+    private:
+        int vehicle_id;
+        uint32_t start_idx;
+        uint32_t window;
+        uint32_t request_id;
+
+    public:
+        static constexpr uint8_t PACKET_ID = 10;
+        static constexpr uint32_t SIZE_VEHICLE_ID = sizeof(int);
+        static constexpr uint32_t SIZE_START_IDX = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_WINDOW = sizeof(uint32_t);
+        static constexpr uint32_t SIZE_REQUEST_ID = sizeof(uint32_t);
+
+        GoalSubscribePacket(void);
+        GoalSubscribePacket(const GoalSubscribePacket&);
+        GoalSubscribePacket(GoalSubscribePacket&&);
+        virtual ~GoalSubscribePacket(void) {/*dtor*/}
+
+        virtual packet_error encode(void);
+        virtual packet_error decode(void);
+
+        virtual inline uint8_t id(void) const noexcept          {return PACKET_ID;}
+        virtual inline uint32_t min_size(void) const noexcept   {return this->header_size() + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_WINDOW + SIZE_REQUEST_ID;}
+
+        void set_vehicle_id(int)    noexcept;
+        int  get_vehicle_id(void)   const noexcept;
+
+        void     set_start_index(uint32_t)  noexcept;
+        uint32_t get_start_index(void)      const noexcept;
+
+        void     set_window(uint32_t)   noexcept;
+        uint32_t get_window(void)       const noexcept;
+
+        void     set_request_id(uint32_t)   noexcept;
+        uint32_t get_request_id(void)       const noexcept;
+
+        GoalSubscribePacket& operator=(const GoalSubscribePacket&);
+        GoalSubscribePacket& operator=(GoalSubscribePacket&&);
+    };
+
+    /*  DATA STRUCTURE:
+    *       id | length | vehicle id | next index
+    *       1B | 4B     | 4B         | 4B
+    *   Acknowledges the pushed goals of a subscription: the client has used the goals before 'next index'.
+    *   The server then pushes the following goals, there is no answer.
+    */
+
+    class GoalAckPacket : public Packet
+    {
+    private:
+        int vehicle_id;
+        uint32_t next_idx;
+
+    public:
+        static constexpr uint8_t PACKET_ID = 11;
+        static constexpr uint32_t SIZE_VEHICLE_ID = sizeof(int);
+        static constexpr uint32_t SIZE_NEXT_IDX = sizeof(uint32_t);
+
+        GoalAckPacket(void);
+        GoalAckPacket(const GoalAckPacket&);
+        GoalAckPacket(GoalAckPacket&&);
+        virtual ~GoalAckPacket(void) {/*dtor*/}
+
+        virtual packet_error encode(void);
+        virtual packet_error decode(void);
+
+        virtual inline uint8_t id(void) const noexcept          {return PACKET_ID;}
+        virtual inline uint32_t min_size(void) const noexcept   {return this->header_size() + SIZE_VEHICLE_ID + SIZE_NEXT_IDX;}
+
+        void set_vehicle_id(int)    noexcept;
+        int  get_vehicle_id(void)   const noexcept;
+
+        void     set_next_index(uint32_t)   noexcept;
+        uint32_t get_next_index(void)       const noexcept;
+
+        GoalAckPacket& operator=(const GoalAckPacket&);
+        GoalAckPacket& operator=(GoalAckPacket&&);
+    };
 };
 
 #endif //__schwarm_packet_h__
\ No newline at end of file
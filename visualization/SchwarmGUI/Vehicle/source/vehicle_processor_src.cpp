@@ -58,11 +58,31 @@ void VehicleProcessor::process(VehicleProcessor* processor)
             for(size_t i=0; i < vehicle_buffer->get_num_vehicles(); i+=2)
                 goal_indices[i / 2] = 0;
 
+            // The goals are requested in windows, not every goal costs a round-trip to the path server.
+            GoalWindow* goal_windows = new GoalWindow[vehicle_buffer->get_num_vehicles() / 2];
+
+            // Replies of an interrupted simulation are not needed anymore.
+            (*processor->shared_memory)[Schwarm::Client::GENERAL].sync.lock();
+            (*processor->shared_memory)[Schwarm::Client::PATH_SERVER].goalpackets.clear();
+            (*processor->shared_memory)[Schwarm::Client::PATH_SERVER].goallistpackets.clear();
+            (*processor->shared_memory)[Schwarm::Client::PATH_SERVER].errorpackets.clear();
+            (*processor->shared_memory)[Schwarm::Client::GENERAL].sync.unlock();
+
+            // All vehicle commands of one tick are collected and sent with a single write.
+            // The batch keeps its memory, so there is no reallocation every tick.
+            Schwarm::BatchPacket commands;
+            Schwarm::VehicleCommandPacket command;
+
+            // The goal requests of one tick are also sent with a single write, several requests can be outstanding.
+            Schwarm::BatchPacket requests;
+
             std::chrono::time_point tstart = std::chrono::high_resolution_clock::now();
             do
             {
                 uint64_t deltatime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - tstart).count();
                 tstart = std::chrono::high_resolution_clock::now();
+                commands.clear();
+                requests.clear();
                 for (size_t i = 0; i < vehicle_buffer->get_num_vehicles(); i+=2)
                 {
                     Vehicle* cur_vehicle = vehicle_buffer->get_vehicle(i);
@@ -71,45 +91,75 @@ void VehicleProcessor::process(VehicleProcessor* processor)
                     // Get goal if vehicles hasn't got one.
                     if (simu_states[i/2] && cur_vehicle->goal_needed())
                     {
-                        // Create request for goal.
-                        GoalReqPacket request;
-                        request.set_goal_index(goal_indices[i / 2]++);
-                        request.set_vehicle_id(i / 2);
-                        request.allocate(request.min_size());
-                        request.encode();
-                        // Send request for a goal.
-                        (*processor->shared_memory)[Schwarm::Client::PATH_SERVER].client->send(request.rawdata(), request.size(), 0);
-
-                        // Wait until a packet is received (either a GoalPacket or an ErrorPacket).
-                        // break the waiting if processor was stopped or simulation was stopped
-                        while (processor->running &&
-                            (*processor->shared_memory)[Schwarm::Client::GENERAL].start &&
-                            (*processor->shared_memory)[Schwarm::Client::PATH_SERVER].recv_packed_id == -1)
-                        {
-                            std::this_thread::yield();
-                        }
+                        GoalWindow& window = goal_windows[i / 2];
+
+                        Schwarm::Client::SharedMemory& path_server = (*processor->shared_memory)[Schwarm::Client::PATH_SERVER];
 
-                        // Error case
-                        if ((*processor->shared_memory)[Schwarm::Client::PATH_SERVER].recv_packed_id == ErrorPacket::PACKET_ID)
+                        // Take the reply of the outstanding request if it has been received (either a GoalListPacket or an ErrorPacket).
+                        if (window.pending_request != 0)
                         {
-                            // Simulation is finished if client receives a PACKET_INVALID_GOAL
-                            // Mutex requiered because .get_code() is not atomic.
                             (*processor->shared_memory)[Schwarm::Client::GENERAL].sync.lock();
-                            bool is_invalid = ((*processor->shared_memory)[Schwarm::Client::PATH_SERVER].errorpacket.get_code() == Schwarm::packet_error::PACKET_INVALID_GOAL);
+                            auto error = path_server.errorpackets.find(window.pending_request);
+                            auto list = path_server.goallistpackets.find(window.pending_request);
+                            if (error != path_server.errorpackets.end())
+                            {
+                                // Simulation is finished if client receives a PACKET_INVALID_GOAL
+                                if (error->second.get_code() == Schwarm::packet_error::PACKET_INVALID_GOAL)
+                                    std::cout << get_msg("INFO / SIMU") << "Simulation finished for vehicle " << i/2 << std::endl;
+                                else
+                                    std::cout << get_msg("ERROR / SIMU") << "Simultion failed for vehicle " << i/2 << std::endl;
+                                simu_states[i/2] = false;
+                                path_server.errorpackets.erase(error);
+                                window.pending_request = 0;
+                            }
+                            else if (list != path_server.goallistpackets.end())
+                            {
+                                // Append the received normalized texture coordinates to the remaining goals of the window.
+                                window.goals.erase(window.goals.begin(), window.goals.begin() + window.next);
+                                window.next = 0;
+                                for (uint32_t g = 0; g < list->second.get_num_goals(); g++)
+                                    window.goals.push_back(glm::vec2(list->second.get_goal_x(g), list->second.get_goal_y(g)));
+                                window.end_of_path = list->second.is_end_of_path();
+                                goal_indices[i / 2] += list->second.get_num_goals();
+                                path_server.goallistpackets.erase(list);
+                                window.pending_request = 0;
+                            }
                             (*processor->shared_memory)[Schwarm::Client::GENERAL].sync.unlock();
-                            if (is_invalid)
-                                std::cout << get_msg("INFO / SIMU") << "Simulation finished for vehicle " << i/2 << std::endl;
-                            else
-                                std::cout << get_msg("ERROR / SIMU") << "Simultion failed for vehicle " << i/2 << std::endl;
-                            simu_states[i/2] = false;
                         }
-                        else if ((*processor->shared_memory)[Schwarm::Client::PATH_SERVER].recv_packed_id == GoalPacket::PACKET_ID)
+
+                        /*  Request the next goals of the path before all received goals have been used,
+                        *   the vehicle keeps driving while the request is outstanding. The requests of all vehicles
+                        *   are sent at the end of the tick and are answered in order by the path server.
+                        */
+                        if (simu_states[i / 2] && window.pending_request == 0 && !window.end_of_path &&
+                            window.goals.size() - window.next <= GOAL_WINDOW_SIZE / 2)
                         {
-                            // Get the received normalized texture coordinates.
-                            (*processor->shared_memory)[Schwarm::Client::GENERAL].sync.lock();
-                            const float ntc_x = (*processor->shared_memory)[Schwarm::Client::PATH_SERVER].goalpacket.get_goal_x();
-                            const float ntc_y = (*processor->shared_memory)[Schwarm::Client::PATH_SERVER].goalpacket.get_goal_y();
-                            (*processor->shared_memory)[Schwarm::Client::GENERAL].sync.unlock();
+                            // Create request for a range of goals.
+                            GoalRangeReqPacket request;
+                            request.set_vehicle_id(i / 2);
+                            request.set_start_index(goal_indices[i / 2]);
+                            request.set_count(GOAL_WINDOW_SIZE);
+                            request.set_request_id(path_server.next_request_id++);
+                            if (Schwarm::SEND_EXT_HEADER)
+                                path_server.send_stats.stamp(request);
+                            request.allocate(request.min_size());
+                            request.encode();
+                            requests.add(request);
+                            window.pending_request = request.get_request_id();
+                        }
+
+                        // The whole path has been received and driven.
+                        if (simu_states[i / 2] && window.next >= window.goals.size() && window.end_of_path)
+                        {
+                            std::cout << get_msg("INFO / SIMU") << "Simulation finished for vehicle " << i/2 << std::endl;
+                            simu_states[i / 2] = false;
+                        }
+                        else if (simu_states[i / 2] && window.next < window.goals.size())
+                        {
+                            // Get the next normalized texture coordinates.
+                            const float ntc_x = window.goals[window.next].x;
+                            const float ntc_y = window.goals[window.next].y;
+                            window.next++;
 
                             // Calculate the real position from the normalized coordinates.
                             // Formula: origin + size * normalized_position
@@ -158,17 +208,17 @@ void VehicleProcessor::process(VehicleProcessor* processor)
 
                             if (real)
                             {
-                                // encode and send vehicle command packet
-                                Schwarm::VehicleCommandPacket command;
+                                // encode vehicle command packet, it is sent at the end of the tick
                                 command.set_vehicle_id(i / 2);
                                 command.set_angle(beta - alpha);
                                 command.set_length(cur_vehicle->get_distance());
+                                if (Schwarm::SEND_EXT_HEADER)
+                                    (*processor->shared_memory)[Schwarm::Client::CONTROL_SERVER].send_stats.stamp(command);
                                 command.allocate(command.min_size());
                                 command.encode();
-                                (*processor->shared_memory)[Schwarm::Client::CONTROL_SERVER].client->send(command.rawdata(), command.size(), 0);
+                                commands.add(command);
                             }
                         }
-                        (*processor->shared_memory)[Schwarm::Client::PATH_SERVER].recv_packed_id = -1;
                     }
                     // Move vehicle if vehicle has goal and simulation is processed is for that vehicle
                     if (simu_states[i / 2] && !cur_vehicle->goal_needed())
@@ -227,6 +277,22 @@ void VehicleProcessor::process(VehicleProcessor* processor)
                         }
                     }
                 }
+
+                // send the goal requests of this tick, the replies are taken in the next ticks
+                if (requests.get_num_packets() > 0)
+                {
+                    requests.allocate(requests.min_size() + requests.batch_size());
+                    requests.encode();
+                    Schwarm::Client::send_to_path_server((*processor->shared_memory)[Schwarm::Client::PATH_SERVER], requests.rawdata(), requests.size());
+                }
+
+                // send the vehicle commands of this tick
+                if (real && commands.get_num_packets() > 0)
+                {
+                    commands.allocate(commands.min_size() + commands.batch_size());
+                    commands.encode();
+                    (*processor->shared_memory)[Schwarm::Client::CONTROL_SERVER].client->send(commands.rawdata(), commands.size(), 0);
+                }
             }
             while(processor->running && (*processor->shared_memory)[Schwarm::Client::GENERAL].start && !simu_finished(simu_states, vehicle_buffer->get_num_vehicles() / 2));
             /*  1) Interrupt simulation if thread (vehicle-processor) shuts down.
@@ -240,6 +306,7 @@ void VehicleProcessor::process(VehicleProcessor* processor)
                 std::cout << get_msg("INFO / SIMU") << "Simulation interrupted." << std::endl;
             delete[](simu_states);
             delete[](goal_indices);
+            delete[](goal_windows);
             (*processor->shared_memory)[Schwarm::Client::GENERAL].start = false;
         }
         // While waiting for simulation to start, sleep 5 milliseconds for low CPU-usage.
@@ -156,6 +156,20 @@ namespace Schwarm
         std::map<Schwarm::Client::ClientType, Schwarm::Client::SharedMemory>* shared_memory;
         std::chrono::milliseconds tickspeed;
 
+        /*
+        *   Goals of one vehicle that have been received and not used yet.
+        *   The next list is requested when half of the window has been used, so the reply
+        *   usually arrives before the vehicle runs out of goals.
+        */
+        struct GoalWindow
+        {
+            std::vector<glm::vec2> goals;
+            size_t next{0};
+            bool end_of_path{false};
+            uint32_t pending_request{0};    // request id of the outstanding GoalRangeReqPacket, 0 if there is none
+        };
+        static constexpr uint32_t GOAL_WINDOW_SIZE = 64;    // number of goals that are requested at once
+
         static void process(VehicleProcessor*);
 
         /*
@@ -34,7 +34,8 @@ void Client::on_path_receive(std::shared_ptr<cppsock::tcp::socket> socket, cppso
 
     const uint32_t* packet_size = Packet::size_ptr(buff1);    // Get size of the packet.
 
-    if (*packet_size > 100)
+    // A goal list is the biggest packet the path server sends.
+    if (*packet_size > GoalListPacket::MAX_SIZE)
         return;
 
     uint8_t buff2[*packet_size];                            // Create a second buffer with the size of the packet.
@@ -75,9 +76,17 @@ void Client::on_detection_receive(std::shared_ptr<cppsock::tcp::socket> socket,
     socket->recv(buff2, sizeof(buff2), cppsock::waitall);       // internal compiler error: bug report
 
     // process detection packet
-    uint8_t id = *Packet::id_ptr(buff2);
+    uint8_t id = Packet::get_id(buff2);
     uint32_t size = *Packet::size_ptr(buff2);
 
+    // the detection sends the current position every few milliseconds, the statistics show how old it is
+    if (mem != nullptr)
+    {
+        (*mem)[GENERAL].sync.lock();
+        (*mem)[DETECTION_SERVER].recv_stats.record(buff2, size);
+        (*mem)[GENERAL].sync.unlock();
+    }
+
     if (id == GoalPacket::PACKET_ID && mem != nullptr)
     {
         GoalPacket detec;
@@ -98,39 +107,115 @@ void Client::process_packet(uint8_t* buff, void** persistent)
 {
     std::map<Schwarm::Client::ClientType, Schwarm::Client::SharedMemory>* mem = (std::map<Schwarm::Client::ClientType, Schwarm::Client::SharedMemory>*)*persistent;
 
-    const uint8_t* id = Packet::id_ptr(buff);       // get id of packet
+    const uint8_t id = Packet::get_id(buff);        // get id of packet (without header flags)
     const uint32_t* size = Packet::size_ptr(buff);    // get size of packet
 
-    if(*id == AcnPacket::PACKET_ID)
+    // called by the socket handler and by the receiver of the shared memory
+    if (mem != nullptr)
+    {
+        (*mem)[GENERAL].sync.lock();
+        (*mem)[PATH_SERVER].recv_stats.record(buff, *size);
+        (*mem)[GENERAL].sync.unlock();
+    }
+
+    if(id == AcnPacket::PACKET_ID)
     {
         std::cout << get_msg("INFO / CLIENT") << "Successfully generated path." << std::endl;
     }
-    else if(*id == ErrorPacket::PACKET_ID)
+    else if(id == ErrorPacket::PACKET_ID)
     {
-        if(mem != nullptr && (*mem)[PATH_SERVER].recv_packed_id == -1)
+        ErrorPacket packet;
+        packet.allocate(*size);
+        packet.set(buff);
+        if(mem != nullptr && packet.decode() == packet_error::PACKET_NONE)
         {
+            // Nobody waits for the answer of a path generation, the other errors are taken by the vehicle processor.
+            if(packet.get_code() == packet_error::PACKET_FAILED_GENERATING_PATH)
+            {
+                std::cout << get_msg("ERROR / CLIENT") << "Failed to generate path." << std::endl;
+                return;
+            }
             (*mem)[GENERAL].sync.lock();
-            (*mem)[PATH_SERVER].errorpacket.allocate(*size);
-            (*mem)[PATH_SERVER].errorpacket.set(buff);
-            (*mem)[PATH_SERVER].errorpacket.decode();
+            (*mem)[PATH_SERVER].errorpackets[packet.get_request_id()] = std::move(packet);
             (*mem)[GENERAL].sync.unlock();
-            (*mem)[PATH_SERVER].recv_packed_id = *id;
         }
     }
-    else if(*id == GoalPacket::PACKET_ID)
+    else if(id == GoalPacket::PACKET_ID)
     {
-        if(mem != nullptr && (*mem)[PATH_SERVER].recv_packed_id == -1)
-        {  
+        GoalPacket packet;
+        packet.allocate(*size);
+        packet.set(buff);
+        if(mem != nullptr && packet.decode() == packet_error::PACKET_NONE)
+        {
+            (*mem)[GENERAL].sync.lock();
+            (*mem)[PATH_SERVER].goalpackets[packet.get_request_id()] = std::move(packet);
+            (*mem)[GENERAL].sync.unlock();
+        }
+    }
+    else if(id == GoalListPacket::PACKET_ID)
+    {
+        GoalListPacket packet;
+        packet.allocate(*size);
+        packet.set(buff);
+        if(mem != nullptr && packet.decode() == packet_error::PACKET_NONE)
+        {
             (*mem)[GENERAL].sync.lock();
-            (*mem)[PATH_SERVER].goalpacket.allocate(*size);
-            (*mem)[PATH_SERVER].goalpacket.set(buff);
-            (*mem)[PATH_SERVER].goalpacket.decode();
+            (*mem)[PATH_SERVER].goallistpackets[packet.get_request_id()] = std::move(packet);
             (*mem)[GENERAL].sync.unlock();
-            (*mem)[PATH_SERVER].recv_packed_id = *id;
         }
     }
 }
 
+bool Client::connect_path_shm(std::map<ClientType, SharedMemory>* mem)
+{
+    if (!is_local_address(PATH_SERVER_ADDR))
+        return false;
+
+    SharedMemory& path_server = (*mem)[PATH_SERVER];
+    path_server.shm = shm_connect(PATH_SERVER_PORT);
+    if (path_server.shm == nullptr)
+        return false;
+    path_server.shm_receiver = std::thread(Client::run_shm_receiver, path_server.shm, (void*)mem);
+    return true;
+}
+
+void Client::disconnect_path_shm(std::map<ClientType, SharedMemory>* mem)
+{
+    SharedMemory& path_server = (*mem)[PATH_SERVER];
+    if (path_server.shm == nullptr)
+        return;
+
+    // The receiving thread returns when the connection is closed.
+    path_server.shm->close();
+    path_server.shm_receiver.join();
+    path_server.shm_send_mutex.lock();
+    delete(path_server.shm);
+    path_server.shm = nullptr;
+    path_server.shm_send_mutex.unlock();
+}
+
+void Client::run_shm_receiver(ShmEndpoint* shm, void* persistent)
+{
+    std::vector<uint8_t> buff;
+    int ret;
+    while ((ret = shm->recv(buff, 100)) >= 0)
+    {
+        // The same packets as from the socket.
+        if (ret > 0)
+            process_packet(buff.data(), &persistent);
+    }
+    std::cout << get_msg("INFO / CLIENT") << "Shared memory of the path server closed." << std::endl;
+}
+
+void Client::send_to_path_server(SharedMemory& path_server, const uint8_t* data, uint32_t size)
+{
+    std::lock_guard<std::mutex> lock(path_server.shm_send_mutex);
+    if (path_server.shm != nullptr)
+        path_server.shm->send(data, size);
+    else
+        path_server.client->send(data, size, 0);
+}
+
 void Client::run_pathserver(std::atomic_bool* running, const std::string* imgfolder)
 {
     *running = true;
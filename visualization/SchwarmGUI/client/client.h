@@ -2,9 +2,12 @@
 #define __schwarm_client_h__
 
 #include "../SchwarmPacket/packet.h"
+#include "../SchwarmPacket/linkstats.h"
+#include "../SchwarmPacket/shm_transport.h"
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <map>
 #include <cppsock.hpp>
 
 namespace Schwarm
@@ -17,6 +20,10 @@ namespace Schwarm
     constexpr char CONTROL_SERVER_ADDR[] = "10.0.0.216";
     constexpr uint16_t CONTROL_SERVER_PORT = 10002;
 
+    // Send sequence numbers and timestamps (extended header) to the path and control server.
+    // Servers that do not know the extended header reject these packets, set to 'false' for them.
+    constexpr bool SEND_EXT_HEADER = true;
+
     namespace Client
     {
         enum ClientType
@@ -42,10 +49,28 @@ namespace Schwarm
             std::atomic_bool real{ false };
             void* vehicles{ nullptr };          // cant use vehicle-buffer-pointer 
 
-            // used for PATH_SERVER
+            // delay and lost packets of the link (extended header)
+            LinkStats recv_stats;               // packets from the server, guarded by the sync mutex of GENERAL (the path server has two receiving threads with its shared memory)
+            LinkStats send_stats;               // numbers the packets that are sent to the server
+
             std::atomic_int recv_packed_id{-1};
-            GoalPacket goalpacket;
-            ErrorPacket errorpacket;
+
+            /*  used for PATH_SERVER
+            *   The replies are stored by their request id (guarded by the sync mutex of GENERAL),
+            *   so several requests can be outstanding on the connection.
+            */
+            std::atomic_uint32_t next_request_id{1};    // 0 is reserved for packets that are not an answer
+            std::map<uint32_t, GoalPacket> goalpackets;
+            std::map<uint32_t, GoalListPacket> goallistpackets;
+            std::map<uint32_t, ErrorPacket> errorpackets;
+
+            /*  used for PATH_SERVER
+            *   If the path server runs on this machine, the packets go through its shared memory instead of the socket.
+            *   The socket stays connected (e.g. for the exit packet).
+            */
+            ShmEndpoint* shm{ nullptr };
+            std::mutex shm_send_mutex;          // the shared memory has one sender at a time
+            std::thread shm_receiver;
 
             // only used for detection
             std::map<uint8_t, DetecCoord> detec_coords;
@@ -86,6 +111,39 @@ namespace Schwarm
         */
         void process_packet(uint8_t*, void**);
 
+        /*
+        *   Connects to the shared memory of the path server if the path server runs on this machine.
+        *   Parameters:
+        *       std::map<ClientType, SharedMemory>* mem -> The shared memory of all clients.
+        *   Return:
+        *       'false' if the path server is not local or has no shared memory, the socket is used then.
+        */
+        bool connect_path_shm(std::map<ClientType, SharedMemory>*);
+
+        /*
+        *   Closes the shared memory of the path server and waits for its receiving thread.
+        *   Parameters:
+        *       std::map<ClientType, SharedMemory>* mem -> The shared memory of all clients.
+        */
+        void disconnect_path_shm(std::map<ClientType, SharedMemory>*);
+
+        /*
+        *   Function that is called within the receiving thread of the shared memory.
+        *   Parameters:
+        *       ShmEndpoint* shm -> The connection to the path server.
+        *       void* persistent -> Pointer to the shared memory of all clients.
+        */
+        void run_shm_receiver(ShmEndpoint*, void*);
+
+        /*
+        *   Sends a packet to the path server, through the shared memory if it is connected, otherwise through the socket.
+        *   Parameters:
+        *       SharedMemory& path_server -> Shared memory of the path server client.
+        *       const uint8_t* data -> The encoded packet.
+        *       uint32_t size -> Size of the packet.
+        */
+        void send_to_path_server(SharedMemory&, const uint8_t*, uint32_t);
+
         /*
         *    Function that is called within the thread.
         *    Parameters:
@@ -83,11 +83,12 @@ namespace Schwarm
                     packet.set_filepath(args[2].c_str());   // Initialize packet.
                     packet.set_vehicle_id(vehicle_id);
                     packet.set_num_goals(number_of_goals);
+                    packet.set_request_id((*shared_memory)[Schwarm::Client::PATH_SERVER].next_request_id++);
                     packet.allocate(packet.min_size() + packet.filepath_size());    // Allocate memory for packet.
                     packet.encode();    // Encode packet.
 
                     std::cout << get_msg("INFO / CLIENT") << "Generating path from file \"" << args[2] << "\"..." << std::endl;
-                    (*shared_memory)[Schwarm::Client::PATH_SERVER].client->send(packet.rawdata(), packet.size(), 0);   // Send packet.
+                    Schwarm::Client::send_to_path_server((*shared_memory)[Schwarm::Client::PATH_SERVER], packet.rawdata(), packet.size());   // Send packet.
                 }
                 else if(args[1] == "start")
                 {
@@ -150,9 +151,10 @@ namespace Schwarm
                         Schwarm::PathGeneratePacket packet;
                         packet.set_filepath("%delete");         // %delete tells the server to delete the path
                         packet.set_vehicle_id(idx);     
+                        packet.set_request_id((*shared_memory)[Schwarm::Client::PATH_SERVER].next_request_id++);
                         packet.allocate(packet.min_size() + packet.filepath_size());
                         packet.encode();
-                        (*shared_memory)[Schwarm::Client::PATH_SERVER].client->send(packet.rawdata(), packet.size(), 0);
+                        Schwarm::Client::send_to_path_server((*shared_memory)[Schwarm::Client::PATH_SERVER], packet.rawdata(), packet.size());
                         std::cout << get_msg("INFO / CLIENT") << "Path resetted for vehicle: " << idx << "." << std::endl;
                     }
                 }
@@ -698,6 +698,9 @@ int main()  // its showtime
     }
     shared_memory[Schwarm::Client::PATH_SERVER].client = path_server_collection.insert(path_client, &shared_memory);
     std::cout << get_msg("INFO / PATH-SERVER") << "Connected to path server!" << std::endl;
+    // A local path server is used through its shared memory, the socket stays connected.
+    if (Schwarm::Client::connect_path_shm(&shared_memory))
+        std::cout << get_msg("INFO / PATH-SERVER") << "Using shared memory of the local path server." << std::endl;
 
 #if 0
     // connect to detection
@@ -1123,6 +1126,7 @@ int main()  // its showtime
     std::cout << get_msg("INFO / OpenGL WINDOW") << "OpenGL window Closed." << std::endl;
     std::cout << get_msg("INFO / OpenGL") << "OpenGL content successfully terminated." << std::endl;
 
+    Schwarm::Client::disconnect_path_shm(&shared_memory);
     path_server_collection.clear();
     //detection_server_collection.clear();
     //control_client->close();
@@ -1135,6 +1139,12 @@ int main()  // its showtime
     std::cout <<  get_msg("INFO") << "MAX-Frame-Time: " << max_time(time_results) / 1000.0f / 1000.0f << "ms / frame" << std::endl;
     std::cout <<  get_msg("INFO") << "AVG-Frame-Time: " << avg_time(time_results) / 1000.0f / 1000.0f << "ms / frame" << std::endl;
 
+    // delay and lost packets of the received packets (only if the servers send the extended header)
+    shared_memory[Schwarm::Client::GENERAL].sync.lock();
+    shared_memory[Schwarm::Client::PATH_SERVER].recv_stats.print(stdout, "path server -> visualization");
+    shared_memory[Schwarm::Client::DETECTION_SERVER].recv_stats.print(stdout, "detection -> visualization");
+    shared_memory[Schwarm::Client::GENERAL].sync.unlock();
+
     std::cout << get_msg("INFO / EXIT") << "Exit status 0." << std::endl;
     return 0;   // you have been terminated
 }
@@ -0,0 +1,176 @@
+#include "batch.h"
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <set>
+#include <atomic>
+#include <algorithm>
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <thread>
+#else
+    #include <mingw.thread.h>
+#endif
+
+using namespace Path;
+
+/*
+*   Parses one line of a manifest file.
+*   Return: 1 if the line is a job, 0 if it is empty or a comment, -1 if it is invalid.
+*/
+static int parse_job(const char* line, batch_job_t& job)
+{
+    while(isspace((unsigned char)*line))
+        line++;
+    if(*line == '\0' || *line == '#')
+        return 0;
+
+    // Path to the image, maybe in quotes.
+    const char* end;
+    if(*line == '"')
+    {
+        end = strchr(++line, '"');
+        if(end == nullptr)
+            return -1;
+        job.image.assign(line, end++);
+    }
+    else
+    {
+        for(end = line; *end != '\0' && !isspace((unsigned char)*end); end++);
+        job.image.assign(line, end);
+    }
+    if(job.image.empty())
+        return -1;
+
+    // Number of goals, vehicle id and the optional flag.
+    int length = 0;
+    while(isspace((unsigned char)*end))
+        end++;
+    if(!isdigit((unsigned char)*end) || sscanf(end, "%u %d %n", &job.num_goals, &job.vehicle_id, &length) < 2 || length == 0)
+        return -1;
+    end += length;
+    if(*end != '\0' && !isspace((unsigned char)end[-1]))
+        return -1;
+    job.invert = strncmp(end, "-invert", 7) == 0 && (end[7] == '\0' || isspace((unsigned char)end[7]));
+    if(job.invert)
+        end += 7;
+    while(isspace((unsigned char)*end))
+        end++;
+    return (*end == '\0') ? 1 : -1;
+}
+
+bool Path::read_manifest(const char* const path, std::vector<batch_job_t>& jobs, int& error_line)
+{
+    jobs.clear();
+    error_line = 0;
+    FILE* file = fopen(path, "r");
+    if(file == nullptr)
+        return false;
+
+    std::set<int> vehicles;
+    char line[4096];
+    int line_number = 0;
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), file) != nullptr)
+    {
+        line_number++;
+        batch_job_t job;
+        const int result = parse_job(line, job);
+        // A line that does not fit into the buffer is invalid, every vehicle can only get one path.
+        ok = strchr(line, '\n') != nullptr || feof(file);
+        ok = ok && result >= 0 && (result == 0 || vehicles.insert(job.vehicle_id).second);
+        if(ok && result == 1)
+            jobs.push_back(job);
+    }
+    fclose(file);
+    if(!ok)
+        error_line = line_number;
+    return ok;
+}
+
+size_t Path::run_batch(const std::vector<batch_job_t>& jobs, const image_loader_t& load, unsigned int num_threads, std::vector<batch_result_t>& results)
+{
+    results.assign(jobs.size(), batch_result_t{});
+
+    // The jobs with the same image and invert flag, the image is read and traced only once for all of them.
+    struct image_group_t
+    {
+        std::string image;
+        bool invert;
+        std::vector<size_t> jobs;
+    };
+    std::vector<image_group_t> groups;
+    std::map<std::pair<std::string, bool>, size_t> group_index;
+    for(size_t i = 0; i < jobs.size(); i++)
+    {
+        const auto inserted = group_index.insert({{jobs[i].image, jobs[i].invert}, groups.size()});
+        if(inserted.second)
+            groups.push_back({jobs[i].image, jobs[i].invert, {}});
+        groups[inserted.first->second].jobs.push_back(i);
+    }
+
+    // Every thread takes the next image until all are done, so only one image per thread is in memory at once.
+    std::atomic_size_t next{0}, failed{0};
+    auto work = [&](void)
+    {
+        size_t i;
+        while((i = next++) < groups.size())
+        {
+            const image_group_t& group = groups[i];
+            std::vector<img_coord_t> path;
+            image_info_t ii;
+            {
+                PathBitmap bitmap;
+                if(!load(group.image, group.invert, bitmap) || bitmap.width() <= 0 || bitmap.height() <= 0)
+                {
+                    for(size_t job : group.jobs)
+                        results[job].error = PATHGEN_INVALID_IMAGE;
+                    failed += group.jobs.size();
+                    continue;
+                }
+                gen_path(bitmap, path);
+                ii = image_info_t{bitmap.width(), bitmap.height(), 1};
+            }
+
+            std::vector<goal_coord_t> goal_pixels;
+            for(size_t job : group.jobs)
+            {
+                goal_pixels.clear();
+                if(!gen_goals(path, goal_pixels, jobs[job].num_goals))
+                {
+                    results[job].error = PATHGEN_INVALID_NUM_GOALS;
+                    failed++;
+                    continue;
+                }
+                to_ntc(goal_pixels, ii, results[job].goals);
+            }
+        }
+    };
+
+    if(num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    if(num_threads > groups.size())
+        num_threads = (unsigned int)groups.size();
+    if(num_threads <= 1)
+    {
+        work();
+        return failed;
+    }
+    std::vector<std::thread> threads;
+    unsigned int i;
+    for(i = 0; i < num_threads; i++)
+        threads.emplace_back(work);
+    for(std::thread& thread : threads)
+        thread.join();
+    return failed;
+}
+
+void Path::batch_goals(const std::vector<batch_job_t>& jobs, const std::vector<batch_result_t>& results, std::map<int, std::vector<ntc_coord_t>>& goals)
+{
+    goals.clear();
+    for(size_t i = 0; i < jobs.size() && i < results.size(); i++)
+    {
+        if(results[i].error == PATHGEN_NONE)
+            goals[jobs[i].vehicle_id] = results[i].goals;
+    }
+}
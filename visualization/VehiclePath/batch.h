@@ -0,0 +1,97 @@
+#ifndef __batch_h__
+#define __batch_h__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <map>
+#include <functional>
+#include "pathgen.h"
+
+/*
+*   Batch mode of the path generator: generates the goals of many jobs (image, number of goals, invert, vehicle)
+*   in one process on several threads, e.g. to generate a library of paths.
+*   Every image is only read and traced once for all jobs with the same image and invert flag, the goals of these
+*   jobs are generated from the same path.
+*
+*   Manifest file (one job per line, empty lines and lines that start with # are ignored):
+*       <path to image> <number of goals> <vehicle id> [-invert]
+*   The path to the image can be put into quotes (") if it contains spaces.
+*/
+
+namespace Path
+{
+    /*
+    *   One job of a batch.
+    *   Members:
+    *       image -> Path to the image.
+    *       num_goals -> Number of goals that should be generated.
+    *       invert -> Invert the image to be able to use a white background.
+    *       vehicle_id -> Vehicle that gets the goals.
+    */
+    struct batch_job_t
+    {
+        std::string image;
+        unsigned int num_goals{0};
+        bool invert{false};
+        int vehicle_id{0};
+    };
+
+    /*
+    *   Result of one job.
+    *   Members:
+    *       error -> PATHGEN_NONE if the goals have been generated, otherwise the reason why it failed.
+    *       goals -> The goals (NTC), the first goal is repeated at the end.
+    */
+    struct batch_result_t
+    {
+        pathgen_error error{PATHGEN_NONE};
+        std::vector<ntc_coord_t> goals;
+    };
+
+    /*
+    *   Reads an image into a thresholded image, e.g. read_image_bitmap(...).
+    *   Parameters:
+    *       std::string image -> Path to the image.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       PathBitmap& bitmap -> Gets the thresholded image.
+    *   Return:
+    *       False if the image could not be read.
+    */
+    using image_loader_t = std::function<bool(const std::string&, bool, PathBitmap&)>;
+
+    /*
+    *   Reads a manifest file.
+    *   Parameters:
+    *       char* path -> Path to the manifest file.
+    *       std::vector<batch_job_t>& jobs -> Gets the jobs (the content gets replaced).
+    *       int& error_line -> Gets the number of the first invalid line (1 is the first line), 0 if the file could not be opened.
+    *   Return:
+    *       False if the file could not be opened, a line is invalid or two jobs have the same vehicle id.
+    */
+    bool read_manifest(const char* const, std::vector<batch_job_t>&, int&);
+
+    /*
+    *   Runs the jobs of a batch, every thread takes the next image until all images are done.
+    *   Parameters:
+    *       std::vector<batch_job_t> jobs -> The jobs.
+    *       image_loader_t load -> Reads the images, is called once for every different image and invert flag (by several threads at once).
+    *       unsigned int num_threads -> Number of threads, 0 for one per core.
+    *       std::vector<batch_result_t>& results -> Gets the result of every job, in the order of the jobs (the content gets replaced).
+    *   Return:
+    *       Number of jobs that failed.
+    */
+    size_t run_batch(const std::vector<batch_job_t>&, const image_loader_t&, unsigned int, std::vector<batch_result_t>&);
+
+    /*
+    *   Collects the goals of the successful jobs for a binary goal file (see write_goalfile(...)).
+    *   Parameters:
+    *       std::vector<batch_job_t> jobs -> The jobs.
+    *       std::vector<batch_result_t> results -> The results of run_batch(...).
+    *       std::map<int, std::vector<ntc_coord_t>>& goals -> Gets the goals of every vehicle (the content gets replaced).
+    */
+    void batch_goals(const std::vector<batch_job_t>&, const std::vector<batch_result_t>&, std::map<int, std::vector<ntc_coord_t>>&);
+};
+
+#endif // __batch_h__
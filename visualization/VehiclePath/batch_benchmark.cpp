@@ -0,0 +1,197 @@
+/******************************************************************************************************************************************
+* Title:        Batch benchmark
+* Programtitle: batch_benchmark
+* Description:
+*   Throughput (jobs per second) of the batch mode (run_batch) compared with one job at a time like single
+*   pathgenerator calls do it (every job reads and traces its image, without the startup of the process).
+*   The images are synthetic drawings (rings and ellipses, RGB) that are made row by row when they are read,
+*   like a file that is decoded, so reading an image costs time like reading a file.
+*   Every image is used by several jobs with a different number of goals.
+*   Checks:
+*       - The goals of the batch (1 thread and one thread per core, at least 2) are the same as one job at a time.
+*       - A manifest file with comments, quotes and -invert is read correctly, invalid lines are found.
+*       - The goal file of the batch has the goals of every vehicle.
+*
+*   Command syntax:
+*       batch_benchmark [<number of images> [<jobs per image>]]
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "batch.h"
+#include "goalfile.h"
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <thread>
+#else
+    #include <mingw.thread.h>
+#endif
+
+constexpr int IMAGE_WIDTH = 2048, IMAGE_HEIGHT = 1536;
+
+/*
+*   Reads a synthetic image: the name is "image<n>", the image n is an ellipse with a different size.
+*   The path is black on a white background (invert) or white on a black background.
+*/
+static bool load_image(const std::string& name, bool invert, Path::PathBitmap& bitmap)
+{
+    int n;
+    if(sscanf(name.c_str(), "image%d", &n) != 1)
+        return false;
+    const Path::image_info_t ii = {IMAGE_WIDTH, IMAGE_HEIGHT, 3};
+    const float rx = IMAGE_WIDTH * (0.2f + 0.02f * (n % 10)), ry = IMAGE_HEIGHT * (0.15f + 0.025f * (n % 11));
+    const uint8_t path = invert ? 0 : 255, background = invert ? 255 : 0;
+    auto read_rows = [&](uint8_t* rows, int y, int num_rows) -> bool
+    {
+        for(int r = 0; r < num_rows; r++)
+        {
+            uint8_t* row = rows + (size_t)r * IMAGE_WIDTH * 3;
+            const float dy = (y + r + 0.5f - IMAGE_HEIGHT / 2.0f) / ry;
+            for(int x = 0; x < IMAGE_WIDTH; x++)
+            {
+                const float dx = (x + 0.5f - IMAGE_WIDTH / 2.0f) / rx;
+                const float d = dx * dx + dy * dy;
+                const uint8_t v = (d >= 0.9f && d <= 1.0f) ? path : background;
+                row[3 * x] = row[3 * x + 1] = row[3 * x + 2] = v;
+            }
+        }
+        return true;
+    };
+    return Path::threshold_stream(read_rows, ii, invert, bitmap);
+}
+
+static bool same_results(const std::vector<Path::batch_result_t>& a, const std::vector<Path::batch_result_t>& b)
+{
+    if(a.size() != b.size())
+        return false;
+    for(size_t i = 0; i < a.size(); i++)
+    {
+        if(a[i].error != b[i].error || a[i].goals.size() != b[i].goals.size())
+            return false;
+        for(size_t g = 0; g < a[i].goals.size(); g++)
+        {
+            if(a[i].goals[g].x != b[i].goals[g].x || a[i].goals[g].y != b[i].goals[g].y)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Checks read_manifest(...) with a manifest file with every kind of line.
+static bool check_manifest(void)
+{
+    const char* path = "batch_benchmark_manifest.txt";
+    FILE* file = fopen(path, "w");
+    if(file == nullptr)
+        return false;
+    fprintf(file, "# comment\n\nimage1 20 1\n  \"my image.png\"  30 2 -invert \nimage1 40 3 -invert");
+    fclose(file);
+    std::vector<Path::batch_job_t> jobs;
+    int error_line;
+    bool ok = Path::read_manifest(path, jobs, error_line) && jobs.size() == 3
+              && jobs[0].image == "image1" && jobs[0].num_goals == 20 && jobs[0].vehicle_id == 1 && !jobs[0].invert
+              && jobs[1].image == "my image.png" && jobs[1].num_goals == 30 && jobs[1].vehicle_id == 2 && jobs[1].invert
+              && jobs[2].image == "image1" && jobs[2].num_goals == 40 && jobs[2].vehicle_id == 3 && jobs[2].invert;
+
+    // Invalid lines: the line number of the first one.
+    const struct {const char* content; int line;} invalid[] = {
+        {"image1 20 1\nimage2 20 1\n", 2},          // vehicle used twice
+        {"image1 20\n", 1},                         // no vehicle
+        {"image1 -20 1\n", 1},                      // negative number of goals
+        {"image1 20 1 -inverted\n", 1},             // invalid flag
+        {"image1 20 1-invert\n", 1},                // no space in front of the flag
+        {"\"image1 20 1\n", 1},                     // missing quote
+    };
+    for(const auto& test : invalid)
+    {
+        file = fopen(path, "w");
+        if(file == nullptr)
+            return false;
+        fputs(test.content, file);
+        fclose(file);
+        ok = ok && !Path::read_manifest(path, jobs, error_line) && error_line == test.line;
+    }
+    remove(path);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    const int num_images = (argc > 1) ? atoi(argv[1]) : 16;
+    const int jobs_per_image = (argc > 2) ? atoi(argv[2]) : 8;
+    const unsigned int cores = std::max(2u, std::thread::hardware_concurrency());     // at least 2, so the threads are always tested
+
+    if(!check_manifest())
+    {
+        printf("[ERROR] The manifest file has not been read correctly.\n");
+        return -1;
+    }
+
+    // Every image is used by several jobs, the images of the jobs are mixed.
+    std::vector<Path::batch_job_t> jobs;
+    for(int j = 0; j < jobs_per_image; j++)
+    {
+        for(int i = 0; i < num_images; i++)
+            jobs.push_back({"image" + std::to_string(i), 16u + 8u * j, (i % 2) == 0, (int)jobs.size()});
+    }
+    jobs.push_back({"missing", 16, false, (int)jobs.size()});       // the image can not be read
+
+    // One job at a time: every job reads and traces its image.
+    std::vector<Path::batch_result_t> single(jobs.size());
+    std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < jobs.size(); i++)
+    {
+        Path::PathBitmap bitmap;
+        if(!load_image(jobs[i].image, jobs[i].invert, bitmap))
+        {
+            single[i].error = Path::PATHGEN_INVALID_IMAGE;
+            continue;
+        }
+        single[i].error = Path::generate_goals(bitmap, jobs[i].num_goals, single[i].goals);
+    }
+    const double single_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    printf("images,jobs,mode,s,jobs/s,speedup\n");
+    printf("%d,%zu,one job at a time,%.3f,%.1f,1.0x\n", num_images, jobs.size(), single_s, jobs.size() / single_s);
+    const unsigned int thread_counts[2] = {1, cores};
+    std::vector<Path::batch_result_t> results;
+    for(unsigned int num_threads : thread_counts)
+    {
+        t0 = std::chrono::steady_clock::now();
+        const size_t failed = Path::run_batch(jobs, load_image, num_threads, results);
+        const double batch_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if(failed != 1 || !same_results(single, results))
+        {
+            printf("[ERROR] The results of the batch (%u threads) are different from one job at a time.\n", num_threads);
+            return -1;
+        }
+        printf("%d,%zu,batch %u threads,%.3f,%.1f,%.1fx\n", num_images, jobs.size(), num_threads, batch_s, jobs.size() / batch_s, single_s / batch_s);
+    }
+
+    // The goal file has every vehicle but the failed one.
+    std::map<int, std::vector<Path::ntc_coord_t>> goals;
+    Path::batch_goals(jobs, results, goals);
+    const char* path = "batch_benchmark_goals.sgol";
+    Path::GoalFile file;
+    bool ok = Path::write_goalfile(path, goals) && file.open(path) && file.num_vehicles() == jobs.size() - 1;
+    for(size_t i = 0; ok && i + 1 < jobs.size(); i++)
+    {
+        uint32_t num_goals;
+        const Path::ntc_coord_t* g = file.goals(jobs[i].vehicle_id, num_goals);
+        ok = g != nullptr && num_goals == results[i].goals.size() && memcmp(g, results[i].goals.data(), num_goals * sizeof(Path::ntc_coord_t)) == 0;
+    }
+    file.close();
+    remove(path);
+    if(!ok)
+    {
+        printf("[ERROR] The goal file of the batch is wrong.\n");
+        return -1;
+    }
+    return 0;
+}
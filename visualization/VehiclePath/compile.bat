@@ -1,3 +1,11 @@
 mkdir obj
-g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/stb_master -c main.cpp -o obj/main.o
-g++ -o pathgenerator.exe obj/main.o -s
\ No newline at end of file
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/stb_master -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c main.cpp -o obj/main.o
+g++ -Wall -O3 -msse2 -std=c++17 -c pathgen.cpp -o obj/pathgen.o
+g++ -Wall -O3 -std=c++17 -c goalfile.cpp -o obj/goalfile.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c batch.cpp -o obj/batch.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c debug_writer.cpp -o obj/debug_writer.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/stb_master -c pathgen_image.cpp -o obj/pathgen_image.o
+g++ -Wall -O3 -std=c++17 -c polyline.cpp -o obj/polyline.o
+g++ -Wall -O3 -std=c++17 -ID:/Michi/Programmieren/Libraries/mingw-std-threads-master -c contours.cpp -o obj/contours.o
+g++ -o pathgenerator.exe obj/main.o obj/pathgen.o obj/goalfile.o obj/batch.o obj/debug_writer.o obj/pathgen_image.o obj/polyline.o obj/contours.o -s
+g++ -Wall -O3 -std=c++17 -o goalconvert.exe goalconvert.cpp obj/goalfile.o obj/pathgen.o -s
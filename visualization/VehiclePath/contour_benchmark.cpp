@@ -0,0 +1,226 @@
+/******************************************************************************************************************************************
+* Title:        Contour benchmark
+* Programtitle: contour_benchmark
+* Description:
+*   Test of the extraction of every path of an image (gen_contours) with synthetic images with many disjoint paths.
+*   The image is a grid of cells, every cell contains one shape (a thick ring or a rectangle frame of a different size).
+*   Every extracted path is checked:
+*       - There is exactly one path per shape.
+*       - The bounding box of the path is the bounding box of the pixels of the shape.
+*       - The path is byte-identical to the path of gen_path(...) for the cell alone (image with only this shape).
+*   The goals of the paths are generated like "pathgenerator -contours" does it (gen_contour_goals(...)) and checked:
+*       - Every path has its goals (one entry per path, in the order of the paths) inside the bounding box of its shape.
+*       - generate_contour_goals(...) (whole pipeline from the image) gives the same goals.
+*   For every image it prints the time of the thresholding, of gen_contours(...) with one thread and with one thread
+*   per core (at least 2), and of gen_path(...) for comparison (only the first path).
+*
+*   Command syntax:
+*       contour_benchmark [<number of runs>]
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "contours.h"
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <thread>
+#else
+    #include <mingw.thread.h>
+#endif
+
+struct Shape
+{
+    int cell_x, cell_y;             // upper left corner of the cell
+    Path::img_coord_t min, max;     // bounding box of the pixels
+};
+
+/*
+*   Generates a grayscale image with a grid of shapes.
+*   Parameters:
+*       ii -> Size of the image, 1 channel.
+*       cells -> Number of cells in each direction.
+*       shapes -> Gets the shapes.
+*/
+static std::vector<uint8_t> gen_grid(const Path::image_info_t& ii, int cells, std::vector<Shape>& shapes)
+{
+    std::vector<uint8_t> data(ii.width * ii.height, 0);
+    const int cell_w = ii.width / cells, cell_h = ii.height / cells;
+    shapes.clear();
+    for(int cy = 0; cy < cells; cy++)
+    {
+        for(int cx = 0; cx < cells; cx++)
+        {
+            // Different sizes, the shape keeps a margin of 2 pixels to the border of the cell.
+            const int i = cy * cells + cx;
+            const float scale = 0.25f + 0.2f * (i % 4);
+            const float rx = (cell_w / 2 - 2) * scale, ry = (cell_h / 2 - 2) * scale;
+            const float mx = cell_w / 2.0f, my = cell_h / 2.0f;
+            const bool ring = (i % 2) == 0;
+            Shape shape = {cx * cell_w, cy * cell_h, {ii.width, ii.height}, {-1, -1}};
+            for(int y = 0; y < cell_h; y++)
+            {
+                for(int x = 0; x < cell_w; x++)
+                {
+                    const float dx = (x + 0.5f - mx) / rx, dy = (y + 0.5f - my) / ry;
+                    const float d = ring ? std::sqrt(dx * dx + dy * dy) : std::max(std::fabs(dx), std::fabs(dy));
+                    if(d < 0.75f || d > 1.0f)
+                        continue;
+                    const Path::img_coord_t p = {shape.cell_x + x, shape.cell_y + y};
+                    data[Path::img_at(p.x, p.y, ii)] = 255;
+                    shape.min = {std::min(shape.min.x, p.x), std::min(shape.min.y, p.y)};
+                    shape.max = {std::max(shape.max.x, p.x), std::max(shape.max.y, p.y)};
+                }
+            }
+            shapes.push_back(shape);
+        }
+    }
+    return data;
+}
+
+/*
+*   Checks every contour with the path of its cell alone.
+*/
+static bool check_contours(const std::vector<uint8_t>& data, const Path::image_info_t& ii, int cells, const std::vector<Shape>& shapes,
+                           const std::vector<Path::contour_t>& contours)
+{
+    if(contours.size() != shapes.size())
+    {
+        printf("[ERROR] %zu paths instead of %zu.\n", contours.size(), shapes.size());
+        return false;
+    }
+    const Path::image_info_t cell_ii = {ii.width / cells, ii.height / cells, 1};
+    std::vector<uint8_t> cell(cell_ii.width * cell_ii.height);
+    std::vector<bool> found(shapes.size(), false);
+    for(const Path::contour_t& contour : contours)
+    {
+        // The cell of the path.
+        const int cx = contour.min.x / cell_ii.width, cy = contour.min.y / cell_ii.height;
+        const size_t s = cy * cells + cx;
+        const Shape& shape = shapes[s];
+        if(found[s] || contour.min.x != shape.min.x || contour.min.y != shape.min.y || contour.max.x != shape.max.x || contour.max.y != shape.max.y)
+        {
+            printf("[ERROR] The path of the cell (%d, %d) is wrong (bounding box or found twice).\n", cx, cy);
+            return false;
+        }
+        found[s] = true;
+
+        for(int y = 0; y < cell_ii.height; y++)
+            memcpy(&cell[y * cell_ii.width], &data[Path::img_at(shape.cell_x, shape.cell_y + y, ii)], cell_ii.width);
+        std::vector<Path::img_coord_t> path;
+        Path::gen_path(cell.data(), path, cell_ii);
+        bool same = path.size() == contour.path.size();
+        for(size_t i = 0; same && i < path.size(); i++)
+            same = path[i].x + shape.cell_x == contour.path[i].x && path[i].y + shape.cell_y == contour.path[i].y;
+        if(!same || !contour.closed)
+        {
+            printf("[ERROR] The path of the cell (%d, %d) is different from gen_path(...).\n", cx, cy);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+*   Checks the goals of every contour (see header).
+*/
+static bool check_contour_goals(const std::vector<uint8_t>& data, const Path::image_info_t& ii, const std::vector<Path::contour_t>& contours)
+{
+    constexpr unsigned int NUM_GOALS = 32;
+    std::vector<std::vector<Path::goal_coord_t>> goals;
+    const size_t left_out = Path::gen_contour_goals(contours, {NUM_GOALS}, goals);
+    if(left_out != 0 || goals.size() != contours.size())
+    {
+        printf("[ERROR] Goals of %zu paths instead of %zu.\n", goals.size(), contours.size());
+        return false;
+    }
+
+    std::vector<std::vector<Path::ntc_coord_t>> pipeline_goals;
+    if(Path::generate_contour_goals(data.data(), ii, NUM_GOALS, false, 0, pipeline_goals) != Path::PATHGEN_NONE || pipeline_goals.size() != goals.size())
+    {
+        printf("[ERROR] generate_contour_goals(...) has not generated the goals of every path.\n");
+        return false;
+    }
+
+    std::vector<Path::ntc_coord_t> ntc_goals;
+    for(size_t i = 0; i < goals.size(); i++)
+    {
+        const Path::contour_t& contour = contours[i];
+        bool inside = goals[i].size() == NUM_GOALS + 1;
+        for(const Path::goal_coord_t& goal : goals[i])
+            inside = inside && goal.x >= contour.min.x && goal.x <= contour.max.x && goal.y >= contour.min.y && goal.y <= contour.max.y;
+
+        ntc_goals.clear();
+        Path::to_ntc(goals[i], ii, ntc_goals);
+        bool same = ntc_goals.size() == pipeline_goals[i].size();
+        for(size_t g = 0; same && g < ntc_goals.size(); g++)
+            same = ntc_goals[g].x == pipeline_goals[i][g].x && ntc_goals[g].y == pipeline_goals[i][g].y;
+        if(!inside || !same)
+        {
+            printf("[ERROR] The goals of the path %zu are wrong (outside of its shape or different from the pipeline).\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const int runs = (argc > 1) ? atoi(argv[1]) : 5;
+    const unsigned int cores = std::max(2u, std::thread::hardware_concurrency());     // at least 2, so the threads are always tested
+    const struct {int size, cells;} tests[] = {{2048, 1}, {2048, 2}, {2048, 8}, {4096, 8}, {4096, 32}, {8192, 32}, {8192, 64}};
+
+    printf("image,paths,path pixels,binarize ms,contours 1 thread ms,contours %u threads ms,first path only ms\n", cores);
+    for(const auto& test : tests)
+    {
+        const Path::image_info_t ii = {test.size, test.size, 1};
+        std::vector<Shape> shapes;
+        const std::vector<uint8_t> data = gen_grid(ii, test.cells, shapes);
+
+        Path::PathBitmap bitmap;
+        std::chrono::time_point t0 = std::chrono::steady_clock::now();
+        for(int i = 0; i < runs; i++)
+            bitmap.binarize(data.data(), ii, Path::PATH_THRESHOLD);
+        const double binarize_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / runs;
+
+        double contour_ms[2];
+        const unsigned int thread_counts[2] = {1, cores};
+        std::vector<Path::contour_t> contours;
+        for(int t = 0; t < 2; t++)
+        {
+            t0 = std::chrono::steady_clock::now();
+            for(int i = 0; i < runs; i++)
+                Path::gen_contours(bitmap, contours, thread_counts[t]);
+            contour_ms[t] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / runs;
+            if(!check_contours(data, ii, test.cells, shapes, contours))
+                return -1;
+        }
+
+        if(!check_contour_goals(data, ii, contours))
+            return -1;
+
+        std::vector<Path::img_coord_t> path;
+        t0 = std::chrono::steady_clock::now();
+        for(int i = 0; i < runs; i++)
+        {
+            path.clear();
+            Path::gen_path(bitmap, path);
+        }
+        const double path_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / runs;
+        if(contours.empty() || path.size() != contours[0].path.size())
+        {
+            printf("[ERROR] The first path is not the path of gen_path(...).\n");
+            return -1;
+        }
+
+        size_t pixels = 0;
+        for(const Path::contour_t& contour : contours)
+            pixels += contour.path.size();
+        printf("%dx%d,%zu,%zu,%.2f,%.2f,%.2f,%.2f\n", ii.width, ii.height, contours.size(), pixels, binarize_ms, contour_ms[0], contour_ms[1], path_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include "contours.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <thread>
+#else
+    #include <mingw.thread.h>
+#endif
+
+using namespace Path;
+
+static constexpr double SQRT2 = 1.41421356237309504880;  // length of a diagonal step
+
+/*
+*   Consecutive path pixels in one row.
+*   Members:
+*       y -> Row of the pixels.
+*       x0, x1 -> First and last pixel (inclusive).
+*/
+struct pixel_run_t
+{
+    int y, x0, x1;
+};
+
+/*
+*   Searches the next bit with a value in a row of the bitmap.
+*   Parameters:
+*       const uint64_t* words -> Words of the row.
+*       size_t num_words -> Number of words of the row.
+*       size_t pos -> Bit where the search starts.
+*       bool set -> True for a set bit, false for a cleared bit.
+*   Return:
+*       Position of the bit, (num_words * 64) if there is none.
+*/
+static size_t next_bit(const uint64_t* words, size_t num_words, size_t pos, bool set)
+{
+    size_t i = pos / 64;
+    if(i >= num_words)
+        return num_words * 64;
+    uint64_t word = (set ? words[i] : ~words[i]) & (~(uint64_t)0 << (pos % 64));
+    while(word == 0)
+    {
+        if(++i == num_words)
+            return num_words * 64;
+        word = set ? words[i] : ~words[i];
+    }
+    return i * 64 + ctz64(word);
+}
+
+// Appends the runs of a row, left to right.
+static void find_runs(const PathBitmap& bitmap, int y, std::vector<pixel_run_t>& runs)
+{
+    const uint64_t* words = bitmap.row_words(y);
+    const size_t num_words = bitmap.words_per_row();
+    size_t begin = next_bit(words, num_words, 0, true);
+    while(begin < num_words * 64)
+    {
+        // There is always a cleared bit after the last pixel (border), the bit (x + 1) is the pixel x.
+        const size_t end = next_bit(words, num_words, begin, false);
+        runs.push_back({y, (int)begin - 1, (int)end - 2});
+        begin = next_bit(words, num_words, end, true);
+    }
+}
+
+// Return: the root of a run (union-find with path halving).
+static uint32_t find_root(std::vector<uint32_t>& parent, uint32_t i)
+{
+    while(parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Joins the parts of two runs, the root is always the first run (row by row) of the part.
+static void unite(std::vector<uint32_t>& parent, uint32_t a, uint32_t b)
+{
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if(a < b)
+        parent[b] = a;
+    else if(b < a)
+        parent[a] = b;
+}
+
+// Sets the bounding box, the length and whether the contour is closed.
+static void measure(contour_t& contour)
+{
+    const std::vector<img_coord_t>& path = contour.path;
+    if(path.empty())
+        return;
+    contour.min = contour.max = path[0];
+    double length = 0.0;
+    for(size_t i = 0; i < path.size(); i++)
+    {
+        contour.min = {std::min(contour.min.x, path[i].x), std::min(contour.min.y, path[i].y)};
+        contour.max = {std::max(contour.max.x, path[i].x), std::max(contour.max.y, path[i].y)};
+        // Step to the next pixel, the last step of a closed path goes back to the begin.
+        if(i + 1 < path.size() || contour.closed)
+        {
+            const img_coord_t& next = path[(i + 1) % path.size()];
+            length += (next.x != path[i].x && next.y != path[i].y) ? SQRT2 : 1.0;
+        }
+    }
+    contour.length = (float)length;
+}
+
+void Path::gen_contours(const PathBitmap& bitmap, std::vector<contour_t>& contours, unsigned int num_threads)
+{
+    contours.clear();
+
+    // Label the path pixels: every run is joined with the runs of the previous row it touches (also diagonal).
+    std::vector<pixel_run_t> runs;
+    std::vector<uint32_t> parent;
+    size_t prev_begin = 0, prev_end = 0;
+    int y;
+    for(y = 0; y < bitmap.height(); y++)
+    {
+        const size_t begin = runs.size();
+        find_runs(bitmap, y, runs);
+        for(size_t i = begin; i < runs.size(); i++)
+            parent.push_back((uint32_t)i);
+
+        // Both rows are ordered left to right, so the runs of the previous row are only passed once.
+        size_t p = prev_begin;
+        for(size_t c = begin; c < runs.size(); c++)
+        {
+            while(p < prev_end && runs[p].x1 < runs[c].x0 - 1)
+                p++;
+            for(size_t q = p; q < prev_end && runs[q].x0 <= runs[c].x1 + 1; q++)
+                unite(parent, (uint32_t)q, (uint32_t)c);
+        }
+        prev_begin = begin;
+        prev_end = runs.size();
+    }
+
+    // The begin pixel of every part is its first pixel (row by row) with a valid matrix, like gen_path(...) does it.
+    // The runs are ordered row by row, so the begin pixels are found in that order too.
+    std::vector<img_coord_t> begins;
+    std::vector<bool> has_begin(runs.size(), false);
+    for(size_t i = 0; i < runs.size(); i++)
+    {
+        const uint32_t root = find_root(parent, (uint32_t)i);
+        if(has_begin[root])
+            continue;
+        for(int x = runs[i].x0; x <= runs[i].x1; x++)
+        {
+            if(DIRECTION_TABLE.step[bitmap.mask(x, runs[i].y)].valid)
+            {
+                begins.push_back({x, runs[i].y});
+                has_begin[root] = true;
+                break;
+            }
+        }
+    }
+
+    // Trace every part, every thread takes the next part until all are done.
+    contours.resize(begins.size());
+    std::atomic_size_t next{0};
+    auto work = [&](void)
+    {
+        size_t i;
+        while((i = next++) < begins.size())
+        {
+            contours[i].closed = trace_path(bitmap, begins[i].x, begins[i].y, contours[i].path);
+            measure(contours[i]);
+        }
+    };
+
+    if(num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    if(num_threads > begins.size())
+        num_threads = (unsigned int)begins.size();
+    if(num_threads <= 1)
+    {
+        work();
+        return;
+    }
+    std::vector<std::thread> threads;
+    unsigned int i;
+    for(i = 0; i < num_threads; i++)
+        threads.emplace_back(work);
+    for(std::thread& thread : threads)
+        thread.join();
+}
+
+size_t Path::gen_contour_goals(const std::vector<contour_t>& contours, const goal_settings_t& settings, std::vector<std::vector<goal_coord_t>>& goals)
+{
+    goals.clear();
+    size_t left_out = 0;
+    for(const contour_t& contour : contours)
+    {
+        goals.emplace_back();
+        if(!gen_goals(contour.path, goals.back(), settings))
+        {
+            goals.pop_back();
+            left_out++;
+        }
+    }
+    return left_out;
+}
+
+pathgen_error Path::generate_contour_goals(const uint8_t* data, const image_info_t& ii, unsigned int num_goals, bool invert, unsigned int num_threads,
+                                           std::vector<std::vector<ntc_coord_t>>& goals)
+{
+    goals.clear();
+    if(data == nullptr || ii.width <= 0 || ii.height <= 0 || ii.channels <= 0)
+        return PATHGEN_INVALID_IMAGE;
+
+    PathBitmap bitmap;
+    threshold_image(data, ii, invert, bitmap);
+
+    std::vector<contour_t> contours;
+    gen_contours(bitmap, contours, num_threads);
+
+    // Paths with less pixels than goals are left out (e.g. noise).
+    std::vector<std::vector<goal_coord_t>> goal_pixels;
+    gen_contour_goals(contours, {num_goals}, goal_pixels);
+    goals.resize(goal_pixels.size());
+    for(size_t i = 0; i < goal_pixels.size(); i++)
+        to_ntc(goal_pixels[i], ii, goals[i]);
+    return goals.empty() ? PATHGEN_INVALID_NUM_GOALS : PATHGEN_NONE;
+}
@@ -0,0 +1,74 @@
+#ifndef __contours_h__
+#define __contours_h__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "pathgen.h"
+
+/*
+*   Extraction of every separate path of an image (contour), e.g. one path per vehicle in one image.
+*   The path pixels are labeled in one scan (8-connected runs of path pixels, union-find), every
+*   labeled part of the image gets its own begin pixel and is traced like gen_path(...) does it.
+*   The traces are independent of each other and run on several threads.
+*/
+
+namespace Path
+{
+    /*
+    *   One traced path of an image.
+    *   Members:
+    *       path -> The pixels of the path, the same as gen_path(...) would give for an image with only this path.
+    *       min -> Upper left corner of the bounding box of the path (inclusive).
+    *       max -> Lower right corner of the bounding box of the path (inclusive).
+    *       length -> Length of the path in pixels, a diagonal step is sqrt(2) long. A closed path includes the step back to the begin.
+    *       closed -> True if the trace has reached the begin pixel again.
+    */
+    struct contour_t
+    {
+        std::vector<img_coord_t> path;
+        img_coord_t min{0, 0}, max{0, 0};
+        float length{0.0f};
+        bool closed{false};
+    };
+
+    /*
+    *   Extracts every path of a thresholded image.
+    *   Parameters:
+    *       PathBitmap bitmap -> The thresholded image.
+    *       std::vector<contour_t>& contours -> Gets the paths (the content gets replaced), ordered by their begin pixels
+    *                                           (row by row), so the first one is the path of gen_path(...).
+    *       unsigned int num_threads -> Number of threads that trace the paths, 0 for one per core.
+    *   Note: A part of the image without any valid path matrix (e.g. a single pixel) has no path.
+    */
+    void gen_contours(const PathBitmap&, std::vector<contour_t>&, unsigned int);
+
+    /*
+    *   Generates the goals of every path like gen_goals(...) does it for a single path.
+    *   Parameters:
+    *       std::vector<contour_t> contours -> The paths, e.g. of gen_contours(...).
+    *       goal_settings_t settings -> Uniform or adaptive goals of every path.
+    *       std::vector<std::vector<goal_coord_t>>& goals -> The goals of every path that has at least num_goals pixels,
+    *                                                        in the order of the paths (the content gets replaced).
+    *   Return:
+    *       Number of paths that have been left out (less pixels than goals, e.g. noise).
+    */
+    size_t gen_contour_goals(const std::vector<contour_t>&, const goal_settings_t&, std::vector<std::vector<goal_coord_t>>&);
+
+    /*
+    *   Runs the whole pipeline for every path of an image: grayscale, invert (optional), paths and goals.
+    *   Parameters:
+    *       const uint8_t* data -> Pixel data of the image (any number of channels), is not modified.
+    *       image_info_t image_info -> Information of the image.
+    *       unsigned int num_goals -> Number of goals of every path.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       unsigned int num_threads -> Number of threads that trace the paths, 0 for one per core.
+    *       std::vector<std::vector<ntc_coord_t>>& goals -> The goals of every path that has at least num_goals pixels,
+    *                                                       in the order of gen_contours(...) (the content gets replaced).
+    *   Return:
+    *       PATHGEN_NONE if there are goals for at least one path, otherwise the reason why it failed.
+    */
+    pathgen_error generate_contour_goals(const uint8_t*, const image_info_t&, unsigned int, bool, unsigned int, std::vector<std::vector<ntc_coord_t>>&);
+};
+
+#endif // __contours_h__
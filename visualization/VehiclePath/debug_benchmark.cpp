@@ -0,0 +1,299 @@
+/******************************************************************************************************************************************
+* Title:        Debug image benchmark
+* Programtitle: debug_benchmark
+* Description:
+*   End-to-end time of the pipeline of pathgenerator with debug images (grayscale, inverted, goals and path image),
+*   the debug images written on the pipeline (sync, like before) or by the DebugImageWriter (async).
+*   It prints for every format and image size:
+*       pipeline ms -> Until the goals are written (the result of the program).
+*       exit ms     -> Until every debug image is written too (the end of the program).
+*       MiB         -> Size of the 4 debug images.
+*   Formats: pnm and qoi (debug_writer.h) and png if libpng has been found (libpng instead of stb, stb is not needed
+*   for the benchmark, the encoders are similar: zlib deflate).
+*   Before that the encoders are checked: every QOI and PNM image is read back and has to be the same as the image.
+*
+*   Command syntax:
+*       debug_benchmark [<number of runs>]
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "pathgen.h"
+#include "goalfile.h"
+#include "debug_writer.h"
+
+#if defined(DEBUG_BENCHMARK_PNG)
+    #include <png.h>
+#endif
+
+#if defined(DEBUG_BENCHMARK_PNG)
+// Writes a PNG image with libpng (the default compression, like stbi_write_png(...) in pathgenerator).
+static bool write_png(const char* const path, const uint8_t* data, const Path::image_info_t& ii)
+{
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    image.width = ii.width;
+    image.height = ii.height;
+    const png_uint_32 formats[] = {PNG_FORMAT_GRAY, PNG_FORMAT_GA, PNG_FORMAT_RGB, PNG_FORMAT_RGBA};
+    image.format = formats[ii.channels - 1];
+    return png_image_write_to_file(&image, path, 0, data, 0, nullptr) != 0;
+}
+#endif
+
+static std::vector<uint8_t> read_file(const char* path)
+{
+    std::vector<uint8_t> content;
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr)
+        return content;
+    uint8_t buffer[65536];
+    size_t n;
+    while((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        content.insert(content.end(), buffer, buffer + n);
+    fclose(file);
+    return content;
+}
+
+/*
+*   Decodes a QOI image (the reference of the format) into RGBA pixels.
+*   Return: false if the file is not a valid QOI image.
+*/
+static bool decode_qoi(const std::vector<uint8_t>& file, std::vector<uint8_t>& rgba, int& width, int& height, int& channels)
+{
+    if(file.size() < 22 || memcmp(file.data(), "qoif", 4) != 0)
+        return false;
+    width = (file[4] << 24) | (file[5] << 16) | (file[6] << 8) | file[7];
+    height = (file[8] << 24) | (file[9] << 16) | (file[10] << 8) | file[11];
+    channels = file[12];
+    const size_t n = (size_t)width * height;
+    rgba.resize(n * 4);
+    uint8_t index[64][4] = {}, px[4] = {0, 0, 0, 255};
+    size_t p = 14, i = 0;
+    int run = 0;
+    for(i = 0; i < n; i++)
+    {
+        if(run > 0)
+            run--;
+        else
+        {
+            if(p >= file.size() - 8)
+                return false;
+            const uint8_t b = file[p++];
+            if(b == 0xFE)
+            {
+                memcpy(px, &file[p], 3);
+                p += 3;
+            }
+            else if(b == 0xFF)
+            {
+                memcpy(px, &file[p], 4);
+                p += 4;
+            }
+            else if((b & 0xC0) == 0x00)
+                memcpy(px, index[b], 4);
+            else if((b & 0xC0) == 0x40)
+            {
+                px[0] += ((b >> 4) & 3) - 2;
+                px[1] += ((b >> 2) & 3) - 2;
+                px[2] += (b & 3) - 2;
+            }
+            else if((b & 0xC0) == 0x80)
+            {
+                const int dg = (b & 0x3F) - 32, b2 = file[p++];
+                px[0] += dg + ((b2 >> 4) & 15) - 8;
+                px[1] += dg;
+                px[2] += dg + (b2 & 15) - 8;
+            }
+            else
+                run = b & 0x3F;
+            memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        }
+        memcpy(&rgba[i * 4], px, 4);
+    }
+    const uint8_t end_marker[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+    return p + 8 == file.size() && memcmp(&file[p], end_marker, 8) == 0;
+}
+
+// Checks that every QOI and PNM image is the same image after reading it back.
+static bool check_encoders(void)
+{
+    const char* path = "debug_benchmark_check.img";
+    uint32_t random = 2463534242u;
+    for(int channels = 1; channels <= 4; channels++)
+    {
+        // Runs, small and big differences, random pixels and changes of the alpha channel, also a run longer than 62 pixels.
+        const Path::image_info_t ii = {317, 211, channels};
+        std::vector<uint8_t> data((size_t)ii.width * ii.height * channels);
+        for(size_t i = 0; i < data.size(); i++)
+        {
+            random ^= random << 13; random ^= random >> 17; random ^= random << 5;
+            const size_t pixel = i / channels;
+            const int kind = (int)(pixel / 4000) % 4;
+            data[i] = (kind == 0) ? 200 : (kind == 1) ? (uint8_t)(pixel / 7 + (random & 1)) : (kind == 2) ? (uint8_t)(pixel * 3 + (random & 15)) : (uint8_t)random;
+        }
+
+        std::vector<uint8_t> rgba;
+        int width, height, qoi_channels;
+        if(!Path::write_qoi(path, data.data(), ii) || !decode_qoi(read_file(path), rgba, width, height, qoi_channels)
+           || width != ii.width || height != ii.height || qoi_channels != ((channels % 2) ? 3 : 4))
+            return false;
+        for(size_t i = 0; i < (size_t)ii.width * ii.height; i++)
+        {
+            const uint8_t* in = &data[i * channels];
+            const uint8_t expected[4] = {in[0], in[(channels > 2) ? 1 : 0], in[(channels > 2) ? 2 : 0], (channels % 2) ? (uint8_t)255 : in[channels - 1]};
+            if(memcmp(expected, &rgba[i * 4], 4) != 0)
+                return false;
+        }
+
+        // PNM: the header, then the pixels without the alpha channel.
+        const std::vector<uint8_t> pnm = (Path::write_pnm(path, data.data(), ii)) ? read_file(path) : std::vector<uint8_t>();
+        const int pnm_channels = (channels <= 2) ? 1 : 3;
+        char header[64];
+        const int header_size = snprintf(header, sizeof(header), "P%c\n%d %d\n255\n", (pnm_channels == 1) ? '5' : '6', ii.width, ii.height);
+        if(pnm.size() != header_size + (size_t)ii.width * ii.height * pnm_channels || memcmp(pnm.data(), header, header_size) != 0)
+            return false;
+        for(size_t i = 0; i < (size_t)ii.width * ii.height; i++)
+        {
+            if(memcmp(&pnm[header_size + i * pnm_channels], &data[i * channels], pnm_channels) != 0)
+                return false;
+        }
+    }
+    remove(path);
+    return true;
+}
+
+// A drawing: a thick ring on a black background (RGB).
+static std::vector<uint8_t> gen_ring(const Path::image_info_t& ii)
+{
+    std::vector<uint8_t> data((size_t)ii.width * ii.height * ii.channels, 0);
+    const float cx = ii.width / 2.0f, cy = ii.height / 2.0f, r = std::min(ii.width, ii.height) * 0.4f;
+    for(int y = 0; y < ii.height; y++)
+    {
+        for(int x = 0; x < ii.width; x++)
+        {
+            const float d = std::hypot(x + 0.5f - cx, y + 0.5f - cy) / r;
+            if(d >= 0.9f && d <= 1.0f)
+                memset(&data[Path::img_at(x, y, ii)], 255, ii.channels);
+        }
+    }
+    return data;
+}
+
+/*
+*   The pipeline of pathgenerator with debug images (see main.cpp).
+*   Parameters:
+*       encode -> Encoder of the debug images, nullptr for no debug images.
+*       async -> Write the debug images with a DebugImageWriter.
+*       pipeline_ms, exit_ms -> Get the times.
+*/
+static bool run_pipeline(const std::vector<uint8_t>& image, const Path::image_info_t& image_ii, Path::image_encoder_t encode, bool async,
+                         double& pipeline_ms, double& exit_ms)
+{
+    const char* const paths[4] = {"debug_benchmark_grayscale.img", "debug_benchmark_inverted.img", "debug_benchmark_goals.img", "debug_benchmark_path.img"};
+    const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    bool ok = true;
+    {
+        std::unique_ptr<Path::DebugImageWriter> writer((encode != nullptr && async) ? new Path::DebugImageWriter() : nullptr);
+        auto write_debug_image = [&](int i, const uint8_t* data, const Path::image_info_t& ii)
+        {
+            if(encode == nullptr)
+                return;
+            if(async)
+                writer->write(paths[i], std::vector<uint8_t>(data, data + (size_t)ii.width * ii.height * ii.channels), ii, encode);
+            else
+                ok = encode(paths[i], data, ii) && ok;
+        };
+
+        Path::image_info_t ii = image_ii;
+        uint8_t* data = Path::to_grayscale(image.data(), ii);
+        write_debug_image(0, data, ii);
+        Path::invert_image(data, ii);
+        write_debug_image(1, data, ii);
+        Path::invert_image(data, ii);       // the ring is white on black, the path is the ring again
+
+        std::vector<Path::img_coord_t> path;
+        Path::gen_path(data, path, ii);
+        std::vector<Path::goal_coord_t> goals;
+        ok = Path::gen_goals(path, goals, 100) && ok;
+        for(const Path::goal_coord_t& pos : goals)
+            data[Path::img_at(pos.x, pos.y, ii)] = 128;
+        write_debug_image(2, data, ii);
+        for(const Path::img_coord_t& pos : path)
+            data[Path::img_at(pos.x, pos.y, ii)] = 128;
+        write_debug_image(3, data, ii);
+
+        std::vector<Path::ntc_coord_t> ntc_goals;
+        Path::to_ntc(goals, ii, ntc_goals);
+        ok = Path::write_goalfile("debug_benchmark_goals.sgol", 0, ntc_goals) && ok;
+        delete[](data);
+        pipeline_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if(writer != nullptr)
+            ok = writer->finish() == 0 && ok;
+    }
+    exit_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    const int runs = (argc > 1) ? atoi(argv[1]) : 5;
+    if(!check_encoders())
+    {
+        printf("[ERROR] A QOI or PNM image is different after reading it back.\n");
+        return -1;
+    }
+
+    const struct {const char* name; Path::image_encoder_t encode;} formats[] = {
+        {"none", nullptr},
+        {"pnm", Path::write_pnm},
+        {"qoi", Path::write_qoi},
+#if defined(DEBUG_BENCHMARK_PNG)
+        {"png", write_png},
+#endif
+    };
+    const Path::image_info_t sizes[] = {{1920, 1080, 3}, {4096, 3072, 3}};
+
+    printf("image,format,mode,pipeline ms,exit ms,MiB\n");
+    for(const Path::image_info_t& ii : sizes)
+    {
+        const std::vector<uint8_t> image = gen_ring(ii);
+        for(const auto& format : formats)
+        {
+            for(int async = 0; async < ((format.encode != nullptr) ? 2 : 1); async++)
+            {
+                // median of the runs
+                std::vector<double> pipeline(runs), exit(runs);
+                for(int i = 0; i < runs; i++)
+                {
+                    if(!run_pipeline(image, ii, format.encode, async, pipeline[i], exit[i]))
+                    {
+                        printf("[ERROR] %s: the pipeline or writing an image failed.\n", format.name);
+                        return -1;
+                    }
+                }
+                std::sort(pipeline.begin(), pipeline.end());
+                std::sort(exit.begin(), exit.end());
+
+                double mib = 0.0;
+                const char* const paths[4] = {"debug_benchmark_grayscale.img", "debug_benchmark_inverted.img", "debug_benchmark_goals.img", "debug_benchmark_path.img"};
+                for(const char* path : paths)
+                {
+                    if(format.encode != nullptr)
+                        mib += read_file(path).size() / (1024.0 * 1024.0);
+                    remove(path);
+                }
+                printf("%dx%d,%s,%s,%.1f,%.1f,%.2f\n", ii.width, ii.height, format.name, (format.encode == nullptr) ? "-" : (async ? "async" : "sync"),
+                       pipeline[runs / 2], exit[runs / 2], mib);
+            }
+        }
+    }
+    remove("debug_benchmark_goals.sgol");
+    return 0;
+}
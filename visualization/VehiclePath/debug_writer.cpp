@@ -0,0 +1,203 @@
+#include <cstdio>
+#include <cstring>
+#include "debug_writer.h"
+
+using namespace Path;
+
+// Writes a 32-bit number big endian (QOI header).
+static void put_be32(uint8_t* out, uint32_t value)
+{
+    out[0] = (uint8_t)(value >> 24);
+    out[1] = (uint8_t)(value >> 16);
+    out[2] = (uint8_t)(value >> 8);
+    out[3] = (uint8_t)value;
+}
+
+bool Path::write_qoi(const char* const path, const uint8_t* data, const image_info_t& ii)
+{
+    if(ii.width <= 0 || ii.height <= 0 || ii.channels < 1 || ii.channels > 4)
+        return false;
+
+    // Every pixel as RGBA, the alpha channel is 255 if the image has none.
+    const bool alpha = ii.channels == 2 || ii.channels == 4;
+    const size_t n = (size_t)ii.width * ii.height;
+    // Worst case: 5 bytes per pixel (QOI_OP_RGBA) + header + end marker.
+    std::vector<uint8_t> out(14 + n * (alpha ? 5 : 4) + 8);
+    uint8_t* p = out.data();
+    memcpy(p, "qoif", 4);
+    put_be32(p + 4, (uint32_t)ii.width);
+    put_be32(p + 8, (uint32_t)ii.height);
+    p[12] = alpha ? 4 : 3;
+    p[13] = 0;      // sRGB with linear alpha
+    p += 14;
+
+    uint8_t index[64][4] = {};
+    uint8_t prev[4] = {0, 0, 0, 255};
+    unsigned int run = 0;
+    size_t i;
+    for(i = 0; i < n; i++)
+    {
+        const uint8_t* in = data + i * ii.channels;
+        uint8_t px[4];
+        if(ii.channels <= 2)
+            px[0] = px[1] = px[2] = in[0];
+        else
+        {
+            px[0] = in[0];
+            px[1] = in[1];
+            px[2] = in[2];
+        }
+        px[3] = alpha ? in[ii.channels - 1] : 255;
+
+        if(memcmp(px, prev, 4) == 0)
+        {
+            // QOI_OP_RUN: up to 62 times the previous pixel.
+            if(++run == 62)
+            {
+                *p++ = (uint8_t)(0xC0 | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if(run > 0)
+        {
+            *p++ = (uint8_t)(0xC0 | (run - 1));
+            run = 0;
+        }
+
+        const unsigned int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+        if(memcmp(index[hash], px, 4) == 0)
+            *p++ = (uint8_t)hash;                                       // QOI_OP_INDEX
+        else
+        {
+            memcpy(index[hash], px, 4);
+            if(px[3] == prev[3])
+            {
+                const int8_t dr = (int8_t)(px[0] - prev[0]), dg = (int8_t)(px[1] - prev[1]), db = (int8_t)(px[2] - prev[2]);
+                const int dr_dg = dr - dg, db_dg = db - dg;
+                if(dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                    *p++ = (uint8_t)(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));     // QOI_OP_DIFF
+                else if(dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7)
+                {
+                    *p++ = (uint8_t)(0x80 | (dg + 32));                                         // QOI_OP_LUMA
+                    *p++ = (uint8_t)(((dr_dg + 8) << 4) | (db_dg + 8));
+                }
+                else
+                {
+                    *p++ = 0xFE;                                                                // QOI_OP_RGB
+                    *p++ = px[0];
+                    *p++ = px[1];
+                    *p++ = px[2];
+                }
+            }
+            else
+            {
+                *p++ = 0xFF;                                                                    // QOI_OP_RGBA
+                memcpy(p, px, 4);
+                p += 4;
+            }
+        }
+        memcpy(prev, px, 4);
+    }
+    if(run > 0)
+        *p++ = (uint8_t)(0xC0 | (run - 1));
+    const uint8_t end_marker[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+    memcpy(p, end_marker, 8);
+    p += 8;
+
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr)
+        return false;
+    const size_t size = p - out.data();
+    const bool ok = fwrite(out.data(), 1, size, file) == size;
+    return (fclose(file) == 0) && ok;
+}
+
+bool Path::write_pnm(const char* const path, const uint8_t* data, const image_info_t& ii)
+{
+    if(ii.width <= 0 || ii.height <= 0 || ii.channels < 1 || ii.channels > 4)
+        return false;
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr)
+        return false;
+
+    const int channels = (ii.channels <= 2) ? 1 : 3;
+    fprintf(file, "P%c\n%d %d\n255\n", (channels == 1) ? '5' : '6', ii.width, ii.height);
+    bool ok = true;
+    if(channels == ii.channels)
+    {
+        const size_t size = (size_t)ii.width * ii.height * ii.channels;
+        ok = fwrite(data, 1, size, file) == size;
+    }
+    else
+    {
+        // Leave out the alpha channel, row by row.
+        std::vector<uint8_t> row((size_t)ii.width * channels);
+        for(int y = 0; ok && y < ii.height; y++)
+        {
+            const uint8_t* in = data + img_at(0, y, ii);
+            for(int x = 0; x < ii.width; x++)
+                memcpy(&row[(size_t)x * channels], in + (size_t)x * ii.channels, channels);
+            ok = fwrite(row.data(), 1, row.size(), file) == row.size();
+        }
+    }
+    return (fclose(file) == 0) && ok;
+}
+
+DebugImageWriter::DebugImageWriter(void)
+{
+    this->num_pending = 0;
+    this->num_failed = 0;
+    this->running = true;
+    this->writer = std::thread(&DebugImageWriter::write_loop, this);
+}
+
+DebugImageWriter::~DebugImageWriter(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->running = false;
+    }
+    this->job_added.notify_one();
+    this->writer.join();    // The background thread writes the remaining images before it returns.
+}
+
+void DebugImageWriter::write(const char* const path, std::vector<uint8_t>&& pixels, const image_info_t& ii, image_encoder_t encode)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobs.push_back({path, std::move(pixels), ii, encode});
+        this->num_pending++;
+    }
+    this->job_added.notify_one();
+}
+
+size_t DebugImageWriter::finish(void)
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->jobs_done.wait(lock, [this]{return this->num_pending == 0;});
+    return this->num_failed;
+}
+
+void DebugImageWriter::write_loop(void)
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while(true)
+    {
+        this->job_added.wait(lock, [this]{return !this->jobs.empty() || !this->running;});
+        if(this->jobs.empty())
+            return;     // stopped and every image is written
+
+        // Encode without the lock, so new images can be added in the meantime.
+        Job job = std::move(this->jobs.front());
+        this->jobs.pop_front();
+        lock.unlock();
+        const bool ok = job.encode(job.path.c_str(), job.pixels.data(), job.image_info);
+        job.pixels = std::vector<uint8_t>();    // free the memory before waiting
+        lock.lock();
+
+        this->num_failed += !ok;
+        if(--this->num_pending == 0)
+            this->jobs_done.notify_all();
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef __debug_writer_h__
+#define __debug_writer_h__
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include "pathgen.h"
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+#else
+    #include <mingw.thread.h>
+    #include <mingw.mutex.h>
+    #include <mingw.condition_variable.h>
+#endif
+
+/*
+*   Writing of the debug images of the path generator.
+*   The images are encoded and written by a background thread, so the pipeline does not wait for the encoder
+*   (e.g. PNG, which often takes longer than the path itself). Besides PNG (stb, see main.cpp) there are two
+*   fast formats without an image library:
+*       QOI -> "Quite OK Image Format" (qoiformat.org), lossless and about as small as PNG for drawings,
+*              but many times faster to encode. A grayscale image is written as RGB.
+*       PNM -> Binary PGM (grayscale) or PPM (RGB) without compression, the fastest to write.
+*/
+
+namespace Path
+{
+    /*
+    *   Encodes an image and writes it to a file.
+    *   Parameters:
+    *       char* path -> Path to the file.
+    *       const uint8_t* data -> The pixels.
+    *       image_info_t image_info -> Information of the image.
+    *   Return:
+    *       'false' if the file could not be written.
+    */
+    using image_encoder_t = bool(*)(const char* const, const uint8_t*, const image_info_t&);
+
+    /*
+    *   Writes a QOI image (1 to 4 channels, 1 and 2 channels are written as RGB and RGBA).
+    *   Parameters and return: see image_encoder_t.
+    */
+    bool write_qoi(const char* const, const uint8_t*, const image_info_t&);
+
+    /*
+    *   Writes a binary PGM (1 channel) or PPM (3 channels) image, the alpha channel of 2 and 4 channels is left out.
+    *   Parameters and return: see image_encoder_t.
+    */
+    bool write_pnm(const char* const, const uint8_t*, const image_info_t&);
+
+    /*
+    *   Class: DebugImageWriter
+    *   Writes images on a background thread in the order they have been given.
+    *   The pixels are handed over to the writer, so the caller can change its own image right after write(...).
+    *   The destructor waits until every image has been written.
+    */
+    class DebugImageWriter
+    {
+    private:
+        struct Job
+        {
+            std::string path;
+            std::vector<uint8_t> pixels;
+            image_info_t image_info;
+            image_encoder_t encode;
+        };
+
+        std::deque<Job> jobs;
+        std::mutex mutex;
+        std::condition_variable job_added;
+        std::condition_variable jobs_done;
+        size_t num_pending;         // Images that have been given and are not written yet.
+        size_t num_failed;
+        bool running;
+        std::thread writer;
+
+        // Loop of the background thread.
+        void write_loop(void);
+
+    public:
+        // Starts the background thread.
+        DebugImageWriter(void);
+
+        DebugImageWriter(const DebugImageWriter&) = delete;
+        DebugImageWriter& operator=(const DebugImageWriter&) = delete;
+
+        // Writes the remaining images and stops the background thread.
+        virtual ~DebugImageWriter(void);
+
+        /*
+        *   Adds an image to the queue, returns without waiting.
+        *   Parameters:
+        *       char* path -> Path to the file.
+        *       std::vector<uint8_t>&& pixels -> The pixels of the image (width * height * channels bytes), are moved into the writer.
+        *       image_info_t image_info -> Information of the image.
+        *       image_encoder_t encode -> Encoder of the format, e.g. write_qoi.
+        */
+        void write(const char* const, std::vector<uint8_t>&&, const image_info_t&, image_encoder_t);
+
+        /*
+        *   Waits until every image that has been given is written.
+        *   Return:
+        *       Number of images that could not be written (since the start).
+        */
+        size_t finish(void);
+    };
+};
+
+#endif // __debug_writer_h__
@@ -0,0 +1,75 @@
+/******************************************************************************************************************************************
+* Title:        Goal file converter
+* Programtitle: goalconvert(.exe)
+* Description:
+*   Converts goal files between the old text format ("goals.gol") and the binary goal file (see goalfile.h).
+*   The direction is detected from the input file: a binary goal file is converted to a text file, everything
+*   else is read as a text file and converted to a binary goal file.
+*
+*   Command syntax:
+*       goalconvert(.exe) <input file> <output file> [<vehicle id>]
+*   The vehicle id is 0 by default. For a text file it is the vehicle of the goals, for a binary goal file
+*   it selects which goals are written to the text file.
+*
+*   Return values:
+*       0 -> Success!
+*       -1 -> There is something wrong with the command.
+*       -2 -> Failed to read the input file.
+*       -3 -> Failed to write the output file.
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include "goalfile.h"
+
+using namespace Path;
+
+int main(int argc, char** argv)
+{
+    if(argc < 3 || argc > 4)
+    {
+        printf("[ERROR] Syntax: goalconvert <input file> <output file> [<vehicle id>]\n");
+        return -1;
+    }
+    int vehicle_id = 0;
+    if(argc == 4 && sscanf(argv[3], "%d", &vehicle_id) != 1)
+    {
+        printf("[ERROR] Invalid vehicle id: \"%s\"\n", argv[3]);
+        return -1;
+    }
+
+    GoalFile goalfile;
+    std::vector<ntc_coord_t> goals;
+    if(goalfile.open(argv[1]))
+    {
+        // binary -> text
+        uint32_t num_goals;
+        const ntc_coord_t* vehicle_goals = goalfile.goals(vehicle_id, num_goals);
+        if(vehicle_goals == nullptr)
+        {
+            printf("[ERROR] \"%s\" contains no goals for vehicle %d.\n", argv[1], vehicle_id);
+            return -2;
+        }
+        goals.assign(vehicle_goals, vehicle_goals + num_goals);
+        if(!write_text_goals(argv[2], goals))
+        {
+            printf("[ERROR] Failed to write \"%s\".\n", argv[2]);
+            return -3;
+        }
+    }
+    else
+    {
+        // text -> binary
+        if(!read_text_goals(argv[1], goals))
+        {
+            printf("[ERROR] Failed to read \"%s\".\n", argv[1]);
+            return -2;
+        }
+        if(!write_goalfile(argv[2], vehicle_id, goals))
+        {
+            printf("[ERROR] Failed to write \"%s\".\n", argv[2]);
+            return -3;
+        }
+    }
+    printf("Converted %u goals of vehicle %d.\n", (uint32_t)goals.size(), vehicle_id);
+    return 0;
+}
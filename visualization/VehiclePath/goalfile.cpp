@@ -0,0 +1,235 @@
+#include <cstdio>
+#include <cstring>
+#include "goalfile.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+using namespace Path;
+
+/*
+*   Writes the goal file of several vehicles.
+*   Parameters:
+*       const char* path -> Path to the file.
+*       const std::vector<std::pair<int, const std::vector<ntc_coord_t>*>>& vehicles -> Vehicle id and goals of every vehicle.
+*/
+static bool write_vehicles(const char* const path, const std::vector<std::pair<int, const std::vector<ntc_coord_t>*>>& vehicles)
+{
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr)
+        return false;
+
+    goalfile_header_t header;
+    memcpy(header.magic, GOALFILE_MAGIC, sizeof(header.magic));
+    header.version = GOALFILE_VERSION;
+    header.header_size = sizeof(goalfile_header_t);
+    header.num_vehicles = vehicles.size();
+    header.reserved = 0;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // The goals begin after the offset table, every offset is a multiple of 8 (the size of the header, the entries and a goal).
+    uint64_t offset = sizeof(goalfile_header_t) + vehicles.size() * sizeof(goalfile_entry_t);
+    for(const auto& vehicle : vehicles)
+    {
+        goalfile_entry_t entry;
+        entry.vehicle_id = vehicle.first;
+        entry.num_goals = vehicle.second->size();
+        entry.offset = offset;
+        ok = ok && fwrite(&entry, sizeof(entry), 1, file) == 1;
+        offset += entry.num_goals * sizeof(ntc_coord_t);
+    }
+    for(const auto& vehicle : vehicles)
+        ok = ok && fwrite(vehicle.second->data(), sizeof(ntc_coord_t), vehicle.second->size(), file) == vehicle.second->size();
+
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+bool Path::write_goalfile(const char* const path, const std::map<int, std::vector<ntc_coord_t>>& goals)
+{
+    std::vector<std::pair<int, const std::vector<ntc_coord_t>*>> vehicles;
+    for(const auto& vehicle : goals)
+        vehicles.emplace_back(vehicle.first, &vehicle.second);
+    return write_vehicles(path, vehicles);
+}
+
+bool Path::write_goalfile(const char* const path, int vehicle_id, const std::vector<ntc_coord_t>& goals)
+{
+    return write_vehicles(path, {{vehicle_id, &goals}});
+}
+
+bool Path::write_text_goals(const char* const path, const std::vector<ntc_coord_t>& goals)
+{
+    FILE* file = fopen(path, "w");
+    if(file == nullptr)
+        return false;
+
+    for(const ntc_coord_t& goal : goals)
+        fprintf(file, "%f %f\n", goal.x, goal.y);
+
+    return fclose(file) == 0;
+}
+
+bool Path::read_text_goals(const char* const path, std::vector<ntc_coord_t>& goals)
+{
+    FILE* file = fopen(path, "r");
+    if(file == nullptr)
+        return false;
+
+    goals.clear();
+    ntc_coord_t goal;
+    while(fscanf(file, "%f %f", &goal.x, &goal.y) == 2)
+        goals.push_back(goal);
+
+    // Everything has to be read, otherwise the file contains something that is not a goal.
+    const bool ok = feof(file) != 0;
+    fclose(file);
+    return ok;
+}
+
+bool Path::convert_text_goals(const char* const text_path, const char* const goalfile_path, int vehicle_id)
+{
+    std::vector<ntc_coord_t> goals;
+    if(!read_text_goals(text_path, goals))
+        return false;
+    return write_goalfile(goalfile_path, vehicle_id, goals);
+}
+
+GoalFile::GoalFile(void)
+{
+    this->data = nullptr;
+    this->size = 0;
+#ifdef _WIN32
+    this->file_handle = INVALID_HANDLE_VALUE;
+    this->mapping_handle = nullptr;
+#endif
+}
+
+GoalFile::~GoalFile(void)
+{
+    this->close();
+}
+
+bool GoalFile::open(const char* const path)
+{
+    this->close();
+
+#ifdef _WIN32
+    this->file_handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(this->file_handle == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER file_size;
+    if(!GetFileSizeEx(this->file_handle, &file_size) || file_size.QuadPart < (LONGLONG)sizeof(goalfile_header_t))
+    {
+        this->close();
+        return false;
+    }
+    this->mapping_handle = CreateFileMappingA(this->file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(this->mapping_handle == nullptr)
+    {
+        this->close();
+        return false;
+    }
+    this->data = (const uint8_t*)MapViewOfFile(this->mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    this->size = file_size.QuadPart;
+#else
+    const int fd = ::open(path, O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(goalfile_header_t))
+    {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // The mapping stays valid without the file descriptor.
+    if(mapped != MAP_FAILED)
+    {
+        this->data = (const uint8_t*)mapped;
+        this->size = st.st_size;
+    }
+#endif
+
+    if(this->data == nullptr || !this->validate())
+    {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+void GoalFile::close(void)
+{
+#ifdef _WIN32
+    if(this->data != nullptr)
+        UnmapViewOfFile(this->data);
+    if(this->mapping_handle != nullptr)
+        CloseHandle(this->mapping_handle);
+    if(this->file_handle != INVALID_HANDLE_VALUE)
+        CloseHandle(this->file_handle);
+    this->file_handle = INVALID_HANDLE_VALUE;
+    this->mapping_handle = nullptr;
+#else
+    if(this->data != nullptr)
+        munmap((void*)this->data, this->size);
+#endif
+    this->data = nullptr;
+    this->size = 0;
+}
+
+bool GoalFile::validate(void) const noexcept
+{
+    const goalfile_header_t* header = (const goalfile_header_t*)this->data;
+    if(memcmp(header->magic, GOALFILE_MAGIC, sizeof(header->magic)) != 0 || header->version != GOALFILE_VERSION ||
+       header->header_size < sizeof(goalfile_header_t) || header->header_size % alignof(goalfile_entry_t) != 0)
+        return false;
+
+    // The offset table and the goals of every vehicle have to be in the file.
+    const uint64_t table_end = header->header_size + (uint64_t)header->num_vehicles * sizeof(goalfile_entry_t);
+    if(table_end > this->size)
+        return false;
+    uint32_t i;
+    for(i = 0; i < header->num_vehicles; i++)
+    {
+        const goalfile_entry_t& e = this->entry(i);
+        if(e.offset < table_end || e.offset % alignof(ntc_coord_t) != 0 || e.offset > this->size ||
+           (uint64_t)e.num_goals * sizeof(ntc_coord_t) > this->size - e.offset)
+            return false;
+    }
+    return true;
+}
+
+uint32_t GoalFile::num_vehicles(void) const noexcept
+{
+    return ((const goalfile_header_t*)this->data)->num_vehicles;
+}
+
+const goalfile_entry_t& GoalFile::entry(uint32_t index) const noexcept
+{
+    const goalfile_header_t* header = (const goalfile_header_t*)this->data;
+    return ((const goalfile_entry_t*)(this->data + header->header_size))[index];
+}
+
+const ntc_coord_t* GoalFile::goals(int vehicle_id, uint32_t& num_goals) const noexcept
+{
+    // There are only a few vehicles, a linear search is fast enough.
+    uint32_t i;
+    for(i = 0; i < this->num_vehicles(); i++)
+    {
+        const goalfile_entry_t& e = this->entry(i);
+        if(e.vehicle_id == vehicle_id)
+        {
+            num_goals = e.num_goals;
+            return (const ntc_coord_t*)(this->data + e.offset);
+        }
+    }
+    num_goals = 0;
+    return nullptr;
+}
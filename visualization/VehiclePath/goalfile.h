@@ -0,0 +1,179 @@
+#ifndef __goalfile_h__
+#define __goalfile_h__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include "pathgen.h"
+
+/*
+*   Goal files of the path generator.
+*
+*   Binary goal file (version 1), all values are little endian:
+*       header          -> goalfile_header_t (16 bytes)
+*       offset table    -> one goalfile_entry_t (16 bytes) per vehicle
+*       goals           -> x, y (float) of every goal, the goals of every vehicle are packed one after another
+*   The goals are stored exactly as they are in memory (ntc_coord_t), so the file can be memory-mapped and
+*   used without parsing (see GoalFile).
+*
+*   Text goal file (the old format, e.g. "goals.gol"):
+*       one goal per line: "<x> <y>" with 6 decimal places
+*/
+
+namespace Path
+{
+    constexpr char GOALFILE_MAGIC[4] = {'S', 'G', 'O', 'L'};
+    constexpr uint16_t GOALFILE_VERSION = 1;
+
+    /*
+    *   Header of a binary goal file.
+    *   Members:
+    *       magic -> GOALFILE_MAGIC
+    *       version -> GOALFILE_VERSION
+    *       header_size -> Size of the header in bytes, the offset table starts there.
+    *       num_vehicles -> Number of entries in the offset table.
+    *       reserved -> 0
+    */
+    struct goalfile_header_t
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t header_size;
+        uint32_t num_vehicles;
+        uint32_t reserved;
+    };
+
+    /*
+    *   One entry of the offset table.
+    *   Members:
+    *       vehicle_id -> Vehicle that gets the goals.
+    *       num_goals -> Number of goals of the vehicle.
+    *       offset -> Position of the first goal from the begin of the file in bytes.
+    */
+    struct goalfile_entry_t
+    {
+        int32_t vehicle_id;
+        uint32_t num_goals;
+        uint64_t offset;
+    };
+
+    static_assert(sizeof(goalfile_header_t) == 16 && sizeof(goalfile_entry_t) == 16, "the goal file structs must not have padding");
+    static_assert(sizeof(ntc_coord_t) == 2 * sizeof(float), "the goals are stored as packed float pairs");
+
+    /*
+    *   Writes a binary goal file.
+    *   Parameters:
+    *       char* path -> Path to the file.
+    *       std::map<int, std::vector<ntc_coord_t>> goals -> The goals of every vehicle (key: vehicle id).
+    *   Return:
+    *       'false' if the file could not be written.
+    */
+    bool write_goalfile(const char* const, const std::map<int, std::vector<ntc_coord_t>>&);
+
+    /*
+    *   Writes a binary goal file with the goals of one vehicle.
+    *   Parameters:
+    *       char* path -> Path to the file.
+    *       int vehicle_id -> Vehicle that gets the goals.
+    *       std::vector<ntc_coord_t> goals -> The goals.
+    *   Return:
+    *       'false' if the file could not be written.
+    */
+    bool write_goalfile(const char* const, int, const std::vector<ntc_coord_t>&);
+
+    /*
+    *   Writes a text goal file (old format).
+    *   Parameters:
+    *       char* path -> Path to the file.
+    *       std::vector<ntc_coord_t> goals -> The goals.
+    *   Return:
+    *       'false' if the file could not be written.
+    */
+    bool write_text_goals(const char* const, const std::vector<ntc_coord_t>&);
+
+    /*
+    *   Reads a text goal file (old format).
+    *   Parameters:
+    *       char* path -> Path to the file.
+    *       std::vector<ntc_coord_t>& goals -> Gets the goals.
+    *   Return:
+    *       'false' if the file could not be read.
+    */
+    bool read_text_goals(const char* const, std::vector<ntc_coord_t>&);
+
+    /*
+    *   Converts a text goal file into a binary goal file.
+    *   Parameters:
+    *       char* text_path -> Path to the text goal file.
+    *       char* goalfile_path -> Path to the binary goal file.
+    *       int vehicle_id -> Vehicle that gets the goals.
+    *   Return:
+    *       'false' if the text file could not be read or the binary file could not be written.
+    */
+    bool convert_text_goals(const char* const, const char* const, int);
+
+    /*
+    *   Class: GoalFile
+    *   A memory-mapped binary goal file, the goals are read directly from the file without parsing.
+    */
+    class GoalFile
+    {
+    private:
+        const uint8_t* data;
+        size_t size;
+    #ifdef _WIN32
+        void* file_handle;
+        void* mapping_handle;
+    #endif
+
+        // Checks the header and the offset table.
+        bool validate(void) const noexcept;
+
+    public:
+        GoalFile(void);
+
+        GoalFile(const GoalFile&) = delete;
+        GoalFile& operator=(const GoalFile&) = delete;
+
+        virtual ~GoalFile(void);
+
+        /*
+        *   Maps a binary goal file into memory.
+        *   Parameters:
+        *       char* path -> Path to the file.
+        *   Return:
+        *       'false' if the file could not be mapped or is not a valid goal file (of this version).
+        */
+        bool open(const char* const);
+
+        // Unmaps the file, the pointers to the goals are not valid anymore.
+        void close(void);
+
+        // Return: true if a file is mapped.
+        bool is_open(void) const noexcept {return this->data != nullptr;}
+
+        // Return: number of vehicles in the file.
+        uint32_t num_vehicles(void) const noexcept;
+
+        /*
+        *   Parameters:
+        *       uint32_t index -> Index in the offset table (0 to num_vehicles() - 1).
+        *   Return:
+        *       The entry of the offset table.
+        */
+        const goalfile_entry_t& entry(uint32_t) const noexcept;
+
+        /*
+        *   Returns the goals of a vehicle.
+        *   Parameters:
+        *       int vehicle_id -> The vehicle.
+        *       uint32_t& num_goals -> Gets the number of goals.
+        *   Return:
+        *       Pointer to the first goal in the mapped file, 'nullptr' if the file has no goals of the vehicle.
+        */
+        const ntc_coord_t* goals(int, uint32_t&) const noexcept;
+    };
+};
+
+#endif // __goalfile_h__
@@ -0,0 +1,104 @@
+/******************************************************************************************************************************************
+* Title:        Goal file benchmark
+* Programtitle: goalfile_benchmark
+* Description:
+*   Compares the text goal file (fprintf / fscanf) with the binary goal file (fwrite / memory-mapped).
+*   For every number of goals it prints the time to write and to read the file, the size of the file
+*   and the largest difference between a goal that has been read and the goal that has been written.
+*   Reading the binary file includes mapping it and summing up all goals (every page is touched).
+*
+*   Command syntax:
+*       goalfile_benchmark [<number of runs>]
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include "goalfile.h"
+
+using namespace Path;
+
+static constexpr char TEXT_PATH[] = "goalfile_benchmark.gol";
+static constexpr char BINARY_PATH[] = "goalfile_benchmark.sgol";
+
+static double ms_since(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static long file_size(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr)
+        return -1;
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+int main(int argc, char** argv)
+{
+    const int num_runs = (argc > 1) ? atoi(argv[1]) : 5;
+    const uint32_t goal_counts[] = {10000, 100000, 1000000};
+
+    printf("format,goals,write ms,read ms,file kB,max error\n");
+    for(uint32_t num_goals : goal_counts)
+    {
+        // Goals like those of a path in a 4k image.
+        std::vector<ntc_coord_t> goals(num_goals);
+        uint32_t rnd = 12345;
+        for(ntc_coord_t& goal : goals)
+        {
+            rnd = rnd * 1103515245 + 12345;
+            goal.x = ((rnd >> 8) % 3840) / 3840.0f;
+            rnd = rnd * 1103515245 + 12345;
+            goal.y = ((rnd >> 8) % 2160) / 2160.0f;
+        }
+
+        double text_write = 1e30, text_read = 1e30, bin_write = 1e30, bin_read = 1e30;
+        float text_error = 0.0f, bin_error = 0.0f;
+        for(int run = 0; run < num_runs; run++)
+        {
+            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+            if(!write_text_goals(TEXT_PATH, goals))
+                return -1;
+            text_write = std::min(text_write, ms_since(t0));
+
+            std::vector<ntc_coord_t> text_goals;
+            t0 = std::chrono::steady_clock::now();
+            if(!read_text_goals(TEXT_PATH, text_goals) || text_goals.size() != num_goals)
+                return -1;
+            text_read = std::min(text_read, ms_since(t0));
+
+            t0 = std::chrono::steady_clock::now();
+            if(!write_goalfile(BINARY_PATH, 0, goals))
+                return -1;
+            bin_write = std::min(bin_write, ms_since(t0));
+
+            t0 = std::chrono::steady_clock::now();
+            GoalFile goalfile;
+            uint32_t n = 0;
+            const ntc_coord_t* bin_goals = goalfile.open(BINARY_PATH) ? goalfile.goals(0, n) : nullptr;
+            if(bin_goals == nullptr || n != num_goals)
+                return -1;
+            volatile float sum = 0.0f;
+            for(uint32_t i = 0; i < n; i++)
+                sum = sum + bin_goals[i].x + bin_goals[i].y;
+            bin_read = std::min(bin_read, ms_since(t0));
+
+            for(uint32_t i = 0; i < num_goals; i++)
+            {
+                text_error = std::max({text_error, std::fabs(text_goals[i].x - goals[i].x), std::fabs(text_goals[i].y - goals[i].y)});
+                bin_error = std::max({bin_error, std::fabs(bin_goals[i].x - goals[i].x), std::fabs(bin_goals[i].y - goals[i].y)});
+            }
+        }
+        printf("text,%u,%.2f,%.2f,%ld,%g\n", num_goals, text_write, text_read, file_size(TEXT_PATH) / 1024, text_error);
+        printf("binary,%u,%.2f,%.2f,%ld,%g\n", num_goals, bin_write, bin_read, file_size(BINARY_PATH) / 1024, bin_error);
+    }
+    remove(TEXT_PATH);
+    remove(BINARY_PATH);
+    return 0;
+}
@@ -0,0 +1,179 @@
+/******************************************************************************************************************************************
+* Title:        Goal sampling benchmark
+* Programtitle: goals_benchmark
+* Description:
+*   Compares the uniform goals (gen_goals: the same number of path pixels between all goals) with the adaptive goals
+*   (gen_goals_adaptive: simplified path, more goals in curves than on straight parts) on a corpus of traced paths.
+*   Both are generated through the goal settings (goal_settings_t), like "pathgenerator -adaptive" selects them.
+*   The deviation of a set of goals is the maximum distance of a path pixel to the line between the two goals around it,
+*   that is how far a vehicle that drives straight from goal to goal is away from the drawn path.
+*
+*   For every path and maximum deviation it prints:
+*       adaptive goals  -> Number of goals and their measured deviation (has to be at most the maximum deviation).
+*       uniform goals   -> The smallest number of uniform goals with at most the same deviation (also for every larger
+*                          number), and the deviation of the same number of uniform goals as adaptive goals.
+*       reduction       -> How many goals less the adaptive goals need for the same deviation.
+*
+*   Command syntax:
+*       goals_benchmark
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "pathgen.h"
+
+struct TestPath
+{
+    const char* name;
+    std::vector<Path::img_coord_t> pixels;
+};
+
+// Draws a thick closed line (every pixel whose "distance" d(x, y) is between 0.85 and 1.0) and traces it.
+template<typename dist_func>
+static TestPath gen_path(const char* name, dist_func d)
+{
+    const Path::image_info_t ii = {1280, 960, 1};
+    std::vector<uint8_t> data(ii.width * ii.height, 0);
+    for(int y = 0; y < ii.height; y++)
+    {
+        for(int x = 0; x < ii.width; x++)
+        {
+            const float v = d((x - ii.width / 2.0f) / (ii.width * 0.4f), (y - ii.height / 2.0f) / (ii.height * 0.4f));
+            if(v >= 0.85f && v <= 1.0f)
+                data[Path::img_at(x, y, ii)] = 255;
+        }
+    }
+    TestPath path = {name, {}};
+    Path::gen_path(data.data(), path.pixels, ii);
+    return path;
+}
+
+static std::vector<TestPath> gen_corpus(void)
+{
+    std::vector<TestPath> corpus;
+    corpus.push_back(gen_path("circle", [](float x, float y){return std::sqrt(x * x + y * y);}));
+    corpus.push_back(gen_path("rectangle", [](float x, float y){return std::fmax(std::fabs(x), std::fabs(y));}));
+    corpus.push_back(gen_path("rounded rectangle", [](float x, float y){return std::pow(x * x * x * x + y * y * y * y, 0.25f);}));
+    corpus.push_back(gen_path("ellipse", [](float x, float y){return std::sqrt(x * x * 1.5f + y * y * 0.7f);}));
+    corpus.push_back(gen_path("star", [](float x, float y){
+        // radius changes with the angle (5 tips)
+        return std::sqrt(x * x + y * y) / (0.75f + 0.25f * std::cos(5.0f * std::atan2(y, x)));
+    }));
+    corpus.push_back(gen_path("track", [](float x, float y){
+        // a race track: two straights and two half circles
+        const float cx = std::fmax(0.0f, std::fabs(x) - 0.5f);
+        return std::sqrt(cx * cx * 4.0f + y * y);
+    }));
+    return corpus;
+}
+
+static float segment_distance(const Path::img_coord_t& p, const Path::img_coord_t& a, const Path::img_coord_t& b)
+{
+    const float abx = (float)(b.x - a.x), aby = (float)(b.y - a.y);
+    const float apx = (float)(p.x - a.x), apy = (float)(p.y - a.y);
+    const float len2 = abx * abx + aby * aby;
+    const float t = (len2 > 0.0f) ? std::min(1.0f, std::max(0.0f, (apx * abx + apy * aby) / len2)) : 0.0f;
+    return std::hypot(apx - t * abx, apy - t * aby);
+}
+
+/*
+*   Measures the deviation of goals from the path.
+*   Every goal is a pixel of the path (in the order of the path), the last goal is the first pixel again.
+*   Return: the deviation, a negative value if a goal is not on the path.
+*/
+static float deviation(const std::vector<Path::img_coord_t>& path, const std::vector<Path::goal_coord_t>& goals)
+{
+    std::vector<Path::img_coord_t> chain(path);
+    chain.push_back(path[0]);
+    // Index of every goal in the chain.
+    std::vector<size_t> index;
+    size_t i = 0;
+    for(size_t g = 0; g + 1 < goals.size(); g++)
+    {
+        while(i < path.size() && (chain[i].x != goals[g].x || chain[i].y != goals[g].y))
+            i++;
+        if(i == path.size())
+            return -1.0f;
+        index.push_back(i);
+    }
+    index.push_back(path.size());
+
+    float max_dist = 0.0f;
+    for(size_t g = 0; g + 1 < index.size(); g++)
+    {
+        for(i = index[g]; i <= index[g + 1]; i++)
+            max_dist = std::max(max_dist, segment_distance(chain[i], chain[index[g]], chain[index[g + 1]]));
+    }
+    return max_dist;
+}
+
+// Return: deviation of n uniform goals.
+static float uniform_deviation(const std::vector<Path::img_coord_t>& path, unsigned int n, size_t& num_goals)
+{
+    std::vector<Path::goal_coord_t> goals;
+    Path::gen_goals(path, goals, Path::goal_settings_t{n});
+    num_goals = goals.size();
+    return deviation(path, goals);
+}
+
+int main(void)
+{
+    const std::vector<TestPath> corpus = gen_corpus();
+    const float deviations[] = {0.5f, 1.0f, 2.0f, 4.0f};
+    const float spacings[] = {0.0f, 100.0f};
+    bool ok = true;
+
+    printf("path,path pixels,max deviation,max spacing,adaptive goals,adaptive deviation,uniform goals (same deviation),"
+           "uniform deviation (same goals),reduction,adaptive us\n");
+    for(const TestPath& path : corpus)
+    {
+        if(path.pixels.empty())
+        {
+            printf("[ERROR] No path: %s.\n", path.name);
+            return -1;
+        }
+        for(float spacing : spacings)
+        {
+            for(float max_dev : deviations)
+            {
+                std::vector<Path::goal_coord_t> goals;
+                const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+                Path::gen_goals(path.pixels, goals, Path::goal_settings_t{0, max_dev, spacing});
+                const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+                const float dev = deviation(path.pixels, goals);
+
+                // The largest distance between two goals (at most the arc length).
+                float max_gap = 0.0f;
+                for(size_t g = 0; g + 1 < goals.size(); g++)
+                    max_gap = std::max(max_gap, std::hypot((float)(goals[g + 1].x - goals[g].x), (float)(goals[g + 1].y - goals[g].y)));
+                if(dev < 0.0f || dev > max_dev || (spacing > 0.0f && max_gap > spacing + 1.5f))
+                {
+                    printf("[ERROR] %s: deviation %.2f, spacing %.1f.\n", path.name, dev, max_gap);
+                    ok = false;
+                }
+
+                // The smallest number of uniform goals with the same deviation, also for every larger number
+                // (a smaller number can be below the deviation by chance, e.g. if the goals hit the corners of a rectangle).
+                size_t uniform_goals = path.pixels.size() + 1, num_goals, same_goals;
+                unsigned int n;
+                for(n = path.pixels.size(); n >= 1; n--)
+                {
+                    const float d = uniform_deviation(path.pixels, n, num_goals);
+                    if(d < 0.0f || d > max_dev)
+                        break;
+                    uniform_goals = num_goals;
+                }
+                const float same_dev = uniform_deviation(path.pixels, goals.size() - 1, same_goals);
+
+                printf("%s,%zu,%.1f,%.0f,%zu,%.2f,%zu,%.2f,%.1f%%,%.1f\n", path.name, path.pixels.size(), max_dev, spacing, goals.size(), dev,
+                       uniform_goals, same_dev, 100.0 * (1.0 - (double)goals.size() / uniform_goals), us);
+            }
+        }
+    }
+    return ok ? 0 : -1;
+}
@@ -6,14 +6,33 @@
 * Description:
 *   Program that generates goals from a drawn path on an image file.
 *   The programm supports most of the image filetypes (e.g. .png, .jpg,...).
-*   Debug images are always .png images.
+*   Debug images are .png images (or .qoi / .pgm, see the flags), they are written by a background thread
+*   while the pipeline goes on, the program waits for them at the end.
+*   The input file can also be a vector drawing (polyline text file or SVG, see polyline.h), it is found by its content.
+*   The goals are sampled from the polylines directly, the drawing is never rasterized and traced (no debug images,
+*   -invert has no effect).
 *
 *   Command syntax:
 *       pathgenerator(.exe) <path to input file> <path to output file> <number of goals> [<flags>]
+*       pathgenerator(.exe) -batch <path to manifest file> <path to output file> [-log]
 *   Command flags:
-*       -nodebug -> No debug images will be generated.
+*       -nodebug -> No debug images will be generated, the image is read and thresholded band by band (less memory).
 *       -log -> Debug messages will be printed an a log file.
 *       -invert -> The image gets invertet to be able to use a white background.
+*       -binary -> The goals are written to a binary goal file (see goalfile.h) instead of a text file.
+*       -qoi -> The debug images are .qoi images (see debug_writer.h), many times faster to encode than .png.
+*       -pnm -> The debug images are uncompressed .pgm images, the fastest to write.
+*       -adaptive <max deviation> -> The goals are adaptive (see gen_goals_adaptive(...)): as few goals as possible, so that the
+*                    vehicle never deviates more than <max deviation> pixels from the path. The number of goals is not used.
+*                    Can be combined with -contours. Has no effect on a drawing.
+*       -contours -> Every path of the image gets its own goals (see contours.h), e.g. one path per vehicle in one image.
+*                    The goals are written to a binary goal file with one entry per path (-binary is implied), the vehicle
+*                    ids are 0, 1, 2, ... in the order of the paths (row by row of their begin pixels). Paths with less
+*                    pixels than goals are left out. Has no effect on a drawing.
+*   Batch mode:
+*       Generates the goals of every job of the manifest file (see batch.h) on one thread per core and writes them
+*       into one binary goal file (one entry per vehicle). Every image is only read and traced once, also if several
+*       jobs use it. The failed jobs and the throughput (jobs per second) are printed to the log file if log is enabled.
 *
 *   Return values:
 *       0 -> Success!
@@ -22,6 +41,7 @@
 *       -3 -> Failed to convert to grayscale.
 *       -4 -> Failed to generate goals (too many goals).
 *       -5 -> Failed to print goals to a file.
+*       -6 -> Batch mode: at least one job failed (the goals of the other jobs are written).
 *       If something is wrong with the command, a message will be printed.
 *       If another error occurs, the error message will be in the current log file if log is enabled.
 *
@@ -46,11 +66,6 @@
 * If there are any bugs, contact me!
 ******************************************************************************************************************************************/
 
-#ifndef STB_IMAGE_IMPLEMENTATION
-    #define STB_IMAGE_IMPLEMENTATION
-#endif //STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 #ifndef STB_IMAGE_WRITE_IMPLEMENTATION
     #define STB_IMAGE_WRITE_IMPLEMENTATION
 #endif //STB_IMAGE_WRITE_IMPLEMENTATION
@@ -58,47 +73,24 @@
 
 #include <cstdio>   // for in- and output
 #include <cstring>  // for sveral string-operation-functions
+#include <cstdlib>  // for strtof
 #include <vector>   
+#include <memory>
 #include <chrono>   // for time measurement
 #include <direct.h> // to create directories
 #include <dirent.h> // to check if directory exists
 #include <ctime>
-#include "path.h"
-
-#define PATH_THRESHOLD 10   // treshold value to determine if a pixel is path or not
-#define ARG_MIN_LENGTH 4    // minimal length for argc (command length)
+#include "pathgen.h"       // path generator library (grayscale, path, goals)
+#include "pathgen_image.h" // reading images
+#include "goalfile.h"      // writing the goals
+#include "batch.h"         // batch mode
+#include "debug_writer.h"  // writing the debug images in the background
+#include "polyline.h"      // goals of vector drawings
+#include "contours.h"      // every path of an image
 
-/*
-*   Contains information for one image.
-*   Members:
-*       width -> width of the image in pixels
-*       height -> height of the image in pixels
-*       channels -> number of channels that the image contains (e.g. RGB, RGBA)
-*/
-struct image_info_t
-{
-    int width{0}, height{0};
-    int channels{0};
-};
-
-/*
-*   Contains a X and Y coordinate for an image.
-*   Members:
-*       x -> X-Coordinate of the pixel.
-*       y -> Y-Coordinate of the pixel.
-*/
-
-struct img_coord_t
-{
-    int x, y;
-};
+using namespace Path;
 
-/*
-*   Is used to save the pixel-coordinates of the generated goals.
-*   Contains also X and Y coordinate values.
-*/
-
-using goal_coord_t = img_coord_t;
+#define ARG_MIN_LENGTH 4    // minimal length for argc (command length)
 
 /*
 *   Is an enumeration for several flags.
@@ -110,6 +102,10 @@ using goal_coord_t = img_coord_t;
 *       PATH_NO_DEBUG_IMAGES -> If this flag is set no debug images will be generated.
 *       PATH_LOG -> If this flag is set, debug messages will be printed to a log file.
 *       PATH_INVERT -> If this flag is set, color values will be inverted to be able to use a white background.
+*       PATH_BINARY -> If this flag is set, the goals will be written to a binary goal file.
+*       PATH_QOI -> If this flag is set, the debug images will be .qoi images.
+*       PATH_PNM -> If this flag is set, the debug images will be .pgm images.
+*       PATH_CONTOURS -> If this flag is set, every path of the image gets its own goals.
 */
 
 enum path_flag_type : int
@@ -117,7 +113,11 @@ enum path_flag_type : int
     PATH_NONE               = 0x0,
     PATH_NO_DEBUG_IMAGES    = 0x1,
     PATH_LOG                = 0x2,
-    PATH_INVERT             = 0x4
+    PATH_INVERT             = 0x4,
+    PATH_BINARY             = 0x8,
+    PATH_QOI                = 0x10,
+    PATH_PNM                = 0x20,
+    PATH_CONTOURS           = 0x40
 };
 
 using path_flag_t = int;
@@ -125,89 +125,64 @@ using path_flag_t = int;
 /* ---------- PROTOTYPES ---------- */
 
 /*
-*   Converts a 2-dimensional input (X, Y) to a 1-dimensional output.
-*   Used to access 1-dimensional arrays or vectors with a 2-dimensional (X, Y) input.
 *   Parameters:
-*       size_t x -> X value of the 2-dimensional input.
-*       size_t y -> Y value of the 2-dimensional input.
-*       image_into_t image_info -> image_info_t struct of the image that should be accessed.
+*       path_flag_t flag -> Flag-value of the path_flag_t enum.
 *   Return:
-*       1-dimensional array index.
+*       True if the PATH_NO_DEBUG_IMAGES is set.
+*       False if the PATH_NO_DEBUG_IMAGES is not set.
 */
 
-size_t img_at(size_t, size_t, const image_info_t&);
-
-/*
-*   Searches the given path-matrix of the given map and returns the
-*   direction of that matrix.
-*   Parameters:
-*       std::map<Path::PathMatrix*, Path::PathDirection> mat2dir -> Map where the matrices and the directions are located.
-*       Path::PathMatrix mat -> The matrix that should be searched for.
-*   Return:
-*       A pointer to the found matrix or.
-*       'nullptr' if the matrix couldn't be found.
-*/
-const Path::PathDirection* get_dirp(const std::map<Path::PathMatrix*, Path::PathDirection>&, const Path::PathMatrix&);
+bool should_print_img(path_flag_t);
 
 /*
-*   Determines if a pixel is a path or not.
 *   Parameters:
-*       uint8_t value -> Value of the current (grayscale) pixel.
-*       uint8_t threshold -> Value of the treshold.
+*       path_flag_t flag -> Flag-value of the path_flag_t enum.
 *   Return:
-*       True if the pixel value is a path.
-*       False if the pixel value is not a path.
+*       True if the PATH_LOG is set.
+*       False if the PATH_LOG is not set.
 */
 
-bool is_path(uint8_t, uint8_t);
+bool should_log(path_flag_t);
 
 /*
-*   Generates a matrix for a given image position.
-*   The given position is the center pixel.
-*   If the given coordinate is the edge or the corner of the image, the surrounding
-*   pixels that would be outside of the image will always be 0.
 *   Parameters:
-*       uint8_t* data -> Pointer to the image (pixel) data.
-*       int cx -> Current X value of the center pixel.
-*       int cy -> Current Y value of the center pixel.
-*       image_info_t image_info -> image_info_t struct of the image that should be accessed.
+*       path_flag_t flag -> Flag-value of the path_flag_t enum.
 *   Return:
-*       Returns a 3x3 matrix for the center pixel + 8 surrounding pixels.
-*   Note: The matrix contains only information whether the pixel is a path (1)
-*         or it is not a path (0).
+*       True if the PATH_INVERT is set.
+*       False if the PATH_INVERT is not set.
 */
 
-Path::PathMatrix gen_pathmatrix(uint8_t*, int, int, const image_info_t&);
+bool should_invert(path_flag_t flag);
 
 /*
 *   Parameters:
 *       path_flag_t flag -> Flag-value of the path_flag_t enum.
 *   Return:
-*       True if the PATH_NO_DEBUG_IMAGES is set.
-*       False if the PATH_NO_DEBUG_IMAGES is not set.
+*       True if the PATH_BINARY is set.
+*       False if the PATH_BINARY is not set.
 */
 
-bool should_print_img(path_flag_t);
+bool should_write_binary(path_flag_t flag);
 
 /*
 *   Parameters:
 *       path_flag_t flag -> Flag-value of the path_flag_t enum.
+*       const char*& extension -> Gets the file extension of the debug images (e.g. "png").
 *   Return:
-*       True if the PATH_LOG is set.
-*       False if the PATH_LOG is not set.
+*       The encoder of the debug images: .pnm if PATH_PNM is set, .qoi if PATH_QOI is set, otherwise .png.
 */
 
-bool should_log(path_flag_t);
+image_encoder_t debug_image_format(path_flag_t flag, const char*& extension);
 
 /*
 *   Parameters:
 *       path_flag_t flag -> Flag-value of the path_flag_t enum.
 *   Return:
-*       True if the PATH_INVERT is set.
-*       False if the PATH_INVERT is not set.
+*       True if the PATH_CONTOURS is set.
+*       False if the PATH_CONTOURS is not set.
 */
 
-bool should_invert(path_flag_t flag);
+bool should_extract_contours(path_flag_t flag);
 
 /*
 *   Analyzes a atring of it is a valid decimal number.
@@ -220,83 +195,65 @@ bool should_invert(path_flag_t flag);
 
 bool is_number(const char* const);
 
-/*
-*   Reads the pixels of any given image file.
-*   Parameters:
-*       char* image_path -> Path to the image that should be read.
-*       image_info_t& image_info -> Reference to a image_info_t struct where the corresponding image information gets written to.
-*   Return:
-*       Pixel data of the image.
-*/
-
-uint8_t* read_image(const char* const, image_info_t&);
-
 /*
 *   Outputs image (pixel) data.
 *   Only .png filetype is supported.
 *   Parameters:
 *       char* image_path -> Path where the image should be saved.
+*       const uint8_t* data -> The pixels of the image.
 *       image_info_t image_info -> Image information of the corresponding image.
+*   Return:
+*       'false' if the image could not be written.
 */
 
-void write_image(const char* const, const image_info_t&);
-
-/*
-*   Converts any image to a grayscale image.
-*   Undependend of the given number of channels.
-*   Parameter:
-*       uint8_t** data -> Pointer to the buffer where the image data is located.
-*                         Furthermore, the new data gets written back into the buffer.
-*                         (new buffer will be allocated and the old one gets deleted)
-*       image_info_t image_info -> Struct where the new image information (of the grayscale image)
-*                                  gets written to.
-*/
-
-void to_grayscale(uint8_t**, image_info_t&);
+bool write_image(const char* const, const uint8_t*, const image_info_t&);
 
 /*
-*   Inverts the image to be able to use a white background instead of a white background.
-*   Parameter:
-*       uint8_t* data -> Data of the image.
+*   Prints the goals into a file.
+*   Parameters:
+*       std::vector<goal_coord_t> goals -> Vector with all the goals that should be printed.
+*       char* path -> Path to the file where the goals get printed to.
 *       image_info_t image_info -> Struct of the corresponding image information.
+*       bool binary -> Write a binary goal file (vehicle id 0) instead of a text file.
 */
 
-void invert_image(uint8_t*, image_info_t&);
+bool print_goals(const std::vector<goal_coord_t>&, const char* const, const image_info_t&, bool);
 
 /*
-*   Generated the path of any given image.
+*   Prints the goals of every path of an image into a binary goal file, the vehicle id of a path is its index.
 *   Parameters:
-*       uint8_t* data -> Data of the image.
-*       std::vector<img_coord_t>& path_pixels -> Vector where all the coordinates of the generated path will be saved to.
-*       std::map<Path::PathMatrix*, Path::PathDirection> mat2dir -> Map where the matrices and the directions are located.
+*       std::vector<std::vector<goal_coord_t>> goals -> The goals of every path.
+*       char* path -> Path to the goal file.
 *       image_info_t image_info -> Struct of the corresponding image information.
 */
 
-void gen_path(uint8_t*, std::vector<img_coord_t>&, const std::map<Path::PathMatrix*, Path::PathDirection>&, const image_info_t&);
+bool print_contour_goals(const std::vector<std::vector<goal_coord_t>>&, const char* const, const image_info_t&);
 
 /*
-*   Generates goals form any given path.
+*   Runs the batch mode (see header).
 *   Parameters:
-*       std::vector<img_coord_t> path_pixels -> Vector with all the coordinates of the given path.
-*       std::vector<goal_coord_t>& goals -> Vector where the coordinates of the generated goals will be saved to.
-*       unsigned int n -> Number of goals that should be generated from the given path.
-*                         Is limited to the number of coordinates the path itself has.
+*       int argc, char** argv -> The command.
+*       FILE* logfile -> The log file.
+*       char* time_prefix -> Prefix of every log message.
 *   Return:
-*       True if everything worked well.
-*       False if there was an invalid number of goals given.
+*       The return value of the program.
 */
 
-bool gen_goals(const std::vector<img_coord_t>&, std::vector<goal_coord_t>&, unsigned int);
+int run_batch_mode(const int, const char* const * const, FILE*, const char* const);
 
 /*
-*   Prints the goals into a file.
+*   Generates the goals of a vector drawing (see header), the input file of the command is a drawing.
 *   Parameters:
-*       std::vector<goal_coord_t> goals -> Vector with all the goals that should be printed.
-*       char* path -> Path to the file where the goals get printed to.
-*       image_info_t image_info -> Struct of the corresponding image information.
+*       char** argv -> The command.
+*       unsigned int num_goals -> Number of goals.
+*       path_flag_t flags -> The flags of the command.
+*       FILE* logfile -> The log file.
+*       char* time_prefix -> Prefix of every log message.
+*   Return:
+*       The return value of the program.
 */
 
-bool print_goals(const std::vector<goal_coord_t>&, const char* const, const image_info_t&);
+int run_drawing_mode(const char* const * const, unsigned int, path_flag_t, FILE*, const char* const);
 
 /* ---------- FUNCTIONS ---------- */
 
@@ -305,82 +262,51 @@ bool print_goals(const std::vector<goal_coord_t>&, const char* const, const imag
 *         Only the prototypes of all those functions are described via a header.
 */
 
-size_t img_at(size_t x, size_t y, const image_info_t& ii)
-{
-    /*
-    *   Example data with 3*3 pixels and 4 channels for each pixel (RGBA format).
-    *   The data is stored in a 1-dimensional array.
-    *   To get the index of a simple X-Y gid there is the following equation:
-    *       index = Y * (number of elements in X-direction) + X
-    * 
-    *                   X ... (n pixels) * (n channels) -> elements in X
-    *   ---------------------------------->
-    *   R1 G1 B1 A1 R2 G2 B2 A2 R3 G3 B3 A3 |
-    *   R4 G4 B4 A4 R5 G5 B5 A5 R6 R6 R6 A6 |   Y
-    *   R7 G7 B7 A7 R8 G8 B8 A8 R9 G9 B9 A9 \/
-    *   
-    *   Resulting equation: Y * (n pixels in X) * (n channels) + X * (n channels)
-    *   To get the index of the pixel 5 ('R5') the formula is like this:
-    *       1 * 3 * 4 + 1 * 4 = 16 -> which is correct
-    *   Note that the indices start at 0 and NOT at 1!
-    */
-    return y * ii.width * ii.channels + x * ii.channels;
-}
-
-const Path::PathDirection* get_dirp(const std::map<Path::PathMatrix*, Path::PathDirection>& m2d, const Path::PathMatrix& mat)
+bool should_print_img(path_flag_t flag)
 {
-    // Gothrough every element of the map.
-    for(auto iter = m2d.begin(); iter != m2d.end(); iter++)
-    {
-        // If there was found a matching element in the map, return a pointer to the second element
-        // of the pair which is the direction.
-        if(*iter->first == mat)
-            return &iter->second;
-    }
-    // If there was found nothing return 'nullptr'.
-    return nullptr;
+    // fetch the corresponding bit
+    return !(flag & path_flag_type::PATH_NO_DEBUG_IMAGES);
 }
 
-bool is_path(uint8_t value, uint8_t threshold)
+bool should_log(path_flag_t flag)
 {
-    // Self-explaining, otherwise see the description at the prorotypes.
-    return(value < threshold) ? false : true;
+    // fetch the corresponding bit
+    return flag & path_flag_type::PATH_LOG;
 }
 
-Path::PathMatrix gen_pathmatrix(uint8_t* data, int cx, int cy, const image_info_t& ii)
+bool should_invert(path_flag_t flag)
 {
-    Path::PathMatrix mat;
-    // 2-dimensional loop for a 3*3 matrix
-    int x, y;   // a optimization for speed
-    for(y = cy - 1; y <= cy + 1; y++)
-    {
-        for(x = cx - 1; x <= cx + 1; x++)
-        {
-            // If the x or y would be outside of the image set the value in the matrix to 'false'.
-            // If the pixel is part of the path set the value in the matrix to 'true' (comes from is_path(...)).
-            // If the pixel is part of the background set the value in the matrix to 'false' (comes from is_path(...)).
-            mat.at(y + 1 - cy, x + 1 - cx) = (y < 0 || x < 0 || y >= ii.height || x >= ii.width) ? false : is_path(data[img_at(x, y, ii)], PATH_THRESHOLD);
-        }
-    }
-    return mat;
+    // fetch the corresponding bit
+    return flag & path_flag_type::PATH_INVERT;
 }
 
-bool should_print_img(path_flag_t flag)
+bool should_write_binary(path_flag_t flag)
 {
     // fetch the corresponding bit
-    return !(flag & path_flag_type::PATH_NO_DEBUG_IMAGES);
+    return flag & path_flag_type::PATH_BINARY;
 }
 
-bool should_log(path_flag_t flag)
+image_encoder_t debug_image_format(path_flag_t flag, const char*& extension)
 {
-    // fetch the corresponding bit
-    return flag & path_flag_type::PATH_LOG;
+    // fetch the corresponding bits, uncompressed wins if both are set
+    if(flag & path_flag_type::PATH_PNM)
+    {
+        extension = "pgm";
+        return write_pnm;
+    }
+    if(flag & path_flag_type::PATH_QOI)
+    {
+        extension = "qoi";
+        return write_qoi;
+    }
+    extension = "png";
+    return write_image;
 }
 
-bool should_invert(path_flag_t flag)
+bool should_extract_contours(path_flag_t flag)
 {
     // fetch the corresponding bit
-    return flag & path_flag_type::PATH_INVERT;
+    return flag & path_flag_type::PATH_CONTOURS;
 }
 
 bool is_number(const char* const str)
@@ -395,159 +321,149 @@ bool is_number(const char* const str)
     return true;    // Otherwise return 'true'.
 }
 
-uint8_t* read_image(const char* const path, image_info_t& ii)
-{
-    // Load image with stbi's library function "stbi_load(...)".
-    // Prototype: stbi_load(const char* path, int* width, int* height, int* n_channels, int channels_to_read)
-    return stbi_load(path, &ii.width, &ii.height, &ii.channels, 0);
-}
-
-void write_image(uint8_t* data, const char* const path, const image_info_t& ii)
+bool write_image(const char* const path, const uint8_t* data, const image_info_t& ii)
 {
     // The image stride is, when you look at line 319, exactly one line of the example data.
     const size_t IMG_STRIDE = ii.width * ii.channels;
     // Write .png image with stbi's library function "stbi_write_png(...)".
     // Prototype: stbi_write_png(const char* path, int width, int height, int n_channels, const uint8_t* data, size_t image_stride)
-    stbi_write_png(path, ii.width, ii.height, ii.channels, data, IMG_STRIDE);
+    return stbi_write_png(path, ii.width, ii.height, ii.channels, data, IMG_STRIDE) != 0;
 }
 
-void to_grayscale(uint8_t** data, image_info_t& ii)
+bool print_goals(const std::vector<goal_coord_t>& goals, const char* const path, const image_info_t& ii, bool binary)
 {
-    /* Grayscale: 1 color-channel that means a multiplication with the number of channels is useless.
-    *                                               |  
-    *                                               \/  here
+    /* The image coordinates are represented as NTC (Normalized Texture Coordinates)
+    *  or NIC (Normalized Image Coordinates).
+    *  That means the coordinates are, undependend from the size of the image, clamped
+    *  to 0.0 and 1.0.
+    *  This is done with following equation: NTC = NIC = (pos in px) / (size in px)
     */
-    uint8_t* img_gray_data = new uint8_t[ii.width * ii.height]; // Allocating the new image buffer for the grayscale image.
-    image_info_t gray_ii{ii.width, ii.height, 1};               // And also declare a new image_info_t struct for it.
+    std::vector<ntc_coord_t> ntc_goals;
+    to_ntc(goals, ii, ntc_goals);
 
-    // 2-dimensional loop that iterates every pixel of the image.
-    int x, y;   // a optimization for speed
-    for(y = 0; y < ii.height; y++)
-    {
-        for(x = 0; x < ii.width; x++)
-        {
-            unsigned int sum = 0;
-            // Calculate the average value of all color components except the alpha channel if the image has one.
-            // The average value of the 3 colors (RGB) corresponds to the grayscale value.
-            for(int c = 0; c < ((ii.channels < 4) ? ii.channels : 3); c++)
-            {
-                sum += (*data)[img_at(x, y, ii) + c];
-            }
-            // Write the grayscale value to the new generated buffer.
-            img_gray_data[img_at(x, y, gray_ii)] = sum / ii.channels;
-        }
-    }
-    ii = gray_ii;               // update the image information
-    stbi_image_free(*data);     // free the old data
-    *data = img_gray_data;      // let the data-pointer point to the new data (grayscale image data)
+    // The binary goal file contains the exact values, the text file only 6 decimal places.
+    if(binary)
+        return write_goalfile(path, 0, ntc_goals);
+    return write_text_goals(path, ntc_goals);
 }
 
-void invert_image(uint8_t* data, image_info_t& ii)
+bool print_contour_goals(const std::vector<std::vector<goal_coord_t>>& goals, const char* const path, const image_info_t& ii)
 {
-    int x, y;
-    int index;
-    // 2-dimensional loop to iterate through the image
-    for(y = 0; y < ii.height; y++)
-    {
-        for(x = 0; x < ii.width; x++)
-        {
-            index = img_at(x, y, ii);           // get index
-            data[index] = 255 - data[index];    // invert operation
-        }
-    }
+    // One entry per path, a text file can only contain the goals of one vehicle.
+    std::map<int, std::vector<ntc_coord_t>> ntc_goals;
+    for(size_t i = 0; i < goals.size(); i++)
+        to_ntc(goals[i], ii, ntc_goals[(int)i]);
+    return write_goalfile(path, ntc_goals);
 }
 
-void gen_path(uint8_t* data, std::vector<img_coord_t>& path, const std::map<Path::PathMatrix*, Path::PathDirection>& m2d, const image_info_t& ii)
+int run_batch_mode(const int argc, const char* const * const argv, FILE* logfile, const char* const time_prefix)
 {
-    // If the image has no pixels, there is no need to generate a path.
-    if(ii.width == 0 || ii.height == 0)
-        return;
-
-    int bx = 0, by = 0;                         // Not only a optimization for speed, the variables are also used later in the code!!!
-    Path::PathMatrix begin_mat;                 // Matrix of the begin pixel.
-    const Path::PathDirection* dir = nullptr;   // Direction of the matrix initialized to 'nullptr'.
-
-    // Iterate through the pixels of the image.
-    // The loop breaks if the image was iterated through if no path was found or, which is more likely,
-    // the loop breaks at the first pixel that has a valid matrix.
-    for(by = 0; by < ii.height && dir == nullptr; by++)
+    if(argc < 4 || argc > 5 || (argc == 5 && strcmp(argv[4], "-log") != 0))
     {
-        for(bx = 0; bx < ii.width && dir == nullptr; bx++)
-        {
-            begin_mat = gen_pathmatrix(data, bx, by, ii);   // Generate matrix of current pixel.
-            dir = get_dirp(m2d, begin_mat);                 // Get the direction.    
-        }
+        printf("[ERROR] Invalid batch command, syntax: -batch <path to manifest file> <path to output file> [-log]\n");
+        return -1;
     }
-    
-    // Subtract 1 because the loop iterates through one time too much.
-    int x = --bx;
-    int y = --by;
-
-    // Current matrix.
-    // Initialize it to the begin matrix because this is the starting point.
-    Path::PathMatrix cur_mat = begin_mat;
-    do
+    const bool log = argc == 5;
+
+    std::vector<batch_job_t> jobs;
+    int error_line;
+    if(!read_manifest(argv[2], jobs, error_line))
+    {
+        if(error_line == 0)
+            printf("[ERROR] Could not open manifest file: \"%s\"\n", argv[2]);
+        else
+            printf("[ERROR] Invalid job or vehicle id used twice in line %d of: \"%s\"\n", error_line, argv[2]);
+        return -1;
+    }
+    if(log)
+        fprintf(logfile, "\n-----------------------------------------------\n%s [INFO] Batch: %zu jobs from %s...\n", time_prefix, jobs.size(), argv[2]);
+
+    // The images are read and thresholded band by band (see read_image_bitmap(...)).
+    std::vector<batch_result_t> results;
+    const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    const size_t failed = run_batch(jobs, [](const std::string& image, bool invert, PathBitmap& bitmap)
+    {
+        image_info_t ii;
+        return read_image_bitmap(image.c_str(), invert, bitmap, ii);
+    }, 0, results);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if(log)
     {
-        // Get the direction of the current matrix.
-        dir = get_dirp(m2d, cur_mat);
-        // Maybe the direction is invalid which means the pointer points to 'nullptr'.
-        if(dir != nullptr)
+        for(size_t i = 0; i < jobs.size(); i++)
         {
-            path.push_back({x, y});     // Push the current x and y value into the vector because this is a valid path-coordinate.
-            x += dir->direction_x();    // Add the direction to the x and y value which is returned by the direction_x() and direction_y() method.
-            y += dir->direction_y();
+            if(results[i].error != PATHGEN_NONE)
+                fprintf(logfile, "%s [ERROR] Job %zu (vehicle %d, %s): %s\n", time_prefix, i + 1, jobs[i].vehicle_id, jobs[i].image.c_str(), error_string(results[i].error));
         }
-        cur_mat = gen_pathmatrix(data, x, y, ii);   // Generate the next matrix out of the new x and y value.
-    } 
-    while(!(x == bx && y == by) && dir != nullptr); // Break if the begin matrix has been reached again or if the direction has become invalid.
+    }
+
+    std::map<int, std::vector<ntc_coord_t>> goals;
+    batch_goals(jobs, results, goals);
+    if(!write_goalfile(argv[3], goals))
+    {
+        if(log)
+            fprintf(logfile, "%s [ERROR] Failed to print goals to: %s\n", time_prefix, argv[3]);
+        return -5;
+    }
+    if(log)
+    {
+        fprintf(logfile, "%s [INFO] Batch: %zu of %zu jobs done, printed goals to: %s\n", time_prefix, jobs.size() - failed, jobs.size(), argv[3]);
+        fprintf(logfile, "%s [INFO] Batch time: %lfms (%.1lf jobs/s)\n", time_prefix, seconds * 1000.0, (seconds > 0.0) ? jobs.size() / seconds : 0.0);
+    }
+    return (failed > 0) ? -6 : 0;
 }
 
-bool gen_goals(const std::vector<img_coord_t>& path, std::vector<goal_coord_t>& goals, unsigned int num_goals)
+int run_drawing_mode(const char* const * const argv, unsigned int num_goals, path_flag_t flags, FILE* logfile, const char* const time_prefix)
 {
-    // Invalid number of goals:
-    //  If the number of goals is to big or if 'path' does not contain any coordinates.
-    if(num_goals > path.size() || path.size() == 0)
-        return false;
-
-    // Calculate the width between the goals.
-    float g2g_width = (float)path.size() / (float)num_goals;
-    // Split the path into a certain number of goals.
-    for(float i = 0; i < path.size(); i += g2g_width)
+    /* READ DRAWING */
+    if(should_log(flags))
+        fprintf(logfile, "%s [INFO] Reading drawing: %s...\n", time_prefix, argv[1]);
+    std::chrono::time_point t0 = std::chrono::steady_clock::now();
+    const std::chrono::time_point t0_exec = t0;
+    drawing_t drawing;
+    if(!read_drawing_file(argv[1], drawing))
     {
-        goals.push_back(path.at((size_t)i));
+        if(should_log(flags))
+            fprintf(logfile, "%s [ERROR] Failed to read drawing: %s\n", time_prefix, argv[1]);
+        return -2;
     }
-    // Because the vehicle should drive back to the begin whre it started,
-    // the first goal has to be pushed at the end of the goal-vector.
-    // Only if the vector contains at least one element.
-    if(goals.size() > 0)
-        goals.push_back(goals.at(0));
+    const std::chrono::microseconds t_read = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
+    if(should_log(flags))
+        fprintf(logfile, "%s [INFO] Successfully loaded drawing with %zu polylines: %s\n", time_prefix, drawing.polylines.size(), argv[1]);
 
-    return true;
-}
+    /* GENERATE GOALS */
+    // The goals are already normalized to the canvas of the drawing.
+    std::vector<ntc_coord_t> goals;
+    t0 = std::chrono::steady_clock::now();
+    if(!gen_drawing_goals(drawing, num_goals, goals))
+    {
+        if(should_log(flags))
+            fprintf(logfile, "%s [ERROR] Failed to generate goals: no goals given or the polylines have no length.\n", time_prefix);
+        return -4;
+    }
+    const std::chrono::microseconds t_goals = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
 
-bool print_goals(const std::vector<goal_coord_t>& goals, const char* const path, const image_info_t& ii)
-{
-    FILE* file = fopen(path, "w");
-    if(file == nullptr)
-        return false;
+    /* PRINT GOALS TO FILE */
+    t0 = std::chrono::steady_clock::now();
+    if(!(should_write_binary(flags) ? write_goalfile(argv[2], 0, goals) : write_text_goals(argv[2], goals)))
+    {
+        if(should_log(flags))
+            fprintf(logfile, "%s [ERROR] Failed to print goals.\n", time_prefix);
+        return -5;
+    }
+    const std::chrono::microseconds t_print = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
+    const std::chrono::microseconds t_exec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0_exec);
 
-    /* Iterate through every goal and write the position (x, y) to the file.
-    *  The image coordinates are represented as NTC (Normalized Texture Coordinates)
-    *  or NIC (Normalized Image Coordinates).
-    *  That means the coordinates are, undependend from the size of the image, clamped
-    *  to 0.0 and 1.0.
-    *  This is done with following equation: NTC = NIC = (pos in px) / (size in px)
-    */
-    float ntc_x, ntc_y;
-    for(const goal_coord_t& pos : goals)
+    if(should_log(flags))
     {
-        ntc_x = (float)pos.x / (float)ii.width;
-        ntc_y = (float)pos.y / (float)ii.height;
-        fprintf(file, "%f %f\n", ntc_x, ntc_y);
+        fprintf(logfile, "%s [INFO] Successfully printed goals to: %s\n", time_prefix, argv[2]);
+        fprintf(logfile, "\n");
+        fprintf(logfile, "%s [INFO] Reading drawing time: %lfms\n", time_prefix, t_read.count() / 1000.0);
+        fprintf(logfile, "%s [INFO] Generating goals time: %lfms\n", time_prefix, t_goals.count() / 1000.0);
+        fprintf(logfile, "%s [INFO] Printing goals time: %lfms\n", time_prefix, t_print.count() / 1000.0);
+        fprintf(logfile, "%s [INFO] Execution time: %lfms\n", time_prefix, t_exec.count() / 1000.0);
     }
-    
-    fclose(file);
-    return true;
+    return 0;
 }
 
 // ITS SHOWTIME
@@ -606,6 +522,12 @@ int main(const int argc, const char* const * const argv)
     }
 
     /* DECODE INPUT COMMAND */
+    if(argc >= 2 && strcmp(argv[1], "-batch") == 0)
+    {
+        const int ret = run_batch_mode(argc, argv, logfile, time_prefix);
+        fclose(logfile);
+        return ret;
+    }
     if(argc < ARG_MIN_LENGTH)
     {
         printf("[ERROR] Too few arguments given, required at lest 3.\n");
@@ -613,6 +535,7 @@ int main(const int argc, const char* const * const argv)
     }
 
     path_flag_t flags = path_flag_type::PATH_NONE;
+    goal_settings_t goal_settings;  // Uniform goals, unless -adaptive is given.
     // Iterate through every argument that will be a flag.
     for(int i = ARG_MIN_LENGTH; i < argc; i++)
     {
@@ -623,6 +546,26 @@ int main(const int argc, const char* const * const argv)
             flags |= path_flag_type::PATH_LOG;
         else if(strcmp(argv[i], "-invert") == 0)
             flags |= path_flag_type::PATH_INVERT;
+        else if(strcmp(argv[i], "-binary") == 0)
+            flags |= path_flag_type::PATH_BINARY;
+        else if(strcmp(argv[i], "-qoi") == 0)
+            flags |= path_flag_type::PATH_QOI;
+        else if(strcmp(argv[i], "-pnm") == 0)
+            flags |= path_flag_type::PATH_PNM;
+        else if(strcmp(argv[i], "-contours") == 0)
+            flags |= path_flag_type::PATH_CONTOURS;
+        else if(strcmp(argv[i], "-adaptive") == 0)
+        {
+            // The next argument is the maximum deviation in pixels.
+            char* end = nullptr;
+            if(i + 1 < argc)
+                goal_settings.max_deviation = strtof(argv[++i], &end);
+            if(end == nullptr || *end != '\0' || !(goal_settings.max_deviation > 0.0f))
+            {
+                printf("[ERROR] \"-adaptive\" needs a maximum deviation in pixels greater than 0.\n");
+                return -1;
+            }
+        }
         else
         {
             printf("[ERROR] Invalid flag: \"%s\"\n", argv[i]);
@@ -639,32 +582,58 @@ int main(const int argc, const char* const * const argv)
     }
     unsigned int num_goals;
     sscanf(argv[3], "%u", &num_goals);  // Conver the 3rd argument to a number (unsigned int).
+    goal_settings.num_goals = num_goals;
 
     if(should_log(flags))
         fprintf(logfile, "\n-----------------------------------------------\n");
 
+    /* VECTOR DRAWING */
+    // A drawing has no pixels, the rest of the pipeline (and the debug images) is not needed.
+    if(is_drawing_file(argv[1]))
+    {
+        const int ret = run_drawing_mode(argv, num_goals, flags, logfile, time_prefix);
+        fclose(logfile);
+        return ret;
+    }
+
     /* CREATE DEBUG IMAGE FILEPATHs */
+    const char* debug_ext;
+    const image_encoder_t debug_encoder = debug_image_format(flags, debug_ext);
     char OUT_GRAYSCALE_PATH[256], OUT_INVERTED_PATH[256], OUT_PATHIMG_PATH[256], OUT_GOALSIMG_PATH[256];
-    sprintf(OUT_GRAYSCALE_PATH, "%s/%s-%s_grayscale.png", DEBUG_IMAGE_DIR, date_str, time_str);
-    sprintf(OUT_INVERTED_PATH, "%s/%s-%s_inverted.png", DEBUG_IMAGE_DIR, date_str, time_str);
-    sprintf(OUT_PATHIMG_PATH, "%s/%s-%s_path.png", DEBUG_IMAGE_DIR, date_str, time_str);
-    sprintf(OUT_GOALSIMG_PATH, "%s/%s-%s_goals.png", DEBUG_IMAGE_DIR, date_str, time_str);
+    sprintf(OUT_GRAYSCALE_PATH, "%s/%s-%s_grayscale.%s", DEBUG_IMAGE_DIR, date_str, time_str, debug_ext);
+    sprintf(OUT_INVERTED_PATH, "%s/%s-%s_inverted.%s", DEBUG_IMAGE_DIR, date_str, time_str, debug_ext);
+    sprintf(OUT_PATHIMG_PATH, "%s/%s-%s_path.%s", DEBUG_IMAGE_DIR, date_str, time_str, debug_ext);
+    sprintf(OUT_GOALSIMG_PATH, "%s/%s-%s_goals.%s", DEBUG_IMAGE_DIR, date_str, time_str, debug_ext);
+
+    // The debug images are encoded by a background thread, the writer gets a copy of the image because the image is changed
+    // afterwards (e.g. inverted). If the program ends (also with an error), the writer waits until every image is written.
+    std::unique_ptr<DebugImageWriter> debug_writer(should_print_img(flags) ? new DebugImageWriter() : nullptr);
+    auto write_debug_image = [&](const char* const path, const uint8_t* data, const image_info_t& ii)
+    {
+        debug_writer->write(path, std::vector<uint8_t>(data, data + (size_t)ii.width * ii.height * ii.channels), ii, debug_encoder);
+    };
 
     // Values for time measurement.
-    std::chrono::microseconds t_read, t_convert, t_path, t_goals, t_print, t_exec;
+    std::chrono::microseconds t_read, t_convert, t_path, t_goals, t_print, t_exec, t_debug(0);
     // Makte timepoints.
     std::chrono::time_point t0      = std::chrono::steady_clock::now();
     std::chrono::time_point t0_exec = std::chrono::steady_clock::now();
     // Declare image info.
     image_info_t img_info;
 
+    // Without debug images the image is read, converted, inverted and thresholded band by band (see read_image_bitmap(...)),
+    // the grayscale image is never in memory as a whole. Otherwise the grayscale image is needed for the debug images.
+    const bool fused = !should_print_img(flags);
+    PathBitmap bitmap;
+    uint8_t* data = nullptr;
+
     /* READ IMAGE */
     if(should_log(flags))
         fprintf(logfile, "%s [INFO] Reading image: %s...\n", time_prefix, argv[1]);
     t0 = std::chrono::steady_clock::now(); // Get current time.
-    uint8_t* data = read_image(argv[1], img_info);  // Read image.
+    const bool read = fused ? read_image_bitmap(argv[1], should_invert(flags), bitmap, img_info) : (data = read_image(argv[1], img_info)) != NULL;  // Read image.
     t_read = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0); // Save the time difference.
-    if(data == NULL)
+    if(!read)
     {
         // Exiting with -2 if loading image has failed (file not found).
         if(should_log(flags))
@@ -675,56 +644,79 @@ int main(const int argc, const char* const * const argv)
         fprintf(logfile, "%s [INFO] Successfully loaded image: %s\n", time_prefix, argv[1]);
 
     /* CONVERT TO GRAYSCALE */
-    if(should_log(flags))
-        fprintf(logfile, "%s [INFO] Converting to grayscale...\n", time_prefix);
-    t0 = std::chrono::steady_clock::now(); // Get current time
-    to_grayscale(&data, img_info);                  // Convert to grayscale.
-    t_convert = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0); // Save the time difference.
-    if(data == NULL)
+    // The thresholded image is already converted.
+    t_convert = std::chrono::microseconds(0);
+    if(!fused)
     {
-        // Exit with -3 if converting to grayscale has failed.
         if(should_log(flags))
-            fprintf(logfile, "%s [ERROR] Failed to convert to grayscale.\n", time_prefix);
-        return -3;
-    }
-    // If debug is enabled, write the grayscale image.
-    if(should_print_img(flags))
-        write_image(data, OUT_GRAYSCALE_PATH, img_info);
-    if(should_log(flags))
-        fprintf(logfile, "%s [INFO] Successfully converted to grayscale.\n", time_prefix);
-
-    /* INVERT IMAGE */
-    if(should_invert(flags))
-    {
-        if(should_log(flags))
-            fprintf(logfile, "%s [INFO] Invert image...\n", time_prefix);
-        invert_image(data, img_info);   // Invert the image
+            fprintf(logfile, "%s [INFO] Converting to grayscale...\n", time_prefix);
+        t0 = std::chrono::steady_clock::now(); // Get current time
+        uint8_t* gray_data = to_grayscale(data, img_info);  // Convert to grayscale.
+        free_image(data);                               // Free the data of the original image.
+        data = gray_data;                               // Continue with the grayscale image.
+        t_convert = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0); // Save the time difference.
+        if(data == NULL)
+        {
+            // Exit with -3 if converting to grayscale has failed.
+            if(should_log(flags))
+                fprintf(logfile, "%s [ERROR] Failed to convert to grayscale.\n", time_prefix);
+            return -3;
+        }
+        // If debug is enabled, write the grayscale image.
         if(should_print_img(flags))
-            write_image(data, OUT_INVERTED_PATH, img_info);
+            write_debug_image(OUT_GRAYSCALE_PATH, data, img_info);
         if(should_log(flags))
-            fprintf(logfile, "%s [INFO] Successfully inverted the image.\n", time_prefix);
+            fprintf(logfile, "%s [INFO] Successfully converted to grayscale.\n", time_prefix);
+
+        /* INVERT IMAGE */
+        if(should_invert(flags))
+        {
+            if(should_log(flags))
+                fprintf(logfile, "%s [INFO] Invert image...\n", time_prefix);
+            invert_image(data, img_info);   // Invert the image
+            if(should_print_img(flags))
+                write_debug_image(OUT_INVERTED_PATH, data, img_info);
+            if(should_log(flags))
+                fprintf(logfile, "%s [INFO] Successfully inverted the image.\n", time_prefix);
+        }
     }
 
     /* GENERATE PATH */
-    std::map<Path::PathMatrix*, Path::PathDirection> mat2dir;
     std::vector<img_coord_t> path_pixels;
+    std::vector<contour_t> contours;    // Every path of the image, only with -contours.
 
-    // Read all the valid matrices and their directions.
-    Path::setup(mat2dir);
     if(should_log(flags))
         fprintf(logfile, "%s [INFO] Generating path...\n", time_prefix);
     t0 = std::chrono::steady_clock::now(); // Get current time.
-    gen_path(data, path_pixels, mat2dir, img_info); // Generate path.
+    if(should_extract_contours(flags))
+    {
+        if(!fused)
+            bitmap.binarize(data, img_info, PATH_THRESHOLD);  // The grayscale image is already inverted.
+        gen_contours(bitmap, contours, 0);  // Generate every path, one thread per core.
+    }
+    else if(fused)
+        gen_path(bitmap, path_pixels);      // Generate path of the thresholded image.
+    else
+        gen_path(data, path_pixels, img_info);  // Generate path.
     t_path = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0); // Save the time difference.
     if(should_log(flags))
-        fprintf(logfile, "%s [INFO] Generated path.\n", time_prefix);
+    {
+        if(should_extract_contours(flags))
+            fprintf(logfile, "%s [INFO] Generated %zu paths.\n", time_prefix, contours.size());
+        else
+            fprintf(logfile, "%s [INFO] Generated path.\n", time_prefix);
+    }
 
     /* GENERATE GOALS */
     std::vector<goal_coord_t> goals;
+    std::vector<std::vector<goal_coord_t>> contour_goals;   // The goals of every path, only with -contours.
+    size_t left_out = 0;
     if(should_log(flags))
         fprintf(logfile, "%s [INFO] Generating goals...\n", time_prefix);
     t0 = std::chrono::steady_clock::now(); // Get current time.
-    if(!gen_goals(path_pixels, goals, num_goals))   // Generate goals.
+    if(should_extract_contours(flags))
+        left_out = gen_contour_goals(contours, goal_settings, contour_goals);  // Generate goals of every path.
+    if(should_extract_contours(flags) ? contour_goals.empty() : !gen_goals(path_pixels, goals, goal_settings))   // Generate goals.
     {
         // Exit with -4 if goal generation has failed.
         if(should_log(flags))
@@ -733,7 +725,11 @@ int main(const int argc, const char* const * const argv)
     }
     t_goals = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0); // Save the time difference.
     if(should_log(flags))
+    {
         fprintf(logfile, "%s [INFO] Generated goals.\n", time_prefix);
+        if(left_out > 0)
+            fprintf(logfile, "%s [INFO] Left out %zu paths with less pixels than goals.\n", time_prefix, left_out);
+    }
 
     // If debug is enabled, write the image where the path is shown and the image where the goals are shown.
     if(should_print_img(flags))
@@ -742,20 +738,32 @@ int main(const int argc, const char* const * const argv)
         {
             data[img_at(pos.x, pos.y, img_info)] = 255;
         }
-        write_image(data, OUT_GOALSIMG_PATH, img_info);
+        for(const std::vector<goal_coord_t>& path_goals : contour_goals)
+        {
+            for(const goal_coord_t& pos : path_goals)
+                data[img_at(pos.x, pos.y, img_info)] = 255;
+        }
+        write_debug_image(OUT_GOALSIMG_PATH, data, img_info);
 
         for(const img_coord_t& pos : path_pixels)
         {
             data[img_at(pos.x, pos.y, img_info)] = 255;
         }
-        write_image(data, OUT_PATHIMG_PATH, img_info);
+        for(const contour_t& contour : contours)
+        {
+            for(const img_coord_t& pos : contour.path)
+                data[img_at(pos.x, pos.y, img_info)] = 255;
+        }
+        write_debug_image(OUT_PATHIMG_PATH, data, img_info);
     }
 
     /* PRINT GOALS TO FILE */
     if(should_log(flags))
         fprintf(logfile, "%s [INFO] Printing goals to: %s...\n", time_prefix, argv[2]);
     t0 = std::chrono::steady_clock::now(); // Get current time.
-    if(!print_goals(goals, argv[2], img_info))      // Print goals.
+    const bool printed = should_extract_contours(flags) ? print_contour_goals(contour_goals, argv[2], img_info)
+                                                        : print_goals(goals, argv[2], img_info, should_write_binary(flags));  // Print goals.
+    if(!printed)
     {
         // Exit with -5 if printing goals has failed.
         if(should_log(flags))
@@ -766,8 +774,17 @@ int main(const int argc, const char* const * const argv)
     if(should_log(flags))
         fprintf(logfile, "%s [INFO] Successfully printed goals to: %s\n", time_prefix, argv[2]);
 
-    stbi_image_free(data);  // Free the data of the image.
-    Path::cleanup(mat2dir); // Cleanup the map for the matrices.
+    delete[](data);         // Free the data of the (grayscale) image.
+
+    /* WAIT FOR DEBUG IMAGES */
+    // Only the part of the encoding that has not overlapped with the pipeline is waited for.
+    size_t failed_images = 0;
+    if(debug_writer != nullptr)
+    {
+        t0 = std::chrono::steady_clock::now(); // Get current time.
+        failed_images = debug_writer->finish();
+        t_debug = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0); // Save the time difference.
+    }
     t_exec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0_exec); // Get execution time.
     
     // If program is not silent, print debug messages.
@@ -779,6 +796,10 @@ int main(const int argc, const char* const * const argv)
         fprintf(logfile, "%s [INFO] Gnerating path time: %lfms\n", time_prefix, t_path.count() / 1000.0);
         fprintf(logfile, "%s [INFO] Generating goals time: %lfms\n", time_prefix, t_goals.count() / 1000.0);
         fprintf(logfile, "%s [INFO] Printing goals time: %lfms\n", time_prefix, t_print.count() / 1000.0);
+        if(debug_writer != nullptr)
+            fprintf(logfile, "%s [INFO] Waiting for debug images time: %lfms\n", time_prefix, t_debug.count() / 1000.0);
+        if(failed_images > 0)
+            fprintf(logfile, "%s [ERROR] Failed to write %zu debug images.\n", time_prefix, failed_images);
         fprintf(logfile, "%s [INFO] Execution time: %lfms\n", time_prefix, t_exec.count() / 1000.0);
     }
     fclose(logfile);
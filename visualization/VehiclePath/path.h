@@ -1,6 +1,8 @@
 #ifndef __path_h__
 #define __path_h__
 
+#include <cstdint>
+#include <cstddef>
 #include <map>
 
 namespace Path
@@ -180,6 +182,64 @@ namespace Path
         }
     };
 
+    /*
+    *   Struct: PathPattern
+    *   One valid path matrix and its direction.
+    *   The 9 values of the matrix are in the same order as the parameters of the PathMatrix constructor.
+    */
+    struct PathPattern
+    {
+        bool mat[9];
+        int dir_x, dir_y;
+    };
+
+    /*
+    *   All matrices that are valid for the path and their directions.
+    *   This is the only place where the patterns are defined, the matrix-to-direction-map (setup)
+    *   and the direction table (DIRECTION_TABLE) are both generated from this list.
+    */
+    constexpr PathPattern PATTERNS[] =
+    {
+        {{0,0,0, 0,1,1, 0,1,1}, 1, 0},
+        {{0,0,1, 0,1,1, 0,1,1}, 1, 0},
+        {{1,1,1, 0,1,1, 0,1,1}, 1, 0},
+        {{0,1,1, 0,1,1, 0,1,1}, 1, 0},
+        {{0,1,1, 0,1,1, 0,0,1}, 1, 1},
+        {{1,1,1, 0,1,1, 0,0,1}, 1, 1},
+        {{1,1,1, 1,1,1, 0,0,1}, 1, 1},
+        {{0,1,1, 0,1,1, 0,0,0}, 0, 1},
+        {{1,1,1, 0,1,1, 0,0,0}, 0, 1},
+        {{1,1,1, 1,1,1, 1,0,0}, 0, 1},
+        {{1,1,1, 1,1,1, 0,0,0}, 0, 1},
+        {{1,1,1, 1,1,0, 0,0,0}, -1, 1},
+        {{1,1,1, 1,1,0, 1,0,0}, -1, 1},
+        {{1,1,1, 1,1,0, 1,1,0}, -1, 1},
+        {{1,1,0, 1,1,0, 0,0,0}, -1, 0},
+        {{1,1,0, 1,1,0, 1,0,0}, -1, 0},
+        {{1,1,0, 1,1,0, 1,1,1}, -1, 0},
+        {{1,1,0, 1,1,0, 1,1,0}, -1, 0},
+        {{1,0,0, 1,1,0, 1,1,0}, -1, -1},
+        {{1,0,0, 1,1,0, 1,1,1}, -1, -1},
+        {{1,0,0, 1,1,1, 1,1,1}, -1, -1},
+        {{0,0,0, 1,1,0, 1,1,0}, 0, -1},
+        {{0,0,1, 1,1,1, 1,1,1}, 0, -1},
+        {{0,0,0, 1,1,0, 1,1,1}, 0, -1},
+        {{0,0,0, 1,1,1, 1,1,1}, 0, -1},
+        {{0,0,0, 0,1,1, 1,1,1}, 1, -1},
+        {{0,0,1, 0,1,1, 1,1,1}, 1, -1},
+        {{0,1,1, 0,1,1, 1,1,1}, 1, -1},
+
+        {{0,0,1, 0,1,1, 0,0,1}, 1, 1},
+        {{1,1,1, 0,1,0, 0,0,0}, -1, 1},
+        {{1,0,0, 1,1,0, 1,0,0}, -1, -1},
+        {{0,0,0, 0,1,0, 1,1,1}, 1, -1},
+
+        {{1,1,1, 0,1,1, 1,1,1}, 1, -1},
+        {{1,1,1, 1,1,1, 1,0,1}, 1, 1},
+        {{1,1,1, 1,1,0, 1,1,1}, -1, 1},
+        {{1,0,1, 1,1,1, 1,1,1}, -1, -1}
+    };
+
     /*
     *   Initializes a matrix-to-direction-map with all possible
     *   matrices that are valid for the path and saves the
@@ -188,91 +248,106 @@ namespace Path
     *       std::map<PathMatrix*, PathDirection>& mat2dir -> Matrix-to-direction-map where the data should be saved to.
     */
 
-    void setup(std::map<PathMatrix*, PathDirection>& m2d)
+    inline void setup(std::map<PathMatrix*, PathDirection>& m2d)
     {
-        PathMatrix* p = new PathMatrix(0,0,0, 0,1,1, 0,1,1);
-        m2d[p] = PathDirection(1, 0);
-        p = new PathMatrix(0,0,1, 0,1,1, 0,1,1);
-        m2d[p] = PathDirection(1, 0);
-        p = new PathMatrix(1,1,1, 0,1,1, 0,1,1);
-        m2d[p] = PathDirection(1, 0);
-        p = new PathMatrix(0,1,1, 0,1,1, 0,1,1);
-        m2d[p] = PathDirection(1, 0);
-        p = new PathMatrix(0,1,1, 0,1,1, 0,0,1);
-        m2d[p] = PathDirection(1, 1);
-        p = new PathMatrix(1,1,1, 0,1,1, 0,0,1);
-        m2d[p] = PathDirection(1, 1);
-        p = new PathMatrix(1,1,1, 1,1,1, 0,0,1);
-        m2d[p] = PathDirection(1, 1);
-        p = new PathMatrix(0,1,1, 0,1,1, 0,0,0);
-        m2d[p] = PathDirection(0, 1);
-        p = new PathMatrix(1,1,1, 0,1,1, 0,0,0);
-        m2d[p] = PathDirection(0, 1);
-        p = new PathMatrix(1,1,1, 1,1,1, 1,0,0);
-        m2d[p] = PathDirection(0, 1);
-        p = new PathMatrix(1,1,1, 1,1,1, 0,0,0);
-        m2d[p] = PathDirection(0, 1);
-        p = new PathMatrix(1,1,1, 1,1,0, 0,0,0);
-        m2d[p] = PathDirection(-1, 1);
-        p = new PathMatrix(1,1,1, 1,1,0, 1,0,0);
-        m2d[p] = PathDirection(-1, 1);
-        p = new PathMatrix(1,1,1, 1,1,0, 1,1,0);
-        m2d[p] = PathDirection(-1, 1);
-        p = new PathMatrix(1,1,0, 1,1,0, 0,0,0);
-        m2d[p] = PathDirection(-1, 0);
-        p = new PathMatrix(1,1,0, 1,1,0, 1,0,0);
-        m2d[p] = PathDirection(-1, 0);
-        p = new PathMatrix(1,1,0, 1,1,0, 1,1,1);
-        m2d[p] = PathDirection(-1, 0);
-        p = new PathMatrix(1,1,0, 1,1,0, 1,1,0);
-        m2d[p] = PathDirection(-1, 0);
-        p = new PathMatrix(1,0,0, 1,1,0, 1,1,0);
-        m2d[p] = PathDirection(-1, -1);
-        p = new PathMatrix(1,0,0, 1,1,0, 1,1,1);
-        m2d[p] = PathDirection(-1, -1);
-        p = new PathMatrix(1,0,0, 1,1,1, 1,1,1);
-        m2d[p] = PathDirection(-1, -1);
-        p = new PathMatrix(0,0,0, 1,1,0, 1,1,0);
-        m2d[p] = PathDirection(0, -1);
-        p = new PathMatrix(0,0,1, 1,1,1, 1,1,1);
-        m2d[p] = PathDirection(0, -1);
-        p = new PathMatrix(0,0,0, 1,1,0, 1,1,1);
-        m2d[p] = PathDirection(0, -1);
-        p = new PathMatrix(0,0,0, 1,1,1, 1,1,1);
-        m2d[p] = PathDirection(0, -1);
-        p = new PathMatrix(0,0,0, 0,1,1, 1,1,1);
-        m2d[p] = PathDirection(1, -1);
-        p = new PathMatrix(0,0,1, 0,1,1, 1,1,1);
-        m2d[p] = PathDirection(1, -1);
-        p = new PathMatrix(0,1,1, 0,1,1, 1,1,1);
-        m2d[p] = PathDirection(1, -1);
-
-        p = new PathMatrix(0,0,1, 0,1,1, 0,0,1);
-        m2d[p] = PathDirection(1, 1);
-        p = new PathMatrix(1,1,1, 0,1,0, 0,0,0);
-        m2d[p] = PathDirection(-1, 1);
-        p = new PathMatrix(1,0,0, 1,1,0, 1,0,0);
-        m2d[p] = PathDirection(-1, -1);
-        p = new PathMatrix(0,0,0, 0,1,0, 1,1,1);
-        m2d[p] = PathDirection(1, -1);
-
-        p = new PathMatrix(1,1,1, 0,1,1, 1,1,1);
-        m2d[p] = PathDirection(1, -1);
-        p = new PathMatrix(1,1,1, 1,1,1, 1,0,1);
-        m2d[p] = PathDirection(1, 1);
-        p = new PathMatrix(1,1,1, 1,1,0, 1,1,1);
-        m2d[p] = PathDirection(-1, 1);
-        p = new PathMatrix(1,0,1, 1,1,1, 1,1,1);
-        m2d[p] = PathDirection(-1, -1);
+        for(const PathPattern& pat : PATTERNS)
+        {
+            PathMatrix* p = new PathMatrix(pat.mat[0], pat.mat[1], pat.mat[2], pat.mat[3], pat.mat[4], pat.mat[5], pat.mat[6], pat.mat[7], pat.mat[8]);
+            m2d[p] = PathDirection(pat.dir_x, pat.dir_y);
+        }
     }
 
+    /*
+    *   Packs a 3x3 matrix into a bitmask (9 bits).
+    *   The bits are in the order of the image rows: the bit (3 * (y + 1) + (x + 1)) is the neighbour at (x, y)
+    *   relative to the center pixel, so every row of the neighborhood are 3 adjacent bits.
+    *   The i-th value of the PathMatrix constructor is the neighbour (i / 3 - 1, i % 3 - 1).
+    *   Parameters:
+    *       const bool* mat -> The 9 values of the matrix in the order of the PathMatrix constructor.
+    *   Return:
+    *       The bitmask, 0 to 511.
+    */
+    constexpr uint16_t pattern_mask(const bool* mat)
+    {
+        uint16_t mask = 0;
+        for(int i = 0; i < 9; i++)
+        {
+            if(mat[i])
+                mask |= (uint16_t)(1 << (3 * (i % 3) + i / 3));
+        }
+        return mask;
+    }
+
+    /*
+    *   Struct: PathStep
+    *   Entry of the direction table: the direction of one neighborhood, valid is 'false'
+    *   if the neighborhood is not part of the path (no pattern matches).
+    */
+    struct PathStep
+    {
+        int8_t dir_x{0}, dir_y{0};
+        bool valid{false};
+    };
+
+    constexpr size_t NUM_NEIGHBORHOODS = 512;   // every possible 3x3 matrix
+
+    struct DirectionTable
+    {
+        PathStep step[NUM_NEIGHBORHOODS];
+    };
+
+    /*
+    *   Generates the direction table at compile time out of PATTERNS.
+    *   Every pattern is unique (see below), so the table gives the same direction
+    *   as searching the matrix in the matrix-to-direction-map.
+    */
+    constexpr DirectionTable gen_direction_table(void)
+    {
+        DirectionTable table{};
+        for(const PathPattern& pat : PATTERNS)
+        {
+            PathStep& step = table.step[pattern_mask(pat.mat)];
+            step.dir_x = (int8_t)pat.dir_x;
+            step.dir_y = (int8_t)pat.dir_y;
+            step.valid = true;
+        }
+        return table;
+    }
+
+    /*
+    *   Return: true if no pattern is in the list twice, every pattern contains the center pixel and
+    *           every direction points to a path pixel (so the trace never leaves the image).
+    */
+    constexpr bool patterns_valid(void)
+    {
+        constexpr size_t n = sizeof(PATTERNS) / sizeof(PATTERNS[0]);
+        for(size_t i = 0; i < n; i++)
+        {
+            if(!PATTERNS[i].mat[4] || !PATTERNS[i].mat[3 * (PATTERNS[i].dir_x + 1) + (PATTERNS[i].dir_y + 1)])
+                return false;
+            for(size_t j = i + 1; j < n; j++)
+            {
+                if(pattern_mask(PATTERNS[i].mat) == pattern_mask(PATTERNS[j].mat))
+                    return false;
+            }
+        }
+        return true;
+    }
+    static_assert(patterns_valid(), "The path patterns have to be unique, contain the center pixel and point to a path pixel.");
+
+    /*
+    *   Direction of every neighborhood, indexed by the bitmask of the 3x3 matrix (pattern_mask).
+    *   A lookup replaces the search in the matrix-to-direction-map.
+    */
+    constexpr DirectionTable DIRECTION_TABLE = gen_direction_table();
+
     /*
     *   Cleanes up the matrix: deletes dynamic memory.
     *   Parameters:
     *       std::map<PathMatrix*, PathDirection> mat2dir -> The map that should be cleaned up.
     */
 
-    void cleanup(const std::map<PathMatrix*, PathDirection>& m2d)
+    inline void cleanup(const std::map<PathMatrix*, PathDirection>& m2d)
     {
         for(auto iter = m2d.begin(); iter != m2d.end(); iter++)
         {
@@ -0,0 +1,613 @@
+#include "pathgen.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PATHGEN_SSE2
+    #include <emmintrin.h>
+#endif
+#if defined(PATHGEN_SSE2) && (defined(__SSSE3__) || defined(__AVX__))
+    #define PATHGEN_SSSE3
+    #include <tmmintrin.h>
+#endif
+
+using namespace Path;
+
+/*
+*   Note: The functions are not described twice.
+*         Only the prototypes of all those functions are described via a header.
+*/
+
+size_t Path::img_at(size_t x, size_t y, const image_info_t& ii)
+{
+    /*
+    *   Example data with 3*3 pixels and 4 channels for each pixel (RGBA format).
+    *   The data is stored in a 1-dimensional array.
+    *   To get the index of a simple X-Y gid there is the following equation:
+    *       index = Y * (number of elements in X-direction) + X
+    *
+    *                   X ... (n pixels) * (n channels) -> elements in X
+    *   ---------------------------------->
+    *   R1 G1 B1 A1 R2 G2 B2 A2 R3 G3 B3 A3 |
+    *   R4 G4 B4 A4 R5 G5 B5 A5 R6 R6 R6 A6 |   Y
+    *   R7 G7 B7 A7 R8 G8 B8 A8 R9 G9 B9 A9 \/
+    *
+    *   Resulting equation: Y * (n pixels in X) * (n channels) + X * (n channels)
+    *   To get the index of the pixel 5 ('R5') the formula is like this:
+    *       1 * 3 * 4 + 1 * 4 = 16 -> which is correct
+    *   Note that the indices start at 0 and NOT at 1!
+    */
+    return y * ii.width * ii.channels + x * ii.channels;
+}
+
+const PathDirection* Path::get_dirp(const std::map<PathMatrix*, PathDirection>& m2d, const PathMatrix& mat)
+{
+    // Gothrough every element of the map.
+    for(auto iter = m2d.begin(); iter != m2d.end(); iter++)
+    {
+        // If there was found a matching element in the map, return a pointer to the second element
+        // of the pair which is the direction.
+        if(*iter->first == mat)
+            return &iter->second;
+    }
+    // If there was found nothing return 'nullptr'.
+    return nullptr;
+}
+
+bool Path::is_path(uint8_t value, uint8_t threshold)
+{
+    // Self-explaining, otherwise see the description at the prorotypes.
+    return(value < threshold) ? false : true;
+}
+
+PathMatrix Path::gen_pathmatrix(const uint8_t* data, int cx, int cy, const image_info_t& ii)
+{
+    PathMatrix mat;
+    // 2-dimensional loop for a 3*3 matrix
+    int x, y;   // a optimization for speed
+    for(y = cy - 1; y <= cy + 1; y++)
+    {
+        for(x = cx - 1; x <= cx + 1; x++)
+        {
+            // If the x or y would be outside of the image set the value in the matrix to 'false'.
+            // If the pixel is part of the path set the value in the matrix to 'true' (comes from is_path(...)).
+            // If the pixel is part of the background set the value in the matrix to 'false' (comes from is_path(...)).
+            mat.at(y + 1 - cy, x + 1 - cx) = (y < 0 || x < 0 || y >= ii.height || x >= ii.width) ? false : is_path(data[img_at(x, y, ii)], PATH_THRESHOLD);
+        }
+    }
+    return mat;
+}
+
+uint16_t Path::gen_pathmask(const uint8_t* data, int cx, int cy, const image_info_t& ii)
+{
+    uint16_t mask = 0;
+    int x, y;
+    if(cx > 0 && cy > 0 && cx < ii.width - 1 && cy < ii.height - 1)
+    {
+        // Inner pixel: no neighbour is outside of the image, so the bounds don't have to be checked.
+        const uint8_t* center = data + img_at(cx, cy, ii);
+        const ptrdiff_t step_x = ii.channels, step_y = (ptrdiff_t)ii.width * ii.channels;
+        for(x = -1; x <= 1; x++)
+        {
+            for(y = -1; y <= 1; y++)
+            {
+                if(is_path(center[x * step_x + y * step_y], PATH_THRESHOLD))
+                    mask |= (uint16_t)(1 << (3 * (y + 1) + (x + 1)));
+            }
+        }
+        return mask;
+    }
+
+    // Edge or corner: the pixels outside of the image are 'false', like in gen_pathmatrix(...).
+    for(x = cx - 1; x <= cx + 1; x++)
+    {
+        for(y = cy - 1; y <= cy + 1; y++)
+        {
+            if(y >= 0 && x >= 0 && y < ii.height && x < ii.width && is_path(data[img_at(x, y, ii)], PATH_THRESHOLD))
+                mask |= (uint16_t)(1 << (3 * (y + 1 - cy) + (x + 1 - cx)));
+        }
+    }
+    return mask;
+}
+
+uint8_t* Path::to_grayscale(const uint8_t* data, image_info_t& ii)
+{
+    /* Grayscale: 1 color-channel that means a multiplication with the number of channels is useless.
+    *                                               |
+    *                                               \/  here
+    */
+    uint8_t* img_gray_data = new uint8_t[ii.width * ii.height]; // Allocating the new image buffer for the grayscale image.
+    image_info_t gray_ii{ii.width, ii.height, 1};               // And also declare a new image_info_t struct for it.
+
+    // 2-dimensional loop that iterates every pixel of the image.
+    int x, y;   // a optimization for speed
+    for(y = 0; y < ii.height; y++)
+    {
+        for(x = 0; x < ii.width; x++)
+        {
+            unsigned int sum = 0;
+            // Calculate the average value of all color components except the alpha channel if the image has one.
+            // The average value of the 3 colors (RGB) corresponds to the grayscale value.
+            for(int c = 0; c < ((ii.channels < 4) ? ii.channels : 3); c++)
+            {
+                sum += data[img_at(x, y, ii) + c];
+            }
+            // Write the grayscale value to the new generated buffer.
+            img_gray_data[img_at(x, y, gray_ii)] = sum / ii.channels;
+        }
+    }
+    ii = gray_ii;               // update the image information
+    return img_gray_data;
+}
+
+/*
+*   Grayscale conversion and inversion of pixels with CH channels in one pass.
+*   The result is the same as to_grayscale(...) and invert_image(...): the sum of the first channels (up to 3, so the alpha
+*   channel of RGBA is left out) divided by the number of channels, inverting is a XOR with 255 (255 - value).
+*   Parameters:
+*       const uint8_t* in -> The pixels.
+*       uint8_t* out -> Gets the grayscale pixels.
+*       size_t n -> Number of pixels.
+*       uint8_t flip -> 255 to invert, 0 to not invert.
+*/
+template<int CH>
+static void gray_pixels(const uint8_t* in, uint8_t* out, size_t n, uint8_t flip) noexcept
+{
+    size_t i = 0;
+#if defined(PATHGEN_SSE2)
+    const __m128i vflip = _mm_set1_epi8((char)flip);
+    if constexpr(CH == 1)
+    {
+        for(; i + 16 <= n; i += 16)
+            _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + i)), vflip));
+    }
+    else if constexpr(CH == 4)
+    {
+        // Every 32-bit lane is one pixel (RGBA): R + G + B in the lane, divided by 4 with a shift.
+        const __m128i low = _mm_set1_epi32(0xFF);
+        for(; i + 16 <= n; i += 16)
+        {
+            __m128i sum[4];
+            for(int j = 0; j < 4; j++)
+            {
+                const __m128i v = _mm_loadu_si128((const __m128i*)(in + 4 * i + 16 * j));
+                const __m128i rg = _mm_add_epi32(_mm_and_si128(v, low), _mm_and_si128(_mm_srli_epi32(v, 8), low));
+                sum[j] = _mm_srli_epi32(_mm_add_epi32(rg, _mm_and_si128(_mm_srli_epi32(v, 16), low)), 2);
+            }
+            const __m128i gray = _mm_packus_epi16(_mm_packs_epi32(sum[0], sum[1]), _mm_packs_epi32(sum[2], sum[3]));
+            _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(gray, vflip));
+        }
+    }
+#if defined(PATHGEN_SSSE3)
+    else if constexpr(CH == 3)
+    {
+        // 16 pixels (48 bytes) are split into R, G and B with byte shuffles (-1 gives 0).
+        const __m128i r0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i r1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+        const __m128i r2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+        const __m128i g0 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i g1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+        const __m128i g2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+        const __m128i b0 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i b1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+        const __m128i b2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i third = _mm_set1_epi16((short)43691);     // x / 3 == (x * 43691) >> 17 for every x < 65536
+        for(; i + 16 <= n; i += 16)
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i*)(in + 3 * i));
+            const __m128i b = _mm_loadu_si128((const __m128i*)(in + 3 * i + 16));
+            const __m128i c = _mm_loadu_si128((const __m128i*)(in + 3 * i + 32));
+            const __m128i red = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, r0), _mm_shuffle_epi8(b, r1)), _mm_shuffle_epi8(c, r2));
+            const __m128i green = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, g0), _mm_shuffle_epi8(b, g1)), _mm_shuffle_epi8(c, g2));
+            const __m128i blue = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, b0), _mm_shuffle_epi8(b, b1)), _mm_shuffle_epi8(c, b2));
+            __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(red, zero), _mm_unpacklo_epi8(green, zero)), _mm_unpacklo_epi8(blue, zero));
+            __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(red, zero), _mm_unpackhi_epi8(green, zero)), _mm_unpackhi_epi8(blue, zero));
+            lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, third), 1);
+            hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, third), 1);
+            _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(_mm_packus_epi16(lo, hi), vflip));
+        }
+    }
+#endif
+#endif
+    // The remaining pixels (all pixels without SIMD), the constant number of channels lets the compiler unroll the sum.
+    for(; i < n; i++)
+    {
+        unsigned int sum = 0;
+        for(int c = 0; c < ((CH < 4) ? CH : 3); c++)
+            sum += in[i * CH + c];
+        out[i] = (uint8_t)(sum / CH) ^ flip;
+    }
+}
+
+uint8_t* Path::preprocess(const uint8_t* data, image_info_t& ii, bool invert)
+{
+    const size_t n = (size_t)ii.width * ii.height;
+    const uint8_t flip = invert ? 255 : 0;
+    uint8_t* gray;
+    switch(ii.channels)
+    {
+        case 1: gray = new uint8_t[n]; gray_pixels<1>(data, gray, n, flip); break;
+        case 2: gray = new uint8_t[n]; gray_pixels<2>(data, gray, n, flip); break;
+        case 3: gray = new uint8_t[n]; gray_pixels<3>(data, gray, n, flip); break;
+        case 4: gray = new uint8_t[n]; gray_pixels<4>(data, gray, n, flip); break;
+        default:
+            // Any other number of channels: the reference way in two passes.
+            gray = to_grayscale(data, ii);
+            if(invert)
+                invert_image(gray, ii);
+            return gray;
+    }
+    ii = image_info_t{ii.width, ii.height, 1};  // update the image information
+    return gray;
+}
+
+void Path::preprocess(const uint8_t* data, const image_info_t& ii, bool invert, uint8_t* gray)
+{
+    const size_t n = (size_t)ii.width * ii.height;
+    const uint8_t flip = invert ? 255 : 0;
+    switch(ii.channels)
+    {
+        case 1: gray_pixels<1>(data, gray, n, flip); break;
+        case 2: gray_pixels<2>(data, gray, n, flip); break;
+        case 3: gray_pixels<3>(data, gray, n, flip); break;
+        case 4: gray_pixels<4>(data, gray, n, flip); break;
+        default:
+        {
+            // Any other number of channels: the same as to_grayscale(...) pixel by pixel.
+            size_t i;
+            for(i = 0; i < n; i++)
+            {
+                unsigned int sum = 0;
+                for(int c = 0; c < 3; c++)
+                    sum += data[i * ii.channels + c];
+                gray[i] = (uint8_t)(sum / ii.channels) ^ flip;
+            }
+        }
+    }
+}
+
+void Path::threshold_image(const uint8_t* data, const image_info_t& ii, bool invert, PathBitmap& bitmap)
+{
+    bitmap.resize(ii.width, ii.height);
+    std::vector<uint8_t> gray((size_t)ii.width * std::min(BAND_ROWS, ii.height));
+    for(int y = 0; y < ii.height; y += BAND_ROWS)
+    {
+        const image_info_t band_ii = {ii.width, std::min(BAND_ROWS, ii.height - y), ii.channels};
+        preprocess(data + img_at(0, y, ii), band_ii, invert, gray.data());
+        bitmap.binarize_rows(gray.data(), {ii.width, band_ii.height, 1}, y, PATH_THRESHOLD);
+    }
+}
+
+bool Path::threshold_stream(const row_reader_t& read_rows, const image_info_t& ii, bool invert, PathBitmap& bitmap)
+{
+    if(ii.width <= 0 || ii.height <= 0 || ii.channels <= 0)
+        return false;
+
+    bitmap.resize(ii.width, ii.height);
+    const int band_rows = std::min(BAND_ROWS, ii.height);
+    std::vector<uint8_t> rows((size_t)ii.width * band_rows * ii.channels);
+    std::vector<uint8_t> gray((size_t)ii.width * band_rows);
+    for(int y = 0; y < ii.height; y += BAND_ROWS)
+    {
+        const image_info_t band_ii = {ii.width, std::min(BAND_ROWS, ii.height - y), ii.channels};
+        if(!read_rows(rows.data(), y, band_ii.height))
+            return false;
+        preprocess(rows.data(), band_ii, invert, gray.data());
+        bitmap.binarize_rows(gray.data(), {ii.width, band_ii.height, 1}, y, PATH_THRESHOLD);
+    }
+    return true;
+}
+
+void Path::invert_image(uint8_t* data, const image_info_t& ii)
+{
+    int x, y;
+    int index;
+    // 2-dimensional loop to iterate through the image
+    for(y = 0; y < ii.height; y++)
+    {
+        for(x = 0; x < ii.width; x++)
+        {
+            index = img_at(x, y, ii);           // get index
+            data[index] = 255 - data[index];    // invert operation
+        }
+    }
+}
+
+void PathBitmap::resize(int width, int height)
+{
+    this->w = width;
+    this->h = height;
+    this->stride = ((size_t)width + 2 + 63) / 64;   // + border bit on both sides
+    this->bits.assign(this->stride * (height + 2), 0);
+}
+
+void PathBitmap::binarize(const uint8_t* data, const image_info_t& ii, uint8_t threshold)
+{
+    this->resize(ii.width, ii.height);
+    this->binarize_rows(data, ii, 0, threshold);
+}
+
+void PathBitmap::binarize_rows(const uint8_t* data, const image_info_t& ii, int first_row, uint8_t threshold)
+{
+    for(int y = 0; y < ii.height; y++)
+    {
+        const uint8_t* in = data + img_at(0, y, ii);
+        uint64_t* out = this->bits.data() + (size_t)(first_row + y + 1) * this->stride;
+        std::fill(out, out + this->stride, 0);
+        int x = 0;
+#if defined(PATHGEN_SSE2)
+        if(ii.channels == 1)
+        {
+            // 64 pixels at once, 16 per compare: value >= threshold <=> max(value, threshold) == value (unsigned)
+            const __m128i thres = _mm_set1_epi8((char)threshold);
+            for(; x + 64 <= ii.width; x += 64)
+            {
+                uint64_t word = 0;
+                for(int i = 0; i < 4; i++)
+                {
+                    const __m128i v = _mm_loadu_si128((const __m128i*)(in + x + 16 * i));
+                    word |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, thres), v)) << (16 * i);
+                }
+                // x is a multiple of 64, so the pixels start at bit 1 of the word (border bit).
+                out[x / 64] |= word << 1;
+                out[x / 64 + 1] |= word >> 63;
+            }
+        }
+#endif
+        for(; x < ii.width; x++)
+        {
+            if(is_path(in[x * ii.channels], threshold))
+                out[(x + 1) / 64] |= (uint64_t)1 << ((x + 1) % 64);
+        }
+    }
+}
+
+bool PathBitmap::find_start(int& x, int& y) const noexcept
+{
+    for(int r = 0; r < this->h; r++)
+    {
+        const uint64_t* bits = this->row(r + 1);
+        for(size_t i = 0; i < this->stride; i++)
+        {
+            // Every pattern contains the center pixel, so only the path pixels (set bits) have to be looked up.
+            uint64_t word = bits[i];
+            while(word != 0)
+            {
+                const int px = (int)(i * 64 + ctz64(word)) - 1;     // - border bit
+                word &= word - 1;                                   // clear the lowest set bit
+                if(DIRECTION_TABLE.step[this->mask(px, r)].valid)
+                {
+                    x = px;
+                    y = r;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void Path::gen_path(const uint8_t* data, std::vector<img_coord_t>& path, const image_info_t& ii)
+{
+    // If the image has no pixels, there is no need to generate a path.
+    if(ii.width <= 0 || ii.height <= 0)
+        return;
+
+    PathBitmap bitmap;
+    bitmap.binarize(data, ii, PATH_THRESHOLD);
+    gen_path(bitmap, path);
+}
+
+void Path::gen_path(const PathBitmap& bitmap, std::vector<img_coord_t>& path)
+{
+    // The begin pixel is the first pixel (row by row) that has a valid matrix.
+    int bx, by;
+    if(bitmap.find_start(bx, by))
+        trace_path(bitmap, bx, by, path);
+}
+
+bool Path::trace_path(const PathBitmap& bitmap, int bx, int by, std::vector<img_coord_t>& path)
+{
+    int x = bx, y = by;
+    do
+    {
+        // Get the direction of the current pixel.
+        // Every direction points to a path pixel, so the pixel is always inside of the image.
+        const PathStep& step = DIRECTION_TABLE.step[bitmap.mask(x, y)];
+        // Maybe the direction is invalid which means the path ends here.
+        if(!step.valid)
+            return false;
+        path.push_back({x, y});     // Push the current x and y value into the vector because this is a valid path-coordinate.
+        x += step.dir_x;            // Add the direction to the x and y value.
+        y += step.dir_y;
+    }
+    while(!(x == bx && y == by));   // Break if the begin pixel has been reached again.
+    return true;
+}
+
+bool Path::gen_goals(const std::vector<img_coord_t>& path, std::vector<goal_coord_t>& goals, unsigned int num_goals)
+{
+    // Invalid number of goals:
+    //  If the number of goals is to big or if 'path' does not contain any coordinates.
+    if(num_goals > path.size() || path.size() == 0)
+        return false;
+
+    // Calculate the width between the goals.
+    float g2g_width = (float)path.size() / (float)num_goals;
+    // Split the path into a certain number of goals.
+    for(float i = 0; i < path.size(); i += g2g_width)
+    {
+        goals.push_back(path.at((size_t)i));
+    }
+    // Because the vehicle should drive back to the begin whre it started,
+    // the first goal has to be pushed at the end of the goal-vector.
+    // Only if the vector contains at least one element.
+    if(goals.size() > 0)
+        goals.push_back(goals.at(0));
+
+    return true;
+}
+
+// Return: distance of the pixel p to the line segment from a to b.
+static float segment_distance(const img_coord_t& p, const img_coord_t& a, const img_coord_t& b)
+{
+    const float abx = (float)(b.x - a.x), aby = (float)(b.y - a.y);
+    const float apx = (float)(p.x - a.x), apy = (float)(p.y - a.y);
+    const float len2 = abx * abx + aby * aby;
+    // Position of the nearest point on the segment (0 = a, 1 = b).
+    const float t = (len2 > 0.0f) ? std::min(1.0f, std::max(0.0f, (apx * abx + apy * aby) / len2)) : 0.0f;
+    const float dx = apx - t * abx, dy = apy - t * aby;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+/*
+*   Douglas-Peucker: appends the pixels of the chain between first and last (exclusive) that have to be kept,
+*   so that no pixel is further than max_deviation from the line between the kept pixels.
+*   A stack is used instead of recursion because the chain can have a lot of pixels.
+*/
+static void simplify(const std::vector<img_coord_t>& chain, size_t first, size_t last, float max_deviation, std::vector<size_t>& keep)
+{
+    std::vector<std::pair<size_t, size_t>> stack = {{first, last}};
+    while(!stack.empty())
+    {
+        const size_t a = stack.back().first, b = stack.back().second;
+        stack.pop_back();
+
+        // The pixel that is the furthest away from the line a-b.
+        float max_dist = 0.0f;
+        size_t farthest = a;
+        size_t i;
+        for(i = a + 1; i < b; i++)
+        {
+            const float dist = segment_distance(chain[i], chain[a], chain[b]);
+            if(dist > max_dist)
+            {
+                max_dist = dist;
+                farthest = i;
+            }
+        }
+        if(max_dist > max_deviation)
+        {
+            keep.push_back(farthest);
+            stack.push_back({a, farthest});
+            stack.push_back({farthest, b});
+        }
+    }
+}
+
+bool Path::gen_goals_adaptive(const std::vector<img_coord_t>& path, std::vector<goal_coord_t>& goals, float max_deviation, float max_spacing)
+{
+    if(path.size() == 0 || !(max_deviation > 0.0f))
+        return false;
+
+    // The vehicle drives back to the begin, so the chain is closed with the first pixel.
+    std::vector<img_coord_t> chain(path);
+    chain.push_back(path[0]);
+    const size_t last = chain.size() - 1;
+
+    std::vector<size_t> keep = {0, last};
+    simplify(chain, 0, last, max_deviation, keep);
+    std::sort(keep.begin(), keep.end());
+
+    // Parts that are too long are split by their arc length, every piece is simplified again so the deviation still holds.
+    if(max_spacing > 0.0f)
+    {
+        std::vector<float> arc(chain.size(), 0.0f);     // arc length from the begin to every pixel
+        size_t i;
+        for(i = 1; i < chain.size(); i++)
+            arc[i] = arc[i - 1] + ((chain[i].x != chain[i - 1].x && chain[i].y != chain[i - 1].y) ? 1.41421356f : 1.0f);
+
+        std::vector<size_t> split;
+        for(size_t k = 0; k + 1 < keep.size(); k++)
+        {
+            const size_t a = keep[k], b = keep[k + 1];
+            const float length = arc[b] - arc[a];
+            if(length <= max_spacing)
+                continue;
+            const int pieces = (int)std::ceil(length / max_spacing);
+            size_t prev = a;
+            i = a;
+            for(int p = 1; p < pieces; p++)
+            {
+                const float target = arc[a] + length * p / pieces;
+                while(i < b && arc[i] < target)
+                    i++;
+                if(i > prev && i < b)
+                {
+                    simplify(chain, prev, i, max_deviation, split);
+                    split.push_back(i);
+                    prev = i;
+                }
+            }
+            simplify(chain, prev, b, max_deviation, split);
+        }
+        keep.insert(keep.end(), split.begin(), split.end());
+        std::sort(keep.begin(), keep.end());
+    }
+
+    // The last kept pixel is the first pixel again.
+    goals.reserve(goals.size() + keep.size());
+    for(size_t index : keep)
+        goals.push_back(chain[index]);
+    return true;
+}
+
+bool Path::gen_goals(const std::vector<img_coord_t>& path, std::vector<goal_coord_t>& goals, const goal_settings_t& settings)
+{
+    if(settings.max_deviation > 0.0f)
+        return gen_goals_adaptive(path, goals, settings.max_deviation, settings.max_spacing);
+    return gen_goals(path, goals, settings.num_goals);
+}
+
+void Path::to_ntc(const std::vector<goal_coord_t>& goals, const image_info_t& ii, std::vector<ntc_coord_t>& ntc_goals)
+{
+    /*  The image coordinates are represented as NTC (Normalized Texture Coordinates)
+    *   or NIC (Normalized Image Coordinates).
+    *   That means the coordinates are, undependend from the size of the image, clamped
+    *   to 0.0 and 1.0.
+    */
+    ntc_goals.reserve(ntc_goals.size() + goals.size());
+    for(const goal_coord_t& pos : goals)
+        ntc_goals.push_back({(float)pos.x / (float)ii.width, (float)pos.y / (float)ii.height});
+}
+
+pathgen_error Path::generate_goals(const uint8_t* data, const image_info_t& ii, unsigned int num_goals, bool invert, std::vector<ntc_coord_t>& goals)
+{
+    goals.clear();
+    if(data == nullptr || ii.width <= 0 || ii.height <= 0 || ii.channels <= 0)
+        return PATHGEN_INVALID_IMAGE;
+
+    // Only one band of the grayscale image is in memory at once.
+    PathBitmap bitmap;
+    threshold_image(data, ii, invert, bitmap);
+    return generate_goals(bitmap, num_goals, goals);
+}
+
+pathgen_error Path::generate_goals(const PathBitmap& bitmap, unsigned int num_goals, std::vector<ntc_coord_t>& goals)
+{
+    goals.clear();
+    if(bitmap.width() <= 0 || bitmap.height() <= 0)
+        return PATHGEN_INVALID_IMAGE;
+
+    std::vector<img_coord_t> path_pixels;
+    gen_path(bitmap, path_pixels);
+
+    std::vector<goal_coord_t> goal_pixels;
+    if(!gen_goals(path_pixels, goal_pixels, num_goals))
+        return PATHGEN_INVALID_NUM_GOALS;
+
+    to_ntc(goal_pixels, {bitmap.width(), bitmap.height(), 1}, goals);
+    return PATHGEN_NONE;
+}
+
+const char* Path::error_string(pathgen_error err) noexcept
+{
+    switch(err)
+    {
+        case PATHGEN_NONE:              return "no error";
+        case PATHGEN_INVALID_IMAGE:     return "invalid image";
+        case PATHGEN_INVALID_NUM_GOALS: return "invalid number of goals or no path found";
+    }
+    return "unknown error";
+}
@@ -0,0 +1,455 @@
+#ifndef __pathgen_h__
+#define __pathgen_h__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <functional>
+#include "path.h"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+/*
+*   Library of the path generator.
+*   Generates goals from the pixels of an image that are already in memory, the goals are returned in memory too.
+*   Reading and writing image files is not part of this library (see pathgen_image.h), therefore it can be used
+*   without any image library, e.g. by the path server or by benchmarks with generated images.
+*/
+
+namespace Path
+{
+    constexpr uint8_t PATH_THRESHOLD = 10;  // treshold value to determine if a pixel is path or not
+    constexpr int BAND_ROWS = 64;           // number of rows that are converted at once when an image is thresholded in bands
+
+    /*
+    *   Contains information for one image.
+    *   Members:
+    *       width -> width of the image in pixels
+    *       height -> height of the image in pixels
+    *       channels -> number of channels that the image contains (e.g. RGB, RGBA)
+    */
+    struct image_info_t
+    {
+        int width{0}, height{0};
+        int channels{0};
+    };
+
+    /*
+    *   Contains a X and Y coordinate for an image.
+    *   Members:
+    *       x -> X-Coordinate of the pixel.
+    *       y -> Y-Coordinate of the pixel.
+    */
+    struct img_coord_t
+    {
+        int x, y;
+    };
+
+    /*
+    *   Is used to save the pixel-coordinates of the generated goals.
+    *   Contains also X and Y coordinate values.
+    */
+    using goal_coord_t = img_coord_t;
+
+    /*
+    *   Normalized texture coordinates (NTC) of a goal, independent of the size of the image (0.0 to 1.0).
+    *   This is the format in which the goals are sent to the vehicles.
+    */
+    struct ntc_coord_t
+    {
+        float x, y;
+    };
+
+    /*
+    *   Selects how the goals are sampled from a path (see gen_goals(...) and gen_goals_adaptive(...)).
+    *   Members:
+    *       num_goals -> Number of uniform goals (the same number of path pixels between all goals).
+    *       max_deviation -> If > 0 the goals are adaptive with this maximum deviation in pixels, num_goals is not used.
+    *       max_spacing -> Maximum arc length between two adaptive goals in pixels, 0 for no limit.
+    */
+    struct goal_settings_t
+    {
+        unsigned int num_goals{0};
+        float max_deviation{0.0f};
+        float max_spacing{0.0f};
+    };
+
+    // Return: index of the lowest set bit, the value must not be 0.
+    inline unsigned int ctz64(uint64_t value) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        if(_BitScanForward(&index, (unsigned long)value))
+            return index;
+        _BitScanForward(&index, (unsigned long)(value >> 32));
+        return index + 32;
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+
+    /*
+    *   Class: PathBitmap
+    *   The thresholded image with 1 bit per pixel (1 = path pixel), 8 times smaller than the grayscale image.
+    *   Every row starts at a 64-bit word and has a border of one 0-bit on the left and on the right, and there is
+    *   an empty row above and below the image. So the 3x3 neighborhood of every pixel can be read with shifts,
+    *   the bounds never have to be checked.
+    */
+    class PathBitmap
+    {
+    private:
+        int w, h;
+        size_t stride;                  // Number of 64-bit words per row.
+        std::vector<uint64_t> bits;     // (height + 2) rows, the bit (x + 1) of the row (y + 1) is the pixel (x, y).
+
+        const uint64_t* row(int r) const noexcept
+        {
+            return this->bits.data() + (size_t)r * this->stride;
+        }
+
+    public:
+        PathBitmap(void) : w(0), h(0), stride(0) {}
+
+        /*
+        *   Thresholds an image into the bitmap (the previous content is replaced).
+        *   Parameters:
+        *       const uint8_t* data -> Pixel data of the (grayscale) image, only the first channel of every pixel is used.
+        *       image_info_t image_info -> Information of the image.
+        *       uint8_t threshold -> A pixel is a path pixel if its value is at least the threshold (see is_path(...)).
+        */
+        void binarize(const uint8_t*, const image_info_t&, uint8_t);
+
+        /*
+        *   Sets the size of the bitmap, every pixel is cleared (the previous content is replaced).
+        *   Parameters:
+        *       int width, int height -> Size of the image.
+        */
+        void resize(int, int);
+
+        /*
+        *   Thresholds a band of rows into the bitmap, the other rows are not changed.
+        *   Like this the bitmap can be filled without the whole image in memory (see threshold_stream(...)).
+        *   Parameters:
+        *       const uint8_t* data -> Pixel data of the (grayscale) rows, only the first channel of every pixel is used.
+        *       image_info_t image_info -> Information of the band: width of the bitmap, number of rows and channels.
+        *       int first_row -> Row of the bitmap of the first row of the band.
+        *       uint8_t threshold -> A pixel is a path pixel if its value is at least the threshold (see is_path(...)).
+        */
+        void binarize_rows(const uint8_t*, const image_info_t&, int, uint8_t);
+
+        /*
+        *   Searches the first pixel (row by row) whose neighborhood is a valid path matrix.
+        *   Only the words that contain path pixels are looked at.
+        *   Parameters:
+        *       int& x, int& y -> Get the coordinate of the pixel.
+        *   Return:
+        *       False if there is no such pixel.
+        */
+        bool find_start(int&, int&) const noexcept;
+
+        /*
+        *   Returns the neighborhood of a pixel as bitmask (see pattern_mask(...)), index of the DIRECTION_TABLE.
+        *   The pixel has to be inside of the image.
+        */
+        uint16_t mask(int x, int y) const noexcept
+        {
+            // Because of the border bit, the bit x is the left neighbour and the row y is the upper neighbour.
+            const size_t word = (size_t)x >> 6;
+            const unsigned int shift = (unsigned int)x & 63;
+            uint16_t m = 0;
+            for(int r = 0; r < 3; r++)
+            {
+                const uint64_t* bits = this->row(y + r) + word;
+                uint64_t value = bits[0] >> shift;
+                if(shift > 61)
+                    value |= bits[1] << (64 - shift);
+                m |= (uint16_t)((value & 7) << (3 * r));
+            }
+            return m;
+        }
+
+        int width(void) const noexcept {return this->w;}
+        int height(void) const noexcept {return this->h;}
+
+        // Return: the words of the row y (words_per_row() words), the bit (x + 1) is the pixel x.
+        const uint64_t* row_words(int y) const noexcept {return this->row(y + 1);}
+        size_t words_per_row(void) const noexcept {return this->stride;}
+
+        // Return: size of the bitmap in bytes.
+        size_t memory(void) const noexcept {return this->bits.size() * sizeof(uint64_t);}
+    };
+
+    /*
+    *   Errors of the whole pipeline (generate_goals).
+    *       PATHGEN_NONE -> Success!
+    *       PATHGEN_INVALID_IMAGE -> The image has no pixels or could not be read.
+    *       PATHGEN_INVALID_NUM_GOALS -> Too many goals for the path or no path has been found.
+    */
+    enum pathgen_error
+    {
+        PATHGEN_NONE,
+        PATHGEN_INVALID_IMAGE,
+        PATHGEN_INVALID_NUM_GOALS
+    };
+
+    /*
+    *   Converts a 2-dimensional input (X, Y) to a 1-dimensional output.
+    *   Used to access 1-dimensional arrays or vectors with a 2-dimensional (X, Y) input.
+    *   Parameters:
+    *       size_t x -> X value of the 2-dimensional input.
+    *       size_t y -> Y value of the 2-dimensional input.
+    *       image_into_t image_info -> image_info_t struct of the image that should be accessed.
+    *   Return:
+    *       1-dimensional array index.
+    */
+    size_t img_at(size_t, size_t, const image_info_t&);
+
+    /*
+    *   Searches the given path-matrix of the given map and returns the
+    *   direction of that matrix.
+    *   Parameters:
+    *       std::map<Path::PathMatrix*, Path::PathDirection> mat2dir -> Map where the matrices and the directions are located.
+    *       Path::PathMatrix mat -> The matrix that should be searched for.
+    *   Return:
+    *       A pointer to the found matrix or.
+    *       'nullptr' if the matrix couldn't be found.
+    */
+    const PathDirection* get_dirp(const std::map<PathMatrix*, PathDirection>&, const PathMatrix&);
+
+    /*
+    *   Determines if a pixel is a path or not.
+    *   Parameters:
+    *       uint8_t value -> Value of the current (grayscale) pixel.
+    *       uint8_t threshold -> Value of the treshold.
+    *   Return:
+    *       True if the pixel value is a path.
+    *       False if the pixel value is not a path.
+    */
+    bool is_path(uint8_t, uint8_t);
+
+    /*
+    *   Generates a matrix for a given image position.
+    *   The given position is the center pixel.
+    *   If the given coordinate is the edge or the corner of the image, the surrounding
+    *   pixels that would be outside of the image will always be 0.
+    *   Parameters:
+    *       const uint8_t* data -> Pointer to the image (pixel) data.
+    *       int cx -> Current X value of the center pixel.
+    *       int cy -> Current Y value of the center pixel.
+    *       image_info_t image_info -> image_info_t struct of the image that should be accessed.
+    *   Return:
+    *       Returns a 3x3 matrix for the center pixel + 8 surrounding pixels.
+    *   Note: The matrix contains only information whether the pixel is a path (1)
+    *         or it is not a path (0).
+    */
+    PathMatrix gen_pathmatrix(const uint8_t*, int, int, const image_info_t&);
+
+    /*
+    *   Does the same as gen_pathmatrix(...), but packs the matrix into a bitmask (see pattern_mask(...)).
+    *   Parameters:
+    *       const uint8_t* data -> Pointer to the image (pixel) data.
+    *       int cx -> Current X value of the center pixel.
+    *       int cy -> Current Y value of the center pixel.
+    *       image_info_t image_info -> image_info_t struct of the image that should be accessed.
+    *   Return:
+    *       The bitmask of the center pixel + 8 surrounding pixels, index of the DIRECTION_TABLE.
+    */
+    uint16_t gen_pathmask(const uint8_t*, int, int, const image_info_t&);
+
+    /*
+    *   Converts any image to a grayscale image.
+    *   Undependend of the given number of channels.
+    *   Parameter:
+    *       const uint8_t* data -> Pointer to the image data, is not modified.
+    *       image_info_t image_info -> Struct where the new image information (of the grayscale image)
+    *                                  gets written to.
+    *   Return:
+    *       New buffer (new[]) with the grayscale image, has to be deleted by the caller with delete[].
+    */
+    uint8_t* to_grayscale(const uint8_t*, image_info_t&);
+
+    /*
+    *   Inverts the image to be able to use a white background instead of a white background.
+    *   Parameter:
+    *       uint8_t* data -> Data of the image.
+    *       image_info_t image_info -> Struct of the corresponding image information.
+    */
+    void invert_image(uint8_t*, const image_info_t&);
+
+    /*
+    *   Does the same as to_grayscale(...) and invert_image(...) in one pass: reads the pixels (e.g. RGB or RGBA from stb)
+    *   and writes the final grayscale image, inverted or not. 1 to 4 channels are converted with SIMD (SSE2, RGB needs SSSE3),
+    *   to_grayscale(...) and invert_image(...) are the scalar reference.
+    *   Parameters:
+    *       const uint8_t* data -> Pointer to the image data, is not modified.
+    *       image_info_t image_info -> Information of the image, gets the information of the grayscale image.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *   Return:
+    *       New buffer (new[]) with the grayscale image, has to be deleted by the caller with delete[].
+    */
+    uint8_t* preprocess(const uint8_t*, image_info_t&, bool);
+
+    /*
+    *   Does the same as the previous function into a buffer of the caller, e.g. for one band of an image.
+    *   Parameters:
+    *       const uint8_t* data -> Pointer to the image data, is not modified.
+    *       image_info_t image_info -> Information of the image.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       uint8_t* gray -> Gets the grayscale image (width * height bytes).
+    */
+    void preprocess(const uint8_t*, const image_info_t&, bool, uint8_t*);
+
+    /*
+    *   Reads the next rows of an image, e.g. from a file that is decoded row by row.
+    *   Parameters:
+    *       uint8_t* rows -> Gets the pixels of the rows (num_rows * width * channels bytes).
+    *       int y -> First row that is read, the rows are read from top to bottom.
+    *       int num_rows -> Number of rows that are read.
+    *   Return:
+    *       False if the rows could not be read.
+    */
+    using row_reader_t = std::function<bool(uint8_t*, int, int)>;
+
+    /*
+    *   Converts (see preprocess(...)) and thresholds an image band by band (BAND_ROWS rows) into a bitmap.
+    *   Only one band of the grayscale image is in memory at once instead of the whole grayscale image.
+    *   The bands need no overlapping rows, because every pixel is converted on its own and the 3x3 neighborhood
+    *   of the path is only read from the bitmap.
+    *   Parameters:
+    *       const uint8_t* data -> Pixel data of the image (any number of channels), is not modified.
+    *       image_info_t image_info -> Information of the image.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       PathBitmap& bitmap -> Gets the thresholded image.
+    */
+    void threshold_image(const uint8_t*, const image_info_t&, bool, PathBitmap&);
+
+    /*
+    *   Does the same as the previous function with an image that is read band by band, so the image itself
+    *   is never in memory as a whole: only one band of the image, one band of the grayscale image and the bitmap
+    *   (1 bit per pixel) are in memory.
+    *   Parameters:
+    *       row_reader_t read_rows -> Reads the next band of the image.
+    *       image_info_t image_info -> Information of the image.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       PathBitmap& bitmap -> Gets the thresholded image.
+    *   Return:
+    *       False if the image has no pixels or a band could not be read.
+    */
+    bool threshold_stream(const row_reader_t&, const image_info_t&, bool, PathBitmap&);
+
+    /*
+    *   Generated the path of any given image.
+    *   Parameters:
+    *       const uint8_t* data -> Data of the (grayscale) image.
+    *       std::vector<img_coord_t>& path_pixels -> Vector where all the coordinates of the generated path will be saved to.
+    *       image_info_t image_info -> Struct of the corresponding image information.
+    *   Note: The image is thresholded into a PathBitmap, the direction of every pixel is looked up in the DIRECTION_TABLE.
+    */
+    void gen_path(const uint8_t*, std::vector<img_coord_t>&, const image_info_t&);
+
+    /*
+    *   Does the same as the previous function with an image that is already thresholded.
+    *   Parameters:
+    *       PathBitmap bitmap -> The thresholded image.
+    *       std::vector<img_coord_t>& path_pixels -> Vector where all the coordinates of the generated path will be saved to.
+    */
+    void gen_path(const PathBitmap&, std::vector<img_coord_t>&);
+
+    /*
+    *   Traces the path from a begin pixel until the begin pixel has been reached again or the direction has become invalid.
+    *   Parameters:
+    *       PathBitmap bitmap -> The thresholded image.
+    *       int bx, int by -> The begin pixel, its matrix has to be valid (see PathBitmap::find_start(...)).
+    *       std::vector<img_coord_t>& path_pixels -> Vector where all the coordinates of the path will be saved to.
+    *   Return:
+    *       True if the path is closed (the begin pixel has been reached again).
+    */
+    bool trace_path(const PathBitmap&, int, int, std::vector<img_coord_t>&);
+
+    /*
+    *   Generates goals form any given path.
+    *   Parameters:
+    *       std::vector<img_coord_t> path_pixels -> Vector with all the coordinates of the given path.
+    *       std::vector<goal_coord_t>& goals -> Vector where the coordinates of the generated goals will be saved to.
+    *       unsigned int n -> Number of goals that should be generated from the given path.
+    *                         Is limited to the number of coordinates the path itself has.
+    *   Return:
+    *       True if everything worked well.
+    *       False if there was an invalid number of goals given.
+    */
+    bool gen_goals(const std::vector<img_coord_t>&, std::vector<goal_coord_t>&, unsigned int);
+
+    /*
+    *   Generates as few goals as possible from any given path, so that the vehicle never deviates more than a given
+    *   distance from the path when it drives straight from goal to goal.
+    *   The path is simplified with the Douglas-Peucker algorithm: straight parts of the path get only a goal at their ends,
+    *   curves get more goals the tighter they are (the spacing of the goals in a curve with the radius r is about
+    *   sqrt(8 * max_deviation * r)). Optionally the goals are at most a certain arc length apart.
+    *   Like gen_goals(...) every goal is a pixel of the path and the first goal is repeated at the end.
+    *   Parameters:
+    *       std::vector<img_coord_t> path_pixels -> Vector with all the coordinates of the given path.
+    *       std::vector<goal_coord_t>& goals -> Vector where the coordinates of the generated goals will be saved to.
+    *       float max_deviation -> Maximum distance of a path pixel to the line between its goals in pixels (> 0).
+    *       float max_spacing -> Maximum arc length between two goals in pixels (about 1 pixel more), 0 for no limit.
+    *   Return:
+    *       True if everything worked well.
+    *       False if the path is empty or the maximum deviation is invalid.
+    */
+    bool gen_goals_adaptive(const std::vector<img_coord_t>&, std::vector<goal_coord_t>&, float, float);
+
+    /*
+    *   Generates uniform or adaptive goals, depending on the settings.
+    *   Parameters:
+    *       std::vector<img_coord_t> path_pixels -> Vector with all the coordinates of the given path.
+    *       std::vector<goal_coord_t>& goals -> Vector where the coordinates of the generated goals will be saved to.
+    *       goal_settings_t settings -> Selects gen_goals(...) or gen_goals_adaptive(...) and their parameters.
+    *   Return:
+    *       The return value of the selected function.
+    */
+    bool gen_goals(const std::vector<img_coord_t>&, std::vector<goal_coord_t>&, const goal_settings_t&);
+
+    /*
+    *   Converts the pixel coordinates of the goals to normalized texture coordinates.
+    *   NTC = (pos in px) / (size in px)
+    *   Parameters:
+    *       std::vector<goal_coord_t> goals -> Goals in pixel coordinates.
+    *       image_info_t image_info -> Struct of the corresponding image information.
+    *       std::vector<ntc_coord_t>& ntc_goals -> Vector where the converted goals are appended to.
+    */
+    void to_ntc(const std::vector<goal_coord_t>&, const image_info_t&, std::vector<ntc_coord_t>&);
+
+    /*
+    *   Runs the whole pipeline: grayscale, invert (optional), path and goals.
+    *   Parameters:
+    *       const uint8_t* data -> Pixel data of the image (any number of channels), is not modified.
+    *       image_info_t image_info -> Information of the image.
+    *       unsigned int num_goals -> Number of goals that should be generated.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       std::vector<ntc_coord_t>& goals -> Vector where the goals are written to (the content gets replaced).
+    *                                          The first goal is repeated at the end, so the vehicle drives back to the start.
+    *   Return:
+    *       PATHGEN_NONE if the goals have been generated, otherwise the reason why it failed.
+    */
+    pathgen_error generate_goals(const uint8_t*, const image_info_t&, unsigned int, bool, std::vector<ntc_coord_t>&);
+
+    /*
+    *   Runs the rest of the pipeline (path and goals) for an image that is already thresholded, e.g. by threshold_stream(...).
+    *   Parameters:
+    *       PathBitmap bitmap -> The thresholded image.
+    *       unsigned int num_goals -> Number of goals that should be generated.
+    *       std::vector<ntc_coord_t>& goals -> Vector where the goals are written to (the content gets replaced).
+    *   Return:
+    *       PATHGEN_NONE if the goals have been generated, otherwise the reason why it failed.
+    */
+    pathgen_error generate_goals(const PathBitmap&, unsigned int, std::vector<ntc_coord_t>&);
+
+    /*
+    *   Returns a short description of the error.
+    */
+    const char* error_string(pathgen_error) noexcept;
+};
+
+#endif // __pathgen_h__
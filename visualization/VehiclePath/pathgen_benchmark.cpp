@@ -0,0 +1,447 @@
+/******************************************************************************************************************************************
+* Title:        Path generator benchmark
+* Programtitle: pathgen_benchmark
+* Description:
+*   Compares the two ways the path server can generate goals:
+*       process -> The old way: start the path generator as own process with std::system(...), the process writes the goals
+*                  to a file and the file is read back with fscanf(...).
+*       library -> The new way: call Path::generate_goals(...) in the same process, the goals are returned in memory.
+*   The images are generated (a thick ring on a black background) and saved as binary .ppm, so no image library is needed.
+*   Both ways read the same pixels, decoding the image file (e.g. png) is the same for both and therefore not measured.
+*   For every image size the average time of one generation is printed in milliseconds.
+*
+*   After that the trace of the path (gen_path) is compared with the older traces:
+*       map         -> Every matrix is generated from the grayscale image and searched in the matrix-to-direction-map (get_dirp).
+*       bytes       -> The bitmask of every neighborhood is generated from the grayscale image (gen_pathmask) and looked up
+*                      in the direction table.
+*       bitmap      -> The image is thresholded into a bitmap first (PathBitmap), the start pixel is searched word by word.
+*   It prints:
+*       table check -> The direction of all 512 possible matrices with the map and the table.
+*       trace       -> Memory of the grayscale image and of the bitmap, average time of every trace (the map only runs once)
+*                      and of the thresholding alone (part of the bitmap time) for square images from 1k to 16k pixels.
+*                      All paths have to be byte-identical.
+*
+*   At last the preprocessing of the image is compared with the fused kernel (preprocess):
+*       accuracy    -> Every possible RGB color (4096x4096 pixels), with and without alpha and inverted or not,
+*                      has to give the same grayscale value as to_grayscale(...) and invert_image(...).
+*       stages      -> Average time of every stage of generate_goals(...) for 1 to 4 channels: grayscale, invert and the fused
+*                      kernel instead of both, path (threshold + trace) and goals.
+*
+*   Command syntax:
+*       pathgen_benchmark [<number of runs per size>]
+*       pathgen_benchmark --child <input .ppm> <output file> <number of goals>   (used internally for the "process" way)
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "pathgen.h"
+
+static constexpr unsigned int NUM_GOALS = 500;
+
+/*
+*   Generates a RGB image with a white, thick ring in the center.
+*/
+static std::vector<uint8_t> gen_ring(const Path::image_info_t& ii)
+{
+    std::vector<uint8_t> data(ii.width * ii.height * ii.channels, 0);
+    const float cx = ii.width / 2.0f, cy = ii.height / 2.0f;
+    const float r_out = ((ii.width < ii.height) ? ii.width : ii.height) * 0.4f;
+    const float r_in = r_out * 0.8f;
+    for(int y = 0; y < ii.height; y++)
+    {
+        for(int x = 0; x < ii.width; x++)
+        {
+            const float d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+            if(d2 <= r_out * r_out && d2 >= r_in * r_in)
+                memset(&data[Path::img_at(x, y, ii)], 255, ii.channels);
+        }
+    }
+    return data;
+}
+
+static bool write_ppm(const char* path, const std::vector<uint8_t>& data, const Path::image_info_t& ii)
+{
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr)
+        return false;
+    fprintf(file, "P6\n%d %d\n255\n", ii.width, ii.height);
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+    return true;
+}
+
+static bool read_ppm(const char* path, std::vector<uint8_t>& data, Path::image_info_t& ii)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr)
+        return false;
+    int maxval;
+    if(fscanf(file, "P6 %d %d %d", &ii.width, &ii.height, &maxval) != 3 || fgetc(file) == EOF)
+    {
+        fclose(file);
+        return false;
+    }
+    ii.channels = 3;
+    data.resize(ii.width * ii.height * ii.channels);
+    const bool ok = fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    return ok;
+}
+
+/*
+*   The "process" way, child side: does the same as the path generator program (without debug images and logs).
+*/
+static int child(const char* in, const char* out, unsigned int num_goals)
+{
+    std::vector<uint8_t> data;
+    Path::image_info_t ii;
+    if(!read_ppm(in, data, ii))
+        return -2;
+
+    uint8_t* gray = Path::to_grayscale(data.data(), ii);
+    std::vector<Path::img_coord_t> path_pixels;
+    Path::gen_path(gray, path_pixels, ii);
+    delete[](gray);
+
+    std::vector<Path::goal_coord_t> goals;
+    if(!Path::gen_goals(path_pixels, goals, num_goals))
+        return -4;
+
+    FILE* file = fopen(out, "w");
+    if(file == nullptr)
+        return -5;
+    for(const Path::goal_coord_t& pos : goals)
+        fprintf(file, "%f %f\n", (float)pos.x / (float)ii.width, (float)pos.y / (float)ii.height);
+    fclose(file);
+    return 0;
+}
+
+/*
+*   The old trace: every matrix is generated and searched in the matrix-to-direction-map.
+*/
+static void gen_path_map(const uint8_t* data, std::vector<Path::img_coord_t>& path, const std::map<Path::PathMatrix*, Path::PathDirection>& m2d,
+                         const Path::image_info_t& ii)
+{
+    int bx = 0, by = 0;
+    Path::PathMatrix begin_mat;
+    const Path::PathDirection* dir = nullptr;
+    for(by = 0; by < ii.height && dir == nullptr; by++)
+    {
+        for(bx = 0; bx < ii.width && dir == nullptr; bx++)
+        {
+            begin_mat = Path::gen_pathmatrix(data, bx, by, ii);
+            dir = Path::get_dirp(m2d, begin_mat);
+        }
+    }
+    int x = --bx;
+    int y = --by;
+    Path::PathMatrix cur_mat = begin_mat;
+    do
+    {
+        dir = Path::get_dirp(m2d, cur_mat);
+        if(dir != nullptr)
+        {
+            path.push_back({x, y});
+            x += dir->direction_x();
+            y += dir->direction_y();
+        }
+        cur_mat = Path::gen_pathmatrix(data, x, y, ii);
+    }
+    while(!(x == bx && y == by) && dir != nullptr);
+}
+
+/*
+*   The trace with the direction table on the grayscale image (without the bitmap).
+*/
+static void gen_path_bytes(const uint8_t* data, std::vector<Path::img_coord_t>& path, const Path::image_info_t& ii)
+{
+    int bx = -1, by = -1;
+    for(int y = 0; y < ii.height && bx < 0; y++)
+    {
+        for(int x = 0; x < ii.width; x++)
+        {
+            if(Path::is_path(data[Path::img_at(x, y, ii)], Path::PATH_THRESHOLD) && Path::DIRECTION_TABLE.step[Path::gen_pathmask(data, x, y, ii)].valid)
+            {
+                bx = x;
+                by = y;
+                break;
+            }
+        }
+    }
+    if(bx < 0)
+        return;
+    int x = bx, y = by;
+    do
+    {
+        const Path::PathStep& step = Path::DIRECTION_TABLE.step[Path::gen_pathmask(data, x, y, ii)];
+        if(!step.valid)
+            break;
+        path.push_back({x, y});
+        x += step.dir_x;
+        y += step.dir_y;
+    }
+    while(!(x == bx && y == by));
+}
+
+static bool same_path(const std::vector<Path::img_coord_t>& a, const std::vector<Path::img_coord_t>& b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(Path::img_coord_t)) == 0;
+}
+
+/*
+*   Compares the direction table with the matrix-to-direction-map for every possible matrix.
+*   The matrix of a mask is generated by gen_pathmatrix(...) from a 3x3 image, so the bit order is checked too.
+*/
+static bool check_table(const std::map<Path::PathMatrix*, Path::PathDirection>& m2d)
+{
+    const Path::image_info_t ii = {3, 3, 1};
+    uint32_t valid = 0;
+    for(uint16_t mask = 0; mask < Path::NUM_NEIGHBORHOODS; mask++)
+    {
+        uint8_t pixels[9];
+        for(int x = 0; x < 3; x++)
+        {
+            for(int y = 0; y < 3; y++)
+                pixels[Path::img_at(x, y, ii)] = (mask & (1 << (3 * y + x))) ? 255 : 0;
+        }
+        const Path::PathDirection* dir = Path::get_dirp(m2d, Path::gen_pathmatrix(pixels, 1, 1, ii));
+        const Path::PathStep& step = Path::DIRECTION_TABLE.step[Path::gen_pathmask(pixels, 1, 1, ii)];
+        if(Path::gen_pathmask(pixels, 1, 1, ii) != mask || step.valid != (dir != nullptr) ||
+           (dir != nullptr && (step.dir_x != dir->direction_x() || step.dir_y != dir->direction_y())))
+        {
+            printf("[ERROR] The direction table is wrong for the mask %u.\n", mask);
+            return false;
+        }
+        valid += step.valid;
+    }
+    printf("table check,%u matrices,%u valid\n", (uint32_t)Path::NUM_NEIGHBORHOODS, valid);
+    return true;
+}
+
+/*
+*   Traces the path of large grayscale images in all ways.
+*/
+static bool bench_trace(int runs)
+{
+    std::map<Path::PathMatrix*, Path::PathDirection> mat2dir;
+    Path::setup(mat2dir);
+    bool ok = check_table(mat2dir);
+
+    printf("image,path pixels,gray MB,bitmap MB,map ms,bytes ms,bitmap ms,binarize ms,speedup (bytes / bitmap)\n");
+    for(int size = 1024; ok && size <= 16384; size *= 2)
+    {
+        const Path::image_info_t ii = {size, size, 1};
+        const std::vector<uint8_t> data = gen_ring(ii);
+        std::vector<Path::img_coord_t> map_path, bytes_path, bitmap_path;
+
+        std::chrono::time_point t0 = std::chrono::steady_clock::now();
+        gen_path_map(data.data(), map_path, mat2dir, ii);
+        const double map_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        t0 = std::chrono::steady_clock::now();
+        for(int i = 0; i < runs; i++)
+        {
+            bytes_path.clear();
+            gen_path_bytes(data.data(), bytes_path, ii);
+        }
+        const double bytes_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / runs;
+
+        t0 = std::chrono::steady_clock::now();
+        for(int i = 0; i < runs; i++)
+        {
+            bitmap_path.clear();
+            Path::gen_path(data.data(), bitmap_path, ii);
+        }
+        const double bitmap_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / runs;
+
+        Path::PathBitmap bitmap;
+        t0 = std::chrono::steady_clock::now();
+        for(int i = 0; i < runs; i++)
+            bitmap.binarize(data.data(), ii, Path::PATH_THRESHOLD);
+        const double binarize_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / runs;
+
+        ok = same_path(map_path, bytes_path) && same_path(map_path, bitmap_path);
+        if(!ok)
+            printf("[ERROR] Different paths (%dx%d).\n", ii.width, ii.height);
+        else
+            printf("%dx%d,%zu,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,%.1fx\n", ii.width, ii.height, bitmap_path.size(), data.size() / 1e6, bitmap.memory() / 1e6,
+                   map_ms, bytes_ms, bitmap_ms, binarize_ms, bytes_ms / bitmap_ms);
+    }
+    Path::cleanup(mat2dir);
+    return ok;
+}
+
+/*
+*   Compares the fused kernel with the reference for an image with every RGB color.
+*/
+static bool check_preprocess(void)
+{
+    bool ok = true;
+    for(int channels = 1; channels <= 4; channels++)
+    {
+        // The pixel i has the color (i & 255, (i >> 8) & 255, i >> 16), the alpha channel is random.
+        Path::image_info_t ii = {4096, 4096, channels};
+        std::vector<uint8_t> data(ii.width * ii.height * channels);
+        for(size_t i = 0; i < data.size() / channels; i++)
+        {
+            for(int c = 0; c < channels; c++)
+                data[i * channels + c] = (c < 3) ? (uint8_t)(i >> (8 * c)) : (uint8_t)rand();
+        }
+        for(bool invert : {false, true})
+        {
+            Path::image_info_t ref_ii = ii, fused_ii = ii;
+            uint8_t* ref = Path::to_grayscale(data.data(), ref_ii);
+            if(invert)
+                Path::invert_image(ref, ref_ii);
+            uint8_t* fused = Path::preprocess(data.data(), fused_ii, invert);
+            const bool same = ref_ii.channels == 1 && fused_ii.channels == 1 && memcmp(ref, fused, (size_t)ii.width * ii.height) == 0;
+            printf("accuracy,%d channels,%s,%s\n", channels, invert ? "inverted" : "not inverted", same ? "identical" : "DIFFERENT");
+            ok = ok && same;
+            delete[](ref);
+            delete[](fused);
+        }
+    }
+    return ok;
+}
+
+/*
+*   Average time of every stage of generate_goals(...) with a ring image.
+*/
+static bool bench_preprocess(int runs)
+{
+    if(!check_preprocess())
+        return false;
+
+    printf("image,channels,grayscale ms,invert ms,fused ms,speedup,path ms,goals ms\n");
+    const int sizes[][2] = {{1920, 1080}, {3840, 2160}, {7680, 4320}};
+    for(const auto& size : sizes)
+    {
+        for(int channels = 1; channels <= 4; channels++)
+        {
+            const Path::image_info_t ii = {size[0], size[1], channels};
+            const std::vector<uint8_t> data = gen_ring(ii);
+            double gray_ms = 0.0, invert_ms = 0.0, fused_ms = 0.0, path_ms = 0.0, goals_ms = 0.0;
+            for(int i = 0; i < runs; i++)
+            {
+                Path::image_info_t gray_ii = ii;
+                std::chrono::time_point t0 = std::chrono::steady_clock::now();
+                uint8_t* gray = Path::to_grayscale(data.data(), gray_ii);
+                std::chrono::time_point t1 = std::chrono::steady_clock::now();
+                Path::invert_image(gray, gray_ii);
+                std::chrono::time_point t2 = std::chrono::steady_clock::now();
+                gray_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+                invert_ms += std::chrono::duration<double, std::milli>(t2 - t1).count();
+                delete[](gray);
+
+                // The path is generated from the image that is not inverted (white ring).
+                gray_ii = ii;
+                t0 = std::chrono::steady_clock::now();
+                gray = Path::preprocess(data.data(), gray_ii, false);
+                t1 = std::chrono::steady_clock::now();
+                std::vector<Path::img_coord_t> path_pixels;
+                Path::gen_path(gray, path_pixels, gray_ii);
+                t2 = std::chrono::steady_clock::now();
+                std::vector<Path::goal_coord_t> goals;
+                Path::gen_goals(path_pixels, goals, NUM_GOALS);
+                const std::chrono::time_point t3 = std::chrono::steady_clock::now();
+                fused_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+                path_ms += std::chrono::duration<double, std::milli>(t2 - t1).count();
+                goals_ms += std::chrono::duration<double, std::milli>(t3 - t2).count();
+                delete[](gray);
+            }
+            printf("%dx%d,%d,%.2f,%.2f,%.2f,%.1fx,%.2f,%.3f\n", ii.width, ii.height, channels, gray_ms / runs, invert_ms / runs, fused_ms / runs,
+                   (gray_ms + invert_ms) / fused_ms, path_ms / runs, goals_ms / runs);
+        }
+    }
+    return true;
+}
+
+/*
+*   The "process" way, server side: starts the child and reads the goals from the file (like the path server did).
+*/
+static bool run_process(const char* self, const char* in, const char* out, std::vector<Path::ntc_coord_t>& goals)
+{
+    goals.clear();
+    const std::string cmd = std::string("\"") + self + "\" --child " + in + " " + out + " " + std::to_string(NUM_GOALS);
+    if(std::system(cmd.c_str()) != 0)
+        return false;
+
+    FILE* file = fopen(out, "r");
+    if(file == nullptr)
+        return false;
+    Path::ntc_coord_t goal;
+    while(fscanf(file, "%f %f", &goal.x, &goal.y) == 2)
+        goals.push_back(goal);
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc == 5 && strcmp(argv[1], "--child") == 0)
+        return child(argv[2], argv[3], (unsigned int)atoi(argv[4]));
+
+    const int runs = (argc > 1) ? atoi(argv[1]) : 10;
+    const Path::image_info_t sizes[] = {{640, 480, 3}, {1280, 720, 3}, {1920, 1080, 3}, {3840, 2160, 3}};
+    constexpr char IMAGE_PATH[] = "pathgen_benchmark.ppm";
+    constexpr char GOALS_PATH[] = "pathgen_benchmark.gol";
+
+    printf("image,goals,process ms,library ms,speedup\n");
+    for(const Path::image_info_t& ii : sizes)
+    {
+        const std::vector<uint8_t> data = gen_ring(ii);
+        if(!write_ppm(IMAGE_PATH, data, ii))
+        {
+            printf("[ERROR] Could not write \"%s\".\n", IMAGE_PATH);
+            return -1;
+        }
+
+        std::vector<Path::ntc_coord_t> process_goals, library_goals;
+        std::chrono::time_point t0 = std::chrono::steady_clock::now();
+        for(int i = 0; i < runs; i++)
+        {
+            if(!run_process(argv[0], IMAGE_PATH, GOALS_PATH, process_goals))
+            {
+                printf("[ERROR] Path generator process failed (%dx%d).\n", ii.width, ii.height);
+                return -1;
+            }
+        }
+        const double process_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / runs;
+
+        t0 = std::chrono::steady_clock::now();
+        for(int i = 0; i < runs; i++)
+        {
+            // The library reads the pixels of the file too, so both ways do the same work.
+            std::vector<uint8_t> file_data;
+            Path::image_info_t file_ii;
+            if(!read_ppm(IMAGE_PATH, file_data, file_ii))
+                return -1;
+            const Path::pathgen_error err = Path::generate_goals(file_data.data(), file_ii, NUM_GOALS, false, library_goals);
+            if(err != Path::PATHGEN_NONE)
+            {
+                printf("[ERROR] %s (%dx%d).\n", Path::error_string(err), ii.width, ii.height);
+                return -1;
+            }
+        }
+        const double library_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / runs;
+
+        // Both ways have to generate the same goals (the file contains 6 decimal places).
+        bool equal = process_goals.size() == library_goals.size();
+        for(size_t i = 0; equal && i < library_goals.size(); i++)
+            equal = std::fabs(process_goals[i].x - library_goals[i].x) < 1e-5f && std::fabs(process_goals[i].y - library_goals[i].y) < 1e-5f;
+        if(!equal)
+        {
+            printf("[ERROR] Different goals (%dx%d).\n", ii.width, ii.height);
+            return -1;
+        }
+        printf("%dx%d,%zu,%.2f,%.2f,%.1fx\n", ii.width, ii.height, library_goals.size(), process_ms, library_ms, process_ms / library_ms);
+    }
+    remove(IMAGE_PATH);
+    remove(GOALS_PATH);
+    return (bench_trace(runs) && bench_preprocess(runs)) ? 0 : -1;
+}
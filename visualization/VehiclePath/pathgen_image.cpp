@@ -0,0 +1,128 @@
+#ifndef STB_IMAGE_IMPLEMENTATION
+    #define STB_IMAGE_IMPLEMENTATION
+#endif //STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <cstdio>
+#include <cctype>
+#include "pathgen_image.h"
+
+using namespace Path;
+
+/*
+*   Reads the next number of the header of a PGM or PPM file, whitespaces and comments (# to the end of the line)
+*   in front of the number are skipped.
+*   Return: the number, -1 if there is none.
+*/
+static int read_pnm_number(FILE* file)
+{
+    int c = fgetc(file);
+    while(c != EOF && (isspace(c) || c == '#'))
+    {
+        if(c == '#')
+        {
+            while(c != EOF && c != '\n')
+                c = fgetc(file);
+        }
+        c = fgetc(file);
+    }
+    int value = -1;
+    while(c != EOF && isdigit(c))
+    {
+        value = ((value < 0) ? 0 : value * 10) + (c - '0');
+        if(value > (1 << 24))
+            return -1;
+        c = fgetc(file);
+    }
+    // The number ends with exactly one whitespace, after the last number of the header the pixels begin.
+    return (c != EOF && isspace(c)) ? value : -1;
+}
+
+/*
+*   Reads a binary PGM (P5) or PPM (P6) file with 8 bits per channel band by band.
+*   Return: 1 if the file has been read, 0 if it is not such a file, -1 if the file is broken.
+*/
+static int read_pnm_bitmap(FILE* file, bool invert, PathBitmap& bitmap, image_info_t& ii)
+{
+    char magic[2];
+    if(fread(magic, 1, 2, file) != 2 || magic[0] != 'P' || (magic[1] != '5' && magic[1] != '6'))
+        return 0;
+    const int width = read_pnm_number(file);
+    const int height = read_pnm_number(file);
+    const int max_value = read_pnm_number(file);
+    if(width <= 0 || height <= 0 || max_value <= 0)
+        return -1;
+    if(max_value > 255)
+        return 0;   // 16 bit, stb can read it
+
+    const image_info_t file_ii = {width, height, (magic[1] == '5') ? 1 : 3};
+    const size_t row_size = (size_t)width * file_ii.channels;
+    auto read_rows = [&](uint8_t* rows, int y, int num_rows) -> bool
+    {
+        return fread(rows, row_size, num_rows, file) == (size_t)num_rows;
+    };
+    if(!threshold_stream(read_rows, file_ii, invert, bitmap))
+        return -1;
+    ii = image_info_t{width, height, 1};
+    return 1;
+}
+
+uint8_t* Path::read_image(const char* const path, image_info_t& ii)
+{
+    // Load image with stbi's library function "stbi_load(...)".
+    // Prototype: stbi_load(const char* path, int* width, int* height, int* n_channels, int channels_to_read)
+    return stbi_load(path, &ii.width, &ii.height, &ii.channels, 0);
+}
+
+uint8_t* Path::read_image_from_memory(const uint8_t* file, size_t size, image_info_t& ii)
+{
+    return stbi_load_from_memory(file, (int)size, &ii.width, &ii.height, &ii.channels, 0);
+}
+
+void Path::free_image(uint8_t* data)
+{
+    stbi_image_free(data);
+}
+
+bool Path::read_image_bitmap(const char* const path, bool invert, PathBitmap& bitmap, image_info_t& ii)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr)
+        return false;
+    const int pnm = read_pnm_bitmap(file, invert, bitmap, ii);
+    fclose(file);
+    if(pnm != 0)
+        return pnm > 0;
+
+    image_info_t file_ii;
+    uint8_t* data = read_image(path, file_ii);
+    if(data == nullptr)
+        return false;
+    threshold_image(data, file_ii, invert, bitmap);
+    free_image(data);
+    ii = image_info_t{file_ii.width, file_ii.height, 1};
+    return true;
+}
+
+pathgen_error Path::generate_goals_from_file(const char* const path, unsigned int num_goals, bool invert, std::vector<ntc_coord_t>& goals)
+{
+    goals.clear();
+    image_info_t ii;
+    PathBitmap bitmap;
+    if(!read_image_bitmap(path, invert, bitmap, ii))
+        return PATHGEN_INVALID_IMAGE;
+    return generate_goals(bitmap, num_goals, goals);
+}
+
+pathgen_error Path::generate_goals_from_memory(const uint8_t* file, size_t size, unsigned int num_goals, bool invert, std::vector<ntc_coord_t>& goals)
+{
+    goals.clear();
+    image_info_t ii;
+    uint8_t* data = read_image_from_memory(file, size, ii);
+    if(data == nullptr)
+        return PATHGEN_INVALID_IMAGE;
+
+    const pathgen_error err = generate_goals(data, ii, num_goals, invert, goals);
+    free_image(data);
+    return err;
+}
@@ -0,0 +1,82 @@
+#ifndef __pathgen_image_h__
+#define __pathgen_image_h__
+
+#include "pathgen.h"
+
+/*
+*   Image file functions of the path generator library.
+*   Uses stb_image to read the images, therefore stb has to be in the include path when this file is compiled.
+*/
+
+namespace Path
+{
+    /*
+    *   Reads the pixels of any given image file.
+    *   Parameters:
+    *       char* image_path -> Path to the image that should be read.
+    *       image_info_t& image_info -> Reference to a image_info_t struct where the corresponding image information gets written to.
+    *   Return:
+    *       Pixel data of the image, has to be freed with free_image(...).
+    *       'nullptr' if the image could not be read.
+    */
+    uint8_t* read_image(const char* const, image_info_t&);
+
+    /*
+    *   Decodes the pixels of an image file that is already in memory (e.g. to hash the file before it is decoded).
+    *   Parameters:
+    *       const uint8_t* file -> Content of the image file.
+    *       size_t size -> Size of the file in bytes.
+    *       image_info_t& image_info -> Reference to a image_info_t struct where the corresponding image information gets written to.
+    *   Return:
+    *       Pixel data of the image, has to be freed with free_image(...).
+    *       'nullptr' if the image could not be decoded.
+    */
+    uint8_t* read_image_from_memory(const uint8_t*, size_t, image_info_t&);
+
+    /*
+    *   Frees the pixel data that has been returned by read_image(...) or read_image_from_memory(...).
+    */
+    void free_image(uint8_t*);
+
+    /*
+    *   Reads an image file directly into a thresholded image (see threshold_image(...)), the grayscale image is never
+    *   in memory as a whole. Binary PGM and PPM files (P5, P6, 8 bit) are read band by band, so even the image itself
+    *   is never in memory as a whole (e.g. scanned drawings that are bigger than the memory). Every other file is
+    *   decoded with stb and thresholded band by band.
+    *   Parameters:
+    *       char* image_path -> Path to the image that should be read.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       PathBitmap& bitmap -> Gets the thresholded image.
+    *       image_info_t& image_info -> Gets the information of the grayscale image (1 channel).
+    *   Return:
+    *       False if the image could not be read.
+    */
+    bool read_image_bitmap(const char* const, bool, PathBitmap&, image_info_t&);
+
+    /*
+    *   Reads an image file and generates the goals of it (see generate_goals(...)).
+    *   Parameters:
+    *       char* image_path -> Path to the image.
+    *       unsigned int num_goals -> Number of goals that should be generated.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       std::vector<ntc_coord_t>& goals -> Vector where the goals are written to.
+    *   Return:
+    *       PATHGEN_NONE if the goals have been generated, otherwise the reason why it failed.
+    */
+    pathgen_error generate_goals_from_file(const char* const, unsigned int, bool, std::vector<ntc_coord_t>&);
+
+    /*
+    *   The same as generate_goals_from_file(...) for an image file that is already in memory.
+    *   Parameters:
+    *       const uint8_t* file -> Content of the image file.
+    *       size_t size -> Size of the file in bytes.
+    *       unsigned int num_goals -> Number of goals that should be generated.
+    *       bool invert -> Invert the image to be able to use a white background.
+    *       std::vector<ntc_coord_t>& goals -> Vector where the goals are written to.
+    *   Return:
+    *       PATHGEN_NONE if the goals have been generated, otherwise the reason why it failed.
+    */
+    pathgen_error generate_goals_from_memory(const uint8_t*, size_t, unsigned int, bool, std::vector<ntc_coord_t>&);
+};
+
+#endif // __pathgen_image_h__
@@ -0,0 +1,534 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include "polyline.h"
+
+using namespace Path;
+
+constexpr size_t DRAWING_PROBE_SIZE = 4096;     // is_drawing_file(...) reads only this many bytes
+constexpr float CURVE_TOLERANCE = 0.001f;       // maximum distance of a flattened curve to the curve, relative to the size of the curve
+constexpr int MAX_CURVE_SEGMENTS = 256;
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Return: true if the text begins with the word (followed by a space or the end).
+static bool begins_with_word(const char* p, const char* end, const char* word)
+{
+    const size_t n = strlen(word);
+    return (size_t)(end - p) >= n && strncmp(p, word, n) == 0 && (p + n == end || is_space(p[n]));
+}
+
+// Reads a number and moves p behind it, only finite numbers are valid.
+static bool parse_float(const char*& p, float& value)
+{
+    char* end;
+    value = strtof(p, &end);
+    if(end == p || !std::isfinite(value))
+        return false;
+    p = end;
+    return true;
+}
+
+// Skips spaces, tabs and commas (separators of SVG numbers).
+static const char* skip_separators(const char* p)
+{
+    while(is_space(*p) || *p == ',')
+        p++;
+    return p;
+}
+
+bool Path::is_drawing(const uint8_t* file, size_t size)
+{
+    const char* p = (const char*)file;
+    const char* end = p + size;
+    if(size >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0)
+        p += 3;     // UTF-8 BOM
+    while(p < end)
+    {
+        if(is_space(*p))
+            p++;
+        else if(*p == '#')
+        {
+            // Comment line of a polyline text file.
+            while(p < end && *p != '\n')
+                p++;
+        }
+        else
+            return *p == '<' || begins_with_word(p, end, "canvas") || begins_with_word(p, end, "polyline");
+    }
+    return false;
+}
+
+bool Path::is_drawing_file(const char* const path)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr)
+        return false;
+    uint8_t probe[DRAWING_PROBE_SIZE];
+    const size_t n = fread(probe, 1, sizeof(probe), file);
+    fclose(file);
+    return is_drawing(probe, n);
+}
+
+/*
+*   Reads a polyline text file (see polyline.h).
+*   The text has to end with '\0'.
+*/
+static bool read_polyline_text(const char* text, drawing_t& drawing)
+{
+    bool closed = false;
+    auto close_polyline = [&]()
+    {
+        if(closed && drawing.polylines.back().size() > 1)
+            drawing.polylines.back().push_back(drawing.polylines.back().front());
+    };
+
+    const char* p = text;
+    while(*p != '\0')
+    {
+        // one statement per line
+        const char* line_end = strchr(p, '\n');
+        if(line_end == nullptr)
+            line_end = p + strlen(p);
+        while(p < line_end && is_space(*p))
+            p++;
+
+        if(p == line_end || *p == '#')
+            p = line_end;       // empty line or comment
+        else if(begins_with_word(p, line_end, "canvas"))
+        {
+            p += strlen("canvas");
+            if(!parse_float(p, drawing.size.x) || !parse_float(p, drawing.size.y) || drawing.size.x <= 0.0f || drawing.size.y <= 0.0f)
+                return false;
+            drawing.origin = {0.0f, 0.0f};
+        }
+        else if(begins_with_word(p, line_end, "polyline"))
+        {
+            if(!drawing.polylines.empty())
+                close_polyline();
+            p += strlen("polyline");
+            while(p < line_end && is_space(*p))
+                p++;
+            closed = begins_with_word(p, line_end, "closed");
+            if(closed)
+                p += strlen("closed");
+            drawing.polylines.emplace_back();
+        }
+        else
+        {
+            // A point, only inside of a polyline.
+            vec_coord_t point;
+            if(drawing.polylines.empty() || !parse_float(p, point.x) || !parse_float(p, point.y))
+                return false;
+            drawing.polylines.back().push_back(point);
+        }
+
+        // Nothing else may be in the line, strtof has not gone over the end of the line either.
+        while(p < line_end && is_space(*p))
+            p++;
+        if(p != line_end)
+            return false;
+        p = (*line_end == '\0') ? line_end : line_end + 1;
+    }
+    if(!drawing.polylines.empty())
+        close_polyline();
+    return true;
+}
+
+// Appends a cubic Bézier curve (without its first point) as line segments.
+static void flatten_cubic(const vec_coord_t& p0, const vec_coord_t& p1, const vec_coord_t& p2, const vec_coord_t& p3, std::vector<vec_coord_t>& line)
+{
+    /*  Wang's formula: with n segments the distance to the curve is at most 3/4 * M / n^2,
+    *   M is the longest second difference of the control points. The tolerance is relative to the size of the curve,
+    *   so the units of the drawing do not matter.
+    */
+    const float ddx1 = p0.x - 2.0f * p1.x + p2.x, ddy1 = p0.y - 2.0f * p1.y + p2.y;
+    const float ddx2 = p1.x - 2.0f * p2.x + p3.x, ddy2 = p1.y - 2.0f * p2.y + p3.y;
+    const float m = std::max(std::hypot(ddx1, ddy1), std::hypot(ddx2, ddy2));
+    const float size = std::max(std::max({p0.x, p1.x, p2.x, p3.x}) - std::min({p0.x, p1.x, p2.x, p3.x}),
+                                std::max({p0.y, p1.y, p2.y, p3.y}) - std::min({p0.y, p1.y, p2.y, p3.y}));
+    int n = 1;
+    if(size > 0.0f)
+        n = std::min(MAX_CURVE_SEGMENTS, std::max(1, (int)std::ceil(std::sqrt(0.75f * m / (size * CURVE_TOLERANCE)))));
+
+    int i;
+    for(i = 1; i <= n; i++)
+    {
+        const float t = (float)i / (float)n, s = 1.0f - t;
+        const float a = s * s * s, b = 3.0f * s * s * t, c = 3.0f * s * t * t, d = t * t * t;
+        line.push_back({a * p0.x + b * p1.x + c * p2.x + d * p3.x, a * p0.y + b * p1.y + c * p2.y + d * p3.y});
+    }
+}
+
+/*
+*   Reads the path data of a SVG path (the attribute "d") into the polylines of the drawing, every subpath is a polyline.
+*   Return: false if the path data is invalid or has an unsupported command.
+*/
+static bool read_path_data(const char* p, drawing_t& drawing)
+{
+    vec_coord_t cur = {0.0f, 0.0f}, start = {0.0f, 0.0f};
+    vec_coord_t ctrl = {0.0f, 0.0f};    // last control point of the previous curve, for S and T
+    char cmd = 0, prev = 0;             // current command and the previous one (upper case)
+    bool moved = false;
+    std::vector<vec_coord_t>* line = nullptr;
+
+    // Reads a point, relative commands are relative to the current point.
+    auto read_point = [&](const char*& p, bool rel, vec_coord_t& point) -> bool
+    {
+        if(!parse_float(p, point.x) || !parse_float(p = skip_separators(p), point.y))
+            return false;
+        p = skip_separators(p);
+        if(rel)
+        {
+            point.x += cur.x;
+            point.y += cur.y;
+        }
+        return true;
+    };
+    // After a Z the next command continues at the begin of the subpath without a M.
+    auto begin_line = [&]()
+    {
+        if(line == nullptr)
+        {
+            drawing.polylines.push_back({cur});
+            line = &drawing.polylines.back();
+        }
+    };
+
+    while(*(p = skip_separators(p)) != '\0')
+    {
+        if(isalpha((unsigned char)*p))
+            cmd = *p++;
+        else if(cmd == 0)
+            return false;       // a number without a command
+        const bool rel = islower((unsigned char)cmd);
+        const char c = (char)toupper((unsigned char)cmd);
+        if(!moved && c != 'M')
+            return false;       // the path data has to begin with a M
+        p = skip_separators(p);
+
+        vec_coord_t p1, p2, p3;
+        switch(c)
+        {
+            case 'M':
+                if(!read_point(p, rel, p1))
+                    return false;
+                cur = start = p1;
+                moved = true;
+                drawing.polylines.push_back({cur});
+                line = &drawing.polylines.back();
+                cmd = rel ? 'l' : 'L';     // further points are lines
+                break;
+            case 'L':
+                if(!read_point(p, rel, p1))
+                    return false;
+                begin_line();
+                line->push_back(cur = p1);
+                break;
+            case 'H':
+            case 'V':
+            {
+                float value;
+                if(!parse_float(p, value))
+                    return false;
+                p1 = cur;
+                if(c == 'H')
+                    p1.x = rel ? cur.x + value : value;
+                else
+                    p1.y = rel ? cur.y + value : value;
+                begin_line();
+                line->push_back(cur = p1);
+                break;
+            }
+            case 'C':
+            case 'S':
+                // The first control point of S is the reflection of the last one of the previous curve.
+                if(c == 'C' && !read_point(p, rel, p1))
+                    return false;
+                if(c == 'S')
+                    p1 = (prev == 'C' || prev == 'S') ? vec_coord_t{2.0f * cur.x - ctrl.x, 2.0f * cur.y - ctrl.y} : cur;
+                if(!read_point(p, rel, p2) || !read_point(p, rel, p3))
+                    return false;
+                begin_line();
+                flatten_cubic(cur, p1, p2, p3, *line);
+                ctrl = p2;
+                cur = p3;
+                break;
+            case 'Q':
+            case 'T':
+                // A quadratic curve is the cubic curve with the control points 2/3 of the way to the quadratic control point.
+                if(c == 'Q' && !read_point(p, rel, p1))
+                    return false;
+                if(c == 'T')
+                    p1 = (prev == 'Q' || prev == 'T') ? vec_coord_t{2.0f * cur.x - ctrl.x, 2.0f * cur.y - ctrl.y} : cur;
+                if(!read_point(p, rel, p3))
+                    return false;
+                begin_line();
+                flatten_cubic(cur, {cur.x + 2.0f / 3.0f * (p1.x - cur.x), cur.y + 2.0f / 3.0f * (p1.y - cur.y)},
+                              {p3.x + 2.0f / 3.0f * (p1.x - p3.x), p3.y + 2.0f / 3.0f * (p1.y - p3.y)}, p3, *line);
+                ctrl = p1;
+                cur = p3;
+                break;
+            case 'Z':
+                if(line != nullptr && (line->back().x != start.x || line->back().y != start.y))
+                    line->push_back(start);
+                cur = start;
+                line = nullptr;
+                cmd = 0;        // Z has no numbers
+                break;
+            default:
+                return false;   // arcs and unknown commands
+        }
+        prev = c;
+    }
+    return true;
+}
+
+// Reads the value of an attribute of a tag (the quotes are removed), moves p behind the attribute.
+static bool read_attribute(const char*& p, std::string& name, std::string& value)
+{
+    const char* begin = p;
+    while(*p != '\0' && *p != '=' && *p != '>' && *p != '/' && !is_space(*p))
+        p++;
+    name.assign(begin, p);
+    while(is_space(*p))
+        p++;
+    if(name.empty() || *p != '=')
+        return false;
+    p++;
+    while(is_space(*p))
+        p++;
+    const char quote = *p;
+    if(quote != '"' && quote != '\'')
+        return false;
+    const char* value_end = strchr(p + 1, quote);
+    if(value_end == nullptr)
+        return false;
+    value.assign(p + 1, value_end);
+    p = value_end + 1;
+    return true;
+}
+
+/*
+*   Reads a SVG file (see polyline.h).
+*   The text has to end with '\0'.
+*/
+static bool read_svg(const char* text, drawing_t& drawing)
+{
+    bool has_svg = false;
+    std::string name, value;
+    const char* p = text;
+    while((p = strchr(p, '<')) != nullptr)
+    {
+        if(strncmp(p, "<!--", 4) == 0)
+        {
+            // comment
+            p = strstr(p, "-->");
+            if(p == nullptr)
+                return false;
+            continue;
+        }
+        if(p[1] == '?' || p[1] == '!' || p[1] == '/')
+        {
+            // declaration or end tag
+            p++;
+            continue;
+        }
+
+        const char* tag = ++p;
+        while(isalnum((unsigned char)*p) || *p == ':' || *p == '_' || *p == '-')
+            p++;
+        const std::string tag_name(tag, p);
+        const bool is_svg = tag_name == "svg" && !has_svg;
+        const bool is_path = tag_name == "path", is_polyline = tag_name == "polyline", is_polygon = tag_name == "polygon";
+        float svg_width = 0.0f, svg_height = 0.0f;
+        bool has_view_box = false;
+
+        // attributes until the end of the tag
+        while(true)
+        {
+            while(is_space(*p))
+                p++;
+            if(*p == '>' || (p[0] == '/' && p[1] == '>'))
+                break;
+            if(!read_attribute(p, name, value))
+                return false;
+            if(name == "transform")
+                return false;   // the coordinates would have to be transformed
+
+            const char* v = value.c_str();
+            if(is_svg && name == "viewBox")
+            {
+                float box[4];
+                for(float& number : box)
+                {
+                    if(!parse_float(v = skip_separators(v), number))
+                        return false;
+                }
+                if(box[2] <= 0.0f || box[3] <= 0.0f)
+                    return false;
+                drawing.origin = {box[0], box[1]};
+                drawing.size = {box[2], box[3]};
+                has_view_box = true;
+            }
+            else if(is_svg && (name == "width" || name == "height"))
+            {
+                // Only in user units (pixels), other units need a viewBox.
+                float number;
+                if(parse_float(v, number) && (*v == '\0' || strcmp(v, "px") == 0))
+                    (name == "width" ? svg_width : svg_height) = number;
+            }
+            else if(is_path && name == "d")
+            {
+                if(!read_path_data(v, drawing))
+                    return false;
+            }
+            else if((is_polyline || is_polygon) && name == "points")
+            {
+                drawing.polylines.emplace_back();
+                std::vector<vec_coord_t>& line = drawing.polylines.back();
+                vec_coord_t point;
+                while(*(v = skip_separators(v)) != '\0')
+                {
+                    if(!parse_float(v, point.x) || !parse_float(v = skip_separators(v), point.y))
+                        return false;
+                    line.push_back(point);
+                }
+                if(is_polygon && line.size() > 1)
+                    line.push_back(line.front());
+            }
+        }
+        if(is_svg)
+        {
+            has_svg = true;
+            if(!has_view_box && svg_width > 0.0f && svg_height > 0.0f)
+            {
+                drawing.origin = {0.0f, 0.0f};
+                drawing.size = {svg_width, svg_height};
+            }
+        }
+    }
+    return has_svg;
+}
+
+bool Path::read_drawing(const uint8_t* file, size_t size, drawing_t& drawing)
+{
+    drawing = drawing_t();
+    if(!is_drawing(file, size))
+        return false;
+
+    // The parsers need the '\0' at the end (e.g. for strtof).
+    const std::string text((const char*)file, size);
+    if(text.find('\0') != std::string::npos)
+        return false;
+    const char* begin = text.c_str();
+    while(is_space(*begin) || (uint8_t)*begin >= 0x80)
+        begin++;        // spaces and the UTF-8 BOM, a comment of a text file begins with '#'
+    const bool ok = (*begin == '<') ? read_svg(begin, drawing) : read_polyline_text(begin, drawing);
+
+    bool has_point = false;
+    for(const std::vector<vec_coord_t>& line : drawing.polylines)
+        has_point = has_point || !line.empty();
+    return ok && has_point;
+}
+
+bool Path::read_drawing_file(const char* const path, drawing_t& drawing)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr)
+        return false;
+    std::vector<uint8_t> content;
+    uint8_t buffer[65536];
+    size_t n;
+    while((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        content.insert(content.end(), buffer, buffer + n);
+    const bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok && read_drawing(content.data(), content.size(), drawing);
+}
+
+bool Path::gen_drawing_goals(const drawing_t& drawing, unsigned int num_goals, std::vector<ntc_coord_t>& goals)
+{
+    goals.clear();
+
+    // The canvas, without one the bounding box of the points.
+    vec_coord_t origin = drawing.origin, size = drawing.size;
+    if(size.x <= 0.0f || size.y <= 0.0f)
+    {
+        vec_coord_t min = {INFINITY, INFINITY}, max = {-INFINITY, -INFINITY};
+        for(const std::vector<vec_coord_t>& line : drawing.polylines)
+        {
+            for(const vec_coord_t& point : line)
+            {
+                min = {std::min(min.x, point.x), std::min(min.y, point.y)};
+                max = {std::max(max.x, point.x), std::max(max.y, point.y)};
+            }
+        }
+        origin = min;
+        size = {max.x - min.x, max.y - min.y};
+    }
+    // A straight horizontal or vertical drawing without canvas is in the middle of the table.
+    auto to_table = [&](float x, float y) -> ntc_coord_t
+    {
+        return {(size.x > 0.0f) ? (x - origin.x) / size.x : 0.5f, (size.y > 0.0f) ? (y - origin.y) / size.y : 0.5f};
+    };
+
+    double length = 0.0;
+    for(const std::vector<vec_coord_t>& line : drawing.polylines)
+    {
+        for(size_t i = 1; i < line.size(); i++)
+            length += std::hypot((double)line[i].x - line[i - 1].x, (double)line[i].y - line[i - 1].y);
+    }
+    if(num_goals == 0 || num_goals > MAX_DRAWING_GOALS || !(length > 0.0))
+        return false;
+
+    // The goals have the same arc length between each other, walk along the segments.
+    const double spacing = length / num_goals;
+    double next = 0.0;      // arc length of the next goal
+    double walked = 0.0;    // arc length at the begin of the current segment
+    goals.reserve(num_goals + 1);
+    vec_coord_t last = {0.0f, 0.0f};
+    for(const std::vector<vec_coord_t>& line : drawing.polylines)
+    {
+        for(size_t i = 1; i < line.size(); i++)
+        {
+            const vec_coord_t& a = line[i - 1];
+            const vec_coord_t& b = line[i];
+            const double segment = std::hypot((double)b.x - a.x, (double)b.y - a.y);
+            while(goals.size() < num_goals && next < walked + segment)
+            {
+                const float t = (float)((next - walked) / segment);
+                goals.push_back(to_table(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y)));
+                next = spacing * goals.size();
+            }
+            walked += segment;
+            last = b;
+        }
+    }
+    // Rounding can leave out the last goal, it is at the end of the last polyline then.
+    while(goals.size() < num_goals)
+        goals.push_back(to_table(last.x, last.y));
+
+    // Because the vehicle should drive back to the begin where it started.
+    goals.push_back(goals.front());
+    return true;
+}
+
+pathgen_error Path::generate_drawing_goals(const uint8_t* file, size_t size, unsigned int num_goals, bool invert, std::vector<ntc_coord_t>& goals)
+{
+    (void)invert;
+    goals.clear();
+    drawing_t drawing;
+    if(!read_drawing(file, size, drawing))
+        return PATHGEN_INVALID_IMAGE;
+    if(!gen_drawing_goals(drawing, num_goals, goals))
+        return PATHGEN_INVALID_NUM_GOALS;
+    return PATHGEN_NONE;
+}
@@ -0,0 +1,125 @@
+#ifndef __polyline_h__
+#define __polyline_h__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "pathgen.h"
+
+/*
+*   Goals from a vector drawing (polylines) instead of an image.
+*   The goals are sampled from the polylines directly, so a path that has been drawn as vectors does not have to be
+*   rasterized and traced back by gen_path(...): no image in memory, no pixel grid (the goals are exact to the float)
+*   and no thick enough stroke for the trace.
+*   Two file formats are read, the format is found by the content (see is_drawing(...)):
+*       Polyline text file (e.g. ".poly"), one statement per line, '#' starts a comment line:
+*           canvas <width> <height>   -> Optional, size of the drawing (like the size of an image), the point (0, 0) is the
+*                                        upper left corner. Without a canvas the bounding box of the points is used.
+*           polyline [closed]         -> Starts a polyline, "closed" connects its last point with its first one.
+*           <x> <y>                   -> A point of the current polyline.
+*       SVG subset: every <path>, <polyline> and <polygon> element, the canvas is the viewBox of the <svg> element
+*       (or its width and height). The path data can have the commands M, L, H, V, C, S, Q, T and Z (absolute and
+*       relative), the curves are flattened. Arcs (A) and transforms are not supported, such a file is not read.
+*/
+
+namespace Path
+{
+    /*
+    *   A point of a drawing in the units of the drawing (e.g. the pixels of the SVG).
+    */
+    using vec_coord_t = ntc_coord_t;
+
+    /*
+    *   Maximum number of goals of a drawing (8 MB of goals). A path of an image can not have more goals than pixels,
+    *   a drawing has no pixels, so the number of goals (e.g. of a request) is limited by this instead.
+    */
+    constexpr unsigned int MAX_DRAWING_GOALS = 1 << 20;
+
+    /*
+    *   Contains a whole drawing.
+    *   Members:
+    *       polylines -> The polylines in the order of the file, a closed polyline ends with its first point again.
+    *       origin -> Upper left corner of the canvas.
+    *       size -> Size of the canvas, 0 if the file has no canvas (the bounding box of the points is used).
+    */
+    struct drawing_t
+    {
+        std::vector<std::vector<vec_coord_t>> polylines;
+        vec_coord_t origin{0.0f, 0.0f};
+        vec_coord_t size{0.0f, 0.0f};
+    };
+
+    /*
+    *   Determines if the content of a file is a drawing or not (e.g. an image), only the begin of the file is read:
+    *   a polyline text file begins with "canvas" or "polyline" (after comments), a SVG file with '<'.
+    *   Parameters:
+    *       const uint8_t* file -> Content of the file.
+    *       size_t size -> Size of the file in bytes.
+    *   Return:
+    *       True if the file is a drawing.
+    */
+    bool is_drawing(const uint8_t*, size_t);
+
+    /*
+    *   Does the same as the previous function with a file, only the begin of the file is read.
+    *   Parameters:
+    *       char* path -> Path to the file.
+    *   Return:
+    *       True if the file is a drawing, false if it is not or if it could not be opened.
+    */
+    bool is_drawing_file(const char* const);
+
+    /*
+    *   Reads a drawing (see the formats above).
+    *   Parameters:
+    *       const uint8_t* file -> Content of the file.
+    *       size_t size -> Size of the file in bytes.
+    *       drawing_t& drawing -> Gets the drawing (the content gets replaced).
+    *   Return:
+    *       False if the file is not a valid drawing or contains no point.
+    */
+    bool read_drawing(const uint8_t*, size_t, drawing_t&);
+
+    /*
+    *   Does the same as the previous function with a file.
+    *   Parameters:
+    *       char* path -> Path to the file.
+    *       drawing_t& drawing -> Gets the drawing (the content gets replaced).
+    *   Return:
+    *       False if the file could not be read or is not a valid drawing.
+    */
+    bool read_drawing_file(const char* const, drawing_t&);
+
+    /*
+    *   Generates goals from the polylines of a drawing, like gen_goals(...) does it for a path:
+    *   the goals have the same distance along the polylines (their arc length) and the first goal is repeated at the end.
+    *   The polylines are driven in the order of the drawing, the vehicle drives straight from the end of one polyline
+    *   to the begin of the next one (this distance gets no goals).
+    *   The goals are normalized by the canvas (see to_ntc(...)), they are the same as the goals of an image of the
+    *   drawing with the size of the canvas.
+    *   Parameters:
+    *       drawing_t drawing -> The drawing.
+    *       unsigned int num_goals -> Number of goals that should be generated (without the repeated first goal).
+    *       std::vector<ntc_coord_t>& goals -> Vector where the goals are written to (the content gets replaced).
+    *   Return:
+    *       False if the number of goals is 0 or more than MAX_DRAWING_GOALS, or if the polylines have no length.
+    */
+    bool gen_drawing_goals(const drawing_t&, unsigned int, std::vector<ntc_coord_t>&);
+
+    /*
+    *   Runs the whole pipeline for a drawing that is in memory: read and goals.
+    *   Has the same parameters as generate_goals_from_memory(...) (pathgen_image.h), so the both can be used alike.
+    *   Parameters:
+    *       const uint8_t* file -> Content of the file.
+    *       size_t size -> Size of the file in bytes.
+    *       unsigned int num_goals -> Number of goals that should be generated.
+    *       bool invert -> Has no effect, a drawing has no colors.
+    *       std::vector<ntc_coord_t>& goals -> Vector where the goals are written to (the content gets replaced).
+    *   Return:
+    *       PATHGEN_NONE if the goals have been generated, PATHGEN_INVALID_IMAGE if the drawing could not be read,
+    *       PATHGEN_INVALID_NUM_GOALS if the number of goals is 0 or more than MAX_DRAWING_GOALS, or the polylines have no length.
+    */
+    pathgen_error generate_drawing_goals(const uint8_t*, size_t, unsigned int, bool, std::vector<ntc_coord_t>&);
+};
+
+#endif // __polyline_h__
@@ -0,0 +1,301 @@
+/******************************************************************************************************************************************
+* Title:        Polyline benchmark
+* Programtitle: polyline_benchmark
+* Description:
+*   Goals from a vector drawing (polyline.h) compared with the raster route: the drawing is rasterized with a stroke
+*   (like a drawing program exports it) and the image goes through the pipeline (threshold, trace, goals).
+*   Shapes: a circle and a star (polyline text files) and a rounded rectangle (SVG path with curves), each on a canvas
+*   of 2048x1536 and 4096x3072. It prints for every shape and route:
+*       ms         -> Time from the file in memory to the goals (median of the runs), the raster route without and with
+*                     rasterizing the drawing.
+*       max / mean -> Distance of the goals to the drawn polylines in pixels of the canvas (the precision of the goals).
+*   Before that the reading of the drawings is checked: the formats give the same goals for the same shape, the SVG
+*   commands and curves are correct, invalid drawings are not read.
+*
+*   Command syntax:
+*       polyline_benchmark [<number of runs> [<number of goals>]]
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "pathgen.h"
+#include "polyline.h"
+
+constexpr float PI = 3.14159265f;
+
+static Path::pathgen_error generate(const std::string& file, unsigned int num_goals, std::vector<Path::ntc_coord_t>& goals)
+{
+    return Path::generate_drawing_goals((const uint8_t*)file.data(), file.size(), num_goals, false, goals);
+}
+
+static bool read(const std::string& file, Path::drawing_t& drawing)
+{
+    return Path::read_drawing((const uint8_t*)file.data(), file.size(), drawing);
+}
+
+// Return: distance of the point p to the line segment from a to b.
+static float segment_distance(const Path::vec_coord_t& p, const Path::vec_coord_t& a, const Path::vec_coord_t& b)
+{
+    const float abx = b.x - a.x, aby = b.y - a.y, apx = p.x - a.x, apy = p.y - a.y;
+    const float len2 = abx * abx + aby * aby;
+    const float t = (len2 > 0.0f) ? std::min(1.0f, std::max(0.0f, (apx * abx + apy * aby) / len2)) : 0.0f;
+    return std::hypot(apx - t * abx, apy - t * aby);
+}
+
+// Return: distance of the point p to the nearest polyline of the drawing.
+static float drawing_distance(const Path::vec_coord_t& p, const Path::drawing_t& drawing)
+{
+    float distance = INFINITY;
+    for(const std::vector<Path::vec_coord_t>& line : drawing.polylines)
+    {
+        for(size_t i = 1; i < line.size(); i++)
+            distance = std::min(distance, segment_distance(p, line[i - 1], line[i]));
+    }
+    return distance;
+}
+
+static bool same_goals(const std::vector<Path::ntc_coord_t>& a, const std::vector<Path::ntc_coord_t>& b, float tolerance)
+{
+    if(a.size() != b.size())
+        return false;
+    for(size_t i = 0; i < a.size(); i++)
+    {
+        if(std::fabs(a[i].x - b[i].x) > tolerance || std::fabs(a[i].y - b[i].y) > tolerance)
+            return false;
+    }
+    return true;
+}
+
+// Checks the reading of the drawings and the goals.
+static bool check_drawings(void)
+{
+    // detection of the format
+    const std::string not_drawings[] = {"", "P6\n4 4\n255\n", "\x89PNG\r\n\x1a\n", "1 2\n", "polylines\n"};
+    for(const std::string& file : not_drawings)
+    {
+        if(Path::is_drawing((const uint8_t*)file.data(), file.size()))
+            return false;
+    }
+    const std::string drawings[] = {"polyline\n", "# comment\n\n  canvas 1 1\n", "\xEF\xBB\xBF<svg/>", "<?xml version=\"1.0\"?>\n<svg/>"};
+    for(const std::string& file : drawings)
+    {
+        if(!Path::is_drawing((const uint8_t*)file.data(), file.size()))
+            return false;
+    }
+
+    // A square: every corner and the middle of every side is a goal.
+    std::vector<Path::ntc_coord_t> goals, other;
+    const Path::ntc_coord_t square[9] = {{0.0f, 0.0f}, {0.5f, 0.0f}, {1.0f, 0.0f}, {1.0f, 0.5f}, {1.0f, 1.0f}, {0.5f, 1.0f}, {0.0f, 1.0f}, {0.0f, 0.5f}, {0.0f, 0.0f}};
+    if(generate("# square\ncanvas 100 100\npolyline closed\n0 0\n100 0\n100 100\n0 100\n", 8, goals) != Path::PATHGEN_NONE
+       || !same_goals(goals, std::vector<Path::ntc_coord_t>(square, square + 9), 1e-6f))
+        return false;
+
+    // The same square in every format and with every kind of command.
+    const std::string squares[] = {
+        "<svg viewBox=\"0 0 100 100\"><polygon points=\"0,0 100,0 100,100 0,100\"/></svg>",
+        "<svg width=\"100\" height=\"100px\"><!-- <path d=\"M 5 5 L 6 6\"/> --><path d='M0 0L100 0 100 100 0 100Z'/></svg>",
+        "<svg viewBox=\"-10 -10 100 100\"><path d=\"m-10-10 h100 v100 h-100 z\"/></svg>",
+        "<svg viewBox=\"0 0 100 100\"><path d=\"M 0 0 H 100 V 100 L 0 100 L 0 0\"></path></svg>",
+    };
+    for(const std::string& file : squares)
+    {
+        if(generate(file, 8, other) != Path::PATHGEN_NONE || !same_goals(goals, other, 1e-5f))
+            return false;
+    }
+
+    // Curves: a circle of 4 cubic curves, and a quadratic curve with its reflection (T).
+    const float k = 80.0f * 0.5522847f;
+    char circle[512];
+    snprintf(circle, sizeof(circle), "<svg viewBox=\"0 0 200 200\"><path d=\"M180 100 C180 %f %f 180 100 180 S20 %f 20 100 c0 %f %f %f 80 %f s80 %f 80 %f\"/></svg>",
+             100 + k, 100 + k, 100 + k, -k, 80 - k, -80.0f, -80.0f, 80 - k, 80.0f);
+    if(generate(circle, 200, goals) != Path::PATHGEN_NONE)
+        return false;
+    for(const Path::ntc_coord_t& goal : goals)
+    {
+        if(std::fabs(std::hypot(goal.x * 200.0f - 100.0f, goal.y * 200.0f - 100.0f) - 80.0f) > 0.15f)
+            return false;
+    }
+    Path::drawing_t drawing;
+    if(!read("<svg><path d=\"M0 0 Q5 10 10 0 T20 0\"/></svg>", drawing) || drawing.polylines.size() != 1
+       || drawing_distance({5.0f, 5.0f}, drawing) > 0.01f || drawing_distance({15.0f, -5.0f}, drawing) > 0.01f
+       || drawing.polylines[0].back().x != 20.0f || drawing.polylines[0].back().y != 0.0f)
+        return false;
+
+    // Invalid drawings and numbers of goals.
+    const std::string invalid[] = {
+        "polyline\n1 2 3\n", "canvas 0 10\npolyline\n0 0\n1 1\n", "0 0\npolyline\n", "polyline\n",
+        "<svg><path d=\"M0 0 A5 5 0 0 1 10 10\"/></svg>", "<svg><path d=\"L1 1\"/></svg>", "<svg><path d=\"M0 0 L1\"/></svg>",
+        "<svg><g transform=\"scale(2)\"><path d=\"M0 0 L1 1\"/></g></svg>", "<path d=\"M0 0 L1 1\"/>", "<svg><path d=\"M0 0 L1 1/></svg>",
+    };
+    for(const std::string& file : invalid)
+    {
+        if(read(file, drawing))
+            return false;
+    }
+    return generate("polyline\n0 0\n1 1\n", 0, goals) == Path::PATHGEN_INVALID_NUM_GOALS
+           && generate("polyline\n0 0\n1 1\n", Path::MAX_DRAWING_GOALS + 1, goals) == Path::PATHGEN_INVALID_NUM_GOALS
+           && generate("polyline\n0 0\n1 1\n", 0xFFFFFFFFu, goals) == Path::PATHGEN_INVALID_NUM_GOALS
+           && generate("polyline\n0 0\n1 1\n", Path::MAX_DRAWING_GOALS, goals) == Path::PATHGEN_NONE && goals.size() == Path::MAX_DRAWING_GOALS + 1
+           && generate("polyline\n5 5\n", 10, goals) == Path::PATHGEN_INVALID_NUM_GOALS
+           && generate("<svg><polyline points=\"0 0\"/><path d=\"M3 3 L3 9\"/></svg>", 2, goals) == Path::PATHGEN_NONE
+           && same_goals(goals, {{1.0f, 1.0f / 3.0f}, {1.0f, 2.0f / 3.0f}, {1.0f, 1.0f / 3.0f}}, 1e-6f);    // the point is in the bounding box
+}
+
+// Rasterizes the polylines of a drawing with a round stroke (white on black, RGB) like a drawing program exports it.
+static void rasterize(const Path::drawing_t& drawing, const Path::image_info_t& ii, float radius, std::vector<uint8_t>& data)
+{
+    data.assign((size_t)ii.width * ii.height * ii.channels, 0);
+    for(const std::vector<Path::vec_coord_t>& line : drawing.polylines)
+    {
+        for(size_t i = 1; i < line.size(); i++)
+        {
+            const Path::vec_coord_t& a = line[i - 1];
+            const Path::vec_coord_t& b = line[i];
+            const int x0 = std::max(0, (int)std::floor(std::min(a.x, b.x) - radius)), x1 = std::min(ii.width - 1, (int)std::ceil(std::max(a.x, b.x) + radius));
+            const int y0 = std::max(0, (int)std::floor(std::min(a.y, b.y) - radius)), y1 = std::min(ii.height - 1, (int)std::ceil(std::max(a.y, b.y) + radius));
+            for(int y = y0; y <= y1; y++)
+            {
+                for(int x = x0; x <= x1; x++)
+                {
+                    if(segment_distance({x + 0.5f, y + 0.5f}, a, b) <= radius)
+                        memset(&data[Path::img_at(x, y, ii)], 255, ii.channels);
+                }
+            }
+        }
+    }
+}
+
+// The shapes of the benchmark on a canvas, as polyline text file or SVG file.
+static std::string gen_shape(int shape, int width, int height)
+{
+    const float cx = width / 2.0f, cy = height / 2.0f, size = std::min(width, height);
+    std::string file = "canvas " + std::to_string(width) + " " + std::to_string(height) + "\npolyline closed\n";
+    char line[128];
+    if(shape == 0)
+    {
+        // circle
+        for(int i = 0; i < 1440; i++)
+        {
+            snprintf(line, sizeof(line), "%.3f %.3f\n", cx + 0.38f * size * std::cos(2.0f * PI * i / 1440), cy + 0.38f * size * std::sin(2.0f * PI * i / 1440));
+            file += line;
+        }
+    }
+    else if(shape == 1)
+    {
+        // star with 5 points
+        for(int i = 0; i < 10; i++)
+        {
+            const float r = ((i % 2) ? 0.18f : 0.42f) * size, angle = PI * i / 5 - PI / 2;
+            snprintf(line, sizeof(line), "%.3f %.3f\n", cx + r * std::cos(angle), cy + r * std::sin(angle));
+            file += line;
+        }
+    }
+    else
+    {
+        // rounded rectangle, the corners are cubic curves
+        const float w = 0.35f * width, h = 0.35f * height, r = 0.1f * size, k = r * 0.5522847f;
+        snprintf(line, sizeof(line), "<svg viewBox=\"0 0 %d %d\"><path d=\"", width, height);
+        file = line;
+        snprintf(line, sizeof(line), "M%.3f %.3f H%.3f c%.3f 0 %.3f %.3f %.3f %.3f ", cx - w + r, cy - h, cx + w - r, k, r, r - k, r, r);
+        file += line;
+        snprintf(line, sizeof(line), "V%.3f c0 %.3f %.3f %.3f %.3f %.3f ", cy + h - r, k, k - r, r, -r, r);
+        file += line;
+        snprintf(line, sizeof(line), "H%.3f c%.3f 0 %.3f %.3f %.3f %.3f ", cx - w + r, -k, -r, k - r, -r, -r);
+        file += line;
+        snprintf(line, sizeof(line), "V%.3f c0 %.3f %.3f %.3f %.3f %.3f Z\"/></svg>", cy - h + r, -k, r - k, -r, r, -r);
+        file += line;
+    }
+    return file;
+}
+
+// Return: the maximum and mean distance of the goals to the drawing in pixels of the canvas.
+static void deviation(const std::vector<Path::ntc_coord_t>& goals, const Path::drawing_t& drawing, const Path::image_info_t& ii, float& max, float& mean)
+{
+    max = mean = 0.0f;
+    for(const Path::ntc_coord_t& goal : goals)
+    {
+        const float distance = drawing_distance({goal.x * ii.width, goal.y * ii.height}, drawing);
+        max = std::max(max, distance);
+        mean += distance / goals.size();
+    }
+}
+
+static double median(std::vector<double>& values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main(int argc, char** argv)
+{
+    const int runs = (argc > 1) ? atoi(argv[1]) : 5;
+    const unsigned int num_goals = (argc > 2) ? (unsigned int)atoi(argv[2]) : 200;
+    if(!check_drawings())
+    {
+        printf("[ERROR] A drawing has not been read correctly.\n");
+        return -1;
+    }
+
+    const char* const shape_names[3] = {"circle", "star", "rounded rectangle"};
+    const Path::image_info_t sizes[2] = {{2048, 1536, 3}, {4096, 3072, 3}};
+    std::vector<uint8_t> data;
+    std::vector<Path::ntc_coord_t> goals;
+    printf("shape,canvas,route,ms,ms with rasterizing,max px,mean px,speedup\n");
+    for(const Path::image_info_t& ii : sizes)
+    {
+        for(int shape = 0; shape < 3; shape++)
+        {
+            const std::string file = gen_shape(shape, ii.width, ii.height);
+            Path::drawing_t drawing;
+            read(file, drawing);
+            const float stroke = std::max(3.0f, ii.width / 256.0f);
+
+            // vector route
+            std::vector<double> vector_ms(runs), raster_ms(runs), render_ms(runs);
+            for(int i = 0; i < runs; i++)
+            {
+                const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+                if(generate(file, num_goals, goals) != Path::PATHGEN_NONE)
+                {
+                    printf("[ERROR] No goals for the drawing of the %s.\n", shape_names[shape]);
+                    return -1;
+                }
+                vector_ms[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            }
+            float vector_max, vector_mean;
+            deviation(goals, drawing, ii, vector_max, vector_mean);
+
+            // raster route
+            for(int i = 0; i < runs; i++)
+            {
+                const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+                Path::drawing_t parsed;
+                read(file, parsed);
+                rasterize(parsed, ii, stroke / 2.0f, data);
+                const std::chrono::time_point t1 = std::chrono::steady_clock::now();
+                if(Path::generate_goals(data.data(), ii, num_goals, false, goals) != Path::PATHGEN_NONE)
+                {
+                    printf("[ERROR] No goals for the image of the %s.\n", shape_names[shape]);
+                    return -1;
+                }
+                const std::chrono::time_point t2 = std::chrono::steady_clock::now();
+                render_ms[i] = std::chrono::duration<double, std::milli>(t1 - t0).count();
+                raster_ms[i] = std::chrono::duration<double, std::milli>(t2 - t1).count();
+            }
+            float raster_max, raster_mean;
+            deviation(goals, drawing, ii, raster_max, raster_mean);
+
+            const double vector_med = median(vector_ms), raster_med = median(raster_ms), render_med = median(render_ms);
+            printf("%s,%dx%d,vector,%.3f,%.3f,%.3f,%.3f,1.0x\n", shape_names[shape], ii.width, ii.height, vector_med, vector_med, vector_max, vector_mean);
+            printf("%s,%dx%d,raster (stroke %.0f px),%.3f,%.3f,%.3f,%.3f,%.1fx slower\n", shape_names[shape], ii.width, ii.height, stroke,
+                   raster_med, raster_med + render_med, raster_max, raster_mean, raster_med / vector_med);
+        }
+    }
+    return 0;
+}
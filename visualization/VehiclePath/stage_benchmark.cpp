@@ -0,0 +1,409 @@
+/******************************************************************************************************************************************
+* Title:        Stage benchmark
+* Programtitle: stage_benchmark
+* Description:
+*   Runs every stage of the path generator N times on a generated corpus and compares the times with a stored baseline.
+*   Corpus (RGB, every image at 1024x768, 2048x1536 and 4096x3072 pixels):
+*       spiral  -> A thick double spiral (in and out again), a long path with tight curves in the middle.
+*       maze    -> The corridors of a random maze, a long path with many corners and dead ends.
+*       scan    -> A dark ring on slightly yellow paper with noise and dust, like a scanned drawing (inverted).
+*   Stages (like the stages that pathgenerator measures):
+*       read        -> Reading the binary .ppm file of the image (no decoding, like read_ppm of pathgen_benchmark).
+*       convert     -> Grayscale and invert in one pass (preprocess).
+*       threshold   -> Thresholding into the bitmap (PathBitmap::binarize).
+*       path        -> Tracing the path (gen_path).
+*       goals       -> Goals of the path (gen_goals, 100 goals or one per path pixel).
+*       write       -> Writing the binary goal file (write_goalfile).
+*   Output (CSV): min, median and 95th percentile of every stage in milliseconds. With a baseline (a CSV file of an earlier
+*   run, see -save) every median is compared with the median of the baseline: the stage regressed if it is more than
+*   <threshold> times slower (and more than 0.05 ms, so short stages don't fail because of noise). The program fails
+*   (returns -1) if at least one stage regressed.
+*   The times depend on the machine, so there is no baseline in the repository: it has to be saved with -save on the machine
+*   that is compared. A stage without a baseline has the status "no baseline" and is not compared, the program says at the
+*   end how many stages have not been compared.
+*
+*   Command syntax:
+*       stage_benchmark [-runs <number of runs>] [-baseline <baseline .csv>] [-save <output .csv>] [-threshold <factor>]
+*   Defaults: 20 runs, no baseline, threshold 1.25 (25% slower).
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "pathgen.h"
+#include "goalfile.h"
+
+constexpr unsigned int NUM_GOALS = 100;
+constexpr double MIN_REGRESSION_MS = 0.05;      // smaller differences are noise
+const char* const STAGES[] = {"read", "convert", "threshold", "path", "goals", "write"};
+constexpr int NUM_STAGES = sizeof(STAGES) / sizeof(STAGES[0]);
+
+// A small random generator (xorshift), the corpus is the same on every run and every platform.
+struct Random
+{
+    uint32_t state;
+    uint32_t next(void) noexcept
+    {
+        this->state ^= this->state << 13;
+        this->state ^= this->state >> 17;
+        this->state ^= this->state << 5;
+        return this->state;
+    }
+};
+
+// Sets a pixel of an RGB image (every channel).
+static void set_pixel(std::vector<uint8_t>& data, const Path::image_info_t& ii, int x, int y, uint8_t value)
+{
+    if(x < 0 || y < 0 || x >= ii.width || y >= ii.height)
+        return;
+    uint8_t* pixel = &data[Path::img_at(x, y, ii)];
+    pixel[0] = pixel[1] = pixel[2] = value;
+}
+
+// Draws a filled circle (the brush of the lines).
+static void draw_dot(std::vector<uint8_t>& data, const Path::image_info_t& ii, float cx, float cy, float r, uint8_t value)
+{
+    for(int y = (int)std::floor(cy - r); y <= (int)std::ceil(cy + r); y++)
+    {
+        for(int x = (int)std::floor(cx - r); x <= (int)std::ceil(cx + r); x++)
+        {
+            if((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+                set_pixel(data, ii, x, y, value);
+        }
+    }
+}
+
+// Draws a thick line from (x0, y0) to (x1, y1).
+static void draw_line(std::vector<uint8_t>& data, const Path::image_info_t& ii, float x0, float y0, float x1, float y1, float r, uint8_t value)
+{
+    const int steps = std::max(1, (int)std::ceil(std::hypot(x1 - x0, y1 - y0) / std::max(1.0f, r * 0.5f)));
+    for(int i = 0; i <= steps; i++)
+        draw_dot(data, ii, x0 + (x1 - x0) * i / steps, y0 + (y1 - y0) * i / steps, r, value);
+}
+
+// Two interleaved arms of an Archimedean spiral, joined in the middle and on the outside (one long closed band).
+static std::vector<uint8_t> gen_spiral(const Path::image_info_t& ii)
+{
+    std::vector<uint8_t> data((size_t)ii.width * ii.height * 3, 0);
+    const float cx = ii.width / 2.0f, cy = ii.height / 2.0f;
+    const float max_r = std::min(ii.width, ii.height) * 0.4f, turns = 4.0f;
+    const float brush = std::max(3.0f, ii.width / 256.0f);
+    const float step = 0.5f / (max_r * turns * 6.2831853f);
+    auto point = [&](float t, int arm, float& x, float& y)
+    {
+        const float r = max_r * (0.05f + 0.95f * t), a = t * turns * 6.2831853f + arm * 3.1415927f;
+        x = cx + r * std::cos(a);
+        y = cy + r * std::sin(a);
+    };
+    // The first arm goes half a turn further, so both arms end at the same angle.
+    float t, x, y, x1, y1;
+    for(int arm = 0; arm < 2; arm++)
+    {
+        for(t = 0.0f; t <= 1.0f + ((arm == 0) ? 0.5f / turns : 0.0f); t += step)
+        {
+            point(t, arm, x, y);
+            draw_dot(data, ii, x, y, brush, 255);
+        }
+    }
+    point(0.0f, 0, x, y);
+    point(0.0f, 1, x1, y1);
+    draw_line(data, ii, x, y, x1, y1, brush, 255);
+    point(1.0f + 0.5f / turns, 0, x, y);
+    point(1.0f, 1, x1, y1);
+    draw_line(data, ii, x, y, x1, y1, brush, 255);
+    return data;
+}
+
+// The corridors of a random maze (depth first search): a tree of corridors with many corners and dead ends.
+static std::vector<uint8_t> gen_maze(const Path::image_info_t& ii)
+{
+    std::vector<uint8_t> data((size_t)ii.width * ii.height * 3, 0);
+    const int cells_x = 24, cells_y = 18;
+    const float cell = std::min((ii.width - 8.0f) / cells_x, (ii.height - 8.0f) / cells_y);
+    const float ox = (ii.width - cell * cells_x) / 2.0f + cell / 2.0f, oy = (ii.height - cell * cells_y) / 2.0f + cell / 2.0f;
+    const float brush = cell / 5.0f;
+
+    std::vector<bool> visited(cells_x * cells_y, false);
+    std::vector<int> stack = {0};
+    visited[0] = true;
+    Random random = {12345};
+    while(!stack.empty())
+    {
+        const int c = stack.back(), x = c % cells_x, y = c / cells_x;
+        int next[4], num_next = 0;
+        if(x > 0 && !visited[c - 1]) next[num_next++] = c - 1;
+        if(x + 1 < cells_x && !visited[c + 1]) next[num_next++] = c + 1;
+        if(y > 0 && !visited[c - cells_x]) next[num_next++] = c - cells_x;
+        if(y + 1 < cells_y && !visited[c + cells_x]) next[num_next++] = c + cells_x;
+        if(num_next == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+        // The corridor from the center of the cell to the center of the next cell.
+        const int n = next[random.next() % num_next];
+        draw_line(data, ii, ox + cell * x, oy + cell * y, ox + cell * (n % cells_x), oy + cell * (n / cells_x), brush, 255);
+        visited[n] = true;
+        stack.push_back(n);
+    }
+    return data;
+}
+
+// A dark ring on gray paper with noise and dust, inverted by the pipeline.
+static std::vector<uint8_t> gen_scan(const Path::image_info_t& ii)
+{
+    std::vector<uint8_t> data((size_t)ii.width * ii.height * 3);
+    Random random = {987654321};
+    const float cx = ii.width / 2.0f, cy = ii.height / 2.0f;
+    const float rx = ii.width * 0.4f, ry = ii.height * 0.4f, thickness = 0.04f;
+    for(int y = 0; y < ii.height; y++)
+    {
+        for(int x = 0; x < ii.width; x++)
+        {
+            const float dx = (x - cx) / rx, dy = (y - cy) / ry, d = std::sqrt(dx * dx + dy * dy);
+            const int noise = (int)(random.next() % 5) - 2;
+            const int paper = 252 - (int)(2.0f * y / ii.height);      // a bit darker at the bottom, inverted still below the threshold
+            const int value = (std::fabs(d - 1.0f) < thickness) ? 40 + noise * 6 : paper + noise;
+            uint8_t* pixel = &data[Path::img_at(x, y, ii)];
+            pixel[0] = (uint8_t)std::min(255, value + 4);               // a bit yellow
+            pixel[1] = (uint8_t)std::min(255, value + 2);
+            pixel[2] = (uint8_t)std::max(0, value - 6);
+        }
+    }
+    // Dust: small light gray dots on the paper (below the threshold too).
+    for(int i = 0; i < ii.width * ii.height / 20000; i++)
+        draw_dot(data, ii, (float)(random.next() % ii.width), (float)(random.next() % ii.height), 1.0f + random.next() % 2, 248);
+    return data;
+}
+
+static bool write_ppm(const char* path, const std::vector<uint8_t>& data, const Path::image_info_t& ii)
+{
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr)
+        return false;
+    fprintf(file, "P6\n%d %d\n255\n", ii.width, ii.height);
+    const bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    return ok;
+}
+
+static bool read_ppm(const char* path, std::vector<uint8_t>& data, Path::image_info_t& ii)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr)
+        return false;
+    int max_value;
+    bool ok = fscanf(file, "P6 %d %d %d", &ii.width, &ii.height, &max_value) == 3 && fgetc(file) != EOF;
+    if(ok)
+    {
+        ii.channels = 3;
+        data.resize((size_t)ii.width * ii.height * 3);
+        ok = fread(data.data(), 1, data.size(), file) == data.size();
+    }
+    fclose(file);
+    return ok;
+}
+
+/*
+*   Times of one stage.
+*   Members:
+*       min, median, p95 -> Minimum, median and 95th percentile of the runs in milliseconds.
+*/
+struct stage_time_t
+{
+    double min, median, p95;
+};
+
+static stage_time_t statistics(std::vector<double> ms)
+{
+    std::sort(ms.begin(), ms.end());
+    const size_t n = ms.size();
+    const double median = (n % 2) ? ms[n / 2] : (ms[n / 2 - 1] + ms[n / 2]) / 2.0;
+    // nearest rank
+    const size_t p95 = std::min(n - 1, (size_t)std::ceil(0.95 * n) - 1);
+    return {ms[0], median, ms[p95]};
+}
+
+/*
+*   Reads the medians of a baseline (CSV of an earlier run).
+*   Return: false if the file could not be read.
+*/
+static bool read_baseline(const char* path, std::map<std::string, double>& medians)
+{
+    FILE* file = fopen(path, "r");
+    if(file == nullptr)
+        return false;
+    char line[512];
+    while(fgets(line, sizeof(line), file) != nullptr)
+    {
+        // image,resolution,stage,runs,min,median,...
+        char image[64], resolution[64], stage[64];
+        int runs;
+        double min, median;
+        if(sscanf(line, "%63[^,],%63[^,],%63[^,],%d,%lf,%lf", image, resolution, stage, &runs, &min, &median) == 6)
+            medians[std::string(image) + "," + resolution + "," + stage] = median;
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int runs = 20;
+    double threshold = 1.25;
+    const char* baseline_path = nullptr;
+    const char* save_path = nullptr;
+    int i;
+    for(i = 1; i < argc; i++)
+    {
+        if(i + 1 < argc && strcmp(argv[i], "-runs") == 0)
+            runs = atoi(argv[++i]);
+        else if(i + 1 < argc && strcmp(argv[i], "-baseline") == 0)
+            baseline_path = argv[++i];
+        else if(i + 1 < argc && strcmp(argv[i], "-save") == 0)
+            save_path = argv[++i];
+        else if(i + 1 < argc && strcmp(argv[i], "-threshold") == 0)
+            threshold = atof(argv[++i]);
+        else
+        {
+            printf("[ERROR] Invalid argument: \"%s\"\n", argv[i]);
+            return -1;
+        }
+    }
+    if(runs < 1 || threshold <= 0.0)
+    {
+        printf("[ERROR] The number of runs and the threshold have to be greater than 0.\n");
+        return -1;
+    }
+
+    std::map<std::string, double> baseline;
+    if(baseline_path != nullptr && !read_baseline(baseline_path, baseline))
+    {
+        printf("[ERROR] Could not read baseline: \"%s\"\n", baseline_path);
+        return -1;
+    }
+    FILE* save = nullptr;
+    if(save_path != nullptr && (save = fopen(save_path, "w")) == nullptr)
+    {
+        printf("[ERROR] Could not open: \"%s\"\n", save_path);
+        return -1;
+    }
+
+    const struct {const char* name; std::vector<uint8_t>(*gen)(const Path::image_info_t&); bool invert;} corpus[] = {
+        {"spiral", gen_spiral, false}, {"maze", gen_maze, false}, {"scan", gen_scan, true}
+    };
+    const struct {int width, height;} sizes[] = {{1024, 768}, {2048, 1536}, {4096, 3072}};
+    const char* ppm_path = "stage_benchmark.ppm";
+    const char* goal_path = "stage_benchmark.sgol";
+
+    const char* header = "image,resolution,stage,runs,min ms,median ms,p95 ms,baseline ms,ratio,status\n";
+    printf("%s", header);
+    if(save != nullptr)
+        fprintf(save, "%s", header);
+    int regressions = 0, not_compared = 0;
+    for(const auto& image : corpus)
+    {
+        for(const auto& size : sizes)
+        {
+            const Path::image_info_t ii = {size.width, size.height, 3};
+            if(!write_ppm(ppm_path, image.gen(ii), ii))
+            {
+                printf("[ERROR] Could not write: \"%s\"\n", ppm_path);
+                return -1;
+            }
+
+            // The buffers are used again in every run, so the times don't depend on page faults of new memory.
+            std::vector<double> ms[NUM_STAGES];
+            std::vector<uint8_t> data, gray((size_t)ii.width * ii.height);
+            Path::PathBitmap bitmap;
+            std::vector<Path::img_coord_t> path;
+            std::vector<Path::goal_coord_t> goals;
+            std::vector<Path::ntc_coord_t> ntc_goals;
+            for(int run = 0; run < runs; run++)
+            {
+                std::chrono::time_point t0 = std::chrono::steady_clock::now();
+                auto lap = [&](int stage)
+                {
+                    const std::chrono::time_point t1 = std::chrono::steady_clock::now();
+                    ms[stage].push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+                    t0 = t1;
+                };
+
+                Path::image_info_t file_ii;
+                if(!read_ppm(ppm_path, data, file_ii))
+                {
+                    printf("[ERROR] Could not read: \"%s\"\n", ppm_path);
+                    return -1;
+                }
+                lap(0);
+                Path::preprocess(data.data(), file_ii, image.invert, gray.data());
+                lap(1);
+                bitmap.binarize(gray.data(), {ii.width, ii.height, 1}, Path::PATH_THRESHOLD);
+                lap(2);
+                path.clear();
+                Path::gen_path(bitmap, path);
+                lap(3);
+                goals.clear();
+                ntc_goals.clear();
+                if(!Path::gen_goals(path, goals, std::min<size_t>(NUM_GOALS, path.size())))
+                {
+                    printf("[ERROR] No path in %s %dx%d.\n", image.name, ii.width, ii.height);
+                    return -1;
+                }
+                Path::to_ntc(goals, ii, ntc_goals);
+                lap(4);
+                if(!Path::write_goalfile(goal_path, 0, ntc_goals))
+                {
+                    printf("[ERROR] Could not write: \"%s\"\n", goal_path);
+                    return -1;
+                }
+                lap(5);
+            }
+
+            char key[192];
+            for(int stage = 0; stage < NUM_STAGES; stage++)
+            {
+                const stage_time_t t = statistics(ms[stage]);
+                snprintf(key, sizeof(key), "%s,%dx%d,%s", image.name, ii.width, ii.height, STAGES[stage]);
+                char line[512];
+                const auto base = baseline.find(key);
+                if(base == baseline.end())
+                {
+                    not_compared++;
+                    snprintf(line, sizeof(line), "%s,%d,%.3f,%.3f,%.3f,,,no baseline\n", key, runs, t.min, t.median, t.p95);
+                }
+                else
+                {
+                    const bool regressed = t.median > base->second * threshold && t.median - base->second > MIN_REGRESSION_MS;
+                    regressions += regressed;
+                    snprintf(line, sizeof(line), "%s,%d,%.3f,%.3f,%.3f,%.3f,%.2f,%s\n", key, runs, t.min, t.median, t.p95, base->second,
+                             (base->second > 0.0) ? t.median / base->second : 0.0, regressed ? "REGRESSED" : "ok");
+                }
+                printf("%s", line);
+                if(save != nullptr)
+                    fprintf(save, "%s", line);
+            }
+        }
+    }
+    remove(ppm_path);
+    remove(goal_path);
+    if(save != nullptr)
+        fclose(save);
+
+    if(baseline_path == nullptr)
+        printf("[INFO] No baseline given, the times have not been compared (save one with -save, compare with -baseline).\n");
+    else if(not_compared > 0)
+        printf("[WARNING] %d stages are not in the baseline \"%s\", they have not been compared.\n", not_compared, baseline_path);
+    if(regressions > 0)
+    {
+        printf("[ERROR] %d stages regressed more than %.0f%%.\n", regressions, (threshold - 1.0) * 100.0);
+        return -1;
+    }
+    return 0;
+}
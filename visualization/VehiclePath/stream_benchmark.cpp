@@ -0,0 +1,212 @@
+/******************************************************************************************************************************************
+* Title:        Banded thresholding benchmark
+* Programtitle: stream_benchmark
+* Description:
+*   Compares the peak memory (peak RSS) and the runtime of the pipeline (grayscale, invert, threshold, path and goals)
+*   for very large images (default 20000x20000 RGB pixels):
+*       full    -> The pipeline before the banded thresholding: the whole image (like read_image(...) returns it),
+*                  the whole grayscale image (preprocess(...)) and the bitmap are in memory.
+*       memory  -> generate_goals(...): the whole image is in memory, the grayscale image is converted band by band.
+*       stream  -> threshold_stream(...): the image is made row by row (like a file that is read band by band,
+*                  see read_image_bitmap(...)), only the bitmap and one band are in memory.
+*   The image is a synthetic drawing: a thick ring on a white background (inverted), so every mode has the same path.
+*   Every mode runs in its own process (the program calls itself), because the peak RSS of a process never decreases.
+*   The goals of every mode have to be the same as the goals of the first mode.
+*
+*   Command syntax:
+*       stream_benchmark [<size in pixels>]
+*       stream_benchmark <size in pixels> <full | memory | stream>    (one mode, called by the program itself)
+******************************************************************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "pathgen.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <psapi.h>
+    #define popen _popen
+    #define pclose _pclose
+#else
+    #include <sys/resource.h>
+#endif
+
+constexpr unsigned int NUM_GOALS = 64;
+
+// Return: peak memory (peak resident set size) of the process in MiB.
+static double peak_rss_mib(void)
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0.0;
+    return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #if defined(__APPLE__)
+        return usage.ru_maxrss / (1024.0 * 1024.0);     // bytes
+    #else
+        return usage.ru_maxrss / 1024.0;                // KiB
+    #endif
+#endif
+}
+
+/*
+*   Makes one row of the synthetic RGB image: a black ring (thickness 1% of the size) on a white background.
+*   Parameters:
+*       uint8_t* row -> Gets the pixels of the row.
+*       int y -> Row of the image.
+*       int size -> Width and height of the image.
+*/
+static void gen_row(uint8_t* row, int y, int size)
+{
+    memset(row, 240, (size_t)size * 3);
+    const double c = size / 2.0, outer = size * 0.4, inner = outer - std::max(4, size / 100);
+    const double dy = y + 0.5 - c;
+    if(std::fabs(dy) >= outer)
+        return;
+    // Pixels whose center is inside of the outer circle and outside of the inner circle.
+    const double wo = std::sqrt(outer * outer - dy * dy);
+    const double wi = (std::fabs(dy) < inner) ? std::sqrt(inner * inner - dy * dy) : 0.0;
+    const int xo0 = (int)std::ceil(c - wo - 0.5), xo1 = (int)std::floor(c + wo - 0.5);
+    const int xi0 = (int)std::ceil(c - wi - 0.5), xi1 = (int)std::floor(c + wi - 0.5);
+    int x;
+    for(x = std::max(0, xo0); x <= std::min(size - 1, xo1); x++)
+    {
+        if(wi > 0.0 && x >= xi0 && x <= xi1)
+            continue;
+        row[3 * x] = 20;
+        row[3 * x + 1] = 10;
+        row[3 * x + 2] = 30;
+    }
+}
+
+// Return: a checksum of the goals (FNV-1a of the coordinates).
+static uint64_t checksum(const std::vector<Path::ntc_coord_t>& goals)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* bytes = (const uint8_t*)goals.data();
+    for(size_t i = 0; i < goals.size() * sizeof(Path::ntc_coord_t); i++)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+// Runs one mode and prints: mode, image ms, pipeline ms, peak RSS MiB, number of goals, checksum.
+static int run_mode(int size, const char* mode)
+{
+    const Path::image_info_t ii = {size, size, 3};
+    const size_t row_size = (size_t)size * 3;
+    std::vector<Path::ntc_coord_t> goals;
+    Path::pathgen_error err;
+    double image_ms = 0.0;
+    const std::chrono::time_point t0 = std::chrono::steady_clock::now();
+
+    if(strcmp(mode, "stream") == 0)
+    {
+        // The rows are made when they are read, like a file that is decoded row by row.
+        auto read_rows = [&](uint8_t* rows, int y, int num_rows) -> bool
+        {
+            const std::chrono::time_point t = std::chrono::steady_clock::now();
+            for(int r = 0; r < num_rows; r++)
+                gen_row(rows + r * row_size, y + r, size);
+            image_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+            return true;
+        };
+        Path::PathBitmap bitmap;
+        if(!Path::threshold_stream(read_rows, ii, true, bitmap))
+            return -1;
+        err = Path::generate_goals(bitmap, NUM_GOALS, goals);
+    }
+    else
+    {
+        uint8_t* data = new uint8_t[row_size * size];
+        for(int y = 0; y < size; y++)
+            gen_row(data + y * row_size, y, size);
+        image_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        if(strcmp(mode, "memory") == 0)
+            err = Path::generate_goals(data, ii, NUM_GOALS, true, goals);
+        else if(strcmp(mode, "full") == 0)
+        {
+            // The pipeline before the banded thresholding (the whole grayscale image, then the bitmap).
+            Path::image_info_t gray_ii = ii;
+            uint8_t* gray = Path::preprocess(data, gray_ii, true);
+            std::vector<Path::img_coord_t> path;
+            Path::gen_path(gray, path, gray_ii);
+            delete[](gray);
+            std::vector<Path::goal_coord_t> goal_pixels;
+            err = Path::gen_goals(path, goal_pixels, NUM_GOALS) ? Path::PATHGEN_NONE : Path::PATHGEN_INVALID_NUM_GOALS;
+            Path::to_ntc(goal_pixels, gray_ii, goals);
+        }
+        else
+        {
+            delete[](data);
+            printf("[ERROR] Invalid mode: \"%s\"\n", mode);
+            return -1;
+        }
+        delete[](data);
+    }
+    const double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if(err != Path::PATHGEN_NONE)
+    {
+        printf("[ERROR] %s: %s\n", mode, Path::error_string(err));
+        return -1;
+    }
+    printf("%s,%.1f,%.1f,%.1f,%zu,%016llx\n", mode, image_ms, total_ms - image_ms, peak_rss_mib(), goals.size(), (unsigned long long)checksum(goals));
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const int size = (argc > 1) ? atoi(argv[1]) : 20000;
+    if(size < 64)
+    {
+        printf("[ERROR] The size has to be at least 64 pixels.\n");
+        return -1;
+    }
+    if(argc > 2)
+        return run_mode(size, argv[2]);
+
+    printf("image %dx%d RGB (%.1f MiB), bitmap %.1f MiB, band %d rows\n", size, size, 3.0 * size * size / (1024.0 * 1024.0),
+           (size + 2 + 63) / 64 * 8.0 * (size + 2) / (1024.0 * 1024.0), Path::BAND_ROWS);
+    printf("mode,image ms,pipeline ms,peak RSS MiB,goals,checksum\n");
+    const char* modes[] = {"full", "memory", "stream"};
+    char first[64] = "";
+    for(const char* mode : modes)
+    {
+        char command[1024];
+        snprintf(command, sizeof(command), "\"%s\" %d %s", argv[0], size, mode);
+        FILE* child = popen(command, "r");
+        char line[256];
+        if(child == nullptr || fgets(line, sizeof(line), child) == nullptr)
+        {
+            printf("[ERROR] Failed to run: %s\n", command);
+            if(child != nullptr)
+                pclose(child);
+            return -1;
+        }
+        pclose(child);
+        printf("%s", line);
+
+        // The number of goals and the checksum (the last two columns) have to be the same in every mode.
+        const char* result = strchr(line, ',');
+        for(int i = 0; i < 3 && result != nullptr; i++)
+            result = strchr(result + 1, ',');
+        if(result == nullptr)
+            return -1;
+        if(first[0] == '\0')
+            snprintf(first, sizeof(first), "%s", result);
+        else if(strcmp(first, result) != 0)
+        {
+            printf("[ERROR] The goals of \"%s\" are different.\n", mode);
+            return -1;
+        }
+    }
+    return 0;
+}
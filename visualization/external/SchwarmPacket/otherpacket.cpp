@@ -40,6 +40,11 @@ ExitPacket& ExitPacket::operator=(ExitPacket&& other)
 
 /* ACNOLEDGE PACKET */
 
+AcnPacket::AcnPacket(void)
+{
+    this->request_id = 0;
+}
+
 AcnPacket::AcnPacket(const AcnPacket& other)
 {
     *this = other;
@@ -52,23 +57,48 @@ AcnPacket::AcnPacket(AcnPacket&& other)
 
 packet_error AcnPacket::encode(void)
 {
-    return this->internal_encode();
+    packet_error err = this->internal_encode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        *((uint32_t*)dataptr /* +0 */) = this->request_id;
+    }
+    return err;
 }
 
 packet_error AcnPacket::decode(void)
 {
-    return this->internal_decode();
+    packet_error err = this->internal_decode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        this->request_id = *((uint32_t*)dataptr /* +0 */);
+    }
+    return err;
+}
+
+void AcnPacket::set_request_id(uint32_t id) noexcept
+{
+    this->request_id = id;
+}
+
+uint32_t AcnPacket::get_request_id(void) const noexcept
+{
+    return this->request_id;
 }
 
 AcnPacket& AcnPacket::operator=(const AcnPacket& other)
 {
     Packet::operator=(other);
+    this->request_id = other.request_id;
     return *this;
 }
 
 AcnPacket& AcnPacket::operator=(AcnPacket&& other)
 {
     Packet::operator=(other);
+    this->request_id = other.request_id;
+    other.request_id = 0;
     return *this;
 }
 
@@ -77,6 +107,7 @@ AcnPacket& AcnPacket::operator=(AcnPacket&& other)
 ErrorPacket::ErrorPacket(void)
 {
     this->error_code = packet_error::PACKET_NONE;
+    this->request_id = 0;
 }
 
 ErrorPacket::ErrorPacket(const ErrorPacket& other)
@@ -92,16 +123,24 @@ ErrorPacket::ErrorPacket(ErrorPacket&& other)
 packet_error ErrorPacket::encode(void)
 {
     packet_error err = this->internal_encode();
-    uint8_t* dataptr = this->internal_data_ptr();
-    *((packet_error*)dataptr /* +0 */) = this->error_code;
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        *((packet_error*)dataptr /* +0 */) = this->error_code;
+        *((uint32_t*)(dataptr + ERROR_CODE_SIZE)) = this->request_id;
+    }
     return err;
 }
 
 packet_error ErrorPacket::decode(void)
 {
     packet_error err = this->internal_decode();
-    uint8_t* dataptr = this->internal_data_ptr();
-    this->error_code = *((packet_error*)dataptr /* +0 */);
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        this->error_code = *((packet_error*)dataptr /* +0 */);
+        this->request_id = *((uint32_t*)(dataptr + ERROR_CODE_SIZE));
+    }
     return err;
 }
 
@@ -115,10 +154,21 @@ packet_error ErrorPacket::get_code(void) const noexcept
     return this->error_code;
 }
 
+void ErrorPacket::set_request_id(uint32_t id) noexcept
+{
+    this->request_id = id;
+}
+
+uint32_t ErrorPacket::get_request_id(void) const noexcept
+{
+    return this->request_id;
+}
+
 ErrorPacket& ErrorPacket::operator=(const ErrorPacket& other)
 {
     Packet::operator=(other);
     this->error_code = other.error_code;
+    this->request_id = other.request_id;
     return *this;
 }
 
@@ -127,6 +177,8 @@ ErrorPacket& ErrorPacket::operator=(ErrorPacket&& other)
     Packet::operator=(other);
     this->error_code = other.error_code;
     other.error_code = packet_error::PACKET_NONE;
+    this->request_id = other.request_id;
+    other.request_id = 0;
     return *this;
 }
 
@@ -138,14 +190,15 @@ PathGeneratePacket::PathGeneratePacket(void)
     this->fp_allocsize = 0;
     this->vehicle_id = 0;
     this->invert = false;
+    this->request_id = 0;
 }
 
-PathGeneratePacket::PathGeneratePacket(const PathGeneratePacket& other)
+PathGeneratePacket::PathGeneratePacket(const PathGeneratePacket& other) : PathGeneratePacket()
 {
     *this = other;
 }
 
-PathGeneratePacket::PathGeneratePacket(PathGeneratePacket&& other)
+PathGeneratePacket::PathGeneratePacket(PathGeneratePacket&& other) : PathGeneratePacket()
 {
     *this = other;
 }
@@ -168,7 +221,7 @@ void PathGeneratePacket::free_fp(void)
 {
     if(this->filepath != nullptr)
     {
-        delete(this->filepath);
+        delete[](this->filepath);
         this->filepath = nullptr;
         this->fp_allocsize = 0;
     }
@@ -185,9 +238,10 @@ packet_error PathGeneratePacket::encode(void)
         *((unsigned int*)(dataptr /* +0 */)) = this->num_goals;
         *((int*)(dataptr + SIZE_NUM_GOALS)) = this->vehicle_id;
         *((bool*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID)) = this->invert;
-        memcpy((char*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT), this->filepath, (remaining_size < fp_size) ? ((remaining_size == 0) ? 0 : remaining_size - 1) : fp_size);
+        *((uint32_t*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT)) = this->request_id;
+        memcpy((char*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT + SIZE_REQUEST_ID), this->filepath, (remaining_size < fp_size) ? ((remaining_size == 0) ? 0 : remaining_size - 1) : fp_size);
         if(remaining_size < fp_size && remaining_size > 0)
-            *((char*)(dataptr + SIZE_NUM_GOALS + SIZE_INVERT + remaining_size - 1)) = '\0';
+            *((char*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT + SIZE_REQUEST_ID + remaining_size - 1)) = '\0';
     }
     return err;
 }
@@ -202,9 +256,15 @@ packet_error PathGeneratePacket::decode(void)
         this->num_goals = *((unsigned int*)(dataptr /* +0 */));
         this->vehicle_id = *((int*)(dataptr + SIZE_NUM_GOALS));
         this->invert = *((bool*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID));
-        this->free_fp();
-        this->alloc_fp(remaining_size);
-        memcpy(this->filepath, (char*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT), remaining_size);
+        this->request_id = *((uint32_t*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT));
+        // Same strategy as set_filepath(): only reallocate if the received path does not fit.
+        if(remaining_size >= this->fp_allocsize)
+        {
+            this->free_fp();
+            this->alloc_fp(remaining_size + 1);
+        }
+        memcpy(this->filepath, (char*)(dataptr + SIZE_NUM_GOALS + SIZE_VEHICLE_ID + SIZE_INVERT + SIZE_REQUEST_ID), remaining_size);
+        this->filepath[remaining_size] = '\0';    // the received path is not trusted to be terminated
     }
     return err;
 }
@@ -237,6 +297,8 @@ const char* PathGeneratePacket::get_filepath(void) const noexcept
 
 uint32_t PathGeneratePacket::filepath_size(void) const noexcept
 {
+    if(this->filepath == nullptr)
+        return 0;
     return strlen(this->filepath) + 1;   // +1 for \0
 }
 
@@ -260,15 +322,29 @@ bool PathGeneratePacket::should_invert(void) const noexcept
     return this->invert;
 }
 
+void PathGeneratePacket::set_request_id(uint32_t id) noexcept
+{
+    this->request_id = id;
+}
+
+uint32_t PathGeneratePacket::get_request_id(void) const noexcept
+{
+    return this->request_id;
+}
+
 PathGeneratePacket& PathGeneratePacket::operator=(const PathGeneratePacket& other)
 {
     Packet::operator=(other);
     this->num_goals = other.num_goals;
     this->vehicle_id = other.vehicle_id;
     this->invert = other.invert;
-    this->fp_allocsize = other.fp_allocsize;
-    this->alloc_fp(other.fp_allocsize);
-    memcpy(this->filepath, other.filepath, other.fp_allocsize);
+    this->request_id = other.request_id;
+    this->free_fp();
+    if(other.filepath != nullptr)
+    {
+        this->alloc_fp(other.fp_allocsize);
+        memcpy(this->filepath, other.filepath, other.fp_allocsize);
+    }
     return *this;
 }
 
@@ -284,10 +360,15 @@ PathGeneratePacket& PathGeneratePacket::operator=(PathGeneratePacket&& other)
     this->invert = other.invert;
     other.invert = false;
 
-    this->fp_allocsize = other.fp_allocsize;
-    this->alloc_fp(other.fp_allocsize);
-    memcpy(this->filepath, other.filepath, other.fp_allocsize);
-    other.fp_allocsize = 0;
+    this->request_id = other.request_id;
+    other.request_id = 0;
+
+    this->free_fp();
+    if(other.filepath != nullptr)
+    {
+        this->alloc_fp(other.fp_allocsize);
+        memcpy(this->filepath, other.filepath, other.fp_allocsize);
+    }
     other.free_fp();
     
     return *this;
@@ -298,6 +379,7 @@ GoalReqPacket::GoalReqPacket(void)
 {
     this->goal_idx = 0;
     this->vehicle_id = 0;
+    this->request_id = 0;
 }
 
 GoalReqPacket::GoalReqPacket(const GoalReqPacket& other)
@@ -318,6 +400,7 @@ packet_error GoalReqPacket::encode(void)
         uint8_t* dataptr = this->internal_data_ptr();
         *((unsigned int*)(dataptr /* +0 */)) = this->goal_idx;
         *((int*)(dataptr + SIZE_GOAL_IDX)) = this->vehicle_id;
+        *((uint32_t*)(dataptr + SIZE_GOAL_IDX + SIZE_VEHICLE_ID)) = this->request_id;
     }
     return err;
 }
@@ -330,6 +413,7 @@ packet_error GoalReqPacket::decode(void)
         uint8_t* dataptr = this->internal_data_ptr();
         this->goal_idx = *((unsigned int*)(dataptr));
         this->vehicle_id = *((int*)(dataptr + SIZE_GOAL_IDX));
+        this->request_id = *((uint32_t*)(dataptr + SIZE_GOAL_IDX + SIZE_VEHICLE_ID));
     }
     return err;
 }
@@ -354,11 +438,22 @@ int GoalReqPacket::get_vehicle_id(void) const noexcept
     return this->vehicle_id;
 }
 
+void GoalReqPacket::set_request_id(uint32_t id) noexcept
+{
+    this->request_id = id;
+}
+
+uint32_t GoalReqPacket::get_request_id(void) const noexcept
+{
+    return this->request_id;
+}
+
 GoalReqPacket& GoalReqPacket::operator=(const GoalReqPacket& other)
 {
     Packet::operator=(other);
     this->goal_idx = other.goal_idx;
     this->vehicle_id = other.vehicle_id;
+    this->request_id = other.request_id;
     return *this;
 }
 
@@ -371,6 +466,9 @@ GoalReqPacket& GoalReqPacket::operator=(GoalReqPacket&& other)
     this->vehicle_id = other.vehicle_id;
     other.vehicle_id = 0;
 
+    this->request_id = other.request_id;
+    other.request_id = 0;
+
     return *this;
 }
 
@@ -380,6 +478,7 @@ GoalPacket::GoalPacket(void)
     this->goal_x = 0;
     this->goal_y = 0;
     this->vehicle_id = 0;
+    this->request_id = 0;
 }
 
 GoalPacket::GoalPacket(const GoalPacket& other)
@@ -401,6 +500,7 @@ packet_error GoalPacket::encode(void)
         *((float*)(dataptr /* +0 */)) = this->goal_x;
         *((float*)(dataptr + sizeof(float))) = this->goal_y;
         *((int*)(dataptr + SIZE_GOAL)) = this->vehicle_id;
+        *((uint32_t*)(dataptr + SIZE_GOAL + SIZE_VEHICLE_ID)) = this->request_id;
     }
     return err;
 }
@@ -414,6 +514,7 @@ packet_error GoalPacket::decode(void)
         this->goal_x = *((float*)(dataptr /* +0 */));
         this->goal_y = *((float*)(dataptr + sizeof(float)));
         this->vehicle_id = *((int*)(dataptr + SIZE_GOAL));
+        this->request_id = *((uint32_t*)(dataptr + SIZE_GOAL + SIZE_VEHICLE_ID));
     }
     return err;
 }
@@ -444,12 +545,23 @@ int GoalPacket::get_vehicle_id(void) const noexcept
     return this->vehicle_id;
 }
 
+void GoalPacket::set_request_id(uint32_t id) noexcept
+{
+    this->request_id = id;
+}
+
+uint32_t GoalPacket::get_request_id(void) const noexcept
+{
+    return this->request_id;
+}
+
 GoalPacket& GoalPacket::operator=(const GoalPacket& other)
 {
     Packet::operator=(other);
     this->goal_x = other.goal_x;
     this->goal_y = other.goal_y;
     this->vehicle_id = other.vehicle_id;
+    this->request_id = other.request_id;
     return *this;
 }
 
@@ -465,6 +577,9 @@ GoalPacket& GoalPacket::operator=(GoalPacket&& other)
     this->vehicle_id = other.vehicle_id;
     other.vehicle_id = 0;
 
+    this->request_id = other.request_id;
+    other.request_id = 0;
+
     return *this;
 }
 
@@ -477,12 +592,12 @@ VehicleCommandPacket::VehicleCommandPacket(void)
     this->length = 0.0f;
 }
 
-VehicleCommandPacket::VehicleCommandPacket(const GoalPacket& other)
+VehicleCommandPacket::VehicleCommandPacket(const VehicleCommandPacket& other) : VehicleCommandPacket()
 {
     *this = other;
 }
 
-VehicleCommandPacket::VehicleCommandPacket(GoalPacket&& other)
+VehicleCommandPacket::VehicleCommandPacket(VehicleCommandPacket&& other) : VehicleCommandPacket()
 {
     *this = std::move(other);
 }
@@ -564,4 +679,739 @@ VehicleCommandPacket& VehicleCommandPacket::operator=(VehicleCommandPacket&& oth
     this->length = other.length;
     other.length = 0.0f;
     return *this;
-}
\ No newline at end of file
+}
+
+/* BATCH PACKET */
+
+BatchPacket::BatchPacket(void)
+{
+    this->num_packets = 0;
+    this->payload = nullptr;
+    this->payload_size = 0;
+    this->payload_allocsize = 0;
+    this->payload_offset = 0;
+}
+
+BatchPacket::BatchPacket(const BatchPacket& other) : BatchPacket()
+{
+    *this = other;
+}
+
+BatchPacket::BatchPacket(BatchPacket&& other) : BatchPacket()
+{
+    *this = std::move(other);
+}
+
+BatchPacket::~BatchPacket(void)
+{
+    this->free_payload();
+}
+
+void BatchPacket::alloc_payload(uint32_t s)
+{
+    if(s <= this->payload_allocsize)
+        return;
+
+    // Grow geometrically, a batch is usually refilled every tick with roughly the same size.
+    uint32_t new_size = (this->payload_allocsize == 0) ? 64 : this->payload_allocsize;
+    while(new_size < s)
+        new_size *= 2;
+
+    uint8_t* new_payload = new uint8_t[new_size];
+    if(this->payload != nullptr)
+    {
+        memcpy(new_payload, this->payload, this->payload_size);
+        delete[](this->payload);
+    }
+    this->payload = new_payload;
+    this->payload_allocsize = new_size;
+}
+
+void BatchPacket::free_payload(void)
+{
+    if(this->payload != nullptr)
+    {
+        delete[](this->payload);
+        this->payload = nullptr;
+        this->payload_size = 0;
+        this->payload_allocsize = 0;
+    }
+}
+
+void BatchPacket::own_payload(void)
+{
+    if(this->payload_offset == 0)
+        return;
+
+    const uint32_t size = this->payload_size;
+    this->payload_size = 0;
+    this->alloc_payload(size);
+    if(size > 0)
+        memcpy(this->payload, this->rawdata() + this->payload_offset, size);
+    this->payload_size = size;
+    this->payload_offset = 0;
+}
+
+packet_error BatchPacket::encode(void)
+{
+    // The sub-packets of a decoded batch are only still in place if the header has not changed.
+    if(this->payload_offset != 0 && this->payload_offset != this->min_size())
+        return packet_error::PACKET_INVALID_SIZE;
+
+    packet_error err = this->internal_encode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        if(this->size() < this->min_size() + this->payload_size)
+            return packet_error::PACKET_INVALID_SIZE;
+
+        uint8_t* dataptr = this->internal_data_ptr();
+        *((uint32_t*)(dataptr /* +0 */)) = this->num_packets;
+        if(this->payload_size > 0 && this->payload_offset == 0)
+            memcpy(dataptr + SIZE_NUM_PACKETS, this->payload, this->payload_size);
+    }
+    return err;
+}
+
+packet_error BatchPacket::decode(void)
+{
+    packet_error err = this->internal_decode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        const uint8_t* dataptr = this->data();
+        const uint32_t num = *((uint32_t*)(dataptr /* +0 */));
+
+        // Validate the sub-packets before they are handed out by first() and next().
+        uint32_t offset = this->min_size();
+        uint32_t i;
+        for(i = 0; i < num; i++)
+        {
+            if(this->size() - offset < SIZE_ID + SIZE_PACKET_LENGTH)
+                return packet_error::PACKET_INVALID_SIZE;
+            const uint32_t sub_size = *Packet::size_ptr(this->rawdata() + offset);
+            if(sub_size < SIZE_ID + SIZE_PACKET_LENGTH || sub_size > this->size() - offset)
+                return packet_error::PACKET_INVALID_SIZE;
+            offset += sub_size;
+        }
+        // Bytes behind the last sub-packet would be handed out by next() without being validated.
+        if(offset != this->size())
+            return packet_error::PACKET_INVALID_SIZE;
+
+        // The sub-packets stay in the received data, they are only copied if the batch gets extended (see own_payload()).
+        this->payload_offset = this->min_size();
+        this->payload_size = offset - this->min_size();
+        this->num_packets = num;
+    }
+    return err;
+}
+
+packet_error BatchPacket::add(const Packet& packet)
+{
+    if(packet.rawdata() == nullptr)
+        return packet_error::PACKET_NULL;
+
+    this->own_payload();
+    this->alloc_payload(this->payload_size + packet.size());
+    memcpy(this->payload + this->payload_size, packet.rawdata(), packet.size());
+    this->payload_size += packet.size();
+    this->num_packets++;
+    return packet_error::PACKET_NONE;
+}
+
+void BatchPacket::clear(void) noexcept
+{
+    this->num_packets = 0;
+    this->payload_size = 0;
+    this->payload_offset = 0;
+}
+
+uint32_t BatchPacket::get_num_packets(void) const noexcept
+{
+    return this->num_packets;
+}
+
+uint32_t BatchPacket::batch_size(void) const noexcept
+{
+    return this->payload_size;
+}
+
+const uint8_t* BatchPacket::first(void) const noexcept
+{
+    if(this->rawdata() == nullptr || this->num_packets == 0 || this->size() <= this->min_size())
+        return nullptr;
+
+    return this->rawdata() + this->min_size();
+}
+
+const uint8_t* BatchPacket::next(const uint8_t* cur) const noexcept
+{
+    if(cur == nullptr)
+        return nullptr;
+
+    // A sub-packet can not be smaller than its header, this would never reach the end.
+    const uint32_t cur_size = *Packet::size_ptr(cur);
+    if(cur_size < SIZE_ID + SIZE_PACKET_LENGTH)
+        return nullptr;
+
+    const uint8_t* nextptr = cur + cur_size;
+    // 'nullptr' if the end of the batch has been reached.
+    if(nextptr + SIZE_ID + SIZE_PACKET_LENGTH > this->rawdata() + this->size())
+        return nullptr;
+
+    return nextptr;
+}
+
+BatchPacket& BatchPacket::operator=(const BatchPacket& other)
+{
+    Packet::operator=(other);
+    this->num_packets = other.num_packets;
+    // The raw data has been copied, so a payload that is still in the received data stays valid.
+    this->payload_offset = other.payload_offset;
+    this->payload_size = 0;
+    if(other.payload_offset == 0)
+    {
+        this->alloc_payload(other.payload_size);
+        if(other.payload_size > 0)
+            memcpy(this->payload, other.payload, other.payload_size);
+    }
+    this->payload_size = other.payload_size;
+    return *this;
+}
+
+BatchPacket& BatchPacket::operator=(BatchPacket&& other)
+{
+    Packet::operator=(std::move(other));
+    this->free_payload();
+    this->num_packets = other.num_packets;
+    other.num_packets = 0;
+
+    this->payload = other.payload;
+    this->payload_size = other.payload_size;
+    this->payload_allocsize = other.payload_allocsize;
+    this->payload_offset = other.payload_offset;
+    other.payload = nullptr;
+    other.payload_size = 0;
+    other.payload_allocsize = 0;
+    other.payload_offset = 0;
+    return *this;
+}
+
+/* GOAL RANGE REQUEST PACKET */
+GoalRangeReqPacket::GoalRangeReqPacket(void)
+{
+    this->vehicle_id = 0;
+    this->start_idx = 0;
+    this->count = 0;
+    this->request_id = 0;
+}
+
+GoalRangeReqPacket::GoalRangeReqPacket(const GoalRangeReqPacket& other)
+{
+    *this = other;
+}
+
+GoalRangeReqPacket::GoalRangeReqPacket(GoalRangeReqPacket&& other)
+{
+    *this = other;
+}
+
+packet_error GoalRangeReqPacket::encode(void)
+{
+    packet_error err = this->internal_encode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        *((int*)(dataptr /* +0 */)) = this->vehicle_id;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID)) = this->start_idx;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX)) = this->count;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_COUNT)) = this->request_id;
+    }
+    return err;
+}
+
+packet_error GoalRangeReqPacket::decode(void)
+{
+    packet_error err = this->internal_decode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        this->vehicle_id = *((int*)(dataptr /* +0 */));
+        this->start_idx = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID));
+        this->count = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX));
+        this->request_id = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_COUNT));
+    }
+    return err;
+}
+
+void GoalRangeReqPacket::set_vehicle_id(int id) noexcept
+{
+    this->vehicle_id = id;
+}
+
+int GoalRangeReqPacket::get_vehicle_id(void) const noexcept
+{
+    return this->vehicle_id;
+}
+
+void GoalRangeReqPacket::set_start_index(uint32_t i) noexcept
+{
+    this->start_idx = i;
+}
+
+uint32_t GoalRangeReqPacket::get_start_index(void) const noexcept
+{
+    return this->start_idx;
+}
+
+void GoalRangeReqPacket::set_count(uint32_t n) noexcept
+{
+    this->count = n;
+}
+
+uint32_t GoalRangeReqPacket::get_count(void) const noexcept
+{
+    return this->count;
+}
+
+void GoalRangeReqPacket::set_request_id(uint32_t id) noexcept
+{
+    this->request_id = id;
+}
+
+uint32_t GoalRangeReqPacket::get_request_id(void) const noexcept
+{
+    return this->request_id;
+}
+
+GoalRangeReqPacket& GoalRangeReqPacket::operator=(const GoalRangeReqPacket& other)
+{
+    Packet::operator=(other);
+    this->vehicle_id = other.vehicle_id;
+    this->start_idx = other.start_idx;
+    this->count = other.count;
+    this->request_id = other.request_id;
+    return *this;
+}
+
+GoalRangeReqPacket& GoalRangeReqPacket::operator=(GoalRangeReqPacket&& other)
+{
+    Packet::operator=(other);
+    this->vehicle_id = other.vehicle_id;
+    other.vehicle_id = 0;
+
+    this->start_idx = other.start_idx;
+    other.start_idx = 0;
+
+    this->count = other.count;
+    other.count = 0;
+
+    this->request_id = other.request_id;
+    other.request_id = 0;
+    return *this;
+}
+
+/* GOAL LIST PACKET */
+GoalListPacket::GoalListPacket(void)
+{
+    this->vehicle_id = 0;
+    this->start_idx = 0;
+    this->total_goals = 0;
+    this->end_of_path = false;
+    this->num_goals = 0;
+    this->request_id = 0;
+    this->goals = nullptr;
+    this->goals_allocsize = 0;
+}
+
+GoalListPacket::GoalListPacket(const GoalListPacket& other) : GoalListPacket()
+{
+    *this = other;
+}
+
+GoalListPacket::GoalListPacket(GoalListPacket&& other) : GoalListPacket()
+{
+    *this = std::move(other);
+}
+
+GoalListPacket::~GoalListPacket(void)
+{
+    this->free_goals();
+}
+
+void GoalListPacket::alloc_goals(uint32_t n)
+{
+    // The buffer is only reallocated if it is too small.
+    if(n > this->goals_allocsize)
+    {
+        this->free_goals();
+        this->goals = new float[2 * n];
+        this->goals_allocsize = n;
+    }
+}
+
+void GoalListPacket::free_goals(void)
+{
+    if(this->goals != nullptr)
+    {
+        delete[](this->goals);
+        this->goals = nullptr;
+        this->goals_allocsize = 0;
+    }
+}
+
+packet_error GoalListPacket::encode(void)
+{
+    packet_error err = this->internal_encode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        if(this->size() < this->min_size() + this->goals_size())
+            return packet_error::PACKET_INVALID_SIZE;
+
+        uint8_t* dataptr = this->internal_data_ptr();
+        *((int*)(dataptr /* +0 */)) = this->vehicle_id;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID)) = this->start_idx;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX)) = this->total_goals;
+        *((bool*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS)) = this->end_of_path;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS + SIZE_END_OF_PATH)) = this->num_goals;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS + SIZE_END_OF_PATH + SIZE_NUM_GOALS)) = this->request_id;
+        if(this->num_goals > 0)
+            memcpy(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS + SIZE_END_OF_PATH + SIZE_NUM_GOALS + SIZE_REQUEST_ID, this->goals, this->goals_size());
+    }
+    return err;
+}
+
+packet_error GoalListPacket::decode(void)
+{
+    packet_error err = this->internal_decode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        const uint32_t n = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS + SIZE_END_OF_PATH));
+        // The number of goals must fit into the received packet.
+        if(n > MAX_GOALS || n * SIZE_GOAL > this->size() - this->min_size())
+            return packet_error::PACKET_INVALID_SIZE;
+
+        this->vehicle_id = *((int*)(dataptr /* +0 */));
+        this->start_idx = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID));
+        this->total_goals = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX));
+        this->end_of_path = *((bool*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS));
+        this->request_id = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS + SIZE_END_OF_PATH + SIZE_NUM_GOALS));
+        this->alloc_goals(n);
+        this->num_goals = n;
+        if(n > 0)
+            memcpy(this->goals, dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_TOTAL_GOALS + SIZE_END_OF_PATH + SIZE_NUM_GOALS + SIZE_REQUEST_ID, this->goals_size());
+    }
+    return err;
+}
+
+void GoalListPacket::set_vehicle_id(int id) noexcept
+{
+    this->vehicle_id = id;
+}
+
+int GoalListPacket::get_vehicle_id(void) const noexcept
+{
+    return this->vehicle_id;
+}
+
+void GoalListPacket::set_start_index(uint32_t i) noexcept
+{
+    this->start_idx = i;
+}
+
+uint32_t GoalListPacket::get_start_index(void) const noexcept
+{
+    return this->start_idx;
+}
+
+void GoalListPacket::set_total_goals(uint32_t n) noexcept
+{
+    this->total_goals = n;
+}
+
+uint32_t GoalListPacket::get_total_goals(void) const noexcept
+{
+    return this->total_goals;
+}
+
+bool& GoalListPacket::is_end_of_path(void) noexcept
+{
+    return this->end_of_path;
+}
+
+bool GoalListPacket::is_end_of_path(void) const noexcept
+{
+    return this->end_of_path;
+}
+
+void GoalListPacket::set_request_id(uint32_t id) noexcept
+{
+    this->request_id = id;
+}
+
+uint32_t GoalListPacket::get_request_id(void) const noexcept
+{
+    return this->request_id;
+}
+
+void GoalListPacket::set_goals(const float* goals, uint32_t n)
+{
+    n = std::min(n, MAX_GOALS);
+    this->alloc_goals(n);
+    this->num_goals = n;
+    if(n > 0)
+        memcpy(this->goals, goals, this->goals_size());
+}
+
+uint32_t GoalListPacket::get_num_goals(void) const noexcept
+{
+    return this->num_goals;
+}
+
+float GoalListPacket::get_goal_x(uint32_t i) const noexcept
+{
+    return (i < this->num_goals) ? this->goals[2 * i] : 0.0f;
+}
+
+float GoalListPacket::get_goal_y(uint32_t i) const noexcept
+{
+    return (i < this->num_goals) ? this->goals[2 * i + 1] : 0.0f;
+}
+
+uint32_t GoalListPacket::goals_size(void) const noexcept
+{
+    return this->num_goals * SIZE_GOAL;
+}
+
+GoalListPacket& GoalListPacket::operator=(const GoalListPacket& other)
+{
+    Packet::operator=(other);
+    this->vehicle_id = other.vehicle_id;
+    this->start_idx = other.start_idx;
+    this->total_goals = other.total_goals;
+    this->end_of_path = other.end_of_path;
+    this->request_id = other.request_id;
+    this->set_goals(other.goals, other.num_goals);
+    return *this;
+}
+
+GoalListPacket& GoalListPacket::operator=(GoalListPacket&& other)
+{
+    Packet::operator=(std::move(other));
+    this->vehicle_id = other.vehicle_id;
+    other.vehicle_id = 0;
+
+    this->start_idx = other.start_idx;
+    other.start_idx = 0;
+
+    this->total_goals = other.total_goals;
+    other.total_goals = 0;
+
+    this->end_of_path = other.end_of_path;
+    other.end_of_path = false;
+
+    this->request_id = other.request_id;
+    other.request_id = 0;
+
+    this->free_goals();
+    this->goals = other.goals;
+    this->num_goals = other.num_goals;
+    this->goals_allocsize = other.goals_allocsize;
+    other.goals = nullptr;
+    other.num_goals = 0;
+    other.goals_allocsize = 0;
+    return *this;
+}
+
+/* GOAL SUBSCRIBE PACKET */
+GoalSubscribePacket::GoalSubscribePacket(void)
+{
+    this->vehicle_id = 0;
+    this->start_idx = 0;
+    this->window = 0;
+    this->request_id = 0;
+}
+
+GoalSubscribePacket::GoalSubscribePacket(const GoalSubscribePacket& other)
+{
+    *this = other;
+}
+
+GoalSubscribePacket::GoalSubscribePacket(GoalSubscribePacket&& other)
+{
+    *this = other;
+}
+
+packet_error GoalSubscribePacket::encode(void)
+{
+    packet_error err = this->internal_encode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        *((int*)(dataptr /* +0 */)) = this->vehicle_id;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID)) = this->start_idx;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX)) = this->window;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_WINDOW)) = this->request_id;
+    }
+    return err;
+}
+
+packet_error GoalSubscribePacket::decode(void)
+{
+    packet_error err = this->internal_decode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        this->vehicle_id = *((int*)(dataptr /* +0 */));
+        this->start_idx = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID));
+        this->window = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX));
+        this->request_id = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID + SIZE_START_IDX + SIZE_WINDOW));
+    }
+    return err;
+}
+
+void GoalSubscribePacket::set_vehicle_id(int id) noexcept
+{
+    this->vehicle_id = id;
+}
+
+int GoalSubscribePacket::get_vehicle_id(void) const noexcept
+{
+    return this->vehicle_id;
+}
+
+void GoalSubscribePacket::set_start_index(uint32_t i) noexcept
+{
+    this->start_idx = i;
+}
+
+uint32_t GoalSubscribePacket::get_start_index(void) const noexcept
+{
+    return this->start_idx;
+}
+
+void GoalSubscribePacket::set_window(uint32_t n) noexcept
+{
+    this->window = n;
+}
+
+uint32_t GoalSubscribePacket::get_window(void) const noexcept
+{
+    return this->window;
+}
+
+void GoalSubscribePacket::set_request_id(uint32_t id) noexcept
+{
+    this->request_id = id;
+}
+
+uint32_t GoalSubscribePacket::get_request_id(void) const noexcept
+{
+    return this->request_id;
+}
+
+GoalSubscribePacket& GoalSubscribePacket::operator=(const GoalSubscribePacket& other)
+{
+    Packet::operator=(other);
+    this->vehicle_id = other.vehicle_id;
+    this->start_idx = other.start_idx;
+    this->window = other.window;
+    this->request_id = other.request_id;
+    return *this;
+}
+
+GoalSubscribePacket& GoalSubscribePacket::operator=(GoalSubscribePacket&& other)
+{
+    Packet::operator=(other);
+    this->vehicle_id = other.vehicle_id;
+    other.vehicle_id = 0;
+
+    this->start_idx = other.start_idx;
+    other.start_idx = 0;
+
+    this->window = other.window;
+    other.window = 0;
+
+    this->request_id = other.request_id;
+    other.request_id = 0;
+    return *this;
+}
+
+/* GOAL ACK PACKET */
+GoalAckPacket::GoalAckPacket(void)
+{
+    this->vehicle_id = 0;
+    this->next_idx = 0;
+}
+
+GoalAckPacket::GoalAckPacket(const GoalAckPacket& other)
+{
+    *this = other;
+}
+
+GoalAckPacket::GoalAckPacket(GoalAckPacket&& other)
+{
+    *this = other;
+}
+
+packet_error GoalAckPacket::encode(void)
+{
+    packet_error err = this->internal_encode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        *((int*)(dataptr /* +0 */)) = this->vehicle_id;
+        *((uint32_t*)(dataptr + SIZE_VEHICLE_ID)) = this->next_idx;
+    }
+    return err;
+}
+
+packet_error GoalAckPacket::decode(void)
+{
+    packet_error err = this->internal_decode();
+    if(err == packet_error::PACKET_NONE)
+    {
+        uint8_t* dataptr = this->internal_data_ptr();
+        this->vehicle_id = *((int*)(dataptr /* +0 */));
+        this->next_idx = *((uint32_t*)(dataptr + SIZE_VEHICLE_ID));
+    }
+    return err;
+}
+
+void GoalAckPacket::set_vehicle_id(int id) noexcept
+{
+    this->vehicle_id = id;
+}
+
+int GoalAckPacket::get_vehicle_id(void) const noexcept
+{
+    return this->vehicle_id;
+}
+
+void GoalAckPacket::set_next_index(uint32_t i) noexcept
+{
+    this->next_idx = i;
+}
+
+uint32_t GoalAckPacket::get_next_index(void) const noexcept
+{
+    return this->next_idx;
+}
+
+GoalAckPacket& GoalAckPacket::operator=(const GoalAckPacket& other)
+{
+    Packet::operator=(other);
+    this->vehicle_id = other.vehicle_id;
+    this->next_idx = other.next_idx;
+    return *this;
+}
+
+GoalAckPacket& GoalAckPacket::operator=(GoalAckPacket&& other)
+{
+    Packet::operator=(other);
+    this->vehicle_id = other.vehicle_id;
+    other.vehicle_id = 0;
+
+    this->next_idx = other.next_idx;
+    other.next_idx = 0;
+    return *this;
+}